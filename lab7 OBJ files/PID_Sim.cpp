@@ -1,448 +1,983 @@
-#include <iostream>
-#include <vector>
-#include <cmath>
-#include <iomanip>
-#include <chrono>
-#include <thread>
-
-// 3D Vector class for position, velocity, and forces
-class Vec3 {
-public:
-    double x, y, z;
-    
-    Vec3(double x = 0, double y = 0, double z = 0) : x(x), y(y), z(z) {}
-    
-    Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
-    Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
-    Vec3 operator*(double s) const { return Vec3(x * s, y * s, z * s); }
-    Vec3 operator/(double s) const { return Vec3(x / s, y / s, z / s); }
-    Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
-    
-    double magnitude() const { return sqrt(x*x + y*y + z*z); }
-    double distance(const Vec3& v) const { return (*this - v).magnitude(); }
-    Vec3 normalized() const { 
-        double mag = magnitude();
-        if (mag > 0) return *this / mag;
-        return Vec3(0, 0, 0);
-    }
-};
-
-// PID Controller class with improved control
-class PIDController {
-private:
-    double kp, ki, kd;
-    double integral;
-    double prev_error;
-    double integral_limit;
-    double output_limit;
-    
-public:
-    PIDController(double kp = 1.0, double ki = 0.0, double kd = 0.0, 
-                  double integral_limit = 100.0, double output_limit = 50.0) 
-        : kp(kp), ki(ki), kd(kd), integral(0), prev_error(0), 
-          integral_limit(integral_limit), output_limit(output_limit) {}
-    
-    double calculate(double error, double dt) {
-        // Proportional term
-        double p_term = kp * error;
-        
-        // Integral term with anti-windup
-        integral += error * dt;
-        if (integral > integral_limit) integral = integral_limit;
-        if (integral < -integral_limit) integral = -integral_limit;
-        double i_term = ki * integral;
-        
-        // Derivative term (with filter for noise reduction)
-        double derivative = 0;
-        if (dt > 0) {
-            derivative = (error - prev_error) / dt;
-        }
-        double d_term = kd * derivative;
-        
-        prev_error = error;
-        
-        // Calculate total output
-        double output = p_term + i_term + d_term;
-        
-        // Limit output
-        if (output > output_limit) output = output_limit;
-        if (output < -output_limit) output = -output_limit;
-        
-        return output;
-    }
-    
-    void reset() {
-        integral = 0;
-        prev_error = 0;
-    }
-    
-    void setGains(double p, double i, double d) {
-        kp = p;
-        ki = i;
-        kd = d;
-    }
-    
-    double getIntegral() const { return integral; }
-};
-
-// UAV class with improved physics and control
-class UAV {
-private:
-    Vec3 position;
-    Vec3 velocity;
-    Vec3 acceleration;
-    double mass;
-    double max_force_per_axis;  // Maximum force per axis
-    double drag_coefficient;
-    double gravity_compensation;
-    
-    // PID controllers for each axis
-    PIDController pid_x;
-    PIDController pid_y;
-    PIDController pid_z;
-    
-    // Velocity controller (cascade control)
-    PIDController pid_vx;
-    PIDController pid_vy;
-    PIDController pid_vz;
-    
-public:
-    UAV(Vec3 initial_pos = Vec3(0, 0, 0), double mass = 1.0, double max_force = 30.0) 
-        : position(initial_pos), velocity(0, 0, 0), acceleration(0, 0, 0),
-          mass(mass), max_force_per_axis(max_force), drag_coefficient(0.05) {
-        
-        // Position PID controllers - generates desired velocity
-        pid_x.setGains(4.0, 0.2, 2.0);   // P, I, D gains for X position
-        pid_y.setGains(4.0, 0.2, 2.0);   // P, I, D gains for Y position
-        pid_z.setGains(5.0, 0.3, 2.5);   // Higher gains for Z (altitude)
-        
-        // Velocity PID controllers - generates force commands
-        pid_vx.setGains(3.0, 0.1, 0.5);  // X velocity control
-        pid_vy.setGains(3.0, 0.1, 0.5);  // Y velocity control
-        pid_vz.setGains(4.0, 0.2, 0.8);  // Z velocity control
-        
-        // Calculate gravity compensation
-        gravity_compensation = 9.81 * mass;
-    }
-    
-    // Calculate control forces using cascade PID (position -> velocity -> force)
-    Vec3 calculateControlForces(const Vec3& target, double dt) {
-        // Position error
-        Vec3 pos_error = target - position;
-        
-        // Calculate desired velocity from position error (outer loop)
-        double desired_vx = pid_x.calculate(pos_error.x, dt);
-        double desired_vy = pid_y.calculate(pos_error.y, dt);
-        double desired_vz = pid_z.calculate(pos_error.z, dt);
-        
-        // Limit desired velocity to reasonable values
-        double max_velocity = 10.0;
-        desired_vx = std::max(-max_velocity, std::min(max_velocity, desired_vx));
-        desired_vy = std::max(-max_velocity, std::min(max_velocity, desired_vy));
-        desired_vz = std::max(-max_velocity, std::min(max_velocity, desired_vz));
-        
-        // Velocity error
-        double vel_error_x = desired_vx - velocity.x;
-        double vel_error_y = desired_vy - velocity.y;
-        double vel_error_z = desired_vz - velocity.z;
-        
-        // Calculate force from velocity error (inner loop)
-        double force_x = pid_vx.calculate(vel_error_x, dt);
-        double force_y = pid_vy.calculate(vel_error_y, dt);
-        double force_z = pid_vz.calculate(vel_error_z, dt);
-        
-        // Add gravity compensation to Z force (feed-forward term)
-        force_z += gravity_compensation;
-        
-        // Apply per-axis force limits
-        force_x = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_x));
-        force_y = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_y));
-        force_z = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_z));
-        
-        return Vec3(force_x, force_y, force_z);
-    }
-    
-    // Alternative: Simple P-D controller with feed-forward for better stability
-    Vec3 calculateSimpleControlForces(const Vec3& target, double dt) {
-        Vec3 pos_error = target - position;
-        
-        // Position control with velocity damping
-        double kp_pos = 5.0;
-        double kd_vel = 3.0;
-        
-        Vec3 force;
-        force.x = kp_pos * pos_error.x - kd_vel * velocity.x;
-        force.y = kp_pos * pos_error.y - kd_vel * velocity.y;
-        force.z = kp_pos * pos_error.z - kd_vel * velocity.z + gravity_compensation;
-        
-        // Apply force limits
-        force.x = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.x));
-        force.y = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.y));
-        force.z = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.z));
-        
-        return force;
-    }
-    
-    // Update UAV physics
-    void update(const Vec3& control_force, double dt) {
-        // Calculate drag force (proportional to velocity squared for more realism)
-        Vec3 drag;
-        drag.x = -drag_coefficient * velocity.x * std::abs(velocity.x);
-        drag.y = -drag_coefficient * velocity.y * std::abs(velocity.y);
-        drag.z = -drag_coefficient * velocity.z * std::abs(velocity.z);
-        
-        // Gravity acts only on Z axis
-        Vec3 gravity(0, 0, -9.81 * mass);
-        
-        // Total force
-        Vec3 total_force = control_force + drag + gravity;
-        
-        // Newton's second law: F = ma
-        acceleration = total_force / mass;
-        
-        // Update velocity and position using Euler integration
-        velocity = velocity + acceleration * dt;
-        position = position + velocity * dt;
-        
-        // Optional: Add ground constraint
-        if (position.z < 0) {
-            position.z = 0;
-            if (velocity.z < 0) velocity.z = 0;
-        }
-    }
-    
-    // Getters
-    Vec3 getPosition() const { return position; }
-    Vec3 getVelocity() const { return velocity; }
-    Vec3 getAcceleration() const { return acceleration; }
-    
-    // Reset all controllers
-    void resetControllers() {
-        pid_x.reset();
-        pid_y.reset();
-        pid_z.reset();
-        pid_vx.reset();
-        pid_vy.reset();
-        pid_vz.reset();
-    }
-    
-    // Set position (for testing)
-    void setPosition(const Vec3& pos) {
-        position = pos;
-        velocity = Vec3(0, 0, 0);
-        acceleration = Vec3(0, 0, 0);
-        resetControllers();
-    }
-};
-
-// Path manager for waypoint navigation
-class PathManager {
-private:
-    std::vector<Vec3> waypoints;
-    size_t current_waypoint_index;
-    double waypoint_tolerance;
-    double approach_speed_factor;
-    
-public:
-    PathManager(double tolerance = 1.0) 
-        : current_waypoint_index(0), waypoint_tolerance(tolerance),
-          approach_speed_factor(1.0) {}
-    
-    void addWaypoint(const Vec3& point) {
-        waypoints.push_back(point);
-    }
-    
-    void addWaypoints(const std::vector<Vec3>& points) {
-        waypoints.insert(waypoints.end(), points.begin(), points.end());
-    }
-    
-    Vec3 getCurrentTarget() const {
-        if (waypoints.empty()) return Vec3(0, 0, 0);
-        return waypoints[current_waypoint_index];
-    }
-    
-    bool updateTarget(const Vec3& current_position) {
-        if (waypoints.empty()) return false;
-        
-        // Check if UAV reached current waypoint
-        double distance = current_position.distance(waypoints[current_waypoint_index]);
-        
-        // Dynamic tolerance based on altitude (more lenient at higher altitudes)
-        double dynamic_tolerance = waypoint_tolerance;
-        if (waypoints[current_waypoint_index].z > 5) {
-            dynamic_tolerance = waypoint_tolerance * 1.5;
-        }
-        
-        if (distance < dynamic_tolerance) {
-            std::cout << "Reached waypoint " << current_waypoint_index + 1 
-                     << " (distance: " << distance << ")\n";
-            current_waypoint_index++;
-            if (current_waypoint_index >= waypoints.size()) {
-                current_waypoint_index = 0;  // Loop back to start
-                return true;  // Path completed
-            }
-        }
-        return false;
-    }
-    
-    bool hasWaypoints() const { return !waypoints.empty(); }
-    size_t getCurrentIndex() const { return current_waypoint_index; }
-    size_t getWaypointCount() const { return waypoints.size(); }
-    void reset() { current_waypoint_index = 0; }
-};
-
-// Simulation class
-class Simulation {
-private:
-    UAV uav;
-    PathManager path_manager;
-    double simulation_time;
-    double dt;
-    bool verbose;
-    bool use_cascade_control;
-    
-public:
-    Simulation(double timestep = 0.01, bool verbose = true, bool cascade = true) 
-        : uav(Vec3(0, 0, 0)), simulation_time(0), dt(timestep), 
-          verbose(verbose), use_cascade_control(cascade) {}
-    
-    void setupPath() {
-        // Create a 3D path with multiple waypoints
-        path_manager.addWaypoints({
-            Vec3(0, 0, 5),      // Take off
-            Vec3(10, 0, 5),     // Move forward
-            Vec3(10, 10, 5),    // Move right
-            Vec3(10, 10, 10),   // Climb
-            Vec3(0, 10, 10),    // Move back
-            Vec3(0, 0, 10),     // Complete square at altitude
-            Vec3(0, 0, 0)       // Land
-        });
-    }
-    
-    void setupSimplePath() {
-        // Simpler path for testing
-        path_manager.addWaypoints({
-            Vec3(0, 0, 2),      // Small takeoff
-            Vec3(5, 0, 2),      // Move forward
-            Vec3(5, 5, 2),      // Move right
-            Vec3(0, 5, 2),      // Move back
-            Vec3(0, 0, 2),      // Return to start
-            Vec3(0, 0, 0)       // Land
-        });
-    }
-    
-    void run(double duration) {
-        std::cout << "\n=== UAV PID Path Control Simulation ===\n";
-        std::cout << "Control mode: " << (use_cascade_control ? "Cascade PID" : "Simple PD+FF") << "\n";
-        std::cout << "Simulation duration: " << duration << " seconds\n";
-        std::cout << "Time step: " << dt << " seconds\n\n";
-        
-        int display_counter = 0;
-        int display_interval = 50;  // Display every 50 iterations (0.5 seconds)
-        
-        double min_error = 999999;
-        double max_error = 0;
-        double total_error = 0;
-        int error_samples = 0;
-        
-        while (simulation_time < duration && path_manager.hasWaypoints()) {
-            // Get current target waypoint
-            Vec3 target = path_manager.getCurrentTarget();
-            
-            // Calculate control forces
-            Vec3 control_force;
-            if (use_cascade_control) {
-                control_force = uav.calculateControlForces(target, dt);
-            } else {
-                control_force = uav.calculateSimpleControlForces(target, dt);
-            }
-            
-            // Update UAV physics
-            uav.update(control_force, dt);
-            
-            // Track error statistics
-            double error = uav.getPosition().distance(target);
-            min_error = std::min(min_error, error);
-            max_error = std::max(max_error, error);
-            total_error += error;
-            error_samples++;
-            
-            // Check if waypoint reached and update target
-            if (path_manager.updateTarget(uav.getPosition())) {
-                uav.resetControllers();  // Reset PID controllers for new waypoint
-                if (verbose) {
-                    std::cout << "\n>>> Path completed! Restarting...\n\n";
-                    path_manager.reset();
-                }
-            }
-            
-            // Display status periodically
-            if (verbose && display_counter % display_interval == 0) {
-                displayStatus(target, control_force);
-            }
-            
-            simulation_time += dt;
-            display_counter++;
-        }
-        
-        std::cout << "\n=== Simulation Statistics ===\n";
-        std::cout << "Minimum error: " << std::fixed << std::setprecision(3) << min_error << " m\n";
-        std::cout << "Maximum error: " << std::fixed << std::setprecision(3) << max_error << " m\n";
-        std::cout << "Average error: " << std::fixed << std::setprecision(3) 
-                  << (total_error / error_samples) << " m\n";
-        std::cout << "Final position: (" << uav.getPosition().x << ", " 
-                  << uav.getPosition().y << ", " << uav.getPosition().z << ")\n";
-    }
-    
-    void displayStatus(const Vec3& target, const Vec3& control_force) {
-        Vec3 pos = uav.getPosition();
-        Vec3 vel = uav.getVelocity();
-        double error = pos.distance(target);
-        
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "T:" << std::setw(5) << simulation_time << "s | ";
-        std::cout << "WP:" << path_manager.getCurrentIndex() + 1 
-                  << "/" << path_manager.getWaypointCount() << " | ";
-        std::cout << "Pos:(" << std::setw(5) << pos.x << "," 
-                  << std::setw(5) << pos.y << "," 
-                  << std::setw(5) << pos.z << ") | ";
-        std::cout << "Tgt:(" << std::setw(5) << target.x << "," 
-                  << std::setw(5) << target.y << "," 
-                  << std::setw(5) << target.z << ") | ";
-        std::cout << "Err:" << std::setw(5) << error << "m | ";
-        std::cout << "Vel:" << std::setw(5) << vel.magnitude() << "m/s | ";
-        std::cout << "F:(" << std::setw(5) << control_force.x << ","
-                  << std::setw(5) << control_force.y << ","
-                  << std::setw(5) << control_force.z << ")\n";
-    }
-};
-
-int main() {
-    std::cout << "UAV PID Path Control System\n";
-    std::cout << "===========================\n\n";
-    
-    // Test 1: Simple path with cascade control
-    std::cout << "Test 1: Simple Path with Cascade PID Control\n";
-    std::cout << "---------------------------------------------\n";
-    Simulation sim1(0.01, true, true);
-    sim1.setupSimplePath();
-    sim1.run(30.0);
-    
-    std::cout << "\n\n";
-    
-    // Test 2: Complex path with simple PD control
-    std::cout << "Test 2: Complex Path with Simple PD+FeedForward Control\n";
-    std::cout << "-------------------------------------------------------\n";
-    Simulation sim2(0.01, true, false);
-    sim2.setupPath();
-    sim2.run(40.0);
-    
-    std::cout << "\n=== Control System Notes ===\n";
-    std::cout << "1. Cascade Control: Uses position->velocity->force cascade for smooth control\n";
-    std::cout << "2. Simple PD+FF: Uses proportional-derivative with gravity feedforward\n";
-    std::cout << "3. Gravity compensation is applied to maintain altitude\n";
-    std::cout << "4. Force limits are applied per-axis for realistic behavior\n";
-    std::cout << "5. Waypoint tolerance adapts based on altitude\n";
-    
-    return 0;
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 3D Vector class for position, velocity, and forces
+class Vec3 {
+public:
+    double x, y, z;
+    
+    Vec3(double x = 0, double y = 0, double z = 0) : x(x), y(y), z(z) {}
+    
+    Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
+    Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
+    Vec3 operator*(double s) const { return Vec3(x * s, y * s, z * s); }
+    Vec3 operator/(double s) const { return Vec3(x / s, y / s, z / s); }
+    Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+    
+    double magnitude() const { return sqrt(x*x + y*y + z*z); }
+    double distance(const Vec3& v) const { return (*this - v).magnitude(); }
+    Vec3 normalized() const { 
+        double mag = magnitude();
+        if (mag > 0) return *this / mag;
+        return Vec3(0, 0, 0);
+    }
+};
+
+// PID Controller class with improved control
+class PIDController {
+private:
+    double kp, ki, kd;
+    double integral;
+    double prev_error;
+    double integral_limit;
+    double output_limit;
+    
+public:
+    PIDController(double kp = 1.0, double ki = 0.0, double kd = 0.0, 
+                  double integral_limit = 100.0, double output_limit = 50.0) 
+        : kp(kp), ki(ki), kd(kd), integral(0), prev_error(0), 
+          integral_limit(integral_limit), output_limit(output_limit) {}
+    
+    double calculate(double error, double dt) {
+        // Proportional term
+        double p_term = kp * error;
+        
+        // Integral term with anti-windup
+        integral += error * dt;
+        if (integral > integral_limit) integral = integral_limit;
+        if (integral < -integral_limit) integral = -integral_limit;
+        double i_term = ki * integral;
+        
+        // Derivative term (with filter for noise reduction)
+        double derivative = 0;
+        if (dt > 0) {
+            derivative = (error - prev_error) / dt;
+        }
+        double d_term = kd * derivative;
+        
+        prev_error = error;
+        
+        // Calculate total output
+        double output = p_term + i_term + d_term;
+        
+        // Limit output
+        if (output > output_limit) output = output_limit;
+        if (output < -output_limit) output = -output_limit;
+        
+        return output;
+    }
+    
+    void reset() {
+        integral = 0;
+        prev_error = 0;
+    }
+    
+    void setGains(double p, double i, double d) {
+        kp = p;
+        ki = i;
+        kd = d;
+    }
+    
+    double getIntegral() const { return integral; }
+};
+
+// UAV class with improved physics and control
+class UAV {
+private:
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 acceleration;
+    double mass;
+    double max_force_per_axis;  // Maximum force per axis
+    double drag_coefficient;
+    double gravity_compensation;
+    
+    // PID controllers for each axis
+    PIDController pid_x;
+    PIDController pid_y;
+    PIDController pid_z;
+    
+    // Velocity controller (cascade control)
+    PIDController pid_vx;
+    PIDController pid_vy;
+    PIDController pid_vz;
+    
+public:
+    UAV(Vec3 initial_pos = Vec3(0, 0, 0), double mass = 1.0, double max_force = 30.0) 
+        : position(initial_pos), velocity(0, 0, 0), acceleration(0, 0, 0),
+          mass(mass), max_force_per_axis(max_force), drag_coefficient(0.05) {
+        
+        // Position PID controllers - generates desired velocity
+        pid_x.setGains(4.0, 0.2, 2.0);   // P, I, D gains for X position
+        pid_y.setGains(4.0, 0.2, 2.0);   // P, I, D gains for Y position
+        pid_z.setGains(5.0, 0.3, 2.5);   // Higher gains for Z (altitude)
+        
+        // Velocity PID controllers - generates force commands
+        pid_vx.setGains(3.0, 0.1, 0.5);  // X velocity control
+        pid_vy.setGains(3.0, 0.1, 0.5);  // Y velocity control
+        pid_vz.setGains(4.0, 0.2, 0.8);  // Z velocity control
+        
+        // Calculate gravity compensation
+        gravity_compensation = 9.81 * mass;
+    }
+    
+    // Calculate control forces using cascade PID (position -> velocity -> force).
+    // ff_velocity / ff_accel are the trajectory's feed-forward terms (zero for
+    // a fixed waypoint).
+    Vec3 calculateControlForces(const Vec3& target, double dt,
+                                const Vec3& ff_velocity = Vec3(),
+                                const Vec3& ff_accel = Vec3()) {
+        // Position error
+        Vec3 pos_error = target - position;
+        
+        // Calculate desired velocity from position error (outer loop)
+        double desired_vx = pid_x.calculate(pos_error.x, dt) + ff_velocity.x;
+        double desired_vy = pid_y.calculate(pos_error.y, dt) + ff_velocity.y;
+        double desired_vz = pid_z.calculate(pos_error.z, dt) + ff_velocity.z;
+        
+        // Limit desired velocity to reasonable values
+        double max_velocity = 10.0;
+        desired_vx = std::max(-max_velocity, std::min(max_velocity, desired_vx));
+        desired_vy = std::max(-max_velocity, std::min(max_velocity, desired_vy));
+        desired_vz = std::max(-max_velocity, std::min(max_velocity, desired_vz));
+        
+        // Velocity error
+        double vel_error_x = desired_vx - velocity.x;
+        double vel_error_y = desired_vy - velocity.y;
+        double vel_error_z = desired_vz - velocity.z;
+        
+        // Calculate force from velocity error (inner loop)
+        double force_x = pid_vx.calculate(vel_error_x, dt);
+        double force_y = pid_vy.calculate(vel_error_y, dt);
+        double force_z = pid_vz.calculate(vel_error_z, dt);
+        
+        // Add gravity compensation and the trajectory's acceleration (feed-forward terms)
+        force_x += mass * ff_accel.x;
+        force_y += mass * ff_accel.y;
+        force_z += mass * ff_accel.z + gravity_compensation;
+        
+        // Apply per-axis force limits
+        force_x = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_x));
+        force_y = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_y));
+        force_z = std::max(-max_force_per_axis, std::min(max_force_per_axis, force_z));
+        
+        return Vec3(force_x, force_y, force_z);
+    }
+    
+    // Alternative: Simple P-D controller with feed-forward for better stability
+    Vec3 calculateSimpleControlForces(const Vec3& target, double dt,
+                                      const Vec3& ff_velocity = Vec3(),
+                                      const Vec3& ff_accel = Vec3()) {
+        Vec3 pos_error = target - position;
+        Vec3 vel_error = ff_velocity - velocity;
+        
+        // Position control with velocity damping
+        double kp_pos = 5.0;
+        double kd_vel = 3.0;
+        
+        Vec3 force;
+        force.x = kp_pos * pos_error.x + kd_vel * vel_error.x + mass * ff_accel.x;
+        force.y = kp_pos * pos_error.y + kd_vel * vel_error.y + mass * ff_accel.y;
+        force.z = kp_pos * pos_error.z + kd_vel * vel_error.z + mass * ff_accel.z
+                  + gravity_compensation;
+        
+        // Apply force limits
+        force.x = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.x));
+        force.y = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.y));
+        force.z = std::max(-max_force_per_axis, std::min(max_force_per_axis, force.z));
+        
+        return force;
+    }
+    
+    // Update UAV physics
+    void update(const Vec3& control_force, double dt) {
+        // Calculate drag force (proportional to velocity squared for more realism)
+        Vec3 drag;
+        drag.x = -drag_coefficient * velocity.x * std::abs(velocity.x);
+        drag.y = -drag_coefficient * velocity.y * std::abs(velocity.y);
+        drag.z = -drag_coefficient * velocity.z * std::abs(velocity.z);
+        
+        // Gravity acts only on Z axis
+        Vec3 gravity(0, 0, -9.81 * mass);
+        
+        // Total force
+        Vec3 total_force = control_force + drag + gravity;
+        
+        // Newton's second law: F = ma
+        acceleration = total_force / mass;
+        
+        // Update velocity and position using Euler integration
+        velocity = velocity + acceleration * dt;
+        position = position + velocity * dt;
+        
+        // Optional: Add ground constraint
+        if (position.z < 0) {
+            position.z = 0;
+            if (velocity.z < 0) velocity.z = 0;
+        }
+    }
+    
+    // Getters
+    Vec3 getPosition() const { return position; }
+    Vec3 getVelocity() const { return velocity; }
+    Vec3 getAcceleration() const { return acceleration; }
+    
+    // Reset all controllers
+    void resetControllers() {
+        pid_x.reset();
+        pid_y.reset();
+        pid_z.reset();
+        pid_vx.reset();
+        pid_vy.reset();
+        pid_vz.reset();
+    }
+    
+    // Set position (for testing)
+    void setPosition(const Vec3& pos) {
+        position = pos;
+        velocity = Vec3(0, 0, 0);
+        acceleration = Vec3(0, 0, 0);
+        resetControllers();
+    }
+};
+
+// One setpoint of a trajectory
+struct TrajectorySample {
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 acceleration;
+};
+
+// Minimum-snap trajectory through a list of waypoints.
+// Each segment is a 7th-order polynomial per axis in local time s in [0, 1].
+// With the segment times fixed, the snap-minimising spline passes every
+// waypoint, starts and ends at rest (zero velocity, acceleration and jerk)
+// and is continuous up to the 6th derivative at interior waypoints. That is
+// 8 linear conditions per segment, so the coefficients come from one square
+// solve, shared by the three axes. A fully smooth spline swings wide at
+// sharp corners (metres on a 90 degree turn), so waypoints where the path
+// turns more than stop_angle are rest points instead. Coefficients of the position, velocity
+// and acceleration polynomials are kept, so a sample is three Horner loops.
+class MinSnapTrajectory {
+private:
+    static const int kCoeffs = 8;
+
+    struct Segment {
+        double start_time;
+        double duration;
+        double pos[3][8];   // per axis, in s
+        double vel[3][7];   // already divided by duration
+        double acc[3][6];   // already divided by duration^2
+    };
+
+    std::vector<Segment> segments;
+    mutable size_t cursor;   // segment of the last sample (time mostly moves forward)
+
+    static double horner(const double* c, int n, double s) {
+        double r = c[n - 1];
+        for (int k = n - 2; k >= 0; --k) r = r * s + c[k];
+        return r;
+    }
+
+    // k! / (k - r)!, the r-th derivative factor of s^k
+    static double falling(int k, int r) {
+        double f = 1.0;
+        for (int i = 0; i < r; ++i) f *= (k - i);
+        return f;
+    }
+
+    // Gaussian elimination with partial pivoting on the n x n row-major system,
+    // for three right-hand sides at once. Returns false if singular.
+    static bool solve(std::vector<double>& a, std::vector<double> (&b)[3], int n) {
+        for (int col = 0; col < n; ++col) {
+            int pivot = col;
+            for (int r = col + 1; r < n; ++r) {
+                if (std::abs(a[r * n + col]) > std::abs(a[pivot * n + col])) pivot = r;
+            }
+            if (std::abs(a[pivot * n + col]) < 1e-12) return false;
+            if (pivot != col) {
+                for (int c = 0; c < n; ++c) std::swap(a[col * n + c], a[pivot * n + c]);
+                for (auto& rhs : b) std::swap(rhs[col], rhs[pivot]);
+            }
+            for (int r = col + 1; r < n; ++r) {
+                double f = a[r * n + col] / a[col * n + col];
+                if (f == 0.0) continue;
+                for (int c = col; c < n; ++c) a[r * n + c] -= f * a[col * n + c];
+                for (auto& rhs : b) rhs[r] -= f * rhs[col];
+            }
+        }
+        for (int r = n - 1; r >= 0; --r) {
+            for (auto& rhs : b) {
+                double v = rhs[r];
+                for (int c = r + 1; c < n; ++c) v -= a[r * n + c] * rhs[c];
+                rhs[r] = v / a[r * n + r];
+            }
+        }
+        return true;
+    }
+
+public:
+    MinSnapTrajectory() : cursor(0) {}
+
+    // points[0] is the start; each segment's duration is its length over
+    // average_speed (at least min_duration). stop_angle is in radians.
+    // Returns false if fewer than two points.
+    bool generate(const std::vector<Vec3>& points, double average_speed,
+                  double stop_angle = 0.785, double min_duration = 1.0) {
+        segments.clear();
+        cursor = 0;
+        if (points.size() < 2) return false;
+
+        const int m = static_cast<int>(points.size()) - 1;
+        const int n = kCoeffs * m;
+        std::vector<double> times(m);
+        for (int j = 0; j < m; ++j) {
+            times[j] = std::max(min_duration, points[j].distance(points[j + 1]) / average_speed);
+        }
+
+        std::vector<double> a(static_cast<size_t>(n) * n, 0.0);
+        std::vector<double> b[3];
+        for (auto& rhs : b) rhs.assign(n, 0.0);
+        int row = 0;
+        auto set_rhs = [&](const Vec3& p) { b[0][row] = p.x; b[1][row] = p.y; b[2][row] = p.z; };
+
+        for (int j = 0; j < m; ++j) {
+            const int c0 = kCoeffs * j;
+            // Passes through both ends of the segment
+            a[row * n + c0] = 1.0;
+            set_rhs(points[j]);
+            ++row;
+            for (int k = 0; k < kCoeffs; ++k) a[row * n + c0 + k] = 1.0;
+            set_rhs(points[j + 1]);
+            ++row;
+        }
+        // At rest at both ends: velocity, acceleration and jerk are zero
+        for (int r = 1; r <= 3; ++r) {
+            a[row * n + r] = falling(r, r);
+            ++row;
+            const int c0 = kCoeffs * (m - 1);
+            for (int k = r; k < kCoeffs; ++k) a[row * n + c0 + k] = falling(k, r);
+            ++row;
+        }
+        // Derivatives 1..6 match at interior waypoints. In real time the
+        // r-th derivative is divided by duration^r; both sides are scaled
+        // by the next segment's duration^r to keep the rows well conditioned.
+        for (int j = 1; j < m; ++j) {
+            const int prev = kCoeffs * (j - 1), next = kCoeffs * j;
+            Vec3 in = (points[j] - points[j - 1]).normalized();
+            Vec3 out = (points[j + 1] - points[j]).normalized();
+            double cos_turn = in.x * out.x + in.y * out.y + in.z * out.z;
+            if (cos_turn < std::cos(stop_angle)) {
+                // Sharp corner: both segments at rest here
+                for (int r = 1; r <= 3; ++r) {
+                    for (int k = r; k < kCoeffs; ++k) a[row * n + prev + k] = falling(k, r);
+                    ++row;
+                    a[row * n + next + r] = falling(r, r);
+                    ++row;
+                }
+                continue;
+            }
+            const double ratio = times[j] / times[j - 1];
+            for (int r = 1; r <= 6; ++r) {
+                const double scale = std::pow(ratio, r);
+                for (int k = r; k < kCoeffs; ++k) a[row * n + prev + k] = falling(k, r) * scale;
+                a[row * n + next + r] = -falling(r, r);
+                ++row;
+            }
+        }
+
+        if (!solve(a, b, n)) return false;
+
+        double t = 0.0;
+        segments.resize(m);
+        for (int j = 0; j < m; ++j) {
+            Segment& seg = segments[j];
+            seg.start_time = t;
+            seg.duration = times[j];
+            for (int axis = 0; axis < 3; ++axis) {
+                for (int k = 0; k < kCoeffs; ++k) seg.pos[axis][k] = b[axis][kCoeffs * j + k];
+                for (int k = 0; k < 7; ++k) seg.vel[axis][k] = (k + 1) * seg.pos[axis][k + 1] / times[j];
+                for (int k = 0; k < 6; ++k) seg.acc[axis][k] = (k + 1) * seg.vel[axis][k + 1] / times[j];
+            }
+            t += times[j];
+        }
+        return true;
+    }
+
+    bool empty() const { return segments.empty(); }
+    size_t getSegmentCount() const { return segments.size(); }
+    double getDuration() const {
+        return segments.empty() ? 0.0 : segments.back().start_time + segments.back().duration;
+    }
+
+    // Setpoint at time t (clamped to the trajectory's ends)
+    TrajectorySample sample(double t) const {
+        TrajectorySample out;
+        if (segments.empty()) return out;
+
+        if (cursor >= segments.size() || t < segments[cursor].start_time) cursor = 0;
+        while (cursor + 1 < segments.size() && t >= segments[cursor + 1].start_time) ++cursor;
+
+        const Segment& seg = segments[cursor];
+        double s = (t - seg.start_time) / seg.duration;
+        s = std::max(0.0, std::min(1.0, s));
+
+        double p[3], v[3], a[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            p[axis] = horner(seg.pos[axis], 8, s);
+            v[axis] = horner(seg.vel[axis], 7, s);
+            a[axis] = horner(seg.acc[axis], 6, s);
+        }
+        out.position = Vec3(p[0], p[1], p[2]);
+        // Hold still once the last waypoint is reached
+        if (t < getDuration()) {
+            out.velocity = Vec3(v[0], v[1], v[2]);
+            out.acceleration = Vec3(a[0], a[1], a[2]);
+        }
+        return out;
+    }
+};
+
+// Where a PathManager's waypoints come from. Sources are read-only once
+// built, so one source can back any number of drones; each drone keeps
+// only an index and a small look-ahead window.
+class WaypointSource {
+public:
+    virtual ~WaypointSource() {}
+    
+    virtual size_t size() const = 0;
+    
+    // Copy up to `max` waypoints starting at `first` into `out`;
+    // returns how many were copied (0 past the end)
+    virtual size_t read(size_t first, Vec3* out, size_t max) const = 0;
+};
+
+// Waypoints held in memory (what addWaypoint/addWaypoints build)
+class VectorWaypoints : public WaypointSource {
+private:
+    std::vector<Vec3> points;
+    
+public:
+    void add(const Vec3& p) { points.push_back(p); }
+    void add(const std::vector<Vec3>& p) { points.insert(points.end(), p.begin(), p.end()); }
+    
+    size_t size() const override { return points.size(); }
+    size_t read(size_t first, Vec3* out, size_t max) const override {
+        if (first >= points.size()) return 0;
+        size_t n = std::min(max, points.size() - first);
+        std::copy(points.begin() + first, points.begin() + first + n, out);
+        return n;
+    }
+};
+
+// Lawnmower survey over a rectangle, generated on demand: row after row
+// `spacing` apart, one waypoint every `spacing` along each row. A survey
+// of any size costs the same few bytes.
+class SurveyWaypoints : public WaypointSource {
+private:
+    Vec3 origin;
+    size_t per_row;
+    size_t rows;
+    double spacing;
+    
+public:
+    SurveyWaypoints(const Vec3& origin, double width, double depth, double spacing)
+        : origin(origin), spacing(spacing) {
+        per_row = static_cast<size_t>(width / spacing) + 1;
+        rows = static_cast<size_t>(depth / spacing) + 1;
+    }
+    
+    size_t size() const override { return per_row * rows; }
+    size_t read(size_t first, Vec3* out, size_t max) const override {
+        size_t n = 0;
+        for (size_t i = first; i < size() && n < max; ++i, ++n) {
+            size_t row = i / per_row, col = i % per_row;
+            if (row % 2 == 1) col = per_row - 1 - col;   // back along odd rows
+            out[n] = origin + Vec3(col * spacing, row * spacing, 0);
+        }
+        return n;
+    }
+};
+
+// Binary waypoint file: the magic "WPT1", a little-endian uint64 count,
+// then x, y, z as little-endian doubles per waypoint.
+// The file is memory-mapped, so pages are only read as drones get to
+// them and every drone flying the same mission shares them. On Windows
+// it is read into memory once instead, so concurrent readers share no
+// file position.
+class MappedWaypointFile : public WaypointSource {
+private:
+    static const size_t kHeader = 16;
+    
+    const unsigned char* data;
+    size_t bytes;
+    size_t count;
+#ifdef _WIN32
+    std::vector<unsigned char> contents;
+#endif
+    
+public:
+    explicit MappedWaypointFile(const std::string& path)
+        : data(nullptr), bytes(0), count(0) {
+#ifdef _WIN32
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return;
+        unsigned char chunk[1 << 16];
+        size_t got;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+            contents.insert(contents.end(), chunk, chunk + got);
+        std::fclose(f);
+        if (contents.size() >= kHeader) {
+            data = contents.data();
+            bytes = contents.size();
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= kHeader) {
+            void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const unsigned char*>(p);
+                bytes = st.st_size;
+                ::madvise(p, bytes, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+        // Never trust the count past the waypoints actually in the file
+        if (!data || std::memcmp(data, "WPT1", 4) != 0) return;
+        uint64_t n;
+        std::memcpy(&n, data + 8, 8);
+        count = static_cast<size_t>(std::min<uint64_t>(n, (bytes - kHeader) / 24));
+    }
+    
+    ~MappedWaypointFile() override {
+#ifndef _WIN32
+        if (data) ::munmap(const_cast<unsigned char*>(data), bytes);
+#endif
+    }
+    
+    MappedWaypointFile(const MappedWaypointFile&) = delete;
+    MappedWaypointFile& operator=(const MappedWaypointFile&) = delete;
+    
+    bool isOpen() const { return count > 0; }
+    size_t size() const override { return count; }
+    
+    size_t read(size_t first, Vec3* out, size_t max) const override {
+        if (first >= count) return 0;
+        size_t n = std::min(max, count - first);
+        const unsigned char* p = data + kHeader + first * 24;
+        for (size_t i = 0; i < n; ++i, p += 24) {
+            double xyz[3];
+            std::memcpy(xyz, p, 24);
+            out[i] = Vec3(xyz[0], xyz[1], xyz[2]);
+        }
+        return n;
+    }
+    
+    // Write any source out in this format, a chunk at a time
+    static bool write(const std::string& path, const WaypointSource& source) {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        unsigned char header[kHeader] = { 'W', 'P', 'T', '1' };
+        uint64_t n = source.size();
+        std::memcpy(header + 8, &n, 8);
+        bool ok = std::fwrite(header, 1, kHeader, f) == kHeader;
+        
+        Vec3 chunk[1024];
+        double xyz[3 * 1024];
+        for (size_t first = 0; ok && first < n; first += 1024) {
+            size_t got = source.read(first, chunk, 1024);
+            for (size_t i = 0; i < got; ++i) {
+                xyz[3 * i] = chunk[i].x;
+                xyz[3 * i + 1] = chunk[i].y;
+                xyz[3 * i + 2] = chunk[i].z;
+            }
+            ok = std::fwrite(xyz, 8, 3 * got, f) == 3 * got;
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+};
+
+// Path manager for waypoint navigation
+class PathManager {
+public:
+    static const size_t kLookAhead = 16;   // waypoints buffered per drone
+    
+private:
+    std::shared_ptr<const WaypointSource> source;
+    std::shared_ptr<VectorWaypoints> owned;   // backs addWaypoint(s)
+    size_t current_waypoint_index;
+    double waypoint_tolerance;
+    double approach_speed_factor;
+    
+    // Look-ahead window: waypoints [window_first, window_first + window_count)
+    Vec3 window[kLookAhead];
+    size_t window_first;
+    size_t window_count;
+    
+    // Re-read the window from the current waypoint once half of it is used
+    void refill() {
+        window_first = current_waypoint_index;
+        window_count = source ? source->read(window_first, window, kLookAhead) : 0;
+    }
+    void advanceWindow() {
+        size_t used = current_waypoint_index - window_first;
+        bool more = window_count == kLookAhead;
+        if (current_waypoint_index < window_first || used >= window_count
+            || (more && used >= kLookAhead / 2)) {
+            refill();
+        }
+    }
+    const Vec3& current() const { return window[current_waypoint_index - window_first]; }
+    
+public:
+    PathManager(double tolerance = 1.0) 
+        : current_waypoint_index(0), waypoint_tolerance(tolerance),
+          approach_speed_factor(1.0), window_first(0), window_count(0) {}
+    
+    // Fly waypoints from a shared source (file, generator, ...) from the start
+    void setSource(std::shared_ptr<const WaypointSource> s) {
+        source = std::move(s);
+        owned.reset();
+        current_waypoint_index = 0;
+        refill();
+    }
+    
+    void addWaypoint(const Vec3& point) {
+        addWaypoints({ point });
+    }
+    
+    void addWaypoints(const std::vector<Vec3>& points) {
+        if (!owned) {
+            owned = std::make_shared<VectorWaypoints>();
+            source = owned;
+        }
+        owned->add(points);
+        refill();
+    }
+    
+    Vec3 getCurrentTarget() const {
+        if (window_count == 0) return Vec3(0, 0, 0);
+        return current();
+    }
+    
+    bool updateTarget(const Vec3& current_position) {
+        if (window_count == 0) return false;
+        
+        // Check if UAV reached current waypoint
+        double distance = current_position.distance(current());
+        
+        // Dynamic tolerance based on altitude (more lenient at higher altitudes)
+        double dynamic_tolerance = waypoint_tolerance;
+        if (current().z > 5) {
+            dynamic_tolerance = waypoint_tolerance * 1.5;
+        }
+        
+        if (distance < dynamic_tolerance) {
+            std::cout << "Reached waypoint " << current_waypoint_index + 1 
+                     << " (distance: " << distance << ")\n";
+            current_waypoint_index++;
+            if (current_waypoint_index >= source->size()) {
+                current_waypoint_index = 0;  // Loop back to start
+                refill();
+                return true;  // Path completed
+            }
+            advanceWindow();
+        }
+        return false;
+    }
+    
+    // Smooth trajectory from `start` through the buffered waypoints (the
+    // whole path when it fits in the look-ahead window), instead of
+    // jumping the target from one waypoint to the next
+    MinSnapTrajectory buildTrajectory(const Vec3& start, double average_speed) const {
+        std::vector<Vec3> points;
+        points.reserve(kLookAhead + 1);
+        points.push_back(start);
+        for (size_t i = current_waypoint_index - window_first; i < window_count; ++i) {
+            points.push_back(window[i]);
+        }
+        MinSnapTrajectory trajectory;
+        trajectory.generate(points, average_speed);
+        return trajectory;
+    }
+    
+    bool hasWaypoints() const { return window_count > 0; }
+    size_t getCurrentIndex() const { return current_waypoint_index; }
+    size_t getWaypointCount() const { return source ? source->size() : 0; }
+    void reset() {
+        current_waypoint_index = 0;
+        refill();
+    }
+};
+
+// Simulation class
+class Simulation {
+private:
+    UAV uav;
+    PathManager path_manager;
+    double simulation_time;
+    double dt;
+    bool verbose;
+    bool use_cascade_control;
+    bool use_trajectory;
+    double trajectory_speed;
+    MinSnapTrajectory trajectory;
+    
+public:
+    Simulation(double timestep = 0.01, bool verbose = true, bool cascade = true) 
+        : uav(Vec3(0, 0, 0)), simulation_time(0), dt(timestep), 
+          verbose(verbose), use_cascade_control(cascade),
+          use_trajectory(false), trajectory_speed(2.0) {}
+    
+    // Follow a minimum-snap trajectory through the waypoints instead of
+    // stepping the target (average_speed sets the segment times)
+    void useTrajectory(double average_speed) {
+        use_trajectory = true;
+        trajectory_speed = average_speed;
+    }
+    
+    void setupPath() {
+        // Create a 3D path with multiple waypoints
+        path_manager.addWaypoints({
+            Vec3(0, 0, 5),      // Take off
+            Vec3(10, 0, 5),     // Move forward
+            Vec3(10, 10, 5),    // Move right
+            Vec3(10, 10, 10),   // Climb
+            Vec3(0, 10, 10),    // Move back
+            Vec3(0, 0, 10),     // Complete square at altitude
+            Vec3(0, 0, 0)       // Land
+        });
+    }
+    
+    // Waypoints streamed from a shared source instead of a list
+    void setupSource(std::shared_ptr<const WaypointSource> source) {
+        path_manager.setSource(std::move(source));
+    }
+    
+    void setupSimplePath() {
+        // Simpler path for testing
+        path_manager.addWaypoints({
+            Vec3(0, 0, 2),      // Small takeoff
+            Vec3(5, 0, 2),      // Move forward
+            Vec3(5, 5, 2),      // Move right
+            Vec3(0, 5, 2),      // Move back
+            Vec3(0, 0, 2),      // Return to start
+            Vec3(0, 0, 0)       // Land
+        });
+    }
+    
+    void run(double duration) {
+        std::cout << "\n=== UAV PID Path Control Simulation ===\n";
+        std::cout << "Control mode: " << (use_cascade_control ? "Cascade PID" : "Simple PD+FF") << "\n";
+        if (use_trajectory) {
+            trajectory = path_manager.buildTrajectory(uav.getPosition(), trajectory_speed);
+            std::cout << "Setpoints: minimum-snap trajectory, " << trajectory.getSegmentCount()
+                      << " segments, " << trajectory.getDuration() << " s\n";
+        }
+        std::cout << "Simulation duration: " << duration << " seconds\n";
+        std::cout << "Time step: " << dt << " seconds\n\n";
+        
+        int display_counter = 0;
+        int display_interval = 50;  // Display every 50 iterations (0.5 seconds)
+        
+        double min_error = 999999;
+        double max_error = 0;
+        double total_error = 0;
+        int error_samples = 0;
+        double sample_ns = 0;
+        
+        while (simulation_time < duration && path_manager.hasWaypoints()) {
+            // Get current target waypoint, or the trajectory's setpoint
+            Vec3 target = path_manager.getCurrentTarget();
+            TrajectorySample setpoint;
+            if (use_trajectory && !trajectory.empty()) {
+                auto t0 = std::chrono::steady_clock::now();
+                setpoint = trajectory.sample(simulation_time);
+                auto t1 = std::chrono::steady_clock::now();
+                sample_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                target = setpoint.position;
+            }
+            
+            // Calculate control forces
+            Vec3 control_force;
+            if (use_cascade_control) {
+                control_force = uav.calculateControlForces(target, dt, setpoint.velocity,
+                                                           setpoint.acceleration);
+            } else {
+                control_force = uav.calculateSimpleControlForces(target, dt, setpoint.velocity,
+                                                                 setpoint.acceleration);
+            }
+            
+            // Update UAV physics
+            uav.update(control_force, dt);
+            
+            // Track error statistics
+            double error = uav.getPosition().distance(target);
+            min_error = std::min(min_error, error);
+            max_error = std::max(max_error, error);
+            total_error += error;
+            error_samples++;
+            
+            // Check if waypoint reached and update target (the trajectory
+            // already runs through every waypoint on its own clock)
+            if (!use_trajectory && path_manager.updateTarget(uav.getPosition())) {
+                uav.resetControllers();  // Reset PID controllers for new waypoint
+                if (verbose) {
+                    std::cout << "\n>>> Path completed! Restarting...\n\n";
+                    path_manager.reset();
+                }
+            }
+            
+            // Display status periodically
+            if (verbose && display_counter % display_interval == 0) {
+                displayStatus(target, control_force);
+            }
+            
+            simulation_time += dt;
+            display_counter++;
+        }
+        
+        std::cout << "\n=== Simulation Statistics ===\n";
+        std::cout << "Minimum error: " << std::fixed << std::setprecision(3) << min_error << " m\n";
+        std::cout << "Maximum error: " << std::fixed << std::setprecision(3) << max_error << " m\n";
+        std::cout << "Average error: " << std::fixed << std::setprecision(3) 
+                  << (total_error / error_samples) << " m\n";
+        std::cout << "Final position: (" << uav.getPosition().x << ", " 
+                  << uav.getPosition().y << ", " << uav.getPosition().z << ")\n";
+        if (use_trajectory && !trajectory.empty()) {
+            // Error above is tracking error against the moving setpoint.
+            // Evaluation cost: timed in the loop, and in a tight loop
+            // without the clock overhead.
+            const int bench_samples = 1000000;
+            const double span = trajectory.getDuration();
+            double checksum = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < bench_samples; ++i) {
+                checksum += trajectory.sample(span * i / bench_samples).position.z;
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            double tight_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / bench_samples;
+            std::cout << "Setpoint evaluation: " << std::setprecision(1)
+                      << sample_ns / error_samples << " ns/sample in the loop, "
+                      << tight_ns << " ns/sample tight (checksum " << std::setprecision(3)
+                      << checksum / bench_samples << ")\n";
+        }
+    }
+    
+    void displayStatus(const Vec3& target, const Vec3& control_force) {
+        Vec3 pos = uav.getPosition();
+        Vec3 vel = uav.getVelocity();
+        double error = pos.distance(target);
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "T:" << std::setw(5) << simulation_time << "s | ";
+        std::cout << "WP:" << path_manager.getCurrentIndex() + 1 
+                  << "/" << path_manager.getWaypointCount() << " | ";
+        std::cout << "Pos:(" << std::setw(5) << pos.x << "," 
+                  << std::setw(5) << pos.y << "," 
+                  << std::setw(5) << pos.z << ") | ";
+        std::cout << "Tgt:(" << std::setw(5) << target.x << "," 
+                  << std::setw(5) << target.y << "," 
+                  << std::setw(5) << target.z << ") | ";
+        std::cout << "Err:" << std::setw(5) << error << "m | ";
+        std::cout << "Vel:" << std::setw(5) << vel.magnitude() << "m/s | ";
+        std::cout << "F:(" << std::setw(5) << control_force.x << ","
+                  << std::setw(5) << control_force.y << ","
+                  << std::setw(5) << control_force.z << ")\n";
+    }
+};
+
+int main() {
+    std::cout << "UAV PID Path Control System\n";
+    std::cout << "===========================\n\n";
+    
+    // Test 1: Simple path with cascade control
+    std::cout << "Test 1: Simple Path with Cascade PID Control\n";
+    std::cout << "---------------------------------------------\n";
+    Simulation sim1(0.01, true, true);
+    sim1.setupSimplePath();
+    sim1.run(30.0);
+    
+    std::cout << "\n\n";
+    
+    // Test 2: Complex path with simple PD control
+    std::cout << "Test 2: Complex Path with Simple PD+FeedForward Control\n";
+    std::cout << "-------------------------------------------------------\n";
+    Simulation sim2(0.01, true, false);
+    sim2.setupPath();
+    sim2.run(40.0);
+    
+    std::cout << "\n\n";
+    
+    // Test 3: Same path and control law as Test 2, as one minimum-snap trajectory
+    std::cout << "Test 3: Complex Path as a Minimum-Snap Trajectory with Simple PD+FeedForward\n";
+    std::cout << "----------------------------------------------------------------------------\n";
+    Simulation sim3(0.01, true, false);
+    sim3.setupPath();
+    sim3.useTrajectory(2.0);
+    sim3.run(40.0);
+    
+    std::cout << "\n\n";
+    
+    // Test 4: A million-waypoint survey streamed from a memory-mapped file
+    std::cout << "Test 4: Survey Mission Streamed from a Memory-Mapped Waypoint File\n";
+    std::cout << "------------------------------------------------------------------\n";
+    SurveyWaypoints survey(Vec3(0, 0, 5), 2000.0, 2000.0, 2.0);
+    std::string survey_path = (std::filesystem::temp_directory_path() / "survey_waypoints.bin").string();
+    if (MappedWaypointFile::write(survey_path, survey)) {
+        auto mission = std::make_shared<MappedWaypointFile>(survey_path);
+        
+        Simulation sim4(0.01, false, false);
+        sim4.setupSource(mission);
+        sim4.run(20.0);
+        
+        // A fleet flying the same mission shares the mapping; each drone
+        // holds a cursor and its look-ahead window
+        const size_t fleet_size = 1000;
+        std::vector<PathManager> fleet(fleet_size);
+        for (auto& pm : fleet) pm.setSource(mission);
+        double file_mb = (16.0 + 24.0 * mission->size()) / 1e6;
+        double list_mb = sizeof(Vec3) * mission->size() / 1e6;
+        std::cout << "Waypoints: " << mission->size() << " (" << std::setprecision(1)
+                  << file_mb << " MB file, mapped once)\n";
+        std::cout << "Per drone: " << sizeof(PathManager) << " bytes vs "
+                  << list_mb << " MB for its own list\n";
+        std::cout << "Fleet of " << fleet_size << ": " << std::setprecision(2)
+                  << sizeof(PathManager) * fleet_size / 1e6 << " MB vs "
+                  << std::setprecision(0) << list_mb * fleet_size << " MB\n";
+        std::remove(survey_path.c_str());
+    } else {
+        std::cout << "Could not write " << survey_path << "\n";
+    }
+    
+    std::cout << "\n=== Control System Notes ===\n";
+    std::cout << "1. Cascade Control: Uses position->velocity->force cascade for smooth control\n";
+    std::cout << "2. Simple PD+FF: Uses proportional-derivative with gravity feedforward\n";
+    std::cout << "3. Gravity compensation is applied to maintain altitude\n";
+    std::cout << "4. Force limits are applied per-axis for realistic behavior\n";
+    std::cout << "5. Waypoint tolerance adapts based on altitude\n";
+    std::cout << "6. Minimum-snap trajectories replace target jumps with smooth setpoints plus feed-forward\n";
+    std::cout << "7. Waypoints stream from shared sources through a small per-drone window\n";
+    
+    return 0;
 }
\ No newline at end of file
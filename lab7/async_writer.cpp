@@ -0,0 +1,590 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the asynchronous writer. The io_uring
+    backend talks to the kernel through the raw system calls (no
+    liburing), mapping the rings itself.
+*/
+
+#include "async_writer.h"
+#include "memtrack.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace sim
+{
+
+namespace
+{
+
+#ifdef _WIN32
+std::mutex g_seekMutex;   // _lseeki64 + _write share the file position
+#endif
+
+// Write all of [p, p + n) at `off`; false on error
+bool positionalWrite(int fd, const char* p, size_t n, uint64_t off)
+{
+    while (n > 0)
+    {
+#ifdef _WIN32
+        std::lock_guard<std::mutex> lock(g_seekMutex);
+        if (_lseeki64(fd, static_cast<long long>(off), SEEK_SET) < 0) return false;
+        int r = _write(fd, p, static_cast<unsigned>(std::min<size_t>(n, 1u << 30)));
+#else
+        ssize_t r = ::pwrite(fd, p, n, static_cast<off_t>(off));
+#endif
+        if (r < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += r;
+        n -= static_cast<size_t>(r);
+        off += static_cast<uint64_t>(r);
+    }
+    return true;
+}
+
+// Page-aligned staging buffer (std::aligned_alloc is missing on MSVC);
+// null if the allocation fails
+char* allocPages(size_t bytes)
+{
+#ifdef _WIN32
+    return static_cast<char*>(_aligned_malloc(bytes, 4096));
+#else
+    void* p = nullptr;
+    return ::posix_memalign(&p, 4096, bytes) == 0 ? static_cast<char*>(p) : nullptr;
+#endif
+}
+
+void freePages(char* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+// ------------------------------------------
+// Engines
+// ------------------------------------------
+// Owns the staging buffers; a buffer is either free, being filled by the
+// producer, or in flight. queue() collects a full buffer, submit() hands
+// the collected ones over, reap() returns completed buffers to `freeList`.
+// If any buffer cannot be allocated the engine holds none.
+struct AsyncWriter::Engine
+{
+    struct Slot
+    {
+        size_t   len  = 0;
+        size_t   done = 0;
+        uint64_t off  = 0;
+    };
+
+    Engine(size_t bufferSize, int count)
+    {
+        const size_t bytes = (bufferSize + 4095) / 4096 * 4096;
+        for (int i = 0; i < count; ++i)
+        {
+            char* b = allocPages(bytes);
+            if (!b)
+            {
+                for (char* q : bufs) freePages(q);
+                bufs.clear();
+                return;
+            }
+            bufs.push_back(b);
+        }
+        for (int i = 0; i < count; ++i) freeList.push_back(count - 1 - i);
+        slots.resize(count);
+    }
+    virtual ~Engine()
+    {
+        for (char* b : bufs) freePages(b);
+    }
+
+    virtual bool queue(int buf, size_t len, uint64_t off) = 0;
+    virtual bool submit(uint64_t& submits) = 0;
+    virtual bool reap(unsigned minDone, uint64_t& writes) = 0;
+
+    std::vector<char*> bufs;
+    std::vector<Slot>  slots;
+    std::vector<int>   freeList;
+    unsigned inFlight = 0;
+};
+
+#ifdef __linux__
+// Single-producer io_uring: one SQE per buffer write, WRITE_FIXED on the
+// registered buffers (plain WRITE if registration is refused, e.g. by
+// RLIMIT_MEMLOCK). A short write is resubmitted for the remainder.
+class UringEngine : public AsyncWriter::Engine
+{
+public:
+    UringEngine(int fileFd, size_t bufferSize, int count)
+        : Engine(bufferSize, count), fd(fileFd)
+    {
+        if (bufs.empty()) return;
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        ring = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(count), &p));
+        if (ring < 0) return;
+
+        sqBytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqBytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqBytes = cqBytes = std::max(sqBytes, cqBytes);
+
+        sqMap = ::mmap(nullptr, sqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring, IORING_OFF_SQ_RING);
+        cqMap = single ? sqMap
+                       : ::mmap(nullptr, cqBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring, IORING_OFF_CQ_RING);
+        sqeBytes = p.sq_entries * sizeof(io_uring_sqe);
+        sqeMap = ::mmap(nullptr, sqeBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring, IORING_OFF_SQES);
+        if (sqMap == MAP_FAILED || cqMap == MAP_FAILED || sqeMap == MAP_FAILED)
+        {
+            release();
+            return;
+        }
+
+        char* sq = static_cast<char*>(sqMap);
+        char* cq = static_cast<char*>(cqMap);
+        sqTail  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask  = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cqHead  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask  = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        sqes    = static_cast<io_uring_sqe*>(sqeMap);
+
+        std::vector<iovec> iov(bufs.size());
+        for (size_t i = 0; i < bufs.size(); ++i)
+        {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len  = bufferSize;
+        }
+        fixed = syscall(__NR_io_uring_register, ring, IORING_REGISTER_BUFFERS,
+                        iov.data(), static_cast<unsigned>(iov.size())) == 0;
+    }
+
+    ~UringEngine() override { release(); }
+
+    bool ok() const { return ring >= 0; }
+
+    bool queue(int buf, size_t len, uint64_t off) override
+    {
+        slots[buf] = { len, 0, off };
+        ++inFlight;
+        push(buf);
+        return true;
+    }
+
+    bool submit(uint64_t& submits) override
+    {
+        while (toSubmit > 0)
+        {
+            long r = syscall(__NR_io_uring_enter, ring, toSubmit, 0u, 0u, nullptr, 0);
+            if (r < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                return false;
+            }
+            ++submits;
+            toSubmit -= static_cast<unsigned>(r);
+        }
+        return true;
+    }
+
+    bool reap(unsigned minDone, uint64_t& writes) override
+    {
+        unsigned got = 0;
+        for (;;)
+        {
+            unsigned head = *cqHead;
+            const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            bool retry = false, failed = false;
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& c = cqes[head & cqMask];
+                const int buf = static_cast<int>(c.user_data);
+                Slot& s = slots[buf];
+                ++writes;
+                // res == 0 made no progress and would be resubmitted forever
+                if (c.res > 0) s.done += static_cast<size_t>(c.res);
+                else if (c.res != -EINTR && c.res != -EAGAIN) failed = true;
+
+                // After a failure every completed buffer goes back to the
+                // free list (nothing is resubmitted), so inFlight only
+                // counts what the kernel still holds
+                if (s.done < s.len && !failed)
+                {
+                    push(buf);   // short write: the rest of the same buffer
+                    retry = true;
+                }
+                else
+                {
+                    freeList.push_back(buf);
+                    --inFlight;
+                    ++got;
+                }
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+            if (failed) return false;
+            if (got >= minDone || inFlight == 0) return true;
+            const unsigned need = retry ? 0u : 1u;
+            long r = syscall(__NR_io_uring_enter, ring, toSubmit, need,
+                             IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (r < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+            if (r > 0) toSubmit -= static_cast<unsigned>(r);
+        }
+    }
+
+private:
+    void push(int buf)
+    {
+        const Slot& s = slots[buf];
+        const unsigned tail = *sqTail;
+        const unsigned idx  = tail & sqMask;
+        io_uring_sqe& e = sqes[idx];
+        std::memset(&e, 0, sizeof(e));
+        e.opcode    = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        e.fd        = fd;
+        e.addr      = reinterpret_cast<uint64_t>(bufs[buf] + s.done);
+        e.len       = static_cast<unsigned>(s.len - s.done);
+        e.off       = s.off + s.done;
+        e.buf_index = fixed ? static_cast<uint16_t>(buf) : 0;
+        e.user_data = static_cast<uint64_t>(buf);
+        sqArray[idx] = idx;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++toSubmit;
+    }
+
+    void release()
+    {
+        if (sqeMap && sqeMap != MAP_FAILED) ::munmap(sqeMap, sqeBytes);
+        if (cqMap && cqMap != MAP_FAILED && cqMap != sqMap) ::munmap(cqMap, cqBytes);
+        if (sqMap && sqMap != MAP_FAILED) ::munmap(sqMap, sqBytes);
+        sqMap = cqMap = sqeMap = nullptr;
+        if (ring >= 0) ::close(ring);
+        ring = -1;
+    }
+
+    int fd;
+    int ring = -1;
+    bool fixed = false;
+    unsigned toSubmit = 0;
+
+    void*  sqMap = nullptr;
+    void*  cqMap = nullptr;
+    void*  sqeMap = nullptr;
+    size_t sqBytes = 0, cqBytes = 0, sqeBytes = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned  sqMask = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned  cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    io_uring_sqe* sqes = nullptr;
+};
+#endif
+
+// A few threads doing blocking pwrite()s off a shared queue. These are
+// long-lived blocking workers, so they are separate from the fork-join
+// ThreadPool the swarm uses.
+class PWriteEngine : public AsyncWriter::Engine
+{
+public:
+    PWriteEngine(int fileFd, size_t bufferSize, int count, unsigned threads)
+        : Engine(bufferSize, count), fd(fileFd)
+    {
+        for (unsigned t = 0; t < std::max(1u, threads); ++t)
+        {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~PWriteEngine() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        cvJob.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    bool queue(int buf, size_t len, uint64_t off) override
+    {
+        slots[buf] = { len, 0, off };
+        ++inFlight;
+        batch.push_back(buf);
+        return true;
+    }
+
+    bool submit(uint64_t& submits) override
+    {
+        if (batch.empty()) return true;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.insert(jobs.end(), batch.begin(), batch.end());
+        }
+        batch.clear();
+        cvJob.notify_all();
+        ++submits;
+        return true;
+    }
+
+    bool reap(unsigned minDone, uint64_t& writes) override
+    {
+        if (minDone > 0 && !batch.empty())
+        {
+            uint64_t ignored = 0;
+            submit(ignored);
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        cvDone.wait(lock, [&] { return done.size() >= minDone || failed; });
+        for (int b : done)
+        {
+            freeList.push_back(b);
+            --inFlight;
+            ++writes;
+        }
+        done.clear();
+        return !failed;
+    }
+
+private:
+    void workerLoop()
+    {
+        for (;;)
+        {
+            int buf;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cvJob.wait(lock, [&] { return quit || !jobs.empty(); });
+                if (jobs.empty()) return;
+                buf = jobs.front();
+                jobs.pop_front();
+            }
+            const Slot& s = slots[buf];
+            bool ok = positionalWrite(fd, bufs[buf], s.len, s.off);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                done.push_back(buf);
+                failed = failed || !ok;
+            }
+            cvDone.notify_one();
+        }
+    }
+
+    int fd;
+    std::vector<int> batch;   // queued, not yet handed to the workers
+
+    std::mutex mtx;
+    std::condition_variable cvJob, cvDone;
+    std::deque<int>  jobs;
+    std::vector<int> done;
+    bool quit = false;
+    bool failed = false;
+    std::vector<std::thread> workers;
+};
+
+// ------------------------------------------
+// AsyncWriter
+// ------------------------------------------
+AsyncWriter::AsyncWriter(const WriterConfig& c) : cfg(c)
+{
+    cfg.buffers    = std::max(2, cfg.buffers);
+    cfg.batch      = std::clamp(cfg.batch, 1, cfg.buffers);
+    cfg.bufferSize = std::max<size_t>(4096, cfg.bufferSize);
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    close();
+}
+
+const char* AsyncWriter::backendName(Backend b)
+{
+    switch (b)
+    {
+        case Backend::IoUring: return "io_uring";
+        case Backend::PWrite:  return "pwrite";
+        default:               return "none";
+    }
+}
+
+bool AsyncWriter::open(const std::string& path)
+{
+    close();
+    MemScope tag(Subsystem::AssetIO);
+#ifdef _WIN32
+    fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    if (fd < 0) return false;
+
+    streamEnd = 0;
+    error = false;
+    count = Counters();
+    current = -1;
+    fill = 0;
+    unsubmitted = 0;
+
+#ifdef __linux__
+    if (cfg.useIoUring)
+    {
+        auto ring = std::make_unique<UringEngine>(fd, cfg.bufferSize, cfg.buffers);
+        if (ring->ok())
+        {
+            engine = std::move(ring);
+            kind = Backend::IoUring;
+            return true;
+        }
+    }
+#endif
+    engine = std::make_unique<PWriteEngine>(fd, cfg.bufferSize, cfg.buffers, cfg.fallbackThreads);
+    if (engine->bufs.empty())
+    {
+        // No staging memory: fail the open rather than write through nulls
+        engine.reset();
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+        return false;
+    }
+    kind = Backend::PWrite;
+    return true;
+}
+
+bool AsyncWriter::takeBuffer()
+{
+    if (engine->freeList.empty())
+    {
+        // Every buffer is in flight: hand over what is queued and wait
+        ++count.stalls;
+        unsubmitted = 0;
+        error = error || !engine->submit(count.submits)
+                      || !engine->reap(1, count.writes);
+        if (engine->freeList.empty()) return false;
+    }
+    current = engine->freeList.back();
+    engine->freeList.pop_back();
+    fill = 0;
+    return true;
+}
+
+bool AsyncWriter::queueCurrent()
+{
+    if (current < 0 || fill == 0) return true;
+    error = error || !engine->queue(current, fill, streamEnd - fill);
+    current = -1;
+    fill = 0;
+
+    // Batched: one submission per `batch` buffers, plus a cheap poll so
+    // finished buffers come back without waiting
+    if (++unsubmitted >= cfg.batch || engine->freeList.empty())
+    {
+        error = error || !engine->submit(count.submits);
+        unsubmitted = 0;
+    }
+    error = error || !engine->reap(0, count.writes);
+    return !error;
+}
+
+bool AsyncWriter::write(const void* data, size_t bytes)
+{
+    if (fd < 0 || error) return false;
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0)
+    {
+        if (current < 0 && !takeBuffer()) return false;
+        size_t n = std::min(bytes, cfg.bufferSize - fill);
+        std::memcpy(engine->bufs[current] + fill, p, n);
+        fill += n;
+        streamEnd += n;
+        p += n;
+        bytes -= n;
+        if (fill == cfg.bufferSize && !queueCurrent()) return false;
+    }
+    return true;
+}
+
+bool AsyncWriter::flush()
+{
+    if (fd < 0) return false;
+    if (current >= 0)
+    {
+        if (fill > 0) queueCurrent();
+        else
+        {
+            engine->freeList.push_back(current);
+            current = -1;
+        }
+    }
+    error = error || !engine->submit(count.submits);
+    unsubmitted = 0;
+    while (!error && engine->inFlight > 0)
+    {
+        error = !engine->reap(1, count.writes);
+    }
+    return !error;
+}
+
+bool AsyncWriter::writeAt(uint64_t offset, const void* data, size_t bytes)
+{
+    if (!flush()) return false;
+    error = !positionalWrite(fd, static_cast<const char*>(data), bytes, offset);
+    return !error;
+}
+
+bool AsyncWriter::close()
+{
+    if (fd < 0) return !error;
+    flush();
+    engine.reset();
+#ifdef _WIN32
+    error = _close(fd) != 0 || error;
+#else
+    error = ::close(fd) != 0 || error;
+#endif
+    fd = -1;
+    kind = Backend::None;
+    return !error;
+}
+
+} // namespace sim
@@ -0,0 +1,95 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Shared asynchronous file writer for simulation output: io_uring with
+    registered buffers and batched submissions where the kernel has it,
+    a few pwrite worker threads otherwise.
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace sim {
+
+struct WriterConfig
+{
+    size_t   bufferSize      = size_t(1) << 20;  // bytes per staging buffer
+    int      buffers         = 8;     // staging buffers (registered with io_uring)
+    int      batch           = 4;     // full buffers queued per submission
+    unsigned fallbackThreads = 2;     // pwrite workers when io_uring is unavailable
+    bool     useIoUring      = true;  // false forces the pwrite fallback
+};
+
+// Append-only stream into one file. write() copies into a staging
+// buffer; full buffers are written in the background, each at its own
+// offset, while the caller keeps filling the next one. The caller only
+// blocks when every buffer is in flight. Not thread-safe: one producer.
+class AsyncWriter
+{
+public:
+    enum class Backend
+    {
+        None,
+        IoUring,
+        PWrite
+    };
+
+    explicit AsyncWriter(const WriterConfig& cfg = WriterConfig());
+    ~AsyncWriter();
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    // Create / truncate the file
+    bool open(const std::string& path);
+    bool isOpen() const { return fd >= 0; }
+    Backend backend() const { return kind; }
+    static const char* backendName(Backend b);
+
+    // Append at the end of the stream
+    bool write(const void* data, size_t bytes);
+
+    // Write everything appended so far and wait for it
+    bool flush();
+
+    // Flush, then write at an absolute offset (e.g. patch a header)
+    bool writeAt(uint64_t offset, const void* data, size_t bytes);
+
+    // Flush and close; false if any write failed
+    bool close();
+
+    uint64_t size() const { return streamEnd; }
+    bool failed() const { return error; }
+
+    struct Counters
+    {
+        uint64_t submits = 0;   // io_uring_enter calls / fallback wakeups
+        uint64_t writes  = 0;   // buffer writes completed (incl. short-write retries)
+        uint64_t stalls  = 0;   // times write() had to wait for a free buffer
+    };
+    const Counters& counters() const { return count; }
+
+    struct Engine;   // backend, defined in the .cpp
+
+private:
+    bool queueCurrent();
+    bool takeBuffer();
+
+    WriterConfig cfg;
+    int fd = -1;
+    Backend kind = Backend::None;
+    std::unique_ptr<Engine> engine;
+
+    int      current = -1;   // buffer being filled
+    size_t   fill    = 0;
+    int      unsubmitted = 0;   // buffers queued since the last submission
+    uint64_t streamEnd = 0;  // bytes appended so far
+    bool     error = false;
+    Counters count;
+};
+
+} // namespace sim
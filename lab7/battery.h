@@ -0,0 +1,118 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Per-drone battery state for the swarm engine, drained inside the step
+    kernel from the rotor thrust through a momentum-theory power curve.
+*/
+
+#pragma once
+#include "control.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+struct BatteryParams
+{
+    double capacityWh    = 22.0;    // 4S 1500 mAh pack
+    double avionicsPower = 5.0;     // W while the motors are armed
+    double rotorArea     = 0.126;   // m^2, four 0.1 m radius disks
+    double figureOfMerit = 0.6;     // ideal / actual rotor power
+    double airDensity    = 1.225;   // kg/m^3
+    double returnAt      = 0.25;    // charge fraction that starts the return home
+};
+
+struct BatterySummary
+{
+    size_t drones    = 0;
+    size_t armed     = 0;     // motors on (climbing, on sphere or returning)
+    size_t returning = 0;     // in ReturnHome
+    size_t landed    = 0;     // in Landed
+    size_t depleted  = 0;     // charge reached zero
+    double energyUsedWh = 0.0;   // fleet total
+    double meanCharge   = 0.0;   // fraction of capacity left
+    double minCharge    = 0.0;
+    double meanPower    = 0.0;   // W, over armed drones, last step
+};
+
+// One array per field. Power is P = Pavionics + T^1.5 / (FM sqrt(2 rho A))
+// for rotor thrust T, zero while the motors are off.
+class BatteryBatch
+{
+public:
+    void configure(const BatteryParams& p)
+    {
+        params = p;
+        capacity = p.capacityWh * 3600.0;
+        rotorK = 1.0 / (p.figureOfMerit * std::sqrt(2.0 * p.airDensity * p.rotorArea));
+    }
+
+    void resize(size_t n)
+    {
+        energy.resize(n, capacity);
+        used.resize(n, 0.0);
+        power.resize(n, 0.0);
+    }
+    size_t size() const { return energy.size(); }
+
+    // Drone i for a step of dt at rotor thrust `thrust` N; returns the
+    // charge fraction left. Branch-free so the batched loops keep it inline.
+    double drain(size_t i, double thrust, bool armed, double dt)
+    {
+        const double p = armed ? params.avionicsPower + rotorK * thrust * std::sqrt(thrust) : 0.0;
+        const double e = std::max(0.0, energy[i] - p * dt);
+        used[i] += energy[i] - e;
+        energy[i] = e;
+        power[i] = p;
+        return e / capacity;
+    }
+
+    double charge(size_t i)     const { return energy[i] / capacity; }
+    bool   depleted(size_t i)   const { return energy[i] <= 0.0; }
+    double usedWh(size_t i)     const { return used[i] / 3600.0; }
+    double lastPower(size_t i)  const { return power[i]; }
+    double returnThreshold()    const { return params.returnAt; }
+
+    BatterySummary summary(const std::vector<control::ControlState>& ctrl) const
+    {
+        BatterySummary s;
+        s.drones = size();
+        if (s.drones == 0) return s;
+        double charge = 0.0, used = 0.0, pw = 0.0;
+        s.minCharge = 1.0;
+        for (size_t i = 0; i < size(); ++i)
+        {
+            const double c = energy[i] / capacity;
+            charge += c;
+            s.minCharge = std::min(s.minCharge, c);
+            used += this->used[i];
+            s.depleted += energy[i] <= 0.0;
+            const control::Phase ph = ctrl[i].phase;
+            s.returning += ph == control::Phase::ReturnHome;
+            s.landed    += ph == control::Phase::Landed;
+            if (power[i] > 0.0)
+            {
+                ++s.armed;
+                pw += power[i];
+            }
+        }
+        s.energyUsedWh = used / 3600.0;
+        s.meanCharge   = charge / s.drones;
+        s.meanPower    = s.armed ? pw / s.armed : 0.0;
+        return s;
+    }
+
+private:
+    BatteryParams params;
+    double capacity = BatteryParams().capacityWh * 3600.0;   // J
+    double rotorK = 0.0;
+    std::vector<double> energy;   // J left
+    std::vector<double> used;     // J drawn so far
+    std::vector<double> power;    // W over the last step
+};
+
+} // namespace sim
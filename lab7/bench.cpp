@@ -0,0 +1,1937 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Headless benchmarks for the batched swarm engine.
+    Usage: uav_bench <mode> [args...]
+*/
+
+#include "async_writer.h"
+#include "comms.h"
+#include "coverage.h"
+#include "fault_campaign.h"
+#include "field_tiles.h"
+#include "memtrack.h"
+#include "profiler.h"
+#include "recording.h"
+#include "rng.h"
+#include "scenario_file.h"
+#include "simulation.h"
+#include "snapshot_codec.h"
+#include "swarm.h"
+#include "trails.h"
+#include "trajectory_query.h"
+#include "tuning.h"
+#include "view_cull.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using control::Vec3;
+
+namespace
+{
+
+double secondsSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Lab layout: 15 drones on a 3 x 5 ground grid, one shared sphere
+void buildLabScenario(sim::Swarm& swarm)
+{
+    control::ControlConfig cfg;
+    cfg.center = Vec3(0, 0, 50);
+    cfg.sphereRadius = 10.0;
+    uint32_t m = swarm.addMission(cfg);
+
+    for (double y : { -22.5, 0.0, 22.5 })
+        for (double x : { -46.0, -24.0, -2.0, 20.0, 44.0 })
+            swarm.addDrone(Vec3(x, y, 0.0), m);
+}
+
+// Large swarm: drones on a 25 m ground grid, each flying its own sphere
+// above its pad, so most of them are in steady flight most of the time
+void buildSpreadScenario(sim::Swarm& swarm, int drones)
+{
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    const double spacing = 25.0;
+    for (int k = 0; k < drones; ++k)
+    {
+        double x = (k % cols) * spacing;
+        double y = (k / cols) * spacing;
+        control::ControlConfig cfg;
+        cfg.center = Vec3(x, y, 50);
+        cfg.sphereRadius = 10.0;
+        cfg.groundWait = 5.0 + 0.01 * (k % 100);
+        swarm.addDrone(Vec3(x, y, 0.0), swarm.addMission(cfg));
+    }
+}
+
+// Crowded: drones on a 3 m ground grid all flying one sphere
+Vec3 buildSharedScenario(sim::Swarm& swarm, int drones)
+{
+    control::ControlConfig mission;
+    mission.center = Vec3(0, 0, 50);
+    mission.sphereRadius = 10.0;
+    uint32_t m = swarm.addMission(mission);
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    for (int k = 0; k < drones; ++k)
+        swarm.addDrone(Vec3(3.0 * (k % cols - cols / 2), 3.0 * (k / cols - cols / 2), 0), m);
+    return mission.center;
+}
+
+// Multi-rate vs uniform stepping on the same scenario
+// ------------------------------------------
+void compareMultiRate(const char* name, int drones, double seconds)
+{
+    sim::SwarmConfig uniformCfg;
+    sim::SwarmConfig multiCfg;
+    multiCfg.multiRate = true;
+
+    sim::Swarm uniform(uniformCfg);
+    sim::Swarm multi(multiCfg);
+    if (drones <= 0)
+    {
+        buildLabScenario(uniform);
+        buildLabScenario(multi);
+    }
+    else
+    {
+        buildSpreadScenario(uniform, drones);
+        buildSpreadScenario(multi, drones);
+    }
+
+    const int interval = multi.syncInterval();
+    const int windows  = static_cast<int>(seconds / (interval * multiCfg.dt));
+    const size_t n     = multi.size();
+
+    double tUniform = 0.0, tMulti = 0.0;
+    // Errors split by the uniform run's phase: the OnSphere controller never
+    // settles, so small differences grow there regardless of step size
+    double maxErr[2] = {}, sumSq[2] = {};
+    uint64_t samples[2] = {}, phaseMismatch = 0;
+
+    for (int w = 0; w < windows; ++w)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        uniform.step(interval);
+        tUniform += secondsSince(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        multi.step(interval);
+        tMulti += secondsSince(t0);
+
+        // Both swarms are at a sync point here: compare drone by drone
+        for (size_t i = 0; i < n; ++i)
+        {
+            double e = control::distance(uniform.positions()[i], multi.positions()[i]);
+            int b = uniform.controlState(i).phase == control::Phase::OnSphere;
+            maxErr[b] = std::max(maxErr[b], e);
+            sumSq[b] += e * e;
+            ++samples[b];
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (uniform.controlState(i).phase != multi.controlState(i).phase) ++phaseMismatch;
+    }
+
+    double ratio = static_cast<double>(multi.droneSteps()) / uniform.droneSteps();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[" << name << "] drones=" << n << " sim=" << seconds << "s\n";
+    std::cout << "  uniform : " << std::setw(12) << uniform.droneSteps() << " drone-steps  "
+              << std::setw(8) << tUniform << " s wall\n";
+    std::cout << "  multi   : " << std::setw(12) << multi.droneSteps() << " drone-steps  "
+              << std::setw(8) << tMulti << " s wall  (" << 100.0 * ratio << "% of uniform work)\n";
+    const char* bucket[2] = { "ground/climb", "on sphere   " };
+    for (int b = 0; b < 2; ++b)
+    {
+        std::cout << "  position error vs uniform (" << bucket[b] << "): max " << maxErr[b]
+                  << " m, rms " << std::sqrt(sumSq[b] / std::max<uint64_t>(samples[b], 1)) << " m\n";
+    }
+    std::cout << "  phase mismatches at end : " << phaseMismatch << "\n";
+    std::cout << "  collisions resolved     : " << uniform.collisions()
+              << " (uniform) / " << multi.collisions() << " (multi)\n";
+}
+
+// 6-DOF quadrotor swarm vs point mass: real-time factor
+// ------------------------------------------
+void benchDynamics(sim::Dynamics dyn, int drones, double seconds)
+{
+    sim::SwarmConfig cfg;
+    cfg.dynamics = dyn;
+    sim::Swarm swarm(cfg);
+    buildSpreadScenario(swarm, drones);
+
+    const int ticks = static_cast<int>(seconds / cfg.dt);
+    auto t0 = std::chrono::steady_clock::now();
+    swarm.step(ticks);
+    double wall = secondsSince(t0);
+
+    int phases[3] = {};
+    double maxTilt = 0.0;
+    for (size_t i = 0; i < swarm.size(); ++i)
+    {
+        ++phases[static_cast<int>(swarm.controlState(i).phase)];
+        if (dyn == sim::Dynamics::Quadrotor)
+        {
+            const sim::QuadrotorBatch& q = swarm.quadrotors();
+            double zz = 1.0 - 2.0 * (q.qx[i] * q.qx[i] + q.qy[i] * q.qy[i]);
+            maxTilt = std::max(maxTilt, std::acos(std::clamp(zz, -1.0, 1.0)));
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << (dyn == sim::Dynamics::Quadrotor ? "[quadrotor] " : "[pointmass] ")
+              << "drones=" << swarm.size() << " sim=" << seconds << "s"
+              << " threads=" << swarm.threads() << "\n";
+    std::cout << "  wall " << wall << " s, real-time factor " << seconds / wall
+              << "x, " << 1e9 * wall / (static_cast<double>(ticks) * swarm.size())
+              << " ns per drone-step\n";
+    std::cout << "  phases at end: ground " << phases[0] << ", climb " << phases[1]
+              << ", sphere " << phases[2];
+    if (dyn == sim::Dynamics::Quadrotor)
+    {
+        std::cout << ", max tilt " << maxTilt * 180.0 / 3.14159265358979 << " deg";
+    }
+    std::cout << "\n";
+}
+
+// Sensor simulation: cost per drone-tick and thread-count determinism
+// ------------------------------------------
+void benchSensors(int drones, double seconds)
+{
+    auto run = [&](bool sensors, unsigned threads, double& wall) {
+        sim::SwarmConfig cfg;
+        cfg.simulateSensors = sensors;
+        cfg.threads = threads;
+        auto swarm = std::make_unique<sim::Swarm>(cfg);
+        buildSpreadScenario(*swarm, drones);
+        auto t0 = std::chrono::steady_clock::now();
+        swarm->step(static_cast<int>(seconds / cfg.dt));
+        wall = secondsSince(t0);
+        return swarm;
+    };
+
+    double wallPlain, wallSensors, wallOther;
+    run(false, 1, wallPlain);
+    auto a = run(true, 1, wallSensors);
+    auto b = run(true, 4, wallOther);
+
+    const sim::SensorSuite& sa = a->sensors();
+    const sim::SensorSuite& sb = b->sensors();
+    bool same = sa.imuAx == sb.imuAx && sa.imuAz == sb.imuAz && sa.gyroX == sb.gyroX
+             && sa.gpsX == sb.gpsX && sa.gpsVz == sb.gpsVz && sa.baroZ == sb.baroZ;
+
+    // Noise seen against the true state (GPS also includes its latency)
+    double gpsSq = 0.0, baroSq = 0.0;
+    for (size_t i = 0; i < a->size(); ++i)
+    {
+        double ex = sa.gpsX[i] - a->positions()[i].x;
+        double ez = sa.baroZ[i] - a->positions()[i].z;
+        gpsSq  += ex * ex;
+        baroSq += ez * ez;
+    }
+
+    const double ticks = seconds / 0.01;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[sensors] drones=" << a->size() << " sim=" << seconds << "s\n";
+    std::cout << "  step only    : " << wallPlain << " s\n";
+    std::cout << "  with sensors : " << wallSensors << " s  ("
+              << 1e9 * (wallSensors - wallPlain) / (ticks * a->size())
+              << " ns per drone-tick for IMU + GPS + baro)\n";
+    std::cout << "  1 vs 4 threads bit-identical: " << (same ? "yes" : "NO") << "\n";
+    std::cout << "  rms GPS x error " << std::sqrt(gpsSq / a->size())
+              << " m, rms baro error " << std::sqrt(baroSq / a->size()) << " m\n";
+}
+
+// State estimation: filter cost per drone-tick, estimate error, and how
+// the mission flies on estimates compared with the true state
+// ------------------------------------------
+void benchEstimator(int drones, double seconds)
+{
+    struct Result
+    {
+        double wall = 0.0, posSq = 0.0, velSq = 0.0, sphereErr = 0.0;
+        size_t samples = 0, onSphere = 0;
+    };
+
+    auto run = [&](bool estimate) {
+        sim::SwarmConfig cfg;
+        cfg.simulateSensors = true;
+        cfg.estimateState = estimate;
+        sim::Swarm swarm(cfg);
+        buildSpreadScenario(swarm, drones);
+
+        Result r;
+        const int perSecond = static_cast<int>(1.0 / cfg.dt);
+        for (double t = 0.0; t < seconds; t += 1.0)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            swarm.step(perSecond);
+            r.wall += secondsSince(t0);
+
+            if (!estimate) continue;
+            for (size_t i = 0; i < swarm.size(); ++i)
+            {
+                Vec3 dp = swarm.estimator().position(i) - swarm.positions()[i];
+                Vec3 dv = swarm.estimator().velocity(i) - swarm.velocities()[i];
+                r.posSq += dp.x * dp.x + dp.y * dp.y + dp.z * dp.z;
+                r.velSq += dv.x * dv.x + dv.y * dv.y + dv.z * dv.z;
+            }
+            r.samples += swarm.size();
+        }
+
+        for (size_t i = 0; i < swarm.size(); ++i)
+        {
+            if (swarm.controlState(i).phase != control::Phase::OnSphere) continue;
+            const control::ControlConfig& m = swarm.missionOf(i);
+            r.sphereErr += std::abs(control::distance(swarm.positions()[i], m.center)
+                                    - m.sphereRadius);
+            ++r.onSphere;
+        }
+        return r;
+    };
+
+    Result truth = run(false);
+    Result est   = run(true);
+
+    const double ticks = seconds / 0.01;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[estimator] drones=" << drones << " sim=" << seconds << "s\n";
+    std::cout << "  sensors only    : " << truth.wall << " s\n";
+    std::cout << "  sensors + filter: " << est.wall << " s  ("
+              << 1e9 * (est.wall - truth.wall) / (ticks * drones)
+              << " ns per drone-tick)\n";
+    std::cout << "  rms estimate error: pos " << std::sqrt(est.posSq / std::max<size_t>(est.samples, 1))
+              << " m, vel " << std::sqrt(est.velSq / std::max<size_t>(est.samples, 1)) << " m/s\n";
+    for (const auto& [name, r] : { std::pair<const char*, const Result&>("true state", truth),
+                                   std::pair<const char*, const Result&>("estimate", est) })
+    {
+        std::cout << "  flying on " << std::setw(10) << name << ": " << r.onSphere
+                  << " on sphere, mean |r - R| "
+                  << r.sphereErr / std::max<size_t>(r.onSphere, 1) << " m\n";
+    }
+}
+
+// Comms throughput: unicast to random drones (unlimited range) and
+// range-limited broadcast, checked for latency bounds and determinism
+// ------------------------------------------
+struct CommsResult
+{
+    double   sendSec = 0.0, deliverSec = 0.0;
+    uint64_t sent = 0, dropped = 0, delivered = 0;
+    uint64_t digest = 1469598103934665603ull;   // FNV-1a over every inbox
+    bool     latencyOk = true;
+};
+
+CommsResult runComms(const sim::CommsConfig& ccfg, bool broadcast, int drones,
+                     int perDrone, int ticks, unsigned threads)
+{
+    sim::SwarmConfig cfg;
+    cfg.threads = threads;
+    sim::Swarm swarm(cfg);
+    buildSpreadScenario(swarm, drones);
+    sim::ThreadPool& pool = swarm.threadPool();
+    sim::Comms comms(ccfg);
+
+    CommsResult r;
+    for (int t = 0; t < ticks; ++t)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        comms.beginTick(swarm.positions(), t, pool.size());
+        pool.parallelFor(swarm.size(), [&](size_t b, size_t e, unsigned slot) {
+            for (size_t i = b; i < e; ++i)
+            {
+                double data[3] = { double(i), double(t), 0.0 };
+                for (int k = 0; k < perDrone; ++k)
+                {
+                    if (broadcast)
+                    {
+                        comms.broadcast(slot, i, 1, data);
+                    }
+                    else
+                    {
+                        uint32_t to = (i * 2654435761u + t * 40503u + k * 97u) % swarm.size();
+                        comms.send(slot, i, to, 0, data);
+                    }
+                }
+            }
+        }, 256);
+        auto t1 = std::chrono::steady_clock::now();
+        comms.deliver(pool);
+        r.deliverSec += secondsSince(t1);
+        r.sendSec += std::chrono::duration<double>(t1 - t0).count();
+
+        for (size_t i = 0; i < comms.size(); ++i)
+        {
+            for (const sim::Message& m : comms.inbox(i))
+            {
+                uint64_t age = m.deliverTick - m.sentTick;
+                r.latencyOk &= m.deliverTick == static_cast<uint64_t>(t)
+                            && age >= static_cast<uint64_t>(ccfg.latency)
+                            && age <= static_cast<uint64_t>(ccfg.latency + ccfg.jitter);
+                for (uint64_t v : { uint64_t(i), uint64_t(m.from), uint64_t(m.seq), m.sentTick })
+                {
+                    r.digest = (r.digest ^ v) * 1099511628211ull;
+                }
+            }
+        }
+    }
+    r.sent = comms.sent();
+    r.dropped = comms.dropped();
+    r.delivered = comms.delivered();
+    return r;
+}
+
+void benchComms(int drones, int messages, int ticks)
+{
+    const int perDrone = std::max(1, messages / std::max(drones, 1));
+
+    sim::CommsConfig unlimited;
+    unlimited.range = 1e9;
+    sim::CommsConfig radio;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[comms] drones=" << drones << " ticks=" << ticks
+              << " latency " << radio.latency << "+[0," << radio.jitter << "] ticks, loss "
+              << radio.loss << "\n";
+
+    for (bool bcast : { false, true })
+    {
+        const sim::CommsConfig& c = bcast ? radio : unlimited;
+        CommsResult a = runComms(c, bcast, drones, bcast ? 1 : perDrone, ticks, 1);
+        CommsResult b = runComms(c, bcast, drones, bcast ? 1 : perDrone, ticks, 4);
+
+        double perTick = double(a.sent) / ticks;
+        double sec = a.sendSec + a.deliverSec;
+        std::cout << (bcast ? "  broadcast r=" : "  unicast   x")
+                  << (bcast ? c.range : double(perDrone)) << ": "
+                  << perTick << " msgs/tick, "
+                  << 1e3 * sec / ticks << " ms/tick (send " << 1e3 * a.sendSec / ticks
+                  << ", deliver " << 1e3 * a.deliverSec / ticks << "), "
+                  << 1e9 * sec / std::max<uint64_t>(a.sent, 1) << " ns/msg\n";
+        std::cout << "      dropped " << 100.0 * a.dropped / std::max<uint64_t>(a.sent, 1)
+                  << "%, delivered " << a.delivered
+                  << ", latency in bounds: " << (a.latencyOk ? "yes" : "NO")
+                  << ", 1 vs 4 threads identical: "
+                  << (a.digest == b.digest && a.delivered == b.delivered ? "yes" : "NO") << "\n";
+    }
+}
+
+// MPC vs PID: sphere handoff overshoot and tracking on the lab layout,
+// then cost per drone-tick on a large swarm
+// ------------------------------------------
+void compareControllers(sim::Controller law, int iterations, double seconds)
+{
+    sim::SwarmConfig cfg;
+    cfg.controller = law;
+    cfg.mpc.iterations = iterations;
+    sim::Swarm swarm(cfg);
+    buildLabScenario(swarm);
+
+    // Per drone after the ClimbToCenter -> OnSphere handoff: furthest
+    // excursion past R, time until first within 0.5 m of the sphere, and
+    // tracking error once more than 10 s on the sphere
+    const size_t n = swarm.size();
+    std::vector<double> peak(n, 0.0), reach(n, -1.0), sumErr(n, 0.0), sumSpeed(n, 0.0);
+    std::vector<int> samples(n, 0);
+    while (swarm.time() < seconds)
+    {
+        swarm.step(1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const control::ControlState& st = swarm.controlState(i);
+            if (st.phase != control::Phase::OnSphere) continue;
+            const control::ControlConfig& m = swarm.missionOf(i);
+            double r = control::distance(swarm.positions()[i], m.center);
+            peak[i] = std::max(peak[i], r - m.sphereRadius);
+            if (reach[i] < 0.0 && std::abs(r - m.sphereRadius) < 0.5) reach[i] = st.timeInPhase;
+            if (st.timeInPhase > 10.0)
+            {
+                sumErr[i]   += std::abs(r - m.sphereRadius);
+                sumSpeed[i] += std::abs(swarm.velocities()[i].mag()
+                                        - 0.5 * (m.minSpeed + m.maxSpeed));
+                ++samples[i];
+            }
+        }
+    }
+
+    double overshoot = 0.0, reachSum = 0.0, err = 0.0, speedErr = 0.0;
+    int reached = 0, settled = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        overshoot = std::max(overshoot, peak[i]);
+        if (reach[i] >= 0.0) { reachSum += reach[i]; ++reached; }
+        if (samples[i] == 0) continue;
+        err      += sumErr[i] / samples[i];
+        speedErr += sumSpeed[i] / samples[i];
+        ++settled;
+    }
+
+    std::string name = law == sim::Controller::PID
+                     ? "PID" : "MPC x" + std::to_string(iterations);
+    std::cout << "  " << std::left << std::setw(9) << name << std::right
+              << ": overshoot past R " << overshoot << " m, reached sphere "
+              << reached << "/" << n;
+    if (reached) std::cout << " after " << reachSum / reached << " s";
+    std::cout << ", steady |r - R| " << err / std::max(settled, 1)
+              << " m, speed error " << speedErr / std::max(settled, 1) << " m/s\n";
+}
+
+double controllerCost(sim::Controller law, int drones, double seconds)
+{
+    sim::SwarmConfig cfg;
+    cfg.controller = law;
+    sim::Swarm swarm(cfg);
+    buildSpreadScenario(swarm, drones);
+    auto t0 = std::chrono::steady_clock::now();
+    swarm.step(static_cast<int>(seconds / cfg.dt));
+    return secondsSince(t0);
+}
+
+void benchMpc(int drones, double seconds)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[mpc] lab layout, 90 s (steady state = more than 10 s on sphere)\n";
+    compareControllers(sim::Controller::PID, 0, 90.0);
+    compareControllers(sim::Controller::MPC, sim::MpcParams().iterations, 90.0);
+    compareControllers(sim::Controller::MPC, 200, 90.0);
+
+    const double ticks = seconds / 0.01;
+    double pid = controllerCost(sim::Controller::PID, drones, seconds);
+    double mpc = controllerCost(sim::Controller::MPC, drones, seconds);
+    double perDrone = (mpc - pid) / (ticks * drones);
+    std::cout << "[mpc] drones=" << drones << " sim=" << seconds << "s, "
+              << sim::MpcParams().horizon << "-step horizon, "
+              << sim::MpcParams().iterations << " iterations\n";
+    std::cout << "  PID wall " << pid << " s, MPC wall " << mpc << " s\n";
+    std::cout << "  MPC solve: " << 1e9 * perDrone << " ns per drone-tick -> "
+              << static_cast<long>(0.01 / perDrone)
+              << " drones in real time per core at 100 Hz\n";
+}
+
+// Climb planning: lab layout with towers in the way of some straight
+// climbs, flown straight and planned; then planning time for a big swarm
+// ------------------------------------------
+sim::VoxelMap labTowers()
+{
+    sim::VoxelMap map(Vec3(-60, -40, 0), Vec3(60, 40, 70), 1.0);
+    map.addBox(Vec3(-14, -3, 0), Vec3(-9, 3, 45));
+    map.addBox(Vec3(7, -14, 0), Vec3(13, -8, 35));
+    map.addBox(Vec3(19, 8, 0), Vec3(25, 14, 35));
+    return map;
+}
+
+void flyLabClimb(sim::Controller law, bool planned)
+{
+    sim::SwarmConfig cfg;
+    cfg.controller = law;
+    sim::Swarm swarm(cfg);
+    buildLabScenario(swarm);
+    const control::ControlConfig mission = swarm.missionOf(0);
+    sim::PlannerConfig pcfg;
+    sim::VoxelMap towers = labTowers();
+    // Reserved airspace: inside the sphere, where drones already orbit
+    sim::VoxelMap map = towers;
+    map.addSphere(mission.center, mission.sphereRadius - pcfg.clearance - 1.0);
+
+    double planMs = 0.0;
+    if (planned)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        swarm.planClimbs(map, pcfg);
+        planMs = 1e3 * secondsSince(t0);
+    }
+
+    // Closest approach between two climbing drones, ticks spent inside a
+    // tower, and when each drone reached the sphere
+    const size_t n = swarm.size();
+    double minPair = 1e9;
+    long hits = 0;
+    std::vector<double> arrive(n, -1.0);
+    while (swarm.time() < 60.0)
+    {
+        swarm.step(1);
+        const auto& p = swarm.positions();
+        for (size_t i = 0; i < n; ++i)
+        {
+            control::Phase ph = swarm.controlState(i).phase;
+            if (ph == control::Phase::OnSphere && arrive[i] < 0.0) arrive[i] = swarm.time();
+            if (ph == control::Phase::GroundWait) continue;
+            if (p[i].z > 0.5 && towers.blockedAt(p[i])) ++hits;
+            if (ph != control::Phase::ClimbToCenter) continue;
+            for (size_t j = i + 1; j < n; ++j)
+            {
+                if (swarm.controlState(j).phase == control::Phase::ClimbToCenter)
+                    minPair = std::min(minPair, control::distance(p[i], p[j]));
+            }
+        }
+    }
+
+    double arriveSum = 0.0;
+    int arrived = 0;
+    for (double a : arrive) if (a >= 0.0) { arriveSum += a; ++arrived; }
+    std::cout << "  " << (law == sim::Controller::PID ? "PID" : "MPC")
+              << (planned ? " planned " : " straight") << ": closest climbing pair "
+              << minPair << " m, ticks inside towers " << hits << ", on sphere "
+              << arrived << "/" << n;
+    if (arrived) std::cout << " (mean t " << arriveSum / arrived << " s)";
+    if (planned) std::cout << ", planned in " << planMs << " ms";
+    std::cout << "\n";
+}
+
+void benchPlanner(int drones)
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[plan] lab layout, 3 towers, 60 s\n";
+    for (sim::Controller law : { sim::Controller::PID, sim::Controller::MPC })
+    {
+        flyLabClimb(law, false);
+        flyLabClimb(law, true);
+    }
+
+    // Big swarm on a 3 m grid under one large sphere, towers scattered
+    control::ControlConfig mission;
+    mission.center = Vec3(0, 0, 60);
+    mission.sphereRadius = 30.0;
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    const double half = 1.5 * cols + 20.0;
+    sim::PlannerConfig pcfg;
+    sim::VoxelMap map(Vec3(-half, -half, 0), Vec3(half, half, 100), 1.0);
+    for (int k = 0; k < 40; ++k)
+    {
+        double x = -half + 10 + std::fmod(k * 37.0, 2 * half - 20);
+        double y = -half + 10 + std::fmod(k * 53.0, 2 * half - 20);
+        map.addBox(Vec3(x, y, 5), Vec3(x + 4, y + 4, 20 + (k % 5) * 8));
+    }
+    map.addSphere(mission.center, mission.sphereRadius - pcfg.clearance - 1.0);
+
+    sim::SwarmConfig cfg;
+    sim::Swarm swarm(cfg);
+    uint32_t m = swarm.addMission(mission);
+    for (int k = 0; k < drones; ++k)
+    {
+        swarm.addDrone(Vec3(3.0 * (k % cols - cols / 2), 3.0 * (k / cols - cols / 2), 0), m);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t found = swarm.planClimbs(map, pcfg);
+    double sec = secondsSince(t0);
+
+    double ratio = 0.0, minEntry = 1e9;
+    for (size_t i = 0; i < swarm.size(); ++i)
+    {
+        const auto& r = swarm.climbRoute(i);
+        if (r.empty()) continue;
+        double len = control::distance(swarm.positions()[i], r[0]);
+        for (size_t k = 1; k < r.size(); ++k) len += control::distance(r[k - 1], r[k]);
+        ratio += len / control::distance(swarm.positions()[i], r.back());
+        for (size_t j = i + 1; j < swarm.size(); ++j)
+        {
+            if (!swarm.climbRoute(j).empty())
+                minEntry = std::min(minEntry, control::distance(r.back(), swarm.climbRoute(j).back()));
+        }
+    }
+    std::cout << "[plan] drones=" << drones << " map " << map.nx() << "x" << map.ny() << "x"
+              << map.nz() << " voxels, " << swarm.threads() << " threads\n";
+    std::cout << "  planned " << found << "/" << drones << " in " << sec << " s ("
+              << 1e3 * sec / drones << " ms per drone)\n";
+    std::cout << "  path length / straight line " << ratio / std::max<size_t>(found, 1)
+              << ", closest entry points " << minEntry << " m apart\n";
+}
+
+// Gradient of the tracking error w.r.t. the six PID gains: one Dual run
+// against 2 x 6 finite-difference runs, then a few descent steps
+void benchGains(double seconds)
+{
+    sim::TuningConfig cfg;
+    cfg.seconds = seconds;
+    double gains[sim::numGains], ad[sim::numGains], fd[sim::numGains];
+    sim::defaultGains(gains);
+
+    const int reps = 5;
+    auto t0 = std::chrono::steady_clock::now();
+    double loss = 0.0;
+    for (int r = 0; r < reps; ++r) loss = sim::trackingLossGradient(gains, cfg, ad);
+    double adSec = secondsSince(t0) / reps;
+
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) sim::finiteDifferenceGradient(gains, cfg, fd);
+    double fdSec = secondsSince(t0) / reps;
+
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) sim::trackingLoss(gains, cfg);
+    double plainSec = secondsSince(t0) / reps;
+
+    const char* names[sim::numGains] = { "radial P", "radial I", "radial D",
+                                         "speed P", "speed I", "speed D" };
+    std::cout << "[gains] " << seconds << " s flight, " << static_cast<int>(seconds / cfg.dt)
+              << " steps, loss " << std::setprecision(6) << loss << "\n";
+    for (int k = 0; k < sim::numGains; ++k)
+    {
+        double rel = std::abs(ad[k] - fd[k]) / std::max(1e-12, std::max(std::abs(ad[k]), std::abs(fd[k])));
+        std::cout << "  d/d " << std::setw(8) << names[k] << " = " << std::setw(12) << std::setprecision(6)
+                  << ad[k] << "  (finite diff " << std::setw(12) << fd[k] << ", rel diff "
+                  << std::scientific << std::setprecision(1) << rel << std::defaultfloat << ")\n";
+    }
+    std::cout << std::fixed << std::setprecision(2)
+              << "  plain run " << 1e3 * plainSec << " ms, dual run " << 1e3 * adSec
+              << " ms, finite differences " << 1e3 * fdSec << " ms ("
+              << fdSec / adSec << "x the dual run)\n";
+
+    // Plain gradient descent with a backtracking step. Gains may change
+    // sign: with the default radial loop the drone drifts off the sphere.
+    double step = 0.1;
+    const double start = loss;
+    int it = 0;
+    for (; it < 50 && step > 1e-6; ++it)
+    {
+        double norm = 0.0;
+        for (double g : ad) norm += g * g;
+        norm = std::sqrt(norm);
+        if (norm < 1e-12) break;
+
+        double trial[sim::numGains], trialGrad[sim::numGains];
+        for (;;)
+        {
+            for (int k = 0; k < sim::numGains; ++k)
+                trial[k] = gains[k] - step * ad[k] / norm;
+            double l = sim::trackingLossGradient(trial, cfg, trialGrad);
+            if (l < loss)
+            {
+                loss = l;
+                std::copy(trial, trial + sim::numGains, gains);
+                std::copy(trialGrad, trialGrad + sim::numGains, ad);
+                step *= 1.5;
+                break;
+            }
+            step *= 0.5;
+            if (step < 1e-6) break;
+        }
+    }
+    std::cout << std::setprecision(4) << "  " << it << " descent steps: loss " << start
+              << " -> " << loss << ", gains";
+    for (double g : gains) std::cout << " " << g;
+    std::cout << "\n";
+}
+
+// Ray picking through the spatial grid vs a scan over every drone.
+// Drones scattered through a 400 x 400 x 100 m volume, rays from an
+// orbiting camera aimed near random drones (some miss).
+void benchPicking(int drones, int rays)
+{
+    const double radius = 1.0, cell = 4.0, maxDist = 1000.0;
+    std::vector<Vec3> pts(drones);
+    for (int i = 0; i < drones; ++i)
+    {
+        sim::Philox4x32 r(i, 11, 0, 0, 0, 0);
+        pts[i] = Vec3(400.0 * sim::toUniform(r.v[0]) - 200.0,
+                      400.0 * sim::toUniform(r.v[1]) - 200.0,
+                      100.0 * sim::toUniform(r.v[2]));
+    }
+
+    sim::SpatialGrid grid;
+    auto t0 = std::chrono::steady_clock::now();
+    grid.build(pts, cell);
+    double buildMs = 1e3 * secondsSince(t0);
+
+    double gridSec = 0.0, scanSec = 0.0, worst = 0.0;
+    int hits = 0, mismatches = 0;
+    for (int k = 0; k < rays; ++k)
+    {
+        sim::Philox4x32 r(k, 12, 0, 0, 0, 0);
+        double yaw = 6.283185307 * sim::toUniform(r.v[0]);
+        Vec3 eye(300.0 * std::cos(yaw), 300.0 * std::sin(yaw), 150.0);
+        Vec3 aim = pts[r.v[1] % drones]
+                 + Vec3(sim::toUniform(r.v[2]) - 0.5, sim::toUniform(r.v[3]) - 0.5, 0.0) * 4.0;
+        Vec3 dir = (aim - eye).normalized();
+
+        auto a = std::chrono::steady_clock::now();
+        uint32_t g = grid.raycast(pts, eye, dir, radius, maxDist);
+        double s = secondsSince(a);
+        gridSec += s;
+        worst = std::max(worst, s);
+
+        // Reference: nearest hit over every drone
+        a = std::chrono::steady_clock::now();
+        uint32_t best = sim::SpatialGrid::noHit;
+        double bestT = maxDist;
+        for (int i = 0; i < drones; ++i)
+        {
+            Vec3 oc = pts[i] - eye;
+            double tca = oc.dot(dir), d2 = oc.dot(oc) - tca * tca;
+            if (d2 > radius * radius) continue;
+            double t = tca - std::sqrt(radius * radius - d2);
+            if (t >= 0.0 && t < bestT) { bestT = t; best = i; }
+        }
+        scanSec += secondsSince(a);
+
+        hits += g != sim::SpatialGrid::noHit;
+        mismatches += g != best;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[pick] drones=" << drones << " rays=" << rays << " cell=" << cell
+              << " m radius=" << radius << " m, grid build " << buildMs << " ms\n";
+    std::cout << "  grid ray: " << 1e6 * gridSec / rays << " us avg, " << 1e6 * worst
+              << " us worst; full scan: " << 1e6 * scanSec / rays << " us avg\n";
+    std::cout << "  hits " << hits << "/" << rays << ", mismatches vs scan " << mismatches << "\n";
+}
+
+// Trail ring buffer: cost of appending one snapshot and the floats a
+// renderer has to upload per tick, vs re-uploading every K-sample trail
+void benchTrails(int drones, int length, int ticks)
+{
+    std::vector<Vec3> pos(drones);
+    sim::TrailBuffer trails;
+    trails.reset(drones, length);
+    sim::ThreadPool pool;
+
+    auto step = [&](int t) {
+        for (int i = 0; i < drones; ++i)
+        {
+            double a = 0.05 * t + i;
+            pos[i] = Vec3(std::cos(a), std::sin(a), 0.01 * t);
+        }
+    };
+
+    double pushSec = 0.0, poolSec = 0.0, fullSec = 0.0;
+    std::vector<float> upload(sim::TrailBuffer::floatsNeeded(drones, length) / 2);
+    for (int t = 0; t < ticks; ++t)
+    {
+        step(t);
+        auto a = std::chrono::steady_clock::now();
+        trails.push(pos);
+        pushSec += secondsSince(a);
+
+        // What a non-persistent renderer would do: gather every trail
+        // oldest-to-newest into a fresh upload buffer
+        a = std::chrono::steady_clock::now();
+        const float* src = trails.data();
+        const int s = trails.samples();
+        for (int i = 0; i < drones; ++i)
+        {
+            std::copy(src + 3 * trails.first(i), src + 3 * (trails.first(i) + s),
+                      upload.begin() + 3 * size_t(i) * length);
+        }
+        fullSec += secondsSince(a);
+    }
+    const uint64_t written = trails.floatsWritten();
+
+    trails.reset(drones, length);
+    for (int t = 0; t < ticks; ++t)
+    {
+        step(t);
+        auto a = std::chrono::steady_clock::now();
+        trails.push(pos, pool);
+        poolSec += secondsSince(a);
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[trails] drones=" << drones << " K=" << length << " ticks=" << ticks
+              << " threads=" << pool.size() << "\n";
+    std::cout << "  push: " << 1e3 * pushSec / ticks << " ms/tick ("
+              << 1e9 * pushSec / (double(ticks) * drones) << " ns/sample), pooled "
+              << 1e3 * poolSec / ticks << " ms/tick\n";
+    std::cout << "  written per tick: " << written / ticks << " floats vs "
+              << size_t(drones) * length * 3 << " for a full re-upload ("
+              << 1e3 * fullSec / ticks << " ms/tick to gather)\n";
+}
+
+// Sphere coverage updated every tick from the OnSphere drones of one
+// shared mission, streamed every 10 s; cost compared with the step
+void benchCoverage(int drones, double seconds)
+{
+    sim::Swarm swarm;
+    Vec3 center = buildSharedScenario(swarm, drones);
+
+    sim::SphereCoverage coverage;
+    coverage.configure(center, swarm.missionOf(0).sphereRadius);
+    std::vector<uint8_t> onSphere(swarm.size());
+
+    const int ticks = static_cast<int>(seconds / swarm.config().dt);
+    const int report = static_cast<int>(10.0 / swarm.config().dt);
+    double stepSec = 0.0, coverSec = 0.0;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[coverage] drones=" << drones << " cells=" << coverage.cells() << " ("
+              << coverage.bands() << " bands x " << coverage.sectors() << " sectors) threads="
+              << swarm.threads() << "\n";
+    for (int t = 1; t <= ticks; ++t)
+    {
+        auto a = std::chrono::steady_clock::now();
+        swarm.step();
+        stepSec += secondsSince(a);
+
+        a = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < swarm.size(); ++i)
+            onSphere[i] = swarm.controlState(i).phase == control::Phase::OnSphere;
+        coverage.update(swarm.time(), swarm.positions(), onSphere, swarm.threadPool());
+        coverSec += secondsSince(a);
+
+        if (t % report == 0 || t == ticks)
+        {
+            sim::CoverageStats st = coverage.stats();
+            std::cout << "  t=" << std::setw(6) << swarm.time() << " s  visited "
+                      << st.visited << "/" << st.cells << " (" << 100.0 * st.fraction()
+                      << "%), occupied " << st.occupied << ", revisits " << st.revisits
+                      << " mean " << st.meanRevisit << " s max " << st.maxRevisit
+                      << " s, stalest " << st.maxGap << " s\n";
+        }
+    }
+    std::cout << "  step " << 1e3 * stepSec / ticks << " ms/tick, coverage "
+              << 1e3 * coverSec / ticks << " ms/tick (" << 100.0 * coverSec / stepSec
+              << "% of the step)\n";
+}
+
+// Queries over a recording of the crowded scenario (10 Hz), each checked
+// against a scan of every position in its window
+void benchQueries(int drones, double seconds)
+{
+    const char* path = "uav_bench_query.urec";
+    sim::Swarm swarm;
+    const Vec3 center = buildSharedScenario(swarm, drones);
+    {
+        sim::RecordingWriter out;
+        out.open(path, drones, 0.0, 0.1);
+        out.append(swarm.positions());
+        for (int t = 1; t <= static_cast<int>(seconds * 10); ++t)
+        {
+            swarm.step(10);
+            out.append(swarm.positions());
+        }
+        out.close();
+    }
+
+    sim::ThreadPool& pool = swarm.threadPool();
+    sim::Recording rec;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!rec.open(path, &pool))
+    {
+        std::cerr << "cannot reopen " << path << "\n";
+        return;
+    }
+    double openMs = 1e3 * secondsSince(t0);
+    sim::TrajectoryQuery q(rec, pool);
+    const uint32_t n = rec.drones();
+    const double mb = (64.0 + rec.frames() * n * 12.0 + rec.slices() * n * 24.0) / 1e6;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[query] drones=" << n << " frames=" << rec.frames() << " (" << mb
+              << " MB) threads=" << pool.size() << ", open " << openMs << " ms\n";
+
+    // Range: who came near the sphere center (during the climb)
+    const Vec3 c = center;
+    const double radius = 2.0;
+    t0 = std::chrono::steady_clock::now();
+    auto hits = q.range(c, radius, 0.0, seconds);
+    double rangeMs = 1e3 * secondsSince(t0);
+    uint64_t rangeRead = q.counters().samples;
+    size_t scanHits = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t d = 0; d < n; ++d)
+    {
+        bool in = false;
+        for (uint64_t f = 0; f < rec.frames() && !in; ++f)
+        {
+            const float* p = rec.position(f, d);
+            in = (Vec3(p[0], p[1], p[2]) - c).mag() <= radius;
+        }
+        scanHits += in;
+    }
+    double rangeScanMs = 1e3 * secondsSince(t0);
+    std::cout << "  range r=" << radius << " m of the center, whole run: " << hits.size() << " drones in " << rangeMs
+              << " ms (" << rangeRead << " positions read), scan " << rangeScanMs << " ms ("
+              << scanHits << " drones)\n";
+
+    // kNN: 1000 queries at random times and places
+    std::vector<sim::KnnQuery> kq(1000);
+    for (size_t i = 0; i < kq.size(); ++i)
+    {
+        sim::Philox4x32 r(i, 13, 0, 0, 0, 0);
+        Vec3 dir = Vec3(sim::toUniform(r.v[0]) - 0.5, sim::toUniform(r.v[1]) - 0.5,
+                        sim::toUniform(r.v[2]) - 0.5).normalized();
+        kq[i] = { center + dir * 12.0, seconds * sim::toUniform(r.v[3]), 8 };
+    }
+    t0 = std::chrono::steady_clock::now();
+    auto nn = q.nearest(kq);
+    double knnMs = 1e3 * secondsSince(t0);
+    uint64_t knnRead = q.counters().samples;
+    int knnBad = 0;
+    for (size_t i = 0; i < kq.size(); i += 50)
+    {
+        uint64_t f = static_cast<uint64_t>(std::lround(kq[i].time / rec.period()));
+        std::vector<std::pair<double, uint32_t>> all;
+        for (uint32_t d = 0; d < n; ++d)
+        {
+            const float* p = rec.position(f, d);
+            all.push_back({ (Vec3(p[0], p[1], p[2]) - kq[i].point).mag(), d });
+        }
+        std::partial_sort(all.begin(), all.begin() + 8, all.end());
+        for (int k = 0; k < 8; ++k) knnBad += std::abs(all[k].first - nn[i][k].dist) > 1e-9;
+    }
+    std::cout << "  knn k=8: " << kq.size() << " queries in " << knnMs << " ms ("
+              << 1e3 * knnMs / kq.size() << " us each, " << knnRead / kq.size()
+              << " positions read of " << n << "), mismatches vs scan " << knnBad << "\n";
+
+    // Near misses < 0.5 m over 10 s windows: during the climb (sparse) and
+    // on the sphere (crowded), each also found by a pair scan per frame
+    std::vector<uint8_t> close(static_cast<size_t>(n) * n);
+    for (double w0 : { 5.0, 0.5 * seconds })
+    {
+        const double w1 = w0 + 10.0;
+        t0 = std::chrono::steady_clock::now();
+        auto near = q.nearMisses(0.5, w0, w1);
+        double nearMs = 1e3 * secondsSince(t0);
+        const sim::QueryCounters nc = q.counters();
+
+        uint64_t f0, f1;
+        rec.frameRange(w0, w1, f0, f1);
+        std::fill(close.begin(), close.end(), uint8_t(0));
+        size_t scanPairs = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (uint64_t f = f0; f < f1; ++f)
+            for (uint32_t a = 0; a < n; ++a)
+            {
+                const float* pa = rec.position(f, a);
+                for (uint32_t b = a + 1; b < n; ++b)
+                {
+                    const float* pb = rec.position(f, b);
+                    double dx = pa[0] - pb[0], dy = pa[1] - pb[1], dz = pa[2] - pb[2];
+                    if (dx * dx + dy * dy + dz * dz <= 0.25 && !close[size_t(a) * n + b]++) ++scanPairs;
+                }
+            }
+        double nearScanMs = 1e3 * secondsSince(t0);
+        std::cout << "  near misses t=" << w0 << "-" << w1 << " s: " << near.size() << " pairs in "
+                  << nearMs << " ms (" << nc.candidates << " candidate pairs), pair scan "
+                  << nearScanMs << " ms (" << scanPairs << " pairs)\n";
+    }
+
+    std::remove(path);
+}
+
+// Per-drone flight statistics: step cost with and without them, the
+// fleet summary, and drone 0's streamed moments vs a two-pass computation
+void benchFlightStats(int drones, double seconds)
+{
+    const int ticks = static_cast<int>(seconds / sim::SwarmConfig().dt);
+    double cost[2] = {};
+    std::vector<double> radial;
+    for (int on = 0; on < 2; ++on)
+    {
+        sim::SwarmConfig cfg;
+        cfg.flightStats = on != 0;
+        sim::Swarm swarm(cfg);
+        buildSpreadScenario(swarm, drones);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t)
+        {
+            swarm.step();
+            if (on && swarm.controlState(0).phase == control::Phase::OnSphere)
+            {
+                radial.push_back((swarm.positions()[0] - swarm.missionOf(0).center).mag()
+                                 - swarm.missionOf(0).sphereRadius);
+            }
+        }
+        cost[on] = secondsSince(t0);
+        if (!on) continue;
+
+        const sim::FlightStats& fs = swarm.flightStats();
+        sim::FlightSummary s = fs.summary();
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "[stats] drones=" << drones << " seconds=" << seconds << " threads="
+                  << swarm.threads() << "\n";
+        std::cout << "  fleet: " << s.drones << " drones, " << s.time << " drone-s on sphere; radial "
+                  << s.radialMean << " +- " << s.radialStdDev << " m (worst " << s.maxRadialError
+                  << "), speed-band " << s.speedMean << " +- " << s.speedStdDev << " m/s, "
+                  << 100.0 * s.outsideBand << "% outside band (worst " << s.maxSpeedExcess << ")\n";
+
+        double mean = 0.0, var = 0.0;
+        for (double r : radial) mean += r;
+        mean /= std::max<size_t>(1, radial.size());
+        for (double r : radial) var += (r - mean) * (r - mean);
+        var /= std::max<size_t>(1, radial.size());
+        std::cout << std::setprecision(9) << "  drone 0 radial: streamed " << fs.radialMean(0)
+                  << " var " << fs.radialVariance(0) << ", two-pass " << mean << " var " << var
+                  << "\n" << std::setprecision(3);
+    }
+    std::cout << "  step " << 1e3 * cost[0] / ticks << " ms/tick without stats, "
+              << 1e3 * cost[1] / ticks << " ms/tick with (" << 100.0 * (cost[1] / cost[0] - 1.0)
+              << "%, includes drone 0's reference samples)\n";
+}
+
+// Sustained output: `mb` MB in `chunkKb` KB records through each writer
+// backend and through a plain blocking write() loop. Latency is what the
+// producer sees per record.
+void benchWriter(int mb, int chunkKb)
+{
+    const char* path = "uav_bench_write.bin";
+    const size_t chunk = static_cast<size_t>(chunkKb) * 1024;
+    const size_t chunks = static_cast<size_t>(mb) * 1024 / chunkKb;
+    std::vector<char> data(chunk);
+    for (size_t i = 0; i < chunk; ++i) data[i] = static_cast<char>(i * 131);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[write] " << mb << " MB in " << chunkKb << " KB records\n";
+    auto report = [&](const char* name, double total, std::vector<double>& lat, const char* extra) {
+        std::sort(lat.begin(), lat.end());
+        std::cout << "  " << std::left << std::setw(9) << name << std::right
+                  << mb / total << " MB/s, per record p50 " << 1e6 * lat[lat.size() / 2]
+                  << " us p99 " << 1e6 * lat[lat.size() * 99 / 100] << " us max "
+                  << 1e6 * lat.back() << " us" << extra << "\n";
+    };
+
+    // Baseline: blocking write() on the producer thread
+    {
+        std::vector<double> lat(chunks);
+        std::FILE* f = std::fopen(path, "wb");
+        std::setvbuf(f, nullptr, _IONBF, 0);
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            auto a = std::chrono::steady_clock::now();
+            std::fwrite(data.data(), 1, chunk, f);
+            lat[i] = secondsSince(a);
+        }
+        std::fclose(f);
+        report("blocking", secondsSince(t0), lat, "");
+    }
+
+    for (bool uring : { false, true })
+    {
+        sim::WriterConfig cfg;
+        cfg.useIoUring = uring;
+        sim::AsyncWriter out(cfg);
+        std::vector<double> lat(chunks);
+        auto t0 = std::chrono::steady_clock::now();
+        out.open(path);
+        if (uring && out.backend() != sim::AsyncWriter::Backend::IoUring)
+        {
+            std::cout << "  io_uring unavailable here\n";
+            break;
+        }
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            auto a = std::chrono::steady_clock::now();
+            out.write(data.data(), chunk);
+            lat[i] = secondsSince(a);
+        }
+        bool ok = out.close();
+        const sim::AsyncWriter::Counters& c = out.counters();
+        char extra[160];
+        std::snprintf(extra, sizeof(extra), "; %llu submits, %llu writes, %llu stalls%s",
+                      (unsigned long long)c.submits, (unsigned long long)c.writes,
+                      (unsigned long long)c.stalls, ok ? "" : " (FAILED)");
+        report(uring ? "io_uring" : "pwrite", secondsSince(t0), lat, extra);
+    }
+    std::remove(path);
+}
+
+// Packed snapshots vs the double-precision Snapshot struct: size, encode
+// and decode cost, and the error the render / telemetry side sees
+// ------------------------------------------
+void benchSnapshot(int drones, double seconds)
+{
+    sim::Swarm swarm;
+    buildSharedScenario(swarm, drones);
+    swarm.step(static_cast<int>(seconds / swarm.config().dt));
+    const size_t n = swarm.size();
+    const std::vector<Vec3>& pos = swarm.positions();
+    const std::vector<Vec3>& vel = swarm.velocities();
+
+    // Field-style bounds around this scenario's ground grid
+    const double half = 1.5 * std::ceil(std::sqrt(drones)) + 10.0;
+    sim::SnapshotCodec codec(Vec3(-half, -half, 0.0), Vec3(half, half, 100.0));
+
+    const int reps = 50;
+    std::vector<sim::UAV::Snapshot> full(n);
+    std::vector<uint8_t> phase(n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            full[i] = { pos[i], vel[i], swarm.accelerations()[i] };
+            phase[i] = static_cast<uint8_t>(swarm.controlState(i).phase);
+        }
+    }
+    const double copyNs = 1e9 * secondsSince(t0) / (reps * double(n));
+
+    std::vector<sim::PackedDrone> packed(n);
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) codec.encode(n, pos.data(), vel.data(), phase.data(), packed.data());
+    const double encodeNs = 1e9 * secondsSince(t0) / (reps * double(n));
+
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) swarm.packSnapshot(codec, packed);
+    const double packNs = 1e9 * secondsSince(t0) / (reps * double(n));
+
+    std::vector<Vec3> dpos(n), dvel(n);
+    std::vector<uint8_t> dphase(n);
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) codec.decodePositions(n, packed.data(), dpos.data());
+    const double decodePosNs = 1e9 * secondsSince(t0) / (reps * double(n));
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) codec.decode(n, packed.data(), dpos.data(), dvel.data(), dphase.data());
+    const double decodeNs = 1e9 * secondsSince(t0) / (reps * double(n));
+
+    double posErr = 0.0, velErr = 0.0, dirErr = 0.0;
+    size_t phaseBad = 0, clamped = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        posErr = std::max({ posErr, std::fabs(dpos[i].x - pos[i].x), std::fabs(dpos[i].y - pos[i].y),
+                            std::fabs(dpos[i].z - pos[i].z) });
+        velErr = std::max(velErr, (dvel[i] - vel[i]).mag());
+        if (vel[i].mag() > 0.1)
+        {
+            double c = dvel[i].normalized().dot(vel[i].normalized());
+            dirErr = std::max(dirErr, std::acos(std::min(1.0, c)));
+        }
+        phaseBad += dphase[i] != phase[i];
+        clamped += (packed[i].flags & sim::PackedDrone::Clamped) != 0;
+    }
+
+    const Vec3 step = codec.positionStep();
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "[snapshot] drones=" << n << " after " << seconds << " s, bounds +-" << half
+              << " m x 100 m\n";
+    std::cout << "  size      : " << sizeof(sim::UAV::Snapshot) + 1 << " B -> " << sizeof(sim::PackedDrone)
+              << " B per drone (" << double(sizeof(sim::UAV::Snapshot) + 1) / sizeof(sim::PackedDrone)
+              << "x smaller)\n";
+    std::cout << "  per drone : copy " << copyNs << " ns, encode " << encodeNs << " ns, packSnapshot "
+              << packNs << " ns (" << swarm.threads() << " threads), decode positions " << decodePosNs
+              << " ns, full decode " << decodeNs << " ns\n";
+    std::cout << std::setprecision(4) << "  error     : position " << 1e3 * posErr << " mm (bound "
+              << 1e3 * std::max({ step.x, step.y, step.z }) << "), velocity " << 1e3 * velErr
+              << " mm/s, direction " << dirErr * 180.0 / M_PI << " deg, " << phaseBad
+              << " phase mismatches, " << clamped << " clamped\n";
+}
+
+// Fault-injection campaigns: a fault-free baseline, each fault kind on
+// its own, then a mix, all over the same seeds
+// ------------------------------------------
+void benchFaults(int scenarios, int drones, double seconds)
+{
+    // Masks at 1 must leave the engine bit-for-bit unchanged
+    {
+        sim::SwarmConfig cfg;
+        cfg.threads = 1;
+        sim::Swarm plain(cfg), masked(cfg);
+        buildSharedScenario(plain, drones);
+        buildSharedScenario(masked, drones);
+        masked.faultModel().schedule({ 0, UINT64_MAX, sim::FaultKind::MotorOut, 0, 1.0 });
+        plain.step(1000);
+        masked.step(1000);
+        double diff = 0.0;
+        for (size_t i = 0; i < plain.size(); ++i)
+            diff = std::max(diff, (plain.positions()[i] - masked.positions()[i]).mag());
+        std::cout << "[faults] nominal masks: max position difference " << diff << " m\n";
+    }
+
+    sim::CampaignConfig cfg;
+    cfg.scenarios = scenarios;
+    cfg.drones    = drones;
+    cfg.seconds   = seconds;
+
+    struct Run { const char* name; double p, motor, thrust, freeze; };
+    const Run runs[] = {
+        { "baseline",    0.0, 1, 1, 1 },
+        { "motor-out",   0.1, 1, 0, 0 },
+        { "thrust-loss", 0.1, 0, 1, 0 },
+        { "freeze",      0.1, 0, 0, 1 },
+        { "mixed",       0.1, 1, 1, 1 },
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[faults] " << scenarios << " scenarios x " << drones << " drones x " << seconds
+              << " s, faults in [" << cfg.faults.windowStart << ", " << cfg.faults.windowEnd << ") s\n";
+    std::cout << "  campaign     faulted  downed  recovered  rec.time  disturbed  coll/scn  after-fault"
+                 "  vs-twin    p95  w/coll   wall\n";
+    for (const Run& r : runs)
+    {
+        cfg.faults.probability = r.p;
+        cfg.faults.motorOut    = r.motor;
+        cfg.faults.thrustLoss  = r.thrust;
+        cfg.faults.freeze      = r.freeze;
+        sim::CampaignSummary s = sim::runCampaign(cfg);
+        std::cout << "  " << std::left << std::setw(12) << r.name << std::right
+                  << std::setw(9) << s.faulted << std::setw(8) << s.downed << std::setw(11) << s.recovered
+                  << std::setw(9) << s.meanRecovery << "s" << std::setw(11) << s.disturbed
+                  << std::setw(10) << s.collisionsMean << std::setw(13) << s.collisionsAfterMean
+                  << std::setw(9) << s.extraCollisionsMean << std::setw(7) << s.collisionsP95
+                  << std::setw(7) << 100.0 * s.scenariosWithCollision << "%" << std::setw(6)
+                  << s.wallSeconds << "s\n";
+    }
+}
+
+// Memory per drone at each swarm size: heap by subsystem for the batched
+// engine, then the legacy one-thread-per-UAV objects and their threads.
+// Heap figures are requested bytes; RSS adds allocator overhead.
+// ------------------------------------------
+struct MemSnapshot
+{
+    sim::MemStats sub[static_cast<int>(sim::Subsystem::Count)];
+    sim::MemStats total;
+    size_t rss = 0, vsz = 0;
+
+    static MemSnapshot take()
+    {
+        MemSnapshot m;
+        for (int k = 0; k < static_cast<int>(sim::Subsystem::Count); ++k)
+            m.sub[k] = sim::memStats(static_cast<sim::Subsystem>(k));
+        m.total = sim::memTotal();
+        m.rss = sim::residentBytes();
+        m.vsz = sim::virtualBytes();
+        return m;
+    }
+};
+
+void benchMemory(const std::vector<int>& sizes)
+{
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[memory] heap tracking " << (sim::memTrackingEnabled() ? "on" : "off (UAV_MEMTRACK=OFF)")
+              << ", sizeof(UAV) = " << sizeof(sim::UAV) << " B\n";
+
+    double swarmPerDrone = 0.0, uavPerDrone = 0.0, threadRss = 0.0, threadVsz = 0.0;
+    for (int n : sizes)
+    {
+        if (n < 1) continue;
+
+        // Batched engine, after a second of flight so the grids and
+        // contact lists have grown to their working size
+        sim::resetMemPeaks();
+        const MemSnapshot before = MemSnapshot::take();
+        MemSnapshot during;
+        {
+            sim::Swarm swarm;
+            buildSharedScenario(swarm, n);
+            swarm.step(100);
+            during = MemSnapshot::take();
+        }
+        const MemSnapshot after = MemSnapshot::take();
+
+        std::cout << "[swarm] drones=" << n << "   live B/drone   peak B/drone\n";
+        for (int k = 0; k < static_cast<int>(sim::Subsystem::Count); ++k)
+        {
+            const double live = double(during.sub[k].live - before.sub[k].live) / n;
+            const double peak = double(during.sub[k].peak - before.sub[k].live) / n;
+            if (live == 0.0 && peak == 0.0) continue;
+            std::cout << "  " << std::setw(10) << std::left << sim::subsystemName(static_cast<sim::Subsystem>(k))
+                      << std::right << std::setw(14) << live << std::setw(15) << peak << "\n";
+        }
+        swarmPerDrone = double(during.total.live - before.total.live) / n;
+        std::cout << "  " << std::setw(10) << std::left << "total" << std::right << std::setw(14)
+                  << swarmPerDrone << std::setw(15) << double(during.total.peak - before.total.live) / n
+                  << "\n  RSS +" << (double(during.rss) - double(before.rss)) / n << " B/drone, "
+                  << after.total.live - before.total.live << " B still live after teardown\n";
+
+        // Legacy objects: heap per UAV, then what a running thread costs
+        MemSnapshot u0 = MemSnapshot::take();
+        std::vector<std::unique_ptr<sim::UAV>> uavs;
+        {
+            sim::MemScope tag(sim::Subsystem::Physics);
+            uavs.reserve(n);
+            for (int k = 0; k < n; ++k)
+                uavs.emplace_back(std::make_unique<sim::UAV>(Vec3(3.0 * (k % 100), 3.0 * (k / 100), 0.0)));
+        }
+        MemSnapshot u1 = MemSnapshot::take();
+        uavPerDrone = double(u1.total.live - u0.total.live) / n;
+        std::cout << "[uav]   drones=" << n << "\n  heap " << uavPerDrone << " B/drone, RSS +"
+                  << (double(u1.rss) - double(u0.rss)) / n << " B/drone\n";
+
+        const int started = std::min(n, 256);
+        for (int k = 0; k < started; ++k) uavs[k]->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        MemSnapshot u2 = MemSnapshot::take();
+        for (int k = 0; k < started; ++k) uavs[k]->stop();
+        threadRss = (double(u2.rss) - double(u1.rss)) / started;
+        threadVsz = (double(u2.vsz) - double(u1.vsz)) / started;
+        std::cout << "  running thread (" << started << " started): RSS +" << threadRss / 1024.0
+                  << " KB, virtual +" << threadVsz / (1024.0 * 1024.0) << " MB each\n";
+
+        // The all-pairs check is O(n^2); its transient is one snapshot per UAV
+        if (n <= 20000)
+        {
+            sim::resetMemPeaks();
+            const int64_t live = sim::memStats(sim::Subsystem::Collision).live;
+            sim::checkAndResolveCollisions(uavs, 0.01);
+            std::cout << "  checkAndResolveCollisions transient: "
+                      << double(sim::memStats(sim::Subsystem::Collision).peak - live) / n << " B/drone\n";
+        }
+    }
+
+    const double M = 1e6, MB = 1024.0 * 1024.0;
+    std::cout << "[1M drones, extrapolated from the largest size] swarm heap " << swarmPerDrone * M / MB
+              << " MB; UAV objects " << uavPerDrone * M / MB << " MB + threads " << threadRss * M / MB
+              << " MB resident, " << threadVsz * M / (MB * 1024.0) << " GB virtual\n";
+}
+
+// Battery drain and return-to-home on the spread scenario with a pack
+// small enough that drones go home partway through; then the step cost with the
+// battery model on and off.
+// ------------------------------------------
+void benchBattery(int drones, double seconds, double capacityWh)
+{
+    sim::SwarmConfig cfg;
+    cfg.simulateBattery = true;
+    cfg.battery.capacityWh = capacityWh;
+    sim::Swarm swarm(cfg);
+    buildSpreadScenario(swarm, drones);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[battery] " << drones << " drones, " << capacityWh << " Wh packs, return at "
+              << 100.0 * cfg.battery.returnAt << "%\n"
+              << "     t   armed  returning  landed  depleted  charge(mean/min)  power W  used Wh\n";
+    const int perReport = static_cast<int>(10.0 / cfg.dt);
+    const int total = static_cast<int>(seconds / cfg.dt);
+    for (int t = 0; t < total; t += perReport)
+    {
+        swarm.step(std::min(perReport, total - t));
+        const sim::BatterySummary b = swarm.batterySummary();
+        std::cout << std::setw(6) << swarm.tick() * cfg.dt << std::setw(8) << b.armed << std::setw(11)
+                  << b.returning << std::setw(8) << b.landed << std::setw(10) << b.depleted
+                  << std::setw(11) << b.meanCharge << " / " << std::setw(4) << b.minCharge
+                  << std::setw(9) << b.meanPower << std::setw(9) << b.energyUsedWh << "\n";
+    }
+
+    // Overhead: a pack that never runs low, so both runs fly the same
+    // paths, against the model switched off
+    double wall[2];
+    for (int on = 0; on < 2; ++on)
+    {
+        sim::SwarmConfig c = cfg;
+        c.battery.capacityWh = 1e6;
+        c.simulateBattery = on != 0;
+        sim::Swarm s(c);
+        buildSpreadScenario(s, drones);
+        auto t0 = std::chrono::steady_clock::now();
+        s.step(total);
+        wall[on] = secondsSince(t0);
+    }
+    std::cout << "  step cost: " << 1e9 * wall[0] / (double(total) * drones) << " ns/drone off, "
+              << 1e9 * wall[1] / (double(total) * drones) << " ns/drone on ("
+              << 100.0 * (wall[1] / wall[0] - 1.0) << "%)\n";
+}
+
+// Field imagery: one monolithic BMP load against a baked pyramid streamed
+// into a fixed tile cache while a 60 Hz camera dives from overview to
+// a few metres above the grass. Uploads are memcpys into the slot pool.
+// ------------------------------------------
+bool writeBMP24(const char* path, const std::vector<uint8_t>& bgr, int w, int h)
+{
+    const uint32_t row = (3 * w + 3) & ~3u, size = 54 + row * h;
+    unsigned char hdr[54] = { 'B', 'M' };
+    auto put = [&](int at, uint32_t v) { for (int k = 0; k < 4; ++k) hdr[at + k] = (v >> (8 * k)) & 0xff; };
+    put(0x02, size);
+    put(0x0A, 54);
+    put(0x0E, 40);
+    put(0x12, w);
+    put(0x16, h);
+    hdr[0x1A] = 1;
+    hdr[0x1C] = 24;
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(hdr, 1, 54, f) == 54;
+    std::vector<uint8_t> line(row, 0);
+    for (int y = 0; ok && y < h; ++y)
+    {
+        std::copy_n(&bgr[size_t(y) * w * 3], 3 * w, line.begin());
+        ok = std::fwrite(line.data(), 1, row, f) == row;
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+void benchTiles(int width, int tileSize, int slots)
+{
+    const char* bmpPath  = "uav_bench_field.bmp";
+    const char* tilePath = "uav_bench_field.tiles";
+    const int height = width * 4 / 9;   // 120 x 53.3 field
+    const double MB = 1.0 / (1024.0 * 1024.0);
+
+    // Yard stripes with a fine checker so every level differs
+    std::vector<uint8_t> img(size_t(width) * height * 3);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            uint8_t* p = &img[(size_t(y) * width + x) * 3];
+            const int stripe = (x * 12 / width) & 1, fine = ((x >> 2) ^ (y >> 2)) & 1;
+            p[0] = static_cast<uint8_t>(40 + 20 * fine);
+            p[1] = static_cast<uint8_t>(120 + 40 * stripe + 10 * fine);
+            p[2] = static_cast<uint8_t>(30 + 10 * fine);
+        }
+    }
+    if (!writeBMP24(bmpPath, img, width, height))
+    {
+        std::cerr << "cannot write " << bmpPath << "\n";
+        return;
+    }
+    img = std::vector<uint8_t>();
+
+    std::cout << std::fixed << std::setprecision(2);
+    uint32_t w = 0, h = 0;
+    std::vector<uint8_t> whole;
+    auto t0 = std::chrono::steady_clock::now();
+    sim::loadBMP24(bmpPath, w, h, whole);
+    const double wholeSec = secondsSince(t0);
+    std::cout << "[tiles] " << w << " x " << h << " image\n  monolithic load " << 1e3 * wholeSec
+              << " ms, " << whole.size() * MB << " MB (+1/3 for mipmaps) resident\n";
+    t0 = std::chrono::steady_clock::now();
+    const bool baked = sim::bakeTilePyramid(whole.data(), w, h, tileSize, tilePath);
+    const double bakeSec = secondsSince(t0);
+    whole = std::vector<uint8_t>();
+    std::remove(bmpPath);
+    if (!baked)
+    {
+        std::cerr << "bake failed\n";
+        return;
+    }
+
+    sim::TileStreamConfig cfg;
+    cfg.slots = slots;
+    sim::TileStreamer tiles(cfg);
+    t0 = std::chrono::steady_clock::now();
+    tiles.open(tilePath);
+    const double openSec = secondsSince(t0);
+    const sim::TilePyramidHeader& th = tiles.header();
+    std::cout << "  baked " << th.levels << " levels, " << th.tiles << " tiles in " << bakeSec
+              << " s; open " << 1e3 * openSec << " ms\n";
+
+    // 720-pixel-high window at the sim's 60 degree field of view
+    const double pixelAngle = 60.0 * 3.14159265358979 / 180.0 / 720.0;
+    std::vector<uint8_t> texturePool(size_t(slots) * tiles.tileBytes());
+    std::vector<sim::TileDraw> draws;
+    const int frames = 600;
+    double planSec = 0.0;
+    uint64_t blurredFrames = 0;
+    auto next = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f)
+    {
+        const double u = double(f) / frames;
+        const double alt = 130.0 * std::pow(3.0 / 130.0, u);
+        const double yaw = 4.0 * u;
+        const Vec3 eye(50.0 * (1.0 - u) * std::cos(yaw) + 30.0 * u, 20.0 * (1.0 - u) * std::sin(yaw), alt);
+
+        auto tp = std::chrono::steady_clock::now();
+        tiles.poll(8, [&](int slot, const uint8_t* texels) {
+            std::copy_n(texels, tiles.tileBytes(), &texturePool[size_t(slot) * tiles.tileBytes()]);
+        });
+        const uint64_t fb = tiles.counters().fallback;
+        tiles.plan(eye, pixelAngle, draws);
+        planSec += secondsSince(tp);
+        blurredFrames += tiles.counters().fallback != fb;
+
+        next += std::chrono::microseconds(16667);
+        std::this_thread::sleep_until(next);
+    }
+    const sim::TileStreamer::Counters& c = tiles.counters();
+    std::cout << "  " << frames << " frames: poll+plan " << 1e6 * planSec / frames << " us/frame, "
+              << double(c.drawn) / frames << " quads/frame, " << 100.0 * c.fallback / std::max<uint64_t>(c.drawn, 1)
+              << "% drawn from a coarser tile, " << blurredFrames << " frames with any\n"
+              << "  tiles loaded " << c.loaded << ", evicted " << c.evicted << ", dropped " << c.dropped
+              << "; resident " << tiles.resident() << "/" << slots << " slots = "
+              << (slots + cfg.staging) * tiles.tileBytes() * MB << " MB with staging\n";
+    tiles.close();
+    std::remove(tilePath);
+}
+
+// Multi-view culling: every view's instance list from one pass over the
+// drones, against a separate pass per view. Views are the sim's split
+// layout (orbit, chase, map) plus extra orbit cameras around the swarm.
+// ------------------------------------------
+void benchViews(int drones, int views)
+{
+    sim::Swarm swarm;
+    buildSpreadScenario(swarm, drones);
+    swarm.step(static_cast<int>(20.0 / swarm.config().dt));
+    const std::vector<Vec3>& pos = swarm.positions();
+
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    const double extent = 25.0 * cols;
+    const Vec3 mid(0.5 * extent, 0.5 * extent, 40.0), up(0, 0, 1);
+    std::vector<sim::Frustum> frusta;
+    frusta.push_back(sim::Frustum::perspective(mid + Vec3(-0.3 * extent, -0.3 * extent, 0.4 * extent), mid,
+                                               up, 60.0, 1.0, 1.0, 2.0 * extent));
+    frusta.push_back(sim::Frustum::perspective(pos[0] + Vec3(-6, 0, 2), pos[0] + Vec3(2, 0, 0), up,
+                                               60.0, 1.0, 0.1, 500.0));
+    frusta.push_back(sim::Frustum::orthographic(Vec3(mid.x, mid.y, 200.0), Vec3(mid.x, mid.y, 0.0),
+                                                Vec3(0, 1, 0), 0.5 * extent, 0.5 * extent, 1.0, 500.0));
+    for (int k = 3; k < views; ++k)
+    {
+        const double a = 2.0 * 3.14159265358979 * k / views;
+        const Vec3 eye = mid + Vec3(0.4 * extent * std::cos(a), 0.4 * extent * std::sin(a), 60.0);
+        frusta.push_back(sim::Frustum::perspective(eye, mid, up, 60.0, 16.0 / 9.0, 1.0, 2.0 * extent));
+    }
+    frusta.resize(std::min<size_t>(frusta.size(), std::max(views, 1)));
+
+    const int reps = 20;
+    std::vector<std::vector<uint32_t>> shared, single, tmp;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) sim::cullViews(pos, 0.5, frusta, shared);
+    const double oneSec = secondsSince(t0) / reps;
+
+    std::vector<sim::Frustum> alone(1);
+    single.resize(frusta.size());
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+    {
+        for (size_t v = 0; v < frusta.size(); ++v)
+        {
+            alone[0] = frusta[v];
+            sim::cullViews(pos, 0.5, alone, tmp);
+            single[v].swap(tmp[0]);
+        }
+    }
+    const double perViewSec = secondsSince(t0) / reps;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[views] " << drones << " drones, " << frusta.size() << " views; visible:";
+    bool same = true;
+    for (size_t v = 0; v < frusta.size(); ++v)
+    {
+        std::cout << " " << shared[v].size();
+        same = same && shared[v] == single[v];
+    }
+    std::cout << "\n  one pass      " << 1e3 * oneSec << " ms (" << 1e9 * oneSec / drones << " ns/drone)\n"
+              << "  pass per view " << 1e3 * perViewSec << " ms (" << 1e9 * perViewSec / drones
+              << " ns/drone), lists " << (same ? "identical" : "DIFFER") << "\n";
+}
+
+bool samePositions(const std::vector<Vec3>& a, const std::vector<Vec3>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Vec3)) == 0;
+}
+
+// Scenario loading: a spread-out swarm written as text and compiled,
+// then loaded into a swarm from each form and, for reference, built
+// with one addDrone call per drone as the C++ setups do.
+// ------------------------------------------
+void benchScenario(int drones)
+{
+    const char* textPath = "uav_bench_scenario.txt";
+    const char* binPath  = "uav_bench_scenario.scn";
+    const double MB = 1.0 / (1024.0 * 1024.0);
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    const int missions = std::min(drones, 256);
+
+    // Missions over a 16 x 16 grid of blocks, a tower in every block
+    sim::Scenario s;
+    const double block = 3.0 * cols / 16.0;
+    for (int m = 0; m < missions; ++m)
+    {
+        control::ControlConfig cfg;
+        cfg.center = Vec3((m % 16 + 0.5) * block, (m / 16 + 0.5) * block, 60.0);
+        cfg.sphereRadius = 10.0;
+        s.missions.push_back(cfg);
+        sim::Obstacle o;
+        o.a = cfg.center - Vec3(2.0, 2.0, 60.0);
+        o.b = cfg.center + Vec3(2.0, 2.0, -20.0);
+        s.obstacles.push_back(o);
+    }
+    s.airframes.emplace_back();
+    for (int k = 0; k < drones; ++k)
+    {
+        const Vec3 p(3.0 * (k % cols), 3.0 * (k / cols), 0.0);
+        const int bx = std::min(15, static_cast<int>(p.x / block));
+        const int by = std::min(15, static_cast<int>(p.y / block));
+        s.addDrone(p, 0.001 * (k % 6283), static_cast<uint32_t>((by * 16 + bx) % missions));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    const bool wrote = sim::saveScenarioText(s, textPath);
+    const double saveTextSec = secondsSince(t0);
+    t0 = std::chrono::steady_clock::now();
+    const bool compiled = wrote && sim::saveScenarioBinary(s, binPath);
+    const double saveBinSec = secondsSince(t0);
+    if (!compiled)
+    {
+        std::cerr << "cannot write the scenario files\n";
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[scenario] " << drones << " drones, " << missions << " missions, " << missions
+              << " obstacles; wrote text in " << saveTextSec << " s, compiled in " << saveBinSec << " s\n";
+
+    // Reference: the C++ way, one addDrone per drone
+    double addSec;
+    {
+        sim::Swarm swarm;
+        t0 = std::chrono::steady_clock::now();
+        for (const control::ControlConfig& m : s.missions) swarm.addMission(m);
+        for (int k = 0; k < drones; ++k) swarm.addDrone(s.positions[k], s.missionIds[k]);
+        addSec = secondsSince(t0);
+    }
+
+    // Text: read, parse, load
+    double parseSec, textLoadSec;
+    bool textSame;
+    {
+        sim::Scenario parsed;
+        std::string error;
+        t0 = std::chrono::steady_clock::now();
+        if (!sim::loadScenarioText(textPath, parsed, error))
+        {
+            std::cerr << textPath << ": " << error << "\n";
+            return;
+        }
+        parseSec = secondsSince(t0);
+        sim::Swarm swarm;
+        t0 = std::chrono::steady_clock::now();
+        parsed.view().loadInto(swarm);
+        textLoadSec = secondsSince(t0);
+        textSame = samePositions(swarm.positions(), s.positions);
+    }
+
+    // Compiled: map, load
+    double openSec, binLoadSec;
+    bool binSame;
+    size_t binBytes;
+    {
+        sim::ScenarioFile file;
+        t0 = std::chrono::steady_clock::now();
+        if (!file.open(binPath))
+        {
+            std::cerr << binPath << ": cannot open\n";
+            return;
+        }
+        openSec = secondsSince(t0);
+        binBytes = file.fileBytes();
+        sim::Swarm swarm;
+        t0 = std::chrono::steady_clock::now();
+        file.view().loadInto(swarm);
+        binLoadSec = secondsSince(t0);
+        binSame = samePositions(swarm.positions(), s.positions);
+        for (int k = 0; binSame && k < drones; ++k)
+            binSame = swarm.missionOf(k).center.x == s.missions[s.missionIds[k]].center.x;
+    }
+
+    std::FILE* tf = std::fopen(textPath, "rb");
+    long textBytes = 0;
+    if (tf)
+    {
+        std::fseek(tf, 0, SEEK_END);
+        textBytes = std::ftell(tf);
+        std::fclose(tf);
+    }
+    std::remove(textPath);
+    std::remove(binPath);
+
+    std::cout << "  addDrone loop      " << std::setw(9) << 1e3 * addSec << " ms\n"
+              << "  text   " << std::setw(7) << textBytes * MB << " MB: parse " << 1e3 * parseSec
+              << " ms + load " << 1e3 * textLoadSec << " ms = " << 1e3 * (parseSec + textLoadSec) << " ms"
+              << (textSame ? "" : " (positions DIFFER)") << "\n"
+              << "  binary " << std::setw(7) << binBytes * MB << " MB: open " << 1e3 * openSec
+              << " ms + load " << 1e3 * binLoadSec << " ms = " << 1e3 * (openSec + binLoadSec) << " ms"
+              << (binSame ? "" : " (drones DIFFER)") << "\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: uav_bench [--profile] <mode> [args]\n"
+              << "  multirate [drones=2000] [seconds=60]\n"
+              << "  quad      [drones=10000] [seconds=10]\n"
+              << "  sensors   [drones=10000] [seconds=10]\n"
+              << "  estimator [drones=10000] [seconds=20]\n"
+              << "  comms     [drones=10000] [messages/tick=100000] [ticks=100]\n"
+              << "  mpc       [drones=5000] [seconds=10]\n"
+              << "  plan      [drones=1000]\n"
+              << "  gains     [seconds=20]\n"
+              << "  pick      [drones=100000] [rays=2000]\n"
+              << "  trails    [drones=10000] [K=200] [ticks=500]\n"
+              << "  coverage  [drones=2000] [seconds=60]\n"
+              << "  query     [drones=2000] [seconds=120]\n"
+              << "  stats     [drones=10000] [seconds=30]\n"
+              << "  write     [MB=1024] [recordKB=64]\n"
+              << "  memory    [drones...=1000 10000 100000]\n"
+              << "  snapshot  [drones=20000] [seconds=20]\n"
+              << "  faults    [scenarios=200] [drones=60] [seconds=40]\n"
+              << "  views     [drones=100000] [views=3]\n"
+              << "  tiles     [width=8192] [tileSize=256] [slots=64]\n"
+              << "  battery   [drones=2000] [seconds=150] [capacityWh=10]\n"
+              << "  scenario  [drones=1000000]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // --profile: sample the bench and pool threads, report at exit
+    if (argc > 1 && std::string(argv[1]) == "--profile")
+    {
+        if (sim::Profiler::instance().start(sim::Subsystem::Physics))
+            std::atexit([] { sim::Profiler::instance().stop(); });
+        --argc;
+        ++argv;
+    }
+    if (argc < 2) return usage();
+    std::string mode = argv[1];
+
+    if (mode == "multirate")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 2000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 60.0;
+        compareMultiRate("lab", 0, seconds);
+        compareMultiRate("spread", drones, seconds);
+        return 0;
+    }
+    if (mode == "quad")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 10000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+        benchDynamics(sim::Dynamics::PointMass, drones, seconds);
+        benchDynamics(sim::Dynamics::Quadrotor, drones, seconds);
+        return 0;
+    }
+    if (mode == "sensors")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 10000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+        benchSensors(drones, seconds);
+        return 0;
+    }
+    if (mode == "estimator")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 10000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 20.0;
+        benchEstimator(drones, seconds);
+        return 0;
+    }
+    if (mode == "comms")
+    {
+        int drones   = argc > 2 ? std::atoi(argv[2]) : 10000;
+        int messages = argc > 3 ? std::atoi(argv[3]) : 100000;
+        int ticks    = argc > 4 ? std::atoi(argv[4]) : 100;
+        benchComms(drones, messages, ticks);
+        return 0;
+    }
+    if (mode == "mpc")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 5000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 10.0;
+        benchMpc(drones, seconds);
+        return 0;
+    }
+    if (mode == "plan")
+    {
+        int drones = argc > 2 ? std::atoi(argv[2]) : 1000;
+        benchPlanner(drones);
+        return 0;
+    }
+    if (mode == "gains")
+    {
+        double seconds = argc > 2 ? std::atof(argv[2]) : 20.0;
+        benchGains(seconds);
+        return 0;
+    }
+    if (mode == "pick")
+    {
+        int drones = argc > 2 ? std::atoi(argv[2]) : 100000;
+        int rays   = argc > 3 ? std::atoi(argv[3]) : 2000;
+        benchPicking(drones, rays);
+        return 0;
+    }
+    if (mode == "trails")
+    {
+        int drones = argc > 2 ? std::atoi(argv[2]) : 10000;
+        int length = argc > 3 ? std::atoi(argv[3]) : 200;
+        int ticks  = argc > 4 ? std::atoi(argv[4]) : 500;
+        benchTrails(drones, length, ticks);
+        return 0;
+    }
+    if (mode == "coverage")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 2000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 60.0;
+        benchCoverage(drones, seconds);
+        return 0;
+    }
+    if (mode == "query")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 2000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 120.0;
+        benchQueries(drones, seconds);
+        return 0;
+    }
+    if (mode == "stats")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 10000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 30.0;
+        benchFlightStats(drones, seconds);
+        return 0;
+    }
+    if (mode == "write")
+    {
+        int mb      = argc > 2 ? std::atoi(argv[2]) : 1024;
+        int chunkKb = argc > 3 ? std::atoi(argv[3]) : 64;
+        benchWriter(mb, std::max(1, chunkKb));
+        return 0;
+    }
+    if (mode == "faults")
+    {
+        int scenarios  = argc > 2 ? std::atoi(argv[2]) : 200;
+        int drones     = argc > 3 ? std::atoi(argv[3]) : 60;
+        double seconds = argc > 4 ? std::atof(argv[4]) : 40.0;
+        benchFaults(scenarios, drones, seconds);
+        return 0;
+    }
+    if (mode == "snapshot")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 20000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 20.0;
+        benchSnapshot(drones, seconds);
+        return 0;
+    }
+    if (mode == "memory")
+    {
+        std::vector<int> sizes;
+        for (int i = 2; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+        if (sizes.empty()) sizes = { 1000, 10000, 100000 };
+        benchMemory(sizes);
+        return 0;
+    }
+    if (mode == "views")
+    {
+        int drones = argc > 2 ? std::atoi(argv[2]) : 100000;
+        int views  = argc > 3 ? std::atoi(argv[3]) : 3;
+        benchViews(std::max(drones, 1), std::max(views, 1));
+        return 0;
+    }
+    if (mode == "tiles")
+    {
+        int width    = argc > 2 ? std::atoi(argv[2]) : 8192;
+        int tileSize = argc > 3 ? std::atoi(argv[3]) : 256;
+        int slots    = argc > 4 ? std::atoi(argv[4]) : 64;
+        benchTiles(std::max(width, 64), std::max(tileSize, 16), std::max(slots, 4));
+        return 0;
+    }
+    if (mode == "battery")
+    {
+        int drones     = argc > 2 ? std::atoi(argv[2]) : 2000;
+        double seconds = argc > 3 ? std::atof(argv[3]) : 150.0;
+        double wh      = argc > 4 ? std::atof(argv[4]) : 10.0;
+        benchBattery(drones, seconds, wh);
+        return 0;
+    }
+    if (mode == "scenario")
+    {
+        int drones = argc > 2 ? std::atoi(argv[2]) : 1000000;
+        benchScenario(std::max(drones, 1));
+        return 0;
+    }
+
+    return usage();
+}
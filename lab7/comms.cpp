@@ -0,0 +1,215 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the simulated inter-drone radio.
+*/
+
+#include "comms.h"
+#include "rng.h"
+#include <algorithm>
+
+namespace sim
+{
+
+using control::Vec3;
+
+namespace
+{
+
+// Inbox order. Every message in an inbox has the same delivery tick, so
+// sender, send tick and sequence make the order independent of which
+// thread pushed first.
+bool sentBefore(const Message& a, const Message& b)
+{
+    if (a.from != b.from) return a.from < b.from;
+    if (a.sentTick != b.sentTick) return a.sentTick < b.sentTick;
+    return a.seq < b.seq;
+}
+
+} // namespace
+
+Comms::Node* Comms::Arena::alloc()
+{
+    size_t c = used / chunkSize;
+    if (c == chunks.size())
+    {
+        chunks.emplace_back(new Node[chunkSize]);
+    }
+    return &chunks[c][used++ % chunkSize];
+}
+
+Comms::Comms(const CommsConfig& c)
+    : cfg(c)
+{
+    cfg.latency = std::max(0, cfg.latency);
+    cfg.jitter  = std::max(0, cfg.jitter);
+    wheel = cfg.latency + cfg.jitter + 1;
+}
+
+Comms::~Comms() = default;
+
+void Comms::resize(size_t n)
+{
+    // Only between ticks, so nothing is in a mailbox
+    auto boxes = std::make_unique<std::atomic<Node*>[]>(n);
+    for (size_t i = 0; i < n; ++i) boxes[i].store(nullptr, std::memory_order_relaxed);
+    mailboxes = std::move(boxes);
+    buckets.resize(n * wheel);
+    inboxes.resize(n);
+    seqOut.resize(n, 0);
+}
+
+void Comms::beginTick(const std::vector<Vec3>& positions, uint64_t tick, unsigned slots)
+{
+    if (positions.size() != inboxes.size())
+    {
+        resize(positions.size());
+    }
+    if (arenas.size() < slots)
+    {
+        arenas.resize(slots);
+        stats.resize(slots);
+    }
+
+    pos = &positions;
+    tickNow = tick;
+    std::fill(seqOut.begin(), seqOut.end(), 0u);
+
+    // Cells twice the range: a broadcast looks at no more than 8 cells
+    grid.build(positions, 2.0 * cfg.range);
+}
+
+// Loss and jitter for one delivery are drawn from (sender, receiver,
+// tick, seq), so they do not depend on which thread sent the message
+void Comms::post(unsigned slot, uint32_t to, const Message& m, uint32_t draw0, uint32_t draw1)
+{
+    SlotStats& st = stats[slot];
+    ++st.sent;
+    if (toUniform(draw0) < cfg.loss)
+    {
+        ++st.dropped;
+        return;
+    }
+
+    Node* node = arenas[slot].alloc();
+    node->msg = m;
+    node->msg.deliverTick = m.sentTick + cfg.latency + draw1 % (cfg.jitter + 1);
+
+    // Treiber push; the mailbox is only popped in deliver()
+    std::atomic<Node*>& head = mailboxes[to];
+    node->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(node->next, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed))
+    {
+    }
+}
+
+void Comms::send(unsigned slot, uint32_t from, uint32_t to, uint32_t kind, const double data[3])
+{
+    Message m;
+    m.from = from;
+    m.kind = kind;
+    m.sentTick = tickNow;
+    m.seq = seqOut[from]++;
+    std::copy(data, data + 3, m.data);
+
+    if (control::distance((*pos)[from], (*pos)[to]) > cfg.range)
+    {
+        ++stats[slot].sent;
+        ++stats[slot].dropped;
+        return;
+    }
+
+    Philox4x32 r(from, cfg.seed, static_cast<uint32_t>(tickNow),
+                 static_cast<uint32_t>(tickNow >> 32), m.seq, to);
+    post(slot, to, m, r.v[0], r.v[1]);
+}
+
+void Comms::broadcast(unsigned slot, uint32_t from, uint32_t kind, const double data[3])
+{
+    Message m;
+    m.from = from;
+    m.kind = kind;
+    m.sentTick = tickNow;
+    m.seq = seqOut[from]++;
+    std::copy(data, data + 3, m.data);
+
+    const Vec3 p = (*pos)[from];
+    const double r2 = cfg.range * cfg.range;
+    grid.forEachWithin(p, cfg.range, [&](uint32_t to) {
+        if (to == from) return;
+        Vec3 d = (*pos)[to] - p;
+        if (d.x * d.x + d.y * d.y + d.z * d.z > r2) return;
+
+        Philox4x32 r(from, cfg.seed, static_cast<uint32_t>(tickNow),
+                     static_cast<uint32_t>(tickNow >> 32), m.seq, to);
+        post(slot, to, m, r.v[0], r.v[1]);
+    });
+}
+
+void Comms::deliver(ThreadPool& pool)
+{
+    const size_t n = inboxes.size();
+    if (stats.size() < pool.size())
+    {
+        arenas.resize(pool.size());
+        stats.resize(pool.size());
+    }
+
+    pool.parallelFor(n, [&](size_t b, size_t e, unsigned slot) {
+        uint64_t count = 0;
+        for (size_t i = b; i < e; ++i)
+        {
+            std::vector<Message>* q = &buckets[i * wheel];
+            Node* node = mailboxes[i].exchange(nullptr, std::memory_order_acquire);
+            for (; node; node = node->next)
+            {
+                q[node->msg.deliverTick % wheel].push_back(node->msg);
+            }
+
+            // This tick's bucket becomes the inbox
+            std::vector<Message>& in = inboxes[i];
+            in.clear();
+            in.swap(q[tickNow % wheel]);
+            std::sort(in.begin(), in.end(), sentBefore);
+            count += in.size();
+        }
+        stats[slot].delivered += count;
+    }, 256);
+
+    // Every node has been copied out; reuse the memory next tick
+    for (Arena& a : arenas) a.used = 0;
+}
+
+uint64_t Comms::sent() const
+{
+    uint64_t s = 0;
+    for (const SlotStats& st : stats) s += st.sent;
+    return s;
+}
+
+uint64_t Comms::dropped() const
+{
+    uint64_t s = 0;
+    for (const SlotStats& st : stats) s += st.dropped;
+    return s;
+}
+
+uint64_t Comms::delivered() const
+{
+    uint64_t s = 0;
+    for (const SlotStats& st : stats) s += st.delivered;
+    return s;
+}
+
+size_t Comms::inFlight() const
+{
+    size_t s = 0;
+    for (const auto& b : buckets) s += b.size();
+    return s;
+}
+
+} // namespace sim
@@ -0,0 +1,120 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Simulated inter-drone radio: unicast and range-limited broadcast with
+    latency, jitter and loss. Senders push into per-drone lock-free
+    mailboxes; each drone keeps a delivery-time queue.
+*/
+
+#pragma once
+#include "control.h"
+#include "spatial_grid.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sim {
+
+struct CommsConfig
+{
+    double   range   = 50.0;  // m, radio range for unicast and broadcast
+    int      latency = 2;     // ticks, minimum delay
+    int      jitter  = 3;     // extra ticks, uniform in [0, jitter]
+    double   loss    = 0.02;  // probability a single delivery is dropped
+    uint32_t seed    = 7;
+};
+
+struct Message
+{
+    uint32_t from = 0;
+    uint32_t kind = 0;          // application-defined
+    uint64_t sentTick    = 0;
+    uint64_t deliverTick = 0;
+    uint32_t seq  = 0;          // sender's message number within sentTick
+    double   data[3] = {};
+};
+
+class Comms
+{
+public:
+    explicit Comms(const CommsConfig& cfg = CommsConfig());
+    ~Comms();
+
+    Comms(const Comms&) = delete;
+    Comms& operator=(const Comms&) = delete;
+
+    // Start a tick: index drone positions for range checks. Sends are only
+    // allowed between beginTick and deliver, from any thread, as long as
+    // each drone's messages come from one thread at a time. `slot` is the
+    // caller's ThreadPool slot.
+    void beginTick(const std::vector<control::Vec3>& positions, uint64_t tick,
+                   unsigned slots);
+
+    void send(unsigned slot, uint32_t from, uint32_t to, uint32_t kind, const double data[3]);
+    // Every drone within range except the sender
+    void broadcast(unsigned slot, uint32_t from, uint32_t kind, const double data[3]);
+
+    // Move mailboxes into the delivery queues and publish everything due
+    // at the current tick into the inboxes. Call once every tick.
+    void deliver(ThreadPool& pool);
+
+    // Messages delivered by the last deliver(), ordered by
+    // (from, sentTick, seq) so the result does not depend on threads
+    const std::vector<Message>& inbox(size_t drone) const { return inboxes[drone]; }
+
+    size_t   size() const { return inboxes.size(); }
+    uint64_t sent() const;          // deliveries attempted
+    uint64_t dropped() const;       // lost or out of range
+    uint64_t delivered() const;
+    size_t   inFlight() const;      // queued, not yet due
+
+private:
+    struct Node
+    {
+        Message msg;
+        Node*   next;
+    };
+
+    // Bump allocator for one slot's nodes; memory is kept across ticks
+    struct Arena
+    {
+        static constexpr size_t chunkSize = 4096;
+        std::vector<std::unique_ptr<Node[]>> chunks;
+        size_t used = 0;
+        Node* alloc();
+    };
+
+    // Per-slot counters, on their own cache line
+    struct alignas(64) SlotStats
+    {
+        uint64_t sent = 0;
+        uint64_t dropped = 0;
+        uint64_t delivered = 0;
+    };
+
+    void resize(size_t n);
+    void post(unsigned slot, uint32_t to, const Message& m, uint32_t draw0, uint32_t draw1);
+
+    CommsConfig cfg;
+    const std::vector<control::Vec3>* pos = nullptr;
+    SpatialGrid grid;
+    uint64_t    tickNow = 0;
+
+    std::unique_ptr<std::atomic<Node*>[]> mailboxes;  // one lock-free stack per drone
+    // Delivery queue: delays are bounded by latency + jitter, so each
+    // drone's queue is a calendar of `wheel` buckets indexed by
+    // deliverTick % wheel, and a tick's bucket is exactly what is due
+    int wheel = 1;
+    std::vector<std::vector<Message>>     buckets;    // n * wheel
+    std::vector<std::vector<Message>>     inboxes;
+    std::vector<uint32_t>                 seqOut;     // per sender, reset each tick
+
+    std::vector<Arena>     arenas;
+    std::vector<SlotStats> stats;
+};
+
+} // namespace sim
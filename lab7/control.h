@@ -13,72 +13,101 @@ Description:
 namespace control 
 {
 
-struct Vec3 
+// The math below is templated on the scalar type T so the same control
+// law and integrator also run on Dual numbers (dual.h) for gradients.
+// Plain double is what everything else uses, under the usual names.
+template <typename T>
+struct Vec3T 
 {
-    double x, y, z;
+    T x, y, z;
 
-    Vec3(double x_=0, double y_=0, double z_=0) : x(x_), y(y_), z(z_) {}
+    Vec3T(T x_=T(0), T y_=T(0), T z_=T(0)) : x(x_), y(y_), z(z_) {}
 
-    Vec3 operator+(const Vec3& o) const { return Vec3(x+o.x, y+o.y, z+o.z); }
-    Vec3 operator-(const Vec3& o) const { return Vec3(x-o.x, y-o.y, z-o.z); }
-    Vec3 operator*(double s) const { return Vec3(x*s, y*s, z*s); }
-    Vec3 operator/(double s) const { return Vec3(x/s, y/s, z/s); }
+    // Widen e.g. a double vector to a Dual one (derivatives zero)
+    template <typename U>
+    explicit Vec3T(const Vec3T<U>& o) : x(o.x), y(o.y), z(o.z) {}
 
-    Vec3& operator+=(const Vec3& o) { x+=o.x; y+=o.y; z+=o.z; return *this; }
-    Vec3& operator-=(const Vec3& o) { x-=o.x; y-=o.y; z-=o.z; return *this; }
+    Vec3T operator+(const Vec3T& o) const { return Vec3T(x+o.x, y+o.y, z+o.z); }
+    Vec3T operator-(const Vec3T& o) const { return Vec3T(x-o.x, y-o.y, z-o.z); }
+    Vec3T operator*(const T& s) const { return Vec3T(x*s, y*s, z*s); }
+    Vec3T operator/(const T& s) const { return Vec3T(x/s, y/s, z/s); }
 
-    double dot(const Vec3& o) const { return x*o.x + y*o.y + z*o.z; }
+    Vec3T& operator+=(const Vec3T& o) { x+=o.x; y+=o.y; z+=o.z; return *this; }
+    Vec3T& operator-=(const Vec3T& o) { x-=o.x; y-=o.y; z-=o.z; return *this; }
 
-    double mag() const { return std::sqrt(x*x + y*y + z*z); }
+    T dot(const Vec3T& o) const { return x*o.x + y*o.y + z*o.z; }
 
-    Vec3 normalized() const 
+    T mag() const { using std::sqrt; return sqrt(x*x + y*y + z*z); }
+
+    Vec3T normalized() const 
     {
-        double m = mag();
-        if (m < 1e-8) return Vec3(0,0,0);
+        T m = mag();
+        if (m < 1e-8) return Vec3T(0,0,0);
         return *this / m;
     }
 };
 
-inline double distance(const Vec3& a, const Vec3& b) 
+using Vec3 = Vec3T<double>;
+
+template <typename T>
+inline T distance(const Vec3T<T>& a, const Vec3T<T>& b) 
 {
     return (a - b).mag();
 }
 
-class PIDController 
+template <typename T>
+class PIDControllerT 
 {
 public:
-    PIDController(double kp_=0, double ki_=0, double kd_=0,
-                  double integral_limit_=100.0, double output_limit_=100.0)
+    PIDControllerT(T kp_=T(0), T ki_=T(0), T kd_=T(0),
+                   double integral_limit_=100.0, double output_limit_=100.0)
         : kp(kp_), ki(ki_), kd(kd_),
           integral(0.0), prev_error(0.0),
           integral_limit(integral_limit_),
           output_limit(output_limit_) {}
 
-    void setGains(double p, double i, double d) 
+    // Same gains, limits and state in another scalar type
+    template <typename U>
+    explicit PIDControllerT(const PIDControllerT<U>& o)
+        : kp(o.kp), ki(o.ki), kd(o.kd),
+          integral(o.integral), prev_error(o.prev_error),
+          integral_limit(o.integral_limit),
+          output_limit(o.output_limit) {}
+
+    void setGains(T p, T i, T d) 
     {
         kp = p; ki = i; kd = d;
     }
 
-    double calculate(double error, double dt) 
+    void getGains(T& p, T& i, T& d) const
     {
-        if (dt <= 0.0) return 0.0;
+        p = kp; i = ki; d = kd;
+    }
+
+    // Internal state, for display
+    const T& getIntegral() const { return integral; }
+    const T& getPrevError() const { return prev_error; }
+
+    T calculate(const T& error, double dt) 
+    {
+        if (dt <= 0.0) return T(0.0);
 
         // P
-        double p_term = kp * error;
+        T p_term = kp * error;
 
         // I (with windup clamping)
         integral += error * dt;
-        integral = std::clamp(integral, -integral_limit, integral_limit);
-        double i_term = ki * integral;
+        integral = std::clamp(integral, T(-integral_limit), T(integral_limit));
+        T i_term = ki * integral;
 
         // D
-        double derivative = (error - prev_error) / dt;
-        double d_term = kd * derivative;
+        T derivative = (error - prev_error) / dt;
+        T d_term = kd * derivative;
 
         prev_error = error;
 
-        double out = p_term + i_term + d_term;
-        out = std::clamp(out, -output_limit, output_limit);
+        T out = p_term + i_term + d_term;
+        out = std::clamp(out, T(-output_limit), T(output_limit));
         return out;
     }
 
@@ -89,18 +118,24 @@ public:
     }
 
 private:
-    double kp, ki, kd;
-    double integral;
-    double prev_error;
+    template <typename U> friend class PIDControllerT;
+
+    T kp, ki, kd;
+    T integral;
+    T prev_error;
     double integral_limit;
     double output_limit;
 };
 
+using PIDController = PIDControllerT<double>;
+
 enum class Phase 
 {
     GroundWait,
     ClimbToCenter,
-    OnSphere
+    OnSphere,
+    ReturnHome,   // low battery: fly back over the launch pad and land
+    Landed        // back on the pad, motors off
 };
 
 // Helper: convert Phase to human-readable string
@@ -110,6 +145,8 @@ inline const char* phaseToString(Phase p)
         case Phase::GroundWait:   return "GroundWait";
         case Phase::ClimbToCenter: return "ClimbToCenter";
         case Phase::OnSphere:     return "OnSphere";
+        case Phase::ReturnHome:   return "ReturnHome";
+        case Phase::Landed:       return "Landed";
         default:                  return "Unknown";
     }
 }
@@ -123,43 +160,101 @@ struct ControlConfig
     double maxSpeed      = 10.0;  // m/s
 };
 
-struct ControlState 
+template <typename T>
+struct ControlStateT 
 {
     Phase  phase         = Phase::GroundWait;
     double timeInPhase   = 0.0;  // sec
     bool   visitedCenter = false;
 
     // For simple wandering on sphere
-    Vec3 tangentialDir = Vec3(1, 0, 0);
+    Vec3T<T> tangentialDir = Vec3T<T>(1, 0, 0);
+
+    // Planned climb (set by a path follower): fly towards climbTarget
+    // instead of the center. Reaching it ends the climb only when it is
+    // the drone's entry point on the sphere.
+    bool     plannedClimb       = false;
+    Vec3T<T> climbTarget;
+    bool     climbTargetIsEntry = false;
+
+    // Return-to-home: the launch pad, and the altitude to fly back at
+    Vec3T<T> home;
+    T        returnAltitude = T(0);
 };
 
-struct ControlPIDs 
+using ControlState = ControlStateT<double>;
+
+template <typename T>
+struct ControlPIDsT 
 {
-    PIDController radialPID;  // keep |r| ~ R
-    PIDController speedPID;   // keep speed within band
+    PIDControllerT<T> radialPID;  // keep |r| ~ R
+    PIDControllerT<T> speedPID;   // keep speed within band
 };
 
+using ControlPIDs = ControlPIDsT<double>;
+
+// Default gains used by every UAV
+inline ControlPIDs defaultPIDs()
+{
+    ControlPIDs pids;
+    pids.radialPID = PIDController(5, 1.0, 0.5, 100.0, 20.0);
+    pids.speedPID  = PIDController(0.8, 0.0, 10.0, 100.0, 10.0);
+    return pids;
+}
+
 // Utility: clamp a vector's magnitude
-inline Vec3 clampMagnitude(const Vec3& v, double maxMag) 
+template <typename T>
+inline Vec3T<T> clampMagnitude(const Vec3T<T>& v, double maxMag) 
 {
-    double m = v.mag();
+    T m = v.mag();
     if (m <= maxMag || m < 1e-8) return v;
     return v * (maxMag / m);
 }
 
-// Main control law: given position/velocity, update control state and return force
-inline Vec3 computeControlForce(
-    const Vec3& pos,
-    const Vec3& vel,
-    ControlState& state,
-    ControlPIDs& pids,
+// Start the return-to-home leg from wherever the drone is
+template <typename T>
+inline void beginReturnHome(const Vec3T<T>& pos, ControlStateT<T>& state, ControlPIDsT<T>& pids)
+{
+    state.phase = Phase::ReturnHome;
+    state.timeInPhase = 0.0;
+    state.returnAltitude = pos.z;
+    pids.radialPID.reset();
+    pids.speedPID.reset();
+}
+
+// Where a returning drone is heading: over the pad at its return
+// altitude, then straight down once within 1 m horizontally
+template <typename T>
+inline Vec3T<T> homeTarget(const Vec3T<T>& pos, const ControlStateT<T>& state)
+{
+    const T dx = state.home.x - pos.x, dy = state.home.y - pos.y;
+    const bool over = dx * dx + dy * dy < T(1.0);
+    return Vec3T<T>(state.home.x, state.home.y, over ? state.home.z : state.returnAltitude);
+}
+
+// Phase transitions, shared by every control law
+template <typename T>
+inline void advancePhase(
+    const Vec3T<T>& pos,
+    ControlStateT<T>& state,
+    ControlPIDsT<T>& pids,
     const ControlConfig& cfg,
     double dt
-) 
+)
 {
     state.timeInPhase += dt;
 
-    // Phase transitions
+    if (state.phase == Phase::ReturnHome)
+    {
+        const T dx = state.home.x - pos.x, dy = state.home.y - pos.y;
+        if (pos.z - state.home.z < 0.05 && dx * dx + dy * dy < T(1.0))
+        {
+            state.phase = Phase::Landed;
+            state.timeInPhase = 0.0;
+        }
+        return;
+    }
+
     if (state.phase == Phase::GroundWait) 
     {
         if (state.timeInPhase >= cfg.groundWait) 
@@ -169,14 +264,17 @@ inline Vec3 computeControlForce(
         } 
         else 
         {
-            // Sit on ground: motors off (ground reaction balances gravity)
-            return Vec3(0, 0, 0);
+            return;
         }
     }
 
     if (state.phase == Phase::ClimbToCenter) 
     {
-        double dCenter = distance(pos, cfg.center);
+        T dCenter = distance(pos, Vec3T<T>(cfg.center));
+        if (state.plannedClimb)
+        {
+            dCenter = state.climbTargetIsEntry ? distance(pos, state.climbTarget) : T(1e9);
+        }
         if (dCenter < 2.0) 
         { // "close enough"
             state.phase = Phase::OnSphere;
@@ -186,21 +284,47 @@ inline Vec3 computeControlForce(
             pids.speedPID.reset();
         }
     }
+}
+
+// Main control law: given position/velocity, update control state and return force
+template <typename T>
+inline Vec3T<T> computeControlForce(
+    const Vec3T<T>& pos,
+    const Vec3T<T>& vel,
+    ControlStateT<T>& state,
+    ControlPIDsT<T>& pids,
+    const ControlConfig& cfg,
+    double dt
+) 
+{
+    using Vec3 = Vec3T<T>;
+
+    advancePhase(pos, state, pids, cfg, dt);
+
+    if (state.phase == Phase::GroundWait || state.phase == Phase::Landed) 
+    {
+        // Sit on ground: motors off (ground reaction balances gravity)
+        return Vec3(0, 0, 0);
+    }
 
     // Shared geometry
-    Vec3 toCenter = cfg.center - pos;
-    double r      = toCenter.mag();
+    Vec3 toCenter = Vec3(cfg.center) - pos;
+    T r           = toCenter.mag();
     Vec3 radialDir = toCenter.normalized();
 
-    if (state.phase == Phase::ClimbToCenter) 
+    if (state.phase == Phase::ClimbToCenter || state.phase == Phase::ReturnHome) 
     {
-        // Simple "go to center" behaviour (radial PID towards center)
-        double radialError = r; // want r -> 0
-        double radialAccel = pids.radialPID.calculate(radialError, dt);
-        Vec3 force = radialDir * radialAccel;
+        // Simple "go to center" behaviour (radial PID towards center,
+        // or towards the current waypoint of a planned climb); the
+        // return leg flies the same law towards the pad
+        Vec3 toTarget = state.phase == Phase::ReturnHome ? homeTarget(pos, state) - pos
+                      : state.plannedClimb ? state.climbTarget - pos : toCenter;
+        T radialError = toTarget.mag(); // want r -> 0
+        T radialAccel = pids.radialPID.calculate(radialError, dt);
+        Vec3 force = toTarget.normalized() * radialAccel;
 
         // Also lightly limit speed ≤ 2 m/s by damping when too fast
-        double speed = vel.mag();
+        T speed = vel.mag();
         if (speed > 2.0) 
         {
             force -= vel.normalized() * (0.5 * (speed - 2.0));
@@ -211,8 +335,8 @@ inline Vec3 computeControlForce(
 
     // Phase::OnSphere
     // --- radial control: keep |r| ≈ R ---
-    double radialError = r - cfg.sphereRadius; // want this = 0
-    double radialOut   = pids.radialPID.calculate(radialError, dt);
+    T radialError = r - cfg.sphereRadius; // want this = 0
+    T radialOut   = pids.radialPID.calculate(radialError, dt);
     Vec3 radialForce   = radialDir * (-radialOut); // push inward if outside
 
     // --- tangential wandering on sphere ---
@@ -227,10 +351,10 @@ inline Vec3 computeControlForce(
     tangent = tangent.normalized();
     state.tangentialDir = tangent; // could be randomized over time
 
-    double speed = vel.mag();
+    T speed = vel.mag();
     double targetSpeed = 0.5 * (cfg.minSpeed + cfg.maxSpeed); // mid-band
-    double speedError  = targetSpeed - speed;
-    double speedOut    = pids.speedPID.calculate(speedError, dt);
+    T speedError       = targetSpeed - speed;
+    T speedOut         = pids.speedPID.calculate(speedError, dt);
 
     Vec3 tangentialForce = tangent * speedOut;
 
@@ -0,0 +1,178 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the mission-sphere coverage grid.
+*/
+
+#include "coverage.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+namespace
+{
+const double TwoPi = 6.283185307179586;
+}
+
+void SphereCoverage::configure(const control::Vec3& c, double r, const CoverageConfig& config)
+{
+    center = c;
+    radius = r;
+    cfg = config;
+    cfg.bands   = std::max(1, cfg.bands);
+    cfg.sectors = std::max(1, cfg.sectors);
+
+    const size_t n = static_cast<size_t>(cfg.bands) * cfg.sectors;
+    dwell.assign(n, 0);
+    lastSeen.assign(n, 0.0);
+    seen.assign(n, 0);
+    tickCount.assign(n, 0);
+    occupiedNow.clear();
+    partials.clear();
+    reset();
+}
+
+void SphereCoverage::reset()
+{
+    std::fill(dwell.begin(), dwell.end(), 0u);
+    std::fill(seen.begin(), seen.end(), uint8_t(0));
+    occupiedNow.clear();
+    anyUpdate    = false;
+    dwellMax     = 0;
+    visitedCells = 0;
+    samples      = 0;
+    revisits     = 0;
+    revisitSum   = 0.0;
+    revisitMax   = 0.0;
+}
+
+int SphereCoverage::cellOf(const control::Vec3& p) const
+{
+    control::Vec3 d = p - center;
+    double len = d.mag();
+    if (len <= 0.0) return 0;
+
+    double z = std::clamp(d.z / len, -1.0, 1.0);
+    double phi = std::atan2(d.y, d.x);
+    if (phi < 0.0) phi += TwoPi;
+
+    int b = std::min(cfg.bands - 1, static_cast<int>((z + 1.0) * 0.5 * cfg.bands));
+    int s = std::min(cfg.sectors - 1, static_cast<int>(phi / TwoPi * cfg.sectors));
+    return b * cfg.sectors + s;
+}
+
+void SphereCoverage::cellBounds(int c, double& z0, double& z1, double& phi0, double& phi1) const
+{
+    const int b = c / cfg.sectors, s = c % cfg.sectors;
+    z0   = -1.0 + 2.0 * b / cfg.bands;
+    z1   = -1.0 + 2.0 * (b + 1) / cfg.bands;
+    phi0 = TwoPi * s / cfg.sectors;
+    phi1 = TwoPi * (s + 1) / cfg.sectors;
+}
+
+void SphereCoverage::binRange(const std::vector<control::Vec3>& positions,
+                              const std::vector<uint8_t>& onSphere,
+                              size_t begin, size_t end, Partial& part) const
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (!onSphere[i]) continue;
+        int c = cellOf(positions[i]);
+        if (part.count[c]++ == 0) part.touched.push_back(c);
+    }
+}
+
+void SphereCoverage::update(double time, const std::vector<control::Vec3>& positions,
+                            const std::vector<uint8_t>& onSphere)
+{
+    if (partials.empty()) partials.resize(1);
+    Partial& part = partials[0];
+    if (part.count.size() != cells()) part.count.assign(cells(), 0);
+
+    binRange(positions, onSphere, 0, std::min(positions.size(), onSphere.size()), part);
+    merge(time, 1);
+}
+
+void SphereCoverage::update(double time, const std::vector<control::Vec3>& positions,
+                            const std::vector<uint8_t>& onSphere, ThreadPool& pool)
+{
+    if (partials.size() < pool.size()) partials.resize(pool.size());
+    for (Partial& part : partials)
+    {
+        if (part.count.size() != cells()) part.count.assign(cells(), 0);
+    }
+
+    const size_t n = std::min(positions.size(), onSphere.size());
+    pool.parallelFor(n, [&](size_t b, size_t e, unsigned slot) {
+        binRange(positions, onSphere, b, e, partials[slot]);
+    }, 4096);
+    merge(time, pool.size());
+}
+
+// Fold the slots' partial histograms into this update's counts, then
+// update per-cell history for the occupied cells only
+void SphereCoverage::merge(double time, size_t slots)
+{
+    occupiedNow.clear();
+    for (size_t k = 0; k < slots && k < partials.size(); ++k)
+    {
+        Partial& part = partials[k];
+        for (uint32_t c : part.touched)
+        {
+            if (tickCount[c] == 0) occupiedNow.push_back(c);
+            tickCount[c] += part.count[c];
+            part.count[c] = 0;
+        }
+        part.touched.clear();
+    }
+
+    for (uint32_t c : occupiedNow)
+    {
+        const uint32_t cnt = tickCount[c];
+        tickCount[c] = 0;
+        samples += cnt;
+        dwell[c] += cnt;
+        dwellMax = std::max(dwellMax, dwell[c]);
+
+        if (!seen[c])
+        {
+            seen[c] = 1;
+            ++visitedCells;
+        }
+        else if (!anyUpdate || lastSeen[c] != lastUpdate)
+        {
+            // Empty on the previous update: a return to the cell
+            double gap = time - lastSeen[c];
+            ++revisits;
+            revisitSum += gap;
+            revisitMax = std::max(revisitMax, gap);
+        }
+        lastSeen[c] = time;
+    }
+
+    lastUpdate = time;
+    anyUpdate = true;
+}
+
+CoverageStats SphereCoverage::stats() const
+{
+    CoverageStats s;
+    s.cells       = cells();
+    s.visited     = visitedCells;
+    s.occupied    = occupiedNow.size();
+    s.samples     = samples;
+    s.revisits    = revisits;
+    s.meanRevisit = revisits ? revisitSum / revisits : 0.0;
+    s.maxRevisit  = revisitMax;
+    for (size_t c = 0; c < cells(); ++c)
+    {
+        if (seen[c]) s.maxGap = std::max(s.maxGap, lastUpdate - lastSeen[c]);
+    }
+    return s;
+}
+
+} // namespace sim
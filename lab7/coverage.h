@@ -0,0 +1,108 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Mission-sphere coverage: an equal-area occupancy grid on the sphere,
+    updated incrementally from the drones flying on it, with running
+    coverage and revisit statistics.
+*/
+
+#pragma once
+#include "control.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Cells are `bands` equal-height slices in z times `sectors` equal slices
+// in azimuth. Slices of equal height cut equal areas off a sphere
+// (Archimedes), so every cell has the same area; cells get narrow
+// towards the poles.
+struct CoverageConfig
+{
+    int bands   = 24;
+    int sectors = 48;
+};
+
+struct CoverageStats
+{
+    size_t   cells       = 0;
+    size_t   visited     = 0;    // cells occupied at least once
+    size_t   occupied    = 0;    // cells occupied on the last update
+    uint64_t samples     = 0;    // drone positions binned so far
+    uint64_t revisits    = 0;    // returns to a cell after it was left empty
+    double   meanRevisit = 0.0;  // s from last seen to the return
+    double   maxRevisit  = 0.0;
+    double   maxGap      = 0.0;  // s the stalest visited cell has been empty
+
+    double fraction() const { return cells ? double(visited) / cells : 0.0; }
+};
+
+class SphereCoverage
+{
+public:
+    void configure(const control::Vec3& center, double radius,
+                   const CoverageConfig& cfg = CoverageConfig());
+    // Forget everything seen so far (same cells)
+    void reset();
+
+    size_t cells() const { return dwell.size(); }
+    int bands()   const { return cfg.bands; }
+    int sectors() const { return cfg.sectors; }
+
+    // Cell of the direction from the center to p (radial distance ignored)
+    int cellOf(const control::Vec3& p) const;
+    // Cell c covers z in [z0, z1] of the unit sphere and azimuth [phi0, phi1)
+    void cellBounds(int c, double& z0, double& z1, double& phi0, double& phi1) const;
+
+    // Bin one tick: every drone with onSphere[i] != 0 (Phase::OnSphere).
+    // The pooled version bins into one partial histogram per pool slot
+    // and merges only the cells the slots touched.
+    void update(double time, const std::vector<control::Vec3>& positions,
+                const std::vector<uint8_t>& onSphere);
+    void update(double time, const std::vector<control::Vec3>& positions,
+                const std::vector<uint8_t>& onSphere, ThreadPool& pool);
+
+    // Drone-ticks spent in each cell, and the largest of them
+    const std::vector<uint32_t>& dwellTicks() const { return dwell; }
+    uint32_t maxDwell() const { return dwellMax; }
+
+    // Counters are running; maxGap is a scan over the cells
+    CoverageStats stats() const;
+
+private:
+    struct Partial
+    {
+        std::vector<uint32_t> count;    // per cell, zero outside a tick
+        std::vector<uint32_t> touched;  // cells with count != 0
+    };
+
+    void binRange(const std::vector<control::Vec3>& positions,
+                  const std::vector<uint8_t>& onSphere,
+                  size_t begin, size_t end, Partial& part) const;
+    void merge(double time, size_t slots);
+
+    control::Vec3  center;
+    double         radius = 1.0;
+    CoverageConfig cfg;
+
+    std::vector<uint32_t> dwell;
+    std::vector<double>   lastSeen;    // time of the last update it was occupied
+    std::vector<uint8_t>  seen;
+    std::vector<uint32_t> tickCount;   // merged counts of the current update
+    std::vector<uint32_t> occupiedNow;
+    std::vector<Partial>  partials;    // one per pool slot
+
+    double   lastUpdate  = 0.0;
+    bool     anyUpdate   = false;
+    uint32_t dwellMax    = 0;
+    size_t   visitedCells = 0;
+    uint64_t samples     = 0;
+    uint64_t revisits    = 0;
+    double   revisitSum  = 0.0;
+    double   revisitMax  = 0.0;
+};
+
+} // namespace sim
@@ -0,0 +1,117 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Forward-mode automatic differentiation: a value carried together
+    with its derivatives with respect to N inputs.
+*/
+
+#pragma once
+#include <cmath>
+
+namespace control {
+
+// value + sum_k d[k] * eps_k. Every operation updates all N derivatives
+// with the same scalar factors, so the loops over k vectorise (the omp
+// simd hints need -fopenmp-simd, as the swarm engine is built).
+template <int N>
+struct Dual
+{
+    double v;
+    double d[N];
+
+    Dual(double value = 0.0) : v(value)
+    {
+        for (int k = 0; k < N; ++k) d[k] = 0.0;
+    }
+
+    // Input number k: derivative 1 with respect to itself
+    static Dual variable(double value, int k)
+    {
+        Dual r(value);
+        r.d[k] = 1.0;
+        return r;
+    }
+
+    Dual& operator+=(const Dual& o)
+    {
+        v += o.v;
+        #pragma omp simd
+        for (int k = 0; k < N; ++k) d[k] += o.d[k];
+        return *this;
+    }
+    Dual& operator-=(const Dual& o)
+    {
+        v -= o.v;
+        #pragma omp simd
+        for (int k = 0; k < N; ++k) d[k] -= o.d[k];
+        return *this;
+    }
+    Dual& operator*=(const Dual& o)
+    {
+        #pragma omp simd
+        for (int k = 0; k < N; ++k) d[k] = d[k] * o.v + v * o.d[k];
+        v *= o.v;
+        return *this;
+    }
+    Dual& operator/=(const Dual& o)
+    {
+        const double inv = 1.0 / o.v;
+        v *= inv;
+        #pragma omp simd
+        for (int k = 0; k < N; ++k) d[k] = (d[k] - v * o.d[k]) * inv;
+        return *this;
+    }
+};
+
+template <int N> Dual<N> operator+(Dual<N> a, const Dual<N>& b) { return a += b; }
+template <int N> Dual<N> operator-(Dual<N> a, const Dual<N>& b) { return a -= b; }
+template <int N> Dual<N> operator*(Dual<N> a, const Dual<N>& b) { return a *= b; }
+template <int N> Dual<N> operator/(Dual<N> a, const Dual<N>& b) { return a /= b; }
+
+template <int N> Dual<N> operator+(Dual<N> a, double b) { a.v += b; return a; }
+template <int N> Dual<N> operator+(double a, Dual<N> b) { b.v += a; return b; }
+template <int N> Dual<N> operator-(Dual<N> a, double b) { a.v -= b; return a; }
+template <int N> Dual<N> operator-(double a, const Dual<N>& b) { return Dual<N>(a) - b; }
+
+template <int N> Dual<N> operator*(Dual<N> a, double s)
+{
+    a.v *= s;
+    #pragma omp simd
+    for (int k = 0; k < N; ++k) a.d[k] *= s;
+    return a;
+}
+template <int N> Dual<N> operator*(double s, const Dual<N>& a) { return a * s; }
+template <int N> Dual<N> operator/(const Dual<N>& a, double s) { return a * (1.0 / s); }
+template <int N> Dual<N> operator/(double a, const Dual<N>& b) { return Dual<N>(a) / b; }
+
+template <int N> Dual<N> operator-(const Dual<N>& a) { return a * -1.0; }
+
+// Comparisons look at the value only (branches are not differentiated)
+template <int N> bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.v < b.v; }
+template <int N> bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.v > b.v; }
+template <int N> bool operator<=(const Dual<N>& a, const Dual<N>& b) { return a.v <= b.v; }
+template <int N> bool operator>=(const Dual<N>& a, const Dual<N>& b) { return a.v >= b.v; }
+template <int N> bool operator<(const Dual<N>& a, double b) { return a.v < b; }
+template <int N> bool operator>(const Dual<N>& a, double b) { return a.v > b; }
+template <int N> bool operator<=(const Dual<N>& a, double b) { return a.v <= b; }
+template <int N> bool operator>=(const Dual<N>& a, double b) { return a.v >= b; }
+
+template <int N>
+Dual<N> sqrt(const Dual<N>& a)
+{
+    Dual<N> r;
+    r.v = std::sqrt(a.v);
+    // d sqrt(x) = dx / (2 sqrt(x)); zero at 0 instead of infinite
+    const double s = r.v > 0.0 ? 0.5 / r.v : 0.0;
+    #pragma omp simd
+    for (int k = 0; k < N; ++k) r.d[k] = a.d[k] * s;
+    return r;
+}
+
+// Plain value of a scalar, with or without derivatives
+inline double value(double a) { return a; }
+template <int N> double value(const Dual<N>& a) { return a.v; }
+
+} // namespace control
@@ -0,0 +1,189 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the batched state estimator.
+*/
+
+#include "estimator.h"
+
+namespace sim
+{
+
+using control::Vec3;
+
+namespace
+{
+
+// Pointers into one Axis, so the kernels can take them as restrict
+struct AxisPtrs
+{
+    double *p, *v, *a, *P00, *P01, *P02, *P11, *P12, *P22;
+};
+
+AxisPtrs ptrs(StateEstimator::Axis& ax)
+{
+    return { ax.p.data(), ax.v.data(), ax.a.data(), ax.P00.data(), ax.P01.data(),
+             ax.P02.data(), ax.P11.data(), ax.P12.data(), ax.P22.data() };
+}
+
+// x <- F x, P <- F P F^T + Q with F the constant-acceleration transition
+void predictKernel(size_t begin, size_t end, double dt, const double* Q,
+                   double* __restrict p, double* __restrict v, double* __restrict a,
+                   double* __restrict P00, double* __restrict P01, double* __restrict P02,
+                   double* __restrict P11, double* __restrict P12, double* __restrict P22)
+{
+    const double h = 0.5 * dt * dt;
+    const double q0 = Q[0], q1 = Q[1], q2 = Q[2], q3 = Q[3], q4 = Q[4], q5 = Q[5];
+    for (size_t i = begin; i < end; ++i)
+    {
+        p[i] += v[i] * dt + a[i] * h;
+        v[i] += a[i] * dt;
+
+        double A00 = P00[i] + dt * P01[i] + h * P02[i];
+        double A01 = P01[i] + dt * P11[i] + h * P12[i];
+        double A02 = P02[i] + dt * P12[i] + h * P22[i];
+        double A11 = P11[i] + dt * P12[i];
+        double A12 = P12[i] + dt * P22[i];
+
+        P00[i] = A00 + dt * A01 + h * A02 + q0;
+        P01[i] = A01 + dt * A02 + q1;
+        P02[i] = A02 + q2;
+        P11[i] = A11 + dt * A12 + q3;
+        P12[i] = A12 + q4;
+        P22[i] += q5;
+    }
+}
+
+// Scalar measurement m = h0 p + h1 v + h2 a + offset + noise(r). Rows
+// with h1, h2 != 0 refer a delayed reading back to the time it was taken.
+void updateKernel(size_t begin, size_t end, double h0, double h1, double h2,
+                  double offset, double r, const double* __restrict m,
+                  double* __restrict p, double* __restrict v, double* __restrict a,
+                  double* __restrict P00, double* __restrict P01, double* __restrict P02,
+                  double* __restrict P11, double* __restrict P12, double* __restrict P22)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        // P H^T
+        double c0 = P00[i] * h0 + P01[i] * h1 + P02[i] * h2;
+        double c1 = P01[i] * h0 + P11[i] * h1 + P12[i] * h2;
+        double c2 = P02[i] * h0 + P12[i] * h1 + P22[i] * h2;
+        double invS = 1.0 / (h0 * c0 + h1 * c1 + h2 * c2 + r);
+
+        double innov = m[i] - offset - (h0 * p[i] + h1 * v[i] + h2 * a[i]);
+        double k0 = c0 * invS, k1 = c1 * invS, k2 = c2 * invS;
+        p[i] += k0 * innov;
+        v[i] += k1 * innov;
+        a[i] += k2 * innov;
+
+        // P <- P - K (P H^T)^T
+        P00[i] -= k0 * c0;
+        P01[i] -= k0 * c1;
+        P02[i] -= k0 * c2;
+        P11[i] -= k1 * c1;
+        P12[i] -= k1 * c2;
+        P22[i] -= k2 * c2;
+    }
+}
+
+void predictAxis(size_t b, size_t e, double dt, const double* Q, AxisPtrs x)
+{
+    predictKernel(b, e, dt, Q, x.p, x.v, x.a, x.P00, x.P01, x.P02, x.P11, x.P12, x.P22);
+}
+
+void updateAxis(size_t b, size_t e, double h0, double h1, double h2, double offset,
+                double r, const std::vector<double>& m, AxisPtrs x)
+{
+    updateKernel(b, e, h0, h1, h2, offset, r, m.data(),
+                 x.p, x.v, x.a, x.P00, x.P01, x.P02, x.P11, x.P12, x.P22);
+}
+
+} // namespace
+
+void StateEstimator::Axis::reset(size_t n, double pv, double vv, double av)
+{
+    for (auto* f : { &p, &v, &a, &P01, &P02, &P12 })
+    {
+        f->assign(n, 0.0);
+    }
+    P00.assign(n, pv);
+    P11.assign(n, vv);
+    P22.assign(n, av);
+}
+
+void StateEstimator::configure(const EstimatorConfig& cfg, const SensorConfig& sensors,
+                               double tickDt, double g, const std::vector<Vec3>& start)
+{
+    ecfg = cfg;
+    scfg = sensors;
+    dt = tickDt;
+    gravity = g;
+
+    // Discretised white-jerk noise
+    const double q = cfg.jerkNoise;
+    const double d2 = dt * dt, d3 = d2 * dt;
+    Q[0] = q * d3 * d2 / 20;
+    Q[1] = q * d2 * d2 / 8;
+    Q[2] = q * d3 / 6;
+    Q[3] = q * d3 / 3;
+    Q[4] = q * d2 / 2;
+    Q[5] = q * dt;
+
+    auto sq = [](double s) { return s * s; };
+    rAcc    = sq(sensors.accelNoise) + sq(sensors.accelBias);
+    rGpsPos = sq(sensors.gpsNoise);
+    rGpsVel = sq(sensors.gpsVelNoise);
+    rBaro   = sq(sensors.baroNoise) + sq(sensors.baroBias);
+
+    const size_t n = start.size();
+    for (Axis* ax : { &x, &y, &z })
+    {
+        ax->reset(n, cfg.initPosVar, cfg.initVelVar, cfg.initAccVar);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        x.p[i] = start[i].x;
+        y.p[i] = start[i].y;
+        z.p[i] = start[i].z;
+    }
+}
+
+void StateEstimator::update(size_t b, size_t e, uint64_t tick, const SensorSuite& s)
+{
+    AxisPtrs px = ptrs(x), py = ptrs(y), pz = ptrs(z);
+
+    predictAxis(b, e, dt, Q, px);
+    predictAxis(b, e, dt, Q, py);
+    predictAxis(b, e, dt, Q, pz);
+
+    // Accelerometer: specific force, so remove gravity on z
+    if (s.imuDue(tick))
+    {
+        updateAxis(b, e, 0, 0, 1, 0.0, rAcc, s.imuAx, px);
+        updateAxis(b, e, 0, 0, 1, 0.0, rAcc, s.imuAy, py);
+        updateAxis(b, e, 0, 0, 1, gravity, rAcc, s.imuAz, pz);
+    }
+
+    // GPS: the fix describes the state gpsDelay ticks ago
+    if (s.gpsDue(tick))
+    {
+        const double tau = scfg.gpsDelay * dt;
+        const double h = 0.5 * tau * tau;
+        updateAxis(b, e, 1, -tau, h, 0.0, rGpsPos, s.gpsX, px);
+        updateAxis(b, e, 1, -tau, h, 0.0, rGpsPos, s.gpsY, py);
+        updateAxis(b, e, 1, -tau, h, 0.0, rGpsPos, s.gpsZ, pz);
+        updateAxis(b, e, 0, 1, -tau, 0.0, rGpsVel, s.gpsVx, px);
+        updateAxis(b, e, 0, 1, -tau, 0.0, rGpsVel, s.gpsVy, py);
+        updateAxis(b, e, 0, 1, -tau, 0.0, rGpsVel, s.gpsVz, pz);
+    }
+
+    if (s.baroDue(tick))
+    {
+        const double tau = scfg.baroDelay * dt;
+        updateAxis(b, e, 1, -tau, 0.5 * tau * tau, 0.0, rBaro, s.baroZ, pz);
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,66 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Batched constant-acceleration Kalman filter: one per drone and axis,
+    fed by the simulated IMU, GPS and barometer.
+*/
+
+#pragma once
+#include "control.h"
+#include "sensors.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+struct EstimatorConfig
+{
+    double jerkNoise = 400.0;   // (m/s^3)^2 / Hz, white-jerk process noise
+    double initPosVar = 0.01;   // m^2, start position is the known pad
+    double initVelVar = 0.01;   // (m/s)^2
+    double initAccVar = 1.0;    // (m/s^2)^2
+};
+
+class StateEstimator
+{
+public:
+    // Reset every filter to rest at the given positions
+    void configure(const EstimatorConfig& cfg, const SensorConfig& sensors,
+                   double dt, double gravity, const std::vector<control::Vec3>& start);
+
+    // Predict drones [begin, end) over one tick, then fold in whatever
+    // readings `s` delivered at `tick`. Disjoint ranges may run in parallel.
+    void update(size_t begin, size_t end, uint64_t tick, const SensorSuite& s);
+
+    size_t size() const { return x.p.size(); }
+    control::Vec3 position(size_t i) const { return control::Vec3(x.p[i], y.p[i], z.p[i]); }
+    control::Vec3 velocity(size_t i) const { return control::Vec3(x.v[i], y.v[i], z.v[i]); }
+    control::Vec3 acceleration(size_t i) const { return control::Vec3(x.a[i], y.a[i], z.a[i]); }
+
+    // One axis for all drones: state (p, v, a) and the upper triangle of
+    // its 3 x 3 covariance, one array per entry
+    struct Axis
+    {
+        std::vector<double> p, v, a;
+        std::vector<double> P00, P01, P02, P11, P12, P22;
+        void reset(size_t n, double pv, double vv, double av);
+    };
+    const Axis& axis(int k) const { return k == 0 ? x : k == 1 ? y : z; }
+
+private:
+    EstimatorConfig ecfg;
+    SensorConfig    scfg;
+    double dt = 0.01;
+    double gravity = 10.0;
+    double Q[6] = {};     // process noise, same upper-triangle order as P
+
+    // Measurement variances (white noise plus the unmodelled fixed bias)
+    double rAcc = 0.0, rGpsPos = 0.0, rGpsVel = 0.0, rBaro = 0.0;
+
+    Axis x, y, z;
+};
+
+} // namespace sim
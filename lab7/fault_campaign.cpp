@@ -0,0 +1,193 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for Monte Carlo fault-injection campaigns.
+*/
+
+#include "fault_campaign.h"
+#include "rng.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace sim
+{
+
+using control::Vec3;
+using control::Phase;
+
+namespace
+{
+
+// Shared sphere over a 3 m ground grid; take-offs staggered over four
+// missions and pads jittered by up to 0.5 m so seeds differ
+void defaultScenario(Swarm& swarm, int drones, uint64_t seed)
+{
+    uint32_t m[4];
+    for (int k = 0; k < 4; ++k)
+    {
+        control::ControlConfig cfg;
+        cfg.center = Vec3(0, 0, 50);
+        cfg.sphereRadius = 10.0;
+        cfg.groundWait = 2.0 + 2.0 * k;
+        m[k] = swarm.addMission(cfg);
+    }
+    const int cols = static_cast<int>(std::ceil(std::sqrt(std::max(1, drones))));
+    for (int k = 0; k < drones; ++k)
+    {
+        Philox4x32 r(static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                     static_cast<uint32_t>(k), 0x5CE7u, 0, 0);
+        const double jx = toUniform(r.v[0]) - 0.5, jy = toUniform(r.v[1]) - 0.5;
+        swarm.addDrone(Vec3(3.0 * (k % cols - cols / 2) + jx, 3.0 * (k / cols - cols / 2) + jy, 0.0),
+                       m[r.v[2] & 3u]);
+    }
+}
+
+} // namespace
+
+ScenarioResult runScenario(const CampaignConfig& cfg, uint64_t seed)
+{
+    SwarmConfig sc = cfg.swarm;
+    sc.threads = 1;
+    Swarm swarm(sc), reference(sc);
+    for (Swarm* s : { &swarm, &reference })
+    {
+        if (cfg.build) cfg.build(*s, seed);
+        else           defaultScenario(*s, cfg.drones, seed);
+    }
+
+    const size_t n = swarm.size();
+    RandomFaults rf = cfg.faults;
+    rf.seed = seed;
+    swarm.faultModel().scheduleRandom(n, rf, sc.dt);
+    const FaultModel& fm = swarm.faultModel();
+
+    ScenarioResult res;
+    res.seed = seed;
+    std::vector<uint8_t>  airborne(n, 0), downed(n, 0), recovered(n, 0), disturbed(n, 0);
+    std::vector<uint64_t> inBandSince(n, UINT64_MAX);
+    const uint64_t holdTicks = static_cast<uint64_t>(std::ceil(cfg.recoveryHold / sc.dt));
+    uint64_t firstFault = UINT64_MAX, collisionsAtFault = 0;
+
+    const int ticks = static_cast<int>(cfg.seconds / sc.dt);
+    for (int t = 0; t < ticks; ++t)
+    {
+        const uint64_t before = swarm.collisions();
+        swarm.step();
+        reference.step();
+        const uint64_t tick = swarm.tick();
+        if (firstFault == UINT64_MAX && fm.active() > 0)
+        {
+            firstFault = tick;
+            collisionsAtFault = before;
+        }
+        if (firstFault == UINT64_MAX) continue;
+
+        const std::vector<Vec3>& pos = swarm.positions();
+        const std::vector<Vec3>& ref = reference.positions();
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (fm.kind[i] == FaultKind::None)
+            {
+                disturbed[i] |= (pos[i] - ref[i]).mag() > cfg.disturbBand;
+                continue;
+            }
+
+            airborne[i] |= pos[i].z > 0.5;
+            if (airborne[i] && pos[i].z < 0.05) downed[i] = 1;
+            if (recovered[i] || downed[i] || fm.kind[i] == FaultKind::Freeze) continue;
+
+            const Vec3& c = swarm.missionOf(i).center;
+            if (std::fabs((pos[i] - c).mag() - (ref[i] - c).mag()) < cfg.recoveryBand)
+            {
+                if (inBandSince[i] == UINT64_MAX) inBandSince[i] = tick;
+                if (tick - inBandSince[i] >= holdTicks)
+                {
+                    recovered[i] = 1;
+                    res.recoverySum += (inBandSince[i] - std::min(inBandSince[i], fm.faultTick[i])) * sc.dt;
+                }
+            }
+            else
+            {
+                inBandSince[i] = UINT64_MAX;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int k = static_cast<int>(fm.kind[i]);
+        if (fm.kind[i] == FaultKind::None)
+        {
+            res.disturbed += disturbed[i];
+            continue;
+        }
+        ++res.faulted;
+        ++res.faultedByKind[k];
+        res.downed += downed[i];
+        res.downedByKind[k] += downed[i];
+        res.recovered += recovered[i];
+        res.recoveredByKind[k] += recovered[i];
+    }
+    res.collisions = swarm.collisions();
+    res.collisionsAfter = firstFault == UINT64_MAX ? 0 : res.collisions - collisionsAtFault;
+    res.referenceCollisions = reference.collisions();
+    return res;
+}
+
+CampaignSummary runCampaign(const CampaignConfig& cfg, std::vector<ScenarioResult>* results)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    const size_t count = static_cast<size_t>(std::max(0, cfg.scenarios));
+    std::vector<ScenarioResult> all(count);
+    {
+        ThreadPool pool(cfg.threads);
+        pool.parallelFor(count, [&](size_t b, size_t e, unsigned) {
+            for (size_t k = b; k < e; ++k) all[k] = runScenario(cfg, cfg.seed + k);
+        }, 1);
+    }
+
+    CampaignSummary s;
+    s.scenarios = static_cast<int>(count);
+    std::vector<uint64_t> coll(count);
+    double recoverySum = 0.0;
+    size_t withCollision = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        const ScenarioResult& r = all[k];
+        s.faulted   += r.faulted;
+        s.downed    += r.downed;
+        s.recovered += r.recovered;
+        s.disturbed += r.disturbed;
+        recoverySum += r.recoverySum;
+        s.collisionsMean      += r.collisions;
+        s.collisionsAfterMean += r.collisionsAfter;
+        s.extraCollisionsMean += double(r.collisions) - double(r.referenceCollisions);
+        withCollision += r.collisions > 0;
+        coll[k] = r.collisions;
+        for (int j = 0; j < 4; ++j)
+        {
+            s.byKind[j]          += r.faultedByKind[j];
+            s.downedByKind[j]    += r.downedByKind[j];
+            s.recoveredByKind[j] += r.recoveredByKind[j];
+        }
+    }
+    if (count > 0)
+    {
+        s.collisionsMean      /= count;
+        s.collisionsAfterMean /= count;
+        s.extraCollisionsMean /= count;
+        s.scenariosWithCollision = double(withCollision) / count;
+        std::sort(coll.begin(), coll.end());
+        s.collisionsP95 = static_cast<double>(coll[std::min(count - 1, count * 95 / 100)]);
+    }
+    s.meanRecovery = s.recovered ? recoverySum / s.recovered : 0.0;
+    s.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (results) *results = std::move(all);
+    return s;
+}
+
+} // namespace sim
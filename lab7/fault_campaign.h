@@ -0,0 +1,89 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Monte Carlo fault-injection campaigns: many small seeded swarm
+    scenarios run in parallel, each with random faults and a fault-free
+    twin on the same seed, aggregated into collision and recovery
+    statistics.
+*/
+
+#pragma once
+#include "faults.h"
+#include "swarm.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sim {
+
+struct CampaignConfig
+{
+    int      scenarios = 1000;
+    int      drones    = 60;      // per scenario (default layout)
+    double   seconds   = 40.0;
+    uint64_t seed      = 1;       // scenario k uses seed + k
+    unsigned threads   = 0;       // scenarios in parallel; 0 = all cores
+
+    // Engine settings for every scenario (threads is forced to 1:
+    // parallelism is across scenarios)
+    SwarmConfig swarm = [] {
+        SwarmConfig s;
+        s.flightStats = false;
+        return s;
+    }();
+    RandomFaults faults;          // seed is overridden per scenario
+
+    // Each scenario also runs without faults as a reference. A faulted
+    // drone has recovered once its distance from its sphere center has
+    // stayed within recoveryBand m of the reference drone's for
+    // recoveryHold s; a healthy drone is disturbed if it ever ends up
+    // more than disturbBand m from where it is in the reference run.
+    double recoveryBand = 0.5;
+    double recoveryHold = 1.0;
+    double disturbBand  = 0.5;
+
+    // Fills a scenario's swarm; the default is `drones` drones on a 3 m
+    // ground grid sharing one 10 m sphere, jittered by the seed
+    std::function<void(Swarm&, uint64_t seed)> build;
+};
+
+struct ScenarioResult
+{
+    uint64_t seed = 0;
+    uint32_t faulted   = 0;   // drones a fault fired on
+    uint32_t downed    = 0;   // faulted drones that reached the ground
+    uint32_t recovered = 0;   // faulted drones back on their sphere
+    double   recoverySum = 0.0;   // s, summed over recovered drones
+    uint32_t disturbed = 0;   // healthy drones knocked off their reference track
+    uint64_t collisions      = 0;
+    uint64_t collisionsAfter = 0;   // after the first fault fired
+    uint64_t referenceCollisions = 0;   // fault-free twin, whole run
+    // The same counts split by FaultKind
+    uint32_t faultedByKind[4] = {}, downedByKind[4] = {}, recoveredByKind[4] = {};
+};
+
+struct CampaignSummary
+{
+    int      scenarios = 0;
+    uint64_t faulted = 0, downed = 0, recovered = 0, disturbed = 0;
+    double   meanRecovery = 0.0;      // s
+    double   collisionsMean = 0.0;    // per scenario
+    double   collisionsAfterMean = 0.0;
+    double   extraCollisionsMean = 0.0;   // vs the fault-free twins
+    double   collisionsP95 = 0.0;
+    double   scenariosWithCollision = 0.0;   // fraction
+    uint64_t byKind[4] = {}, downedByKind[4] = {}, recoveredByKind[4] = {};
+    double   wallSeconds = 0.0;
+};
+
+// Run one scenario (and its fault-free twin) on the calling thread
+ScenarioResult runScenario(const CampaignConfig& cfg, uint64_t seed);
+
+// Run cfg.scenarios of them in parallel and aggregate. Per-scenario
+// results go to `results` if given (in scenario order).
+CampaignSummary runCampaign(const CampaignConfig& cfg,
+                            std::vector<ScenarioResult>* results = nullptr);
+
+} // namespace sim
@@ -0,0 +1,132 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for fault injection.
+*/
+
+#include "faults.h"
+#include "rng.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+const char* faultKindName(FaultKind k)
+{
+    switch (k)
+    {
+        case FaultKind::MotorOut:   return "motor-out";
+        case FaultKind::ThrustLoss: return "thrust-loss";
+        case FaultKind::Freeze:     return "freeze";
+        default:                    return "none";
+    }
+}
+
+void FaultModel::resize(size_t n)
+{
+    thrust.resize(n, 1.0);
+    for (auto& m : motor) m.resize(n, 1.0);
+    frozen.resize(n, 0);
+    kind.resize(n, FaultKind::None);
+    faultTick.resize(n, UINT64_MAX);
+}
+
+void FaultModel::schedule(const FaultEvent& e)
+{
+    if (next > 0)
+    {
+        // Drop the events already applied before growing the queue
+        events.erase(events.begin(), events.begin() + next);
+        next = 0;
+    }
+    events.push_back(e);
+    sorted = false;
+}
+
+void FaultModel::scheduleRandom(size_t drones, const RandomFaults& cfg, double dt)
+{
+    const double total = cfg.motorOut + cfg.thrustLoss + cfg.freeze;
+    if (total <= 0.0 || cfg.probability <= 0.0 || dt <= 0.0) return;
+    const uint32_t k0 = static_cast<uint32_t>(cfg.seed), k1 = static_cast<uint32_t>(cfg.seed >> 32);
+    for (size_t i = 0; i < drones; ++i)
+    {
+        Philox4x32 r(k0, k1, static_cast<uint32_t>(i), 0xFA017u, 0, 0);
+        if (toUniform(r.v[0]) >= cfg.probability) continue;
+
+        FaultEvent e;
+        e.drone = static_cast<uint32_t>(i);
+        const double t = cfg.windowStart + toUniform(r.v[1]) * (cfg.windowEnd - cfg.windowStart);
+        e.tick = static_cast<uint64_t>(std::max(0.0, std::floor(t / dt)));
+        const double pick = toUniform(r.v[2]) * total;
+        e.kind = pick < cfg.motorOut ? FaultKind::MotorOut
+               : pick < cfg.motorOut + cfg.thrustLoss ? FaultKind::ThrustLoss
+               : FaultKind::Freeze;
+        e.motor = static_cast<uint8_t>(r.v[3] & 3u);
+        e.severity = cfg.minLoss + toUniform(r.v[3]) * (cfg.maxLoss - cfg.minLoss);
+        schedule(e);
+    }
+}
+
+void FaultModel::clear()
+{
+    events.clear();
+    next = 0;
+    fired = 0;
+    sorted = true;
+    const size_t n = size();
+    thrust.assign(n, 1.0);
+    for (auto& m : motor) m.assign(n, 1.0);
+    frozen.assign(n, 0);
+    kind.assign(n, FaultKind::None);
+    faultTick.assign(n, UINT64_MAX);
+}
+
+size_t FaultModel::activate(uint64_t tick)
+{
+    if (!sorted)
+    {
+        std::stable_sort(events.begin() + next, events.end(),
+                         [](const FaultEvent& a, const FaultEvent& b) { return a.tick < b.tick; });
+        sorted = true;
+    }
+    size_t count = 0;
+    for (; next < events.size() && events[next].tick <= tick; ++next)
+    {
+        const FaultEvent& e = events[next];
+        const size_t i = e.drone;
+        if (i >= size()) continue;
+        switch (e.kind)
+        {
+            case FaultKind::MotorOut:
+                motor[e.motor & 3u][i] = 0.0;
+                thrust[i] = 0.0;
+                break;
+            case FaultKind::ThrustLoss:
+            {
+                const double s = 1.0 - std::clamp(e.severity, 0.0, 1.0);
+                thrust[i] *= s;
+                for (auto& m : motor) m[i] *= s;
+                break;
+            }
+            case FaultKind::Freeze:
+                frozen[i] = 1;
+                break;
+            default:
+                continue;
+        }
+        // The first fault is the one the metrics time recovery from
+        if (kind[i] == FaultKind::None)
+        {
+            kind[i] = e.kind;
+            faultTick[i] = e.tick;
+            ++fired;
+        }
+        ++count;
+    }
+    return count;
+}
+
+} // namespace sim
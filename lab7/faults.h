@@ -0,0 +1,87 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Fault injection for the swarm engine: motor loss, partial thrust loss
+    and frozen drones, scheduled at given ticks or drawn at random. Active
+    faults are kept as per-drone masks the step kernels multiply by, so a
+    healthy drone (mask 1) steps exactly as before.
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+enum class FaultKind : uint8_t
+{
+    None,
+    MotorOut,     // one motor stops (point mass: all lift is lost)
+    ThrustLoss,   // every motor delivers (1 - severity) of its command
+    Freeze        // the drone stops where it is and stays there
+};
+
+const char* faultKindName(FaultKind k);
+
+struct FaultEvent
+{
+    uint32_t  drone    = 0;
+    uint64_t  tick     = 0;   // base tick the fault appears at
+    FaultKind kind     = FaultKind::MotorOut;
+    uint8_t   motor    = 0;   // MotorOut: which motor (0..3)
+    double    severity = 1.0; // ThrustLoss: fraction of thrust lost
+};
+
+// Random faults: each drone fails with `probability` once per run, at a
+// uniformly drawn time in [windowStart, windowEnd) s, the kind picked by
+// the weights below. Draws come from Philox keyed by (seed, drone).
+struct RandomFaults
+{
+    double   probability = 0.1;
+    double   windowStart = 15.0;
+    double   windowEnd   = 30.0;
+    double   motorOut    = 1.0;   // relative weights of the kinds
+    double   thrustLoss  = 1.0;
+    double   freeze      = 1.0;
+    double   minLoss     = 0.2;   // ThrustLoss severity range
+    double   maxLoss     = 0.6;
+    uint64_t seed        = 1;
+};
+
+class FaultModel
+{
+public:
+    void resize(size_t n);
+    size_t size() const { return thrust.size(); }
+
+    // Queue a fault; events may be added in any order
+    void schedule(const FaultEvent& e);
+    // Queue random faults for drones [0, drones), dt being the base tick
+    void scheduleRandom(size_t drones, const RandomFaults& cfg, double dt);
+    void clear();
+
+    // Apply every event due at or before `tick`; returns how many fired
+    size_t activate(uint64_t tick);
+    bool   pending() const { return next < events.size(); }
+
+    // Masks read by the step kernels: 1 = nominal
+    std::vector<double>  thrust;     // point-mass force scale
+    std::vector<double>  motor[4];   // quadrotor per-motor thrust scale
+    std::vector<uint8_t> frozen;     // 1 = hold position, zero velocity
+
+    // What hit each drone and when (kind None / UINT64_MAX when healthy)
+    std::vector<FaultKind> kind;
+    std::vector<uint64_t>  faultTick;
+    size_t active() const { return fired; }
+
+private:
+    std::vector<FaultEvent> events;   // sorted by tick from `next` on
+    size_t next  = 0;
+    size_t fired = 0;
+    bool   sorted = true;
+};
+
+} // namespace sim
@@ -0,0 +1,478 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the field tile pyramid and its streamer.
+*/
+
+#include "field_tiles.h"
+#include "memtrack.h"
+#include <cmath>
+#include <cstring>
+
+namespace sim
+{
+
+namespace
+{
+
+constexpr uint32_t kNoTile = UINT32_MAX;
+
+bool seekTo(std::FILE* f, uint64_t off)
+{
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<long long>(off), SEEK_SET) == 0;
+#else
+    return fseeko(f, static_cast<off_t>(off), SEEK_SET) == 0;
+#endif
+}
+
+// Size of an open file in bytes; -1 if it cannot be found
+int64_t fileSize(std::FILE* f)
+{
+#ifdef _WIN32
+    return _fseeki64(f, 0, SEEK_END) == 0 ? _ftelli64(f) : -1;
+#else
+    return fseeko(f, 0, SEEK_END) == 0 ? static_cast<int64_t>(ftello(f)) : -1;
+#endif
+}
+
+uint32_t readU32(const unsigned char* p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// Level sizes, coarsest first: each is the next finer one halved, rounded up
+void levelSizes(uint32_t width, uint32_t height, uint32_t levels,
+                std::vector<uint32_t>& w, std::vector<uint32_t>& h)
+{
+    w.assign(levels, 0);
+    h.assign(levels, 0);
+    w[levels - 1] = width;
+    h[levels - 1] = height;
+    for (uint32_t l = levels - 1; l > 0; --l)
+    {
+        w[l - 1] = (w[l] + 1) / 2;
+        h[l - 1] = (h[l] + 1) / 2;
+    }
+}
+
+// 2x2 box filter; an odd last row / column averages with itself
+void halve(const std::vector<uint8_t>& src, uint32_t sw, uint32_t sh,
+           std::vector<uint8_t>& dst, uint32_t dw, uint32_t dh)
+{
+    dst.resize(size_t(dw) * dh * 3);
+    for (uint32_t y = 0; y < dh; ++y)
+    {
+        const uint8_t* r0 = &src[size_t(std::min(2 * y, sh - 1)) * sw * 3];
+        const uint8_t* r1 = &src[size_t(std::min(2 * y + 1, sh - 1)) * sw * 3];
+        uint8_t* out = &dst[size_t(y) * dw * 3];
+        for (uint32_t x = 0; x < dw; ++x)
+        {
+            const size_t a = size_t(std::min(2 * x, sw - 1)) * 3;
+            const size_t b = size_t(std::min(2 * x + 1, sw - 1)) * 3;
+            for (int c = 0; c < 3; ++c)
+                out[3 * x + c] = static_cast<uint8_t>((r0[a + c] + r0[b + c] + r1[a + c] + r1[b + c] + 2) / 4);
+        }
+    }
+}
+
+} // namespace
+
+// ------------------------------------------
+// Baking
+// ------------------------------------------
+bool loadBMP24(const std::string& path, uint32_t& width, uint32_t& height,
+               std::vector<uint8_t>& bgr)
+{
+    MemScope tag(Subsystem::AssetIO);
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    unsigned char h[54];
+    bool ok = std::fread(h, 1, 54, f) == 54 && h[0] == 'B' && h[1] == 'M'
+           && (h[0x1C] | (h[0x1D] << 8)) == 24 && readU32(h + 0x1E) == 0;
+    const int32_t w  = static_cast<int32_t>(readU32(h + 0x12));
+    const int32_t hh = static_cast<int32_t>(readU32(h + 0x16));
+    ok = ok && w > 0 && hh != 0;
+    if (ok)
+    {
+        // Negative height: rows stored top-down
+        width  = static_cast<uint32_t>(w);
+        height = static_cast<uint32_t>(hh < 0 ? -hh : hh);
+        const size_t row = size_t(width) * 3, stride = (row + 3) & ~size_t(3);
+        bgr.resize(row * height);
+        std::vector<uint8_t> line(stride);
+        ok = seekTo(f, readU32(h + 0x0A));
+        for (uint32_t y = 0; ok && y < height; ++y)
+        {
+            ok = std::fread(line.data(), 1, stride, f) == stride;
+            const uint32_t dst = hh < 0 ? height - 1 - y : y;
+            std::memcpy(&bgr[dst * row], line.data(), row);
+        }
+    }
+    std::fclose(f);
+    return ok;
+}
+
+bool bakeTilePyramid(const uint8_t* bgr, uint32_t width, uint32_t height,
+                     uint32_t tileSize, const std::string& outPath)
+{
+    if (!bgr || width == 0 || height == 0 || tileSize == 0 || tileSize > kMaxTileSize)
+        return false;
+    MemScope tag(Subsystem::AssetIO);
+
+    TilePyramidHeader hdr;
+    hdr.tileSize = tileSize;
+    hdr.width    = width;
+    hdr.height   = height;
+    hdr.levels   = 1;
+    while ((uint64_t(tileSize) << (hdr.levels - 1)) < std::max(width, height)) ++hdr.levels;
+
+    std::vector<uint32_t> w, h;
+    levelSizes(width, height, hdr.levels, w, h);
+    for (uint32_t l = 0; l < hdr.levels; ++l)
+        hdr.tiles += ((w[l] + tileSize - 1) / tileSize) * ((h[l] + tileSize - 1) / tileSize);
+
+    // Every level, finest first (4/3 of the image)
+    std::vector<std::vector<uint8_t>> img(hdr.levels);
+    img[hdr.levels - 1].assign(bgr, bgr + size_t(width) * height * 3);
+    for (uint32_t l = hdr.levels - 1; l > 0; --l)
+        halve(img[l], w[l], h[l], img[l - 1], w[l - 1], h[l - 1]);
+
+    std::FILE* f = std::fopen(outPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+    std::vector<uint8_t> tile(size_t(tileSize) * tileSize * 3);
+    for (uint32_t l = 0; ok && l < hdr.levels; ++l)
+    {
+        const uint32_t tx = (w[l] + tileSize - 1) / tileSize, ty = (h[l] + tileSize - 1) / tileSize;
+        for (uint32_t y = 0; ok && y < ty; ++y)
+        {
+            for (uint32_t x = 0; ok && x < tx; ++x)
+            {
+                for (uint32_t r = 0; r < tileSize; ++r)
+                {
+                    const uint32_t sy = std::min(y * tileSize + r, h[l] - 1);
+                    const uint8_t* src = &img[l][size_t(sy) * w[l] * 3];
+                    uint8_t* dst = &tile[size_t(r) * tileSize * 3];
+                    for (uint32_t c = 0; c < tileSize; ++c)
+                    {
+                        const uint32_t sx = std::min(x * tileSize + c, w[l] - 1);
+                        std::memcpy(dst + 3 * c, src + 3 * size_t(sx), 3);
+                    }
+                }
+                ok = std::fwrite(tile.data(), 1, tile.size(), f) == tile.size();
+            }
+        }
+    }
+    ok = std::fclose(f) == 0 && ok;
+    return ok;
+}
+
+bool bakeTilePyramid(const std::string& bmpPath, const std::string& outPath, uint32_t tileSize)
+{
+    uint32_t w = 0, h = 0;
+    std::vector<uint8_t> bgr;
+    return loadBMP24(bmpPath, w, h, bgr) && bakeTilePyramid(bgr.data(), w, h, tileSize, outPath);
+}
+
+// ------------------------------------------
+// TileStreamer
+// ------------------------------------------
+TileStreamer::TileStreamer(const TileStreamConfig& c) : cfg(c)
+{
+    cfg.slots   = std::max(cfg.slots, 1);
+    cfg.staging = std::max(cfg.staging, 1);
+}
+
+TileStreamer::~TileStreamer()
+{
+    close();
+}
+
+bool TileStreamer::open(const std::string& path)
+{
+    close();
+    MemScope tag(Subsystem::AssetIO);
+    file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    if (std::fread(&hdr, sizeof(hdr), 1, file) != 1 || std::memcmp(hdr.magic, "UTIL", 4) != 0
+        || hdr.version != 1 || hdr.tileSize == 0 || hdr.tileSize > kMaxTileSize
+        || hdr.levels == 0 || hdr.levels > 24
+        || hdr.width == 0 || hdr.height == 0)
+    {
+        close();
+        return false;
+    }
+
+    std::vector<uint32_t> w, h;
+    levelSizes(hdr.width, hdr.height, hdr.levels, w, h);
+    uint64_t total = 0;
+    for (uint32_t l = 0; l < hdr.levels; ++l)
+    {
+        levelFirst.push_back(static_cast<uint32_t>(total));
+        tilesX.push_back((w[l] + hdr.tileSize - 1) / hdr.tileSize);
+        tilesY.push_back((h[l] + hdr.tileSize - 1) / hdr.tileSize);
+        total += uint64_t(tilesX[l]) * tilesY[l];
+    }
+    // Every tile the header promises must be on disk, or the loader
+    // would read past the end
+    const int64_t bytes = fileSize(file);
+    if (total != hdr.tiles || bytes < 0
+        || uint64_t(bytes) < sizeof(hdr) + total * tileBytes())
+    {
+        close();
+        return false;
+    }
+
+    slotOf.assign(total, -1);
+    queued.assign(total, 0);
+    slotTile.assign(cfg.slots, kNoTile);
+    slotUsed.assign(cfg.slots, 0);
+    stagingData.resize(size_t(cfg.staging) * tileBytes());
+    for (int s = cfg.staging - 1; s >= 0; --s) freeStaging.push_back(s);
+    quit = false;
+    loader = std::thread([this] { loaderLoop(); });
+    return true;
+}
+
+void TileStreamer::close()
+{
+    if (loader.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> g(lock);
+            quit = true;
+        }
+        wake.notify_all();
+        loader.join();
+    }
+    if (file) std::fclose(file);
+    file = nullptr;
+    hdr = TilePyramidHeader();
+    levelFirst.clear();
+    tilesX.clear();
+    tilesY.clear();
+    slotOf.clear();
+    queued.clear();
+    slotTile.clear();
+    slotUsed.clear();
+    pending.clear();
+    done.clear();
+    freeStaging.clear();
+    stagingData = std::vector<uint8_t>();
+    count = Counters();
+}
+
+double TileStreamer::tileExtentX(uint32_t level) const
+{
+    const double scale = double(uint64_t(hdr.tileSize) << (hdr.levels - 1 - level));
+    return scale / hdr.width * (cfg.maxX - cfg.minX);
+}
+
+double TileStreamer::tileExtentY(uint32_t level) const
+{
+    const double scale = double(uint64_t(hdr.tileSize) << (hdr.levels - 1 - level));
+    return scale / hdr.height * (cfg.maxY - cfg.minY);
+}
+
+int TileStreamer::resident() const
+{
+    int n = 0;
+    for (uint32_t t : slotTile) n += t != kNoTile;
+    return n;
+}
+
+void TileStreamer::plan(const control::Vec3& eye, double pixelAngle, std::vector<TileDraw>& draws)
+{
+    ++frame;
+    missing.clear();
+    draws.clear();
+    planView(TileView{ eye, pixelAngle }, size_t(cfg.slots) * 3 / 4, draws);
+    submitMissing();
+}
+
+void TileStreamer::plan(const std::vector<TileView>& views, std::vector<std::vector<TileDraw>>& draws)
+{
+    ++frame;
+    missing.clear();
+    draws.resize(views.size());
+    const size_t budget = size_t(cfg.slots) * 3 / 4 / std::max<size_t>(views.size(), 1);
+    for (size_t v = 0; v < views.size(); ++v)
+    {
+        draws[v].clear();
+        planView(views[v], budget, draws[v]);
+    }
+    submitMissing();
+}
+
+void TileStreamer::planView(const TileView& view, size_t budget, std::vector<TileDraw>& draws)
+{
+    if (!isOpen())
+    {
+        draws.push_back({ -1, float(cfg.minX), float(cfg.minY), float(cfg.maxX), float(cfg.maxY),
+                          0.f, 0.f, 1.f, 1.f });
+        return;
+    }
+    const control::Vec3& eye = view.eye;
+
+    // Texels per pixel for a tile, seen from its nearest point
+    const double texel = 1.0 / hdr.tileSize;
+    auto node = [&](uint32_t l, uint32_t x, uint32_t y) {
+        const double ex = tileExtentX(l), ey = tileExtentY(l);
+        const double x0 = cfg.minX + x * ex, x1 = std::min(cfg.maxX, x0 + ex);
+        const double y0 = cfg.minY + y * ey, y1 = std::min(cfg.maxY, y0 + ey);
+        const double dx = std::max({ x0 - eye.x, 0.0, eye.x - x1 });
+        const double dy = std::max({ y0 - eye.y, 0.0, eye.y - y1 });
+        const double d = std::sqrt(dx * dx + dy * dy + eye.z * eye.z);
+        return Node{ std::max(ex, ey) * texel / (std::max(d, 1e-3) * view.pixelAngle), l, x, y };
+    };
+    auto byErr = [](const Node& a, const Node& b) { return a.err < b.err; };
+
+    // Split the worst tile while it is too coarse, keeping the frontier
+    // within what the slots can hold (ancestors stay usable as fallbacks)
+    budget = std::max<size_t>(budget, 1);
+    heap.assign(1, node(0, 0, 0));
+    frontier.clear();
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), byErr);
+        const Node n = heap.back();
+        heap.pop_back();
+        const uint32_t cl = n.level + 1;
+        if (n.err > cfg.lodBias && cl < hdr.levels && frontier.size() + heap.size() + 4 <= budget)
+        {
+            for (uint32_t cy = 2 * n.y; cy < std::min(2 * n.y + 2, tilesY[cl]); ++cy)
+            {
+                for (uint32_t cx = 2 * n.x; cx < std::min(2 * n.x + 2, tilesX[cl]); ++cx)
+                {
+                    heap.push_back(node(cl, cx, cy));
+                    std::push_heap(heap.begin(), heap.end(), byErr);
+                }
+            }
+        }
+        else
+        {
+            frontier.push_back(n);
+        }
+    }
+
+    // Draw each frontier tile from itself or its nearest resident ancestor
+    if (slotOf[0] < 0) missing.push_back(Node{ 0.0, 0, 0, 0 });
+    for (const Node& n : frontier)
+    {
+        const uint32_t id = tileId(n.level, n.x, n.y);
+        if (slotOf[id] < 0 && id != 0) missing.push_back(n);
+
+        uint32_t l = n.level, x = n.x, y = n.y;
+        while (slotOf[tileId(l, x, y)] < 0 && l > 0)
+        {
+            --l;
+            x /= 2;
+            y /= 2;
+        }
+        const int slot = slotOf[tileId(l, x, y)];
+        const double ex = tileExtentX(n.level), ey = tileExtentY(n.level);
+        const double x0 = cfg.minX + n.x * ex, x1 = std::min(cfg.maxX, x0 + ex);
+        const double y0 = cfg.minY + n.y * ey, y1 = std::min(cfg.maxY, y0 + ey);
+        const double ax = tileExtentX(l), ay = tileExtentY(l);
+        const double ox = cfg.minX + x * ax, oy = cfg.minY + y * ay;
+        draws.push_back({ slot, float(x0), float(y0), float(x1), float(y1),
+                          float((x0 - ox) / ax), float((y0 - oy) / ay),
+                          float((x1 - ox) / ax), float((y1 - oy) / ay) });
+        if (slot >= 0) slotUsed[slot] = frame;
+        count.fallback += l != n.level || slot < 0;
+    }
+    count.drawn += frontier.size();
+}
+
+void TileStreamer::submitMissing()
+{
+    // Coarse before fine, then the most visibly blurred first
+    std::sort(missing.begin(), missing.end(), [](const Node& a, const Node& b) {
+        return a.level != b.level ? a.level < b.level : a.err > b.err;
+    });
+    {
+        std::lock_guard<std::mutex> g(lock);
+        for (uint32_t t : pending) queued[t] = 0;
+        pending.clear();
+        for (const Node& n : missing)
+        {
+            const uint32_t id = tileId(n.level, n.x, n.y);
+            if (queued[id]) continue;   // already being read
+            queued[id] = 1;
+            pending.push_back(id);
+        }
+    }
+    wake.notify_one();
+}
+
+int TileStreamer::takeSlot()
+{
+    int best = -1;
+    for (int s = 0; s < cfg.slots; ++s)
+    {
+        if (slotTile[s] == kNoTile) return s;
+        // Level 0 stays resident as the fallback of last resort
+        if (slotTile[s] != 0 && slotUsed[s] < frame && (best < 0 || slotUsed[s] < slotUsed[best]))
+            best = s;
+    }
+    if (best >= 0)
+    {
+        slotOf[slotTile[best]] = -1;
+        slotTile[best] = kNoTile;
+        ++count.evicted;
+    }
+    return best;
+}
+
+void TileStreamer::finish(const Loaded& l, int slot)
+{
+    queued[l.tile] = 0;
+    if (slot >= 0)
+    {
+        slotOf[l.tile] = slot;
+        slotTile[slot] = l.tile;
+        slotUsed[slot] = frame;
+        ++count.loaded;
+    }
+    else if (l.staging >= 0)
+    {
+        ++count.dropped;
+    }
+    if (l.staging >= 0) releaseStaging(l.staging);
+}
+
+void TileStreamer::releaseStaging(int s)
+{
+    {
+        std::lock_guard<std::mutex> g(lock);
+        freeStaging.push_back(s);
+    }
+    wake.notify_one();
+}
+
+void TileStreamer::loaderLoop()
+{
+    const size_t bytes = tileBytes();
+    std::unique_lock<std::mutex> g(lock);
+    while (true)
+    {
+        wake.wait(g, [&] { return quit || (!pending.empty() && !freeStaging.empty()); });
+        if (quit) return;
+        const uint32_t tile = pending.front();
+        pending.pop_front();
+        const int s = freeStaging.back();
+        freeStaging.pop_back();
+
+        g.unlock();
+        const bool ok = seekTo(file, sizeof(TilePyramidHeader) + uint64_t(tile) * bytes)
+                     && std::fread(&stagingData[size_t(s) * bytes], 1, bytes, file) == bytes;
+        g.lock();
+        if (!ok) freeStaging.push_back(s);
+        done.push_back({ tile, ok ? s : -1 });
+    }
+}
+
+} // namespace sim
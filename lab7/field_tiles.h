@@ -0,0 +1,207 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Tiled texture pyramid for the field imagery: baked offline from a
+    BMP, streamed in by a loader thread into a fixed number of tile
+    slots picked by camera distance. No OpenGL here; the renderer owns
+    one texture per slot.
+*/
+
+#pragma once
+#include "control.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+// File layout (little endian):
+//   header  64 bytes, see TilePyramidHeader
+//   tiles   tileSize x tileSize x 3 bytes (BGR, rows bottom-up as in the
+//           BMP) per tile, level 0 (one tile, coarsest) first, each level
+//           row-major; partial edge tiles repeat their last row / column
+// Level L holds the image downsampled by 2^(levels - 1 - L).
+struct TilePyramidHeader
+{
+    char     magic[4] = { 'U', 'T', 'I', 'L' };
+    uint32_t version  = 1;
+    uint32_t tileSize = 0;
+    uint32_t levels   = 0;
+    uint32_t width    = 0;   // finest level, texels
+    uint32_t height   = 0;
+    uint32_t tiles    = 0;   // all levels
+    uint8_t  reserved[36] = {};
+};
+static_assert(sizeof(TilePyramidHeader) == 64, "tile header must stay 64 bytes");
+
+// Largest tile edge the baker writes and the streamer accepts (one
+// tile is then 48 MB, and still a legal texture on any GL 3 driver)
+constexpr uint32_t kMaxTileSize = 4096;
+
+// 24-bit uncompressed BMP into `bgr` (rows bottom-up, no padding)
+bool loadBMP24(const std::string& path, uint32_t& width, uint32_t& height,
+               std::vector<uint8_t>& bgr);
+
+// Build the pyramid from an image and write it; the whole image is in
+// memory here, never at run time
+bool bakeTilePyramid(const uint8_t* bgr, uint32_t width, uint32_t height,
+                     uint32_t tileSize, const std::string& outPath);
+bool bakeTilePyramid(const std::string& bmpPath, const std::string& outPath,
+                     uint32_t tileSize = 256);
+
+struct TileStreamConfig
+{
+    int    slots    = 64;     // resident tiles (the renderer's texture pool)
+    int    staging  = 8;      // tiles read but not yet uploaded
+    double lodBias  = 1.0;    // refine while a texel covers more than this many pixels
+    // World rectangle the image is stretched over (z = 0)
+    double minX = -60.0, minY = -26.65;
+    double maxX =  60.0, maxY =  26.65;
+};
+
+// A camera the field is drawn for: its eye and the angle one pixel spans
+struct TileView
+{
+    control::Vec3 eye;
+    double pixelAngle;
+};
+
+// One quad to draw: a world rectangle and where its texels are in a
+// resident slot; slot -1 means nothing is resident yet
+struct TileDraw
+{
+    int   slot;
+    float x0, y0, x1, y1;
+    float s0, t0, s1, t1;
+};
+
+// Residency and streaming. open() reads only the header, so startup and
+// memory (slots + staging tiles) do not depend on the image size. All
+// calls but the loader's own are from the render thread.
+class TileStreamer
+{
+public:
+    explicit TileStreamer(const TileStreamConfig& cfg = TileStreamConfig());
+    ~TileStreamer();
+    TileStreamer(const TileStreamer&) = delete;
+    TileStreamer& operator=(const TileStreamer&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    const TilePyramidHeader& header() const { return hdr; }
+    const TileStreamConfig& config() const { return cfg; }
+    size_t tileBytes() const { return size_t(hdr.tileSize) * hdr.tileSize * 3; }
+
+    // Pick the tiles for a camera at `eye` where one pixel spans
+    // `pixelAngle` radians, queue the missing ones (nearest and coarsest
+    // first, replacing last frame's queue) and list what to draw now,
+    // each tile falling back to its nearest resident ancestor
+    void plan(const control::Vec3& eye, double pixelAngle, std::vector<TileDraw>& draws);
+    // Several views in one frame: the slot budget is split between them
+    // and their missing tiles share one queue
+    void plan(const std::vector<TileView>& views, std::vector<std::vector<TileDraw>>& draws);
+
+    // Hand at most `budget` finished reads to `upload(slot, texels)`,
+    // evicting the least recently drawn slot when none is free. Returns
+    // the number uploaded.
+    template <class Upload>
+    int poll(int budget, Upload&& upload);
+
+    struct Counters
+    {
+        uint64_t loaded    = 0;   // reads uploaded into a slot
+        uint64_t evicted   = 0;
+        uint64_t dropped   = 0;   // reads discarded (no evictable slot)
+        uint64_t fallback  = 0;   // quads drawn from an ancestor or untextured
+        uint64_t drawn     = 0;
+    };
+    const Counters& counters() const { return count; }
+    int resident() const;
+
+private:
+    struct Node
+    {
+        double   err;   // texels per pixel
+        uint32_t level, x, y;
+    };
+    struct Loaded
+    {
+        uint32_t tile;
+        int staging;
+    };
+
+    uint32_t tileId(uint32_t level, uint32_t x, uint32_t y) const
+    {
+        return levelFirst[level] + y * tilesX[level] + x;
+    }
+    // World extent of one (unclipped) tile at `level`
+    double tileExtentX(uint32_t level) const;
+    double tileExtentY(uint32_t level) const;
+    void planView(const TileView& view, size_t budget, std::vector<TileDraw>& draws);
+    void submitMissing();
+    int  takeSlot();
+    void finish(const Loaded& l, int slot);
+    void releaseStaging(int s);
+    void loaderLoop();
+
+    TileStreamConfig cfg;
+    TilePyramidHeader hdr;
+    std::FILE* file = nullptr;
+    std::vector<uint32_t> levelFirst, tilesX, tilesY;
+
+    // Render thread
+    std::vector<int32_t>  slotOf;     // per tile, -1 if not resident
+    std::vector<uint8_t>  queued;     // per tile: queued or being read
+    std::vector<uint32_t> slotTile;   // per slot, UINT32_MAX if free
+    std::vector<uint64_t> slotUsed;   // frame a slot was last drawn
+    uint64_t frame = 0;
+    std::vector<Node> heap, frontier, missing;
+    Counters count;
+
+    // Shared with the loader
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<uint32_t>  pending;    // tiles to read, in priority order
+    std::vector<Loaded>   done;
+    std::vector<int>      freeStaging;
+    std::vector<uint8_t>  stagingData;
+    bool quit = false;
+    std::thread loader;
+};
+
+template <class Upload>
+int TileStreamer::poll(int budget, Upload&& upload)
+{
+    std::vector<Loaded> ready;
+    {
+        std::lock_guard<std::mutex> g(lock);
+        const size_t n = std::min(done.size(), static_cast<size_t>(std::max(budget, 0)));
+        ready.assign(done.begin(), done.begin() + n);
+        done.erase(done.begin(), done.begin() + n);
+    }
+    int uploaded = 0;
+    for (const Loaded& l : ready)
+    {
+        // staging < 0: the read failed
+        const int slot = l.staging >= 0 ? takeSlot() : -1;
+        if (slot >= 0)
+        {
+            upload(slot, &stagingData[size_t(l.staging) * tileBytes()]);
+            ++uploaded;
+        }
+        finish(l, slot);
+    }
+    return uploaded;
+}
+
+} // namespace sim
@@ -0,0 +1,135 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Streaming flight-quality statistics per drone: how well each drone
+    holds the sphere radius and its speed band, without keeping the
+    trajectory.
+*/
+
+#pragma once
+#include "control.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+// Fleet-wide view of the per-drone accumulators
+struct FlightSummary
+{
+    size_t drones         = 0;    // drones with at least one sample
+    double time           = 0.0;  // s on the sphere, summed over drones
+    double radialMean     = 0.0;  // m, |r| - sphereRadius
+    double radialStdDev   = 0.0;
+    double speedMean      = 0.0;  // m/s, speed - mid-band
+    double speedStdDev    = 0.0;
+    double outsideBand    = 0.0;  // fraction of the time outside [minSpeed, maxSpeed]
+    double maxRadialError = 0.0;  // m, worst |radial error| of any drone
+    double maxSpeedExcess = 0.0;  // m/s, worst excursion outside the band
+};
+
+// One array per statistic. Samples are taken on the sphere only and
+// weighted by the step they cover, so multi-rate drones (longer steps)
+// count for the time they actually flew. Mean and variance use West's
+// weighted form of Welford's update.
+class FlightStats
+{
+public:
+    void resize(size_t n)
+    {
+        for (auto* v : { &weight, &radMean, &radM2, &spdMean, &spdM2,
+                         &outside, &radMax, &spdMax })
+        {
+            v->resize(n, 0.0);
+        }
+    }
+    size_t size() const { return weight.size(); }
+
+    // Drone i after a step of dt at position p / velocity v
+    void record(size_t i, const control::Vec3& p, const control::Vec3& v,
+                const control::ControlConfig& cfg, double dt)
+    {
+        const double radial = (p - cfg.center).mag() - cfg.sphereRadius;
+        const double speed  = v.mag();
+        const double excess = std::max({ cfg.minSpeed - speed, speed - cfg.maxSpeed, 0.0 });
+
+        const double w = weight[i] + dt;
+        const double a = dt / w;
+        weight[i] = w;
+
+        double d = radial - radMean[i];
+        radMean[i] += a * d;
+        radM2[i]   += dt * d * (radial - radMean[i]);
+
+        const double se = speed - 0.5 * (cfg.minSpeed + cfg.maxSpeed);
+        d = se - spdMean[i];
+        spdMean[i] += a * d;
+        spdM2[i]   += dt * d * (se - spdMean[i]);
+
+        outside[i] += excess > 0.0 ? dt : 0.0;
+        radMax[i] = std::max(radMax[i], std::abs(radial));
+        spdMax[i] = std::max(spdMax[i], excess);
+    }
+
+    void reset(size_t i)
+    {
+        weight[i] = radMean[i] = radM2[i] = spdMean[i] = spdM2[i] = 0.0;
+        outside[i] = radMax[i] = spdMax[i] = 0.0;
+    }
+
+    // Per drone
+    double timeOnSphere(size_t i)    const { return weight[i]; }
+    double radialMean(size_t i)      const { return radMean[i]; }
+    double radialVariance(size_t i)  const { return weight[i] > 0.0 ? radM2[i] / weight[i] : 0.0; }
+    double speedMean(size_t i)       const { return spdMean[i]; }
+    double speedVariance(size_t i)   const { return weight[i] > 0.0 ? spdM2[i] / weight[i] : 0.0; }
+    double timeOutsideBand(size_t i) const { return outside[i]; }
+    double maxRadialError(size_t i)  const { return radMax[i]; }
+    double maxSpeedExcess(size_t i)  const { return spdMax[i]; }
+
+    // Merge all drones (Chan et al. pairwise combination of the moments)
+    FlightSummary summary() const
+    {
+        FlightSummary s;
+        double w = 0.0, rm = 0.0, rM2 = 0.0, sm = 0.0, sM2 = 0.0, out = 0.0;
+        for (size_t i = 0; i < size(); ++i)
+        {
+            const double wi = weight[i];
+            if (wi <= 0.0) continue;
+            ++s.drones;
+            const double wn = w + wi;
+            double d = radMean[i] - rm;
+            rm  += d * wi / wn;
+            rM2 += radM2[i] + d * d * w * wi / wn;
+            d = spdMean[i] - sm;
+            sm  += d * wi / wn;
+            sM2 += spdM2[i] + d * d * w * wi / wn;
+            w = wn;
+            out += outside[i];
+            s.maxRadialError = std::max(s.maxRadialError, radMax[i]);
+            s.maxSpeedExcess = std::max(s.maxSpeedExcess, spdMax[i]);
+        }
+        if (w > 0.0)
+        {
+            s.time         = w;
+            s.radialMean   = rm;
+            s.radialStdDev = std::sqrt(rM2 / w);
+            s.speedMean    = sm;
+            s.speedStdDev  = std::sqrt(sM2 / w);
+            s.outsideBand  = out / w;
+        }
+        return s;
+    }
+
+private:
+    std::vector<double> weight;            // s sampled
+    std::vector<double> radMean, radM2;    // radial error moments
+    std::vector<double> spdMean, spdM2;    // speed error moments
+    std::vector<double> outside;           // s outside the speed band
+    std::vector<double> radMax, spdMax;    // worst excursions
+};
+
+} // namespace sim
@@ -7,13 +7,23 @@ Description:
 */
 
 #include "simulation.h"
+#include "coverage.h"
+#include "field_tiles.h"
+#include "memtrack.h"
+#include "scenario_file.h"
+#include "snapshot_codec.h"
+#include "spatial_grid.h"
+#include "trails.h"
+#include "view_cull.h"
 #include <GL/freeglut.h>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cstdio>
+#include <cstdlib>
 #include <cmath>
 
 // Global UAV list
@@ -26,8 +36,137 @@ GLuint g_fieldTex = 0;
 const float FIELD_LENGTH = 120.0f; // x
 const float FIELD_WIDTH  = 53.3f;  // y
 
-// Simple camera parameters
-float g_camDist = 80.0f;
+// High-resolution field imagery: ff.tiles (baked from a BMP with
+// uav_tiles) streamed by camera distance into a fixed set of tile
+// textures; without it ff.bmp is loaded whole into g_fieldTex
+const int TILE_UPLOADS_PER_FRAME = 4;
+
+sim::TileStreamConfig fieldTileConfig()
+{
+    sim::TileStreamConfig c;
+    c.minX = -FIELD_LENGTH * 0.5;
+    c.maxX =  FIELD_LENGTH * 0.5;
+    c.minY = -FIELD_WIDTH * 0.5;
+    c.maxY =  FIELD_WIDTH * 0.5;
+    return c;
+}
+
+sim::TileStreamer          g_fieldTiles(fieldTileConfig());
+std::vector<GLuint>        g_tileTex;     // one per cache slot
+std::vector<sim::TileView> g_tileViews;
+std::vector<std::vector<sim::TileDraw>> g_tileDraws;   // per view
+
+// Orbit camera around g_camTarget. The defaults give the original fixed
+// view: eye at (80, 80, 80) looking at (0, 0, 20).
+control::Vec3 g_camTarget(0.0, 0.0, 20.0);
+float g_camDist  = 128.06f;  // eye to target
+float g_camYaw   = 45.0f;    // degrees around +z, from +x
+float g_camPitch = 27.94f;   // degrees above the horizon
+const float CAM_FOVY = 60.0f;
+int g_winW = 400, g_winH = 400;
+
+// Viewports: 'v' switches between the single orbit view and a split of
+// orbit (left), a chase camera behind the selected drone (top right) and
+// a top-down map (bottom right). Every view draws the same snapshot; one
+// culling pass over the drones builds all the views' instance lists.
+enum class ViewKind { Orbit, Chase, Map };
+
+struct View
+{
+    ViewKind kind;
+    float fx, fy, fw, fh;       // fraction of the window, from bottom-left
+    int   x = 0, y = 0, w = 1, h = 1;   // pixels
+    control::Vec3 eye{}, target{}, up{};
+    double halfW = 0.0, halfH = 0.0;    // Map: orthographic extent
+};
+
+const double CULL_RADIUS = 0.5;   // bounds a drone model
+bool g_splitViews = false;
+std::vector<View> g_views;        // g_views[0] is always the orbit view
+std::vector<sim::Frustum> g_frusta;
+std::vector<std::vector<uint32_t>> g_visible;   // per view, drone indices
+
+// Mouse: left drag orbits, right drag pans, wheel zooms,
+// a left click without dragging selects the drone under the cursor
+int  g_mouseButton = -1;
+int  g_mouseX = 0, g_mouseY = 0;
+bool g_dragged = false;
+
+// Picking: drones are spheres of PICK_RADIUS, found by a ray query on a
+// grid of PICK_CELL cells over the snapshot positions. Each tick only
+// marks the grid stale; the next click rebuilds it.
+const double PICK_RADIUS = 1.0;
+const double PICK_CELL   = 4.0;
+sim::SpatialGrid g_pickGrid;
+bool g_pickGridStale = true;
+int g_selected = -1;
+
+// Trails: last TRAIL_LENGTH published positions per drone, 't' toggles
+const int TRAIL_LENGTH = 200;   // samples, ~6 s at the 30 ms timer
+sim::TrailBuffer g_trails;
+bool g_showTrails = true;
+
+// --scenario: each sim::UAV runs its own thread, so the viewer takes
+// scenarios up to this size; larger ones are for the swarm engine
+const size_t MAX_VIEWER_DRONES = 2000;
+
+// Mission every UAV flies (set up in main)
+control::ControlConfig g_missionCfg;
+
+// Sphere coverage heatmap, 'h' toggles
+sim::SphereCoverage g_coverage;
+bool g_showCoverage = false;
+
+// Drone state read once per timer tick and handed to the render side
+// packed (16 B per drone, same format as telemetry); everything drawn
+// comes from the decoded positions
+sim::SnapshotCodec             g_snapCodec;
+std::vector<sim::PackedDrone>  g_snapFrame;
+std::vector<control::Vec3>     g_rawPos, g_rawVel;
+std::vector<uint8_t>           g_rawPhase;
+std::vector<control::Vec3>     g_snapPos;
+std::vector<uint8_t>           g_snapOnSphere;
+
+// Codec bounds start as the field, are widened to every start and mission
+// sphere in main, and again by the timer if a drone still gets out (the
+// margin keeps that rare); clamped drones would be drawn at the edge
+const double SNAP_MARGIN = 10.0;   // m
+
+bool widenSnapBounds(control::Vec3& lo, control::Vec3& hi, const control::Vec3& p, double r)
+{
+    const double m = r + SNAP_MARGIN;
+    bool changed = false;
+    auto widen = [&](double& l, double& h, double v) {
+        if (v - r < l) { l = v - m; changed = true; }
+        if (v + r > h) { h = v + m; changed = true; }
+    };
+    widen(lo.x, hi.x, p.x);
+    widen(lo.y, hi.y, p.y);
+    widen(lo.z, hi.z, p.z);
+    return changed;
+}
+
+// The trail ring lives in a persistently mapped vertex buffer when the
+// driver has GL 4.4 buffer storage, so each timer tick writes only the
+// new samples and nothing is re-uploaded; otherwise it stays in client
+// memory and is drawn from there
+struct TrailGL
+{
+    GLuint vbo   = 0;
+    GLsync fence = nullptr;   // last draw that reads the buffer
+    std::vector<GLint>   first;
+    std::vector<GLsizei> count;
+
+    PFNGLGENBUFFERSPROC       GenBuffers       = nullptr;
+    PFNGLDELETEBUFFERSPROC    DeleteBuffers    = nullptr;
+    PFNGLBINDBUFFERPROC       BindBuffer       = nullptr;
+    PFNGLBUFFERSTORAGEPROC    BufferStorage    = nullptr;
+    PFNGLMAPBUFFERRANGEPROC   MapBufferRange   = nullptr;
+    PFNGLFENCESYNCPROC        FenceSync        = nullptr;
+    PFNGLCLIENTWAITSYNCPROC   ClientWaitSync   = nullptr;
+    PFNGLDELETESYNCPROC       DeleteSync       = nullptr;
+    PFNGLMULTIDRAWARRAYSPROC  MultiDrawArrays  = nullptr;
+} g_trailGL;
 
 // OBJ model
 // ------------------------------------------
@@ -50,6 +189,7 @@ GLuint   g_uavTex = 0;            // UAV texture ID
 // ------------------------------------------
 bool loadOBJ(const char* filename, ObjModel& model)
 {
+    sim::MemScope tag(sim::Subsystem::AssetIO);
     std::ifstream in(filename);
     if (!in)
     {
@@ -215,6 +355,7 @@ bool loadOBJ(const char* filename, ObjModel& model)
 // BMP loader for field texture
 // ------------------------------------------
 bool loadBMP(const char* filename, GLuint& texId) {
+    sim::MemScope tag(sim::Subsystem::AssetIO);
     unsigned char header[54];
     unsigned int dataPos;
     unsigned int width, height;
@@ -268,10 +409,67 @@ bool loadBMP(const char* filename, GLuint& texId) {
     return true;
 }
 
+// Streamed field: upload a few finished tiles, then pick the tiles for
+// every view at once, each from the best level resident so far
+void planFieldTiles()
+{
+    // Tile rows are tightly packed (3 * tileSize bytes)
+    const GLsizei ts = static_cast<GLsizei>(g_fieldTiles.header().tileSize);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    g_fieldTiles.poll(TILE_UPLOADS_PER_FRAME, [ts](int slot, const uint8_t* texels) {
+        glBindTexture(GL_TEXTURE_2D, g_tileTex[slot]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, ts, ts, GL_BGR, GL_UNSIGNED_BYTE, texels);
+    });
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // The map is orthographic: treat it as seen from its eye height
+    g_tileViews.clear();
+    for (const View& v : g_views)
+    {
+        const double pixelAngle = v.kind == ViewKind::Map
+            ? 2.0 * v.halfH / v.h / v.eye.z
+            : CAM_FOVY * 3.14159265358979 / 180.0 / v.h;
+        g_tileViews.push_back({ v.eye, pixelAngle });
+    }
+    g_fieldTiles.plan(g_tileViews, g_tileDraws);
+}
+
+void drawFieldTiles(const std::vector<sim::TileDraw>& draws)
+{
+    for (const sim::TileDraw& d : draws)
+    {
+        if (d.slot < 0)
+        {
+            glDisable(GL_TEXTURE_2D);
+            glColor3f(0.1f, 0.5f, 0.1f);
+        }
+        else
+        {
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, g_tileTex[d.slot]);
+            glColor3f(1.0f, 1.0f, 1.0f);
+        }
+        glBegin(GL_QUADS);
+            glTexCoord2f(d.s0, d.t0); glVertex3f(d.x0, d.y0, 0.0f);
+            glTexCoord2f(d.s1, d.t0); glVertex3f(d.x1, d.y0, 0.0f);
+            glTexCoord2f(d.s1, d.t1); glVertex3f(d.x1, d.y1, 0.0f);
+            glTexCoord2f(d.s0, d.t1); glVertex3f(d.x0, d.y1, 0.0f);
+        glEnd();
+    }
+
+    glDisable(GL_TEXTURE_2D);
+}
+
 // Convert from field / world units directly to OpenGL space
 // ------------------------------------------
-void drawField() 
+void drawField(size_t view) 
 {
+    if (g_fieldTiles.isOpen())
+    {
+        drawFieldTiles(g_tileDraws[view]);
+        return;
+    }
+
     if (g_fieldTex == 0) 
     {
         // fallback to simple green quad if texture failed
@@ -355,40 +553,535 @@ void drawUAV(const control::Vec3& pos)
     glPopMatrix();
 }
 
-void display() 
+// Camera
+// ------------------------------------------
+control::Vec3 cameraEye()
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const double DEG = 3.14159265358979 / 180.0;
+    double cp = std::cos(g_camPitch * DEG);
+    return g_camTarget + control::Vec3(cp * std::cos(g_camYaw * DEG),
+                                       cp * std::sin(g_camYaw * DEG),
+                                       std::sin(g_camPitch * DEG)) * g_camDist;
+}
+
+// Camera basis: forward, right and up (world z stays up)
+void cameraBasis(control::Vec3& fwd, control::Vec3& right, control::Vec3& up)
+{
+    fwd = (g_camTarget - cameraEye()).normalized();
+    right = control::Vec3(fwd.y, -fwd.x, 0.0).normalized();   // fwd x (0, 0, 1)
+    up = control::Vec3(right.y * fwd.z - right.z * fwd.y,
+                       right.z * fwd.x - right.x * fwd.z,
+                       right.x * fwd.y - right.y * fwd.x);
+}
+
+// Viewports
+// ------------------------------------------
+// Pixel rectangles for the current layout (on reshape and 'v')
+void layoutViews()
+{
+    g_views.clear();
+    g_views.push_back({ ViewKind::Orbit, 0.0f, 0.0f, 1.0f, 1.0f });
+    if (g_splitViews)
+    {
+        g_views[0].fw = 2.0f / 3.0f;
+        g_views.push_back({ ViewKind::Chase, 2.0f / 3.0f, 0.5f, 1.0f / 3.0f, 0.5f });
+        g_views.push_back({ ViewKind::Map,   2.0f / 3.0f, 0.0f, 1.0f / 3.0f, 0.5f });
+    }
+    for (View& v : g_views)
+    {
+        v.x = static_cast<int>(v.fx * g_winW);
+        v.y = static_cast<int>(v.fy * g_winH);
+        v.w = std::max(1, static_cast<int>((v.fx + v.fw) * g_winW) - v.x);
+        v.h = std::max(1, static_cast<int>((v.fy + v.fh) * g_winH) - v.y);
+    }
+}
+
+// Cameras for this frame, from the orbit controls and the snapshot
+void aimViews()
+{
+    const control::Vec3 zUp(0.0, 0.0, 1.0);
+    for (View& v : g_views)
+    {
+        v.up = zUp;
+        if (v.kind == ViewKind::Orbit)
+        {
+            v.eye = cameraEye();
+            v.target = g_camTarget;
+        }
+        else if (v.kind == ViewKind::Chase)
+        {
+            // Behind and above the selected drone (drone 0 if none), along
+            // its horizontal velocity
+            const size_t n = g_snapPos.size();
+            const size_t i = g_selected >= 0 && static_cast<size_t>(g_selected) < n ? g_selected : 0;
+            control::Vec3 p = n ? g_snapPos[i] : g_camTarget;
+            control::Vec3 vel;
+            if (n) g_snapCodec.decode(1, &g_snapFrame[i], nullptr, &vel, nullptr);
+            control::Vec3 dir(vel.x, vel.y, 0.0);
+            dir = dir.mag() > 0.2 ? dir.normalized() : control::Vec3(1.0, 0.0, 0.0);
+            v.eye = p - dir * 6.0 + zUp * 2.0;
+            v.target = p + dir * 2.0;
+        }
+        else
+        {
+            // Straight down over the whole field, x to the right
+            const double aspect = static_cast<double>(v.w) / v.h;
+            v.halfH = 1.05 * std::max(0.5 * FIELD_WIDTH, 0.5 * FIELD_LENGTH / aspect);
+            v.halfW = v.halfH * aspect;
+            v.eye = control::Vec3(0.0, 0.0, 150.0);
+            v.target = control::Vec3(0.0, 0.0, 0.0);
+            v.up = control::Vec3(0.0, 1.0, 0.0);
+        }
+    }
+}
+
+void applyView(const View& v)
+{
+    glViewport(v.x, v.y, v.w, v.h);
+    glScissor(v.x, v.y, v.w, v.h);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    const double aspect = static_cast<double>(v.w) / v.h;
+    if (v.kind == ViewKind::Map)
+        glOrtho(-v.halfW, v.halfW, -v.halfH, v.halfH, 1.0, 500.0);
+    else
+        gluPerspective(CAM_FOVY, aspect, v.kind == ViewKind::Chase ? 0.1 : 1.0, 500.0);
 
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
+    gluLookAt(v.eye.x, v.eye.y, v.eye.z,
+              v.target.x, v.target.y, v.target.z,
+              v.up.x, v.up.y, v.up.z);
+}
 
-    // Simple camera looking at the origin from above-diagonal
-    gluLookAt(g_camDist, g_camDist, g_camDist,
-              0.0, 0.0, 20.0,
-              0.0, 0.0, 1.0);
+sim::Frustum viewFrustum(const View& v)
+{
+    if (v.kind == ViewKind::Map)
+        return sim::Frustum::orthographic(v.eye, v.target, v.up, v.halfW, v.halfH, 1.0, 500.0);
+    return sim::Frustum::perspective(v.eye, v.target, v.up, CAM_FOVY,
+                                     static_cast<double>(v.w) / v.h,
+                                     v.kind == ViewKind::Chase ? 0.1 : 1.0, 500.0);
+}
 
-    drawField();
+// Window pixel (x, y from the top) to the orbit view's pixel; false
+// outside it
+bool toOrbitView(int& x, int& y)
+{
+    if (g_views.empty()) layoutViews();
+    const View& v = g_views[0];
+    x -= v.x;
+    y -= g_winH - (v.y + v.h);
+    return x >= 0 && y >= 0 && x < v.w && y < v.h;
+}
 
-    // Draw all UAVs
-    for (auto& u : g_uavs) 
+// World-space ray through orbit-view pixel (x, y)
+control::Vec3 pixelRay(int x, int y)
+{
+    control::Vec3 fwd, right, up;
+    cameraBasis(fwd, right, up);
+    const View& v = g_views[0];
+    double tanHalf = std::tan(0.5 * CAM_FOVY * 3.14159265358979 / 180.0);
+    double aspect = static_cast<double>(v.w) / v.h;
+    double nx = 2.0 * (x + 0.5) / v.w - 1.0;
+    double ny = 1.0 - 2.0 * (y + 0.5) / v.h;
+    return (fwd + right * (nx * tanHalf * aspect) + up * (ny * tanHalf)).normalized();
+}
+
+// Select the nearest drone under window pixel (x, y), or clear the
+// selection; clicks outside the orbit view are ignored
+void pickAt(int x, int y)
+{
+    if (!toOrbitView(x, y)) return;
+    if (g_pickGridStale)
     {
-        control::Vec3 p = u->getPosition();
-        drawUAV(p);
+        g_pickGrid.build(g_snapPos, PICK_CELL);
+        g_pickGridStale = false;
     }
+    uint32_t hit = g_pickGrid.raycast(g_snapPos, cameraEye(), pixelRay(x, y),
+                                      PICK_RADIUS, 1000.0);
+    g_selected = hit == sim::SpatialGrid::noHit ? -1 : static_cast<int>(hit);
+}
 
-    glutSwapBuffers();
+void mouse(int button, int state, int x, int y)
+{
+    // Wheel: freeglut reports it as buttons 3 (up) and 4 (down)
+    if (button == 3 || button == 4)
+    {
+        if (state == GLUT_DOWN)
+        {
+            g_camDist *= button == 3 ? 0.9f : 1.0f / 0.9f;
+            g_camDist = std::max(2.0f, std::min(g_camDist, 400.0f));
+        }
+        return;
+    }
+
+    if (state == GLUT_DOWN)
+    {
+        g_mouseButton = button;
+        g_mouseX = x;
+        g_mouseY = y;
+        g_dragged = false;
+    }
+    else
+    {
+        if (button == GLUT_LEFT_BUTTON && !g_dragged) pickAt(x, y);
+        g_mouseButton = -1;
+    }
 }
 
-void reshape(int w, int h) 
+void motion(int x, int y)
 {
-    if (h == 0) h = 1;
-    float aspect = static_cast<float>(w) / h;
+    int dx = x - g_mouseX, dy = y - g_mouseY;
+    if (std::abs(dx) + std::abs(dy) > 2) g_dragged = true;
+    if (!g_dragged) return;
+    g_mouseX = x;
+    g_mouseY = y;
+
+    if (g_mouseButton == GLUT_LEFT_BUTTON)
+    {
+        g_camYaw -= 0.4f * dx;
+        g_camPitch = std::max(-5.0f, std::min(g_camPitch + 0.4f * dy, 89.0f));
+    }
+    else if (g_mouseButton == GLUT_RIGHT_BUTTON)
+    {
+        // Move the target so the scene follows the cursor at target depth
+        control::Vec3 fwd, right, up;
+        cameraBasis(fwd, right, up);
+        if (g_views.empty()) layoutViews();
+        double perPixel = 2.0 * g_camDist * std::tan(0.5 * CAM_FOVY * 3.14159265358979 / 180.0) / g_views[0].h;
+        g_camTarget -= right * (dx * perPixel);
+        g_camTarget += up * (dy * perPixel);
+    }
+}
+
+void keyboard(unsigned char key, int, int)
+{
+    if (key == 'r')
+    {
+        g_camTarget = control::Vec3(0.0, 0.0, 20.0);
+        g_camDist = 128.06f;
+        g_camYaw = 45.0f;
+        g_camPitch = 27.94f;
+    }
+    else if (key == 'h')
+    {
+        g_showCoverage = !g_showCoverage;
+    }
+    else if (key == 't')
+    {
+        g_showTrails = !g_showTrails;
+    }
+    else if (key == 'v')
+    {
+        g_splitViews = !g_splitViews;
+        layoutViews();
+    }
+    else if (key == 27)
+    {
+        g_selected = -1;
+    }
+}
 
-    glViewport(0, 0, w, h);
+// Selected drone: highlight in each view plus a text panel
+// ------------------------------------------
+void drawSelection()
+{
+    if (g_selected < 0 || g_selected >= static_cast<int>(g_uavs.size())) return;
+    sim::UAV::Status st = g_uavs[g_selected]->getStatus();
+
+    glDisable(GL_TEXTURE_2D);
+    glColor3f(1.0f, 1.0f, 0.0f);
+    glPushMatrix();
+    glTranslated(st.state.pos.x, st.state.pos.y, st.state.pos.z);
+    glutWireSphere(PICK_RADIUS, 12, 8);
+    glPopMatrix();
+}
 
+// Text panel for the selected drone, top-left of the window
+void drawSelectionPanel()
+{
+    if (g_selected < 0 || g_selected >= static_cast<int>(g_uavs.size())) return;
+    sim::UAV::Status st = g_uavs[g_selected]->getStatus();
+
+    char lines[5][96];
+    std::snprintf(lines[0], sizeof(lines[0]), "UAV %d  %s  %.1f s",
+                  g_selected, control::phaseToString(st.phase), st.timeInPhase);
+    std::snprintf(lines[1], sizeof(lines[1]), "pos (%.2f, %.2f, %.2f)",
+                  st.state.pos.x, st.state.pos.y, st.state.pos.z);
+    std::snprintf(lines[2], sizeof(lines[2]), "vel (%.2f, %.2f, %.2f)  |v| %.2f m/s",
+                  st.state.vel.x, st.state.vel.y, st.state.vel.z, st.state.vel.mag());
+    std::snprintf(lines[3], sizeof(lines[3]), "radial PID  err %.3f  int %.3f",
+                  st.radialError, st.radialIntegral);
+    std::snprintf(lines[4], sizeof(lines[4]), "speed PID   err %.3f  int %.3f",
+                  st.speedError, st.speedIntegral);
+
+    // Screen-space text in the top-left corner
     glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
     glLoadIdentity();
-    gluPerspective(60.0, aspect, 1.0, 500.0);
+    gluOrtho2D(0, g_winW, 0, g_winH);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glDisable(GL_DEPTH_TEST);
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    for (int k = 0; k < 5; ++k)
+    {
+        glRasterPos2i(8, g_winH - 18 - 15 * k);
+        glutBitmapString(GLUT_BITMAP_8_BY_13, reinterpret_cast<const unsigned char*>(lines[k]));
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+// Trails
+// ------------------------------------------
+template <typename Fn>
+void loadGL(Fn& fn, const char* name)
+{
+    fn = reinterpret_cast<Fn>(glutGetProcAddress(name));
+}
+
+void initTrails()
+{
+    TrailGL& gl = g_trailGL;
+    loadGL(gl.GenBuffers, "glGenBuffers");
+    loadGL(gl.DeleteBuffers, "glDeleteBuffers");
+    loadGL(gl.BindBuffer, "glBindBuffer");
+    loadGL(gl.BufferStorage, "glBufferStorage");
+    loadGL(gl.MapBufferRange, "glMapBufferRange");
+    loadGL(gl.FenceSync, "glFenceSync");
+    loadGL(gl.ClientWaitSync, "glClientWaitSync");
+    loadGL(gl.DeleteSync, "glDeleteSync");
+    loadGL(gl.MultiDrawArrays, "glMultiDrawArrays");
+
+    const size_t bytes = sim::TrailBuffer::floatsNeeded(g_uavs.size(), TRAIL_LENGTH) * sizeof(float);
+    void* mapped = nullptr;
+    if (gl.GenBuffers && gl.DeleteBuffers && gl.BindBuffer && gl.BufferStorage
+        && gl.MapBufferRange && gl.FenceSync && gl.ClientWaitSync && gl.DeleteSync)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        gl.GenBuffers(1, &gl.vbo);
+        gl.BindBuffer(GL_ARRAY_BUFFER, gl.vbo);
+        gl.BufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        mapped = gl.MapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags);
+        gl.BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if (!mapped)
+    {
+        printf("No persistent buffer mapping, trails drawn from client memory.\n");
+        if (gl.vbo) gl.DeleteBuffers(1, &gl.vbo);
+        gl.vbo = 0;
+    }
+    g_trails.reset(g_uavs.size(), TRAIL_LENGTH, static_cast<float*>(mapped));
+}
+
+// Append the current positions (called from the timer)
+void pushTrails(const std::vector<control::Vec3>& positions)
+{
+    TrailGL& gl = g_trailGL;
+    if (gl.fence)
+    {
+        // The GPU may still be reading the slots about to be overwritten
+        gl.ClientWaitSync(gl.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+        gl.DeleteSync(gl.fence);
+        gl.fence = nullptr;
+    }
+
+    g_trails.push(positions);
+}
+
+void drawTrails()
+{
+    const int samples = g_trails.samples();
+    if (!g_showTrails || samples < 2) return;
+
+    TrailGL& gl = g_trailGL;
+    const size_t n = g_trails.drones();
+    gl.first.resize(n);
+    gl.count.assign(n, samples);
+    for (size_t i = 0; i < n; ++i)
+    {
+        gl.first[i] = static_cast<GLint>(g_trails.first(i));
+    }
+
+    glDisable(GL_TEXTURE_2D);
+    glColor3f(1.0f, 0.85f, 0.3f);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (gl.vbo)
+    {
+        gl.BindBuffer(GL_ARRAY_BUFFER, gl.vbo);
+        glVertexPointer(3, GL_FLOAT, 0, nullptr);
+    }
+    else
+    {
+        glVertexPointer(3, GL_FLOAT, 0, g_trails.data());
+    }
+
+    if (gl.MultiDrawArrays)
+    {
+        gl.MultiDrawArrays(GL_LINE_STRIP, gl.first.data(), gl.count.data(),
+                           static_cast<GLsizei>(n));
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i) glDrawArrays(GL_LINE_STRIP, gl.first[i], samples);
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (gl.vbo)
+    {
+        gl.BindBuffer(GL_ARRAY_BUFFER, 0);
+        // Drawn once per view; the last fence covers the earlier draws
+        if (gl.fence) gl.DeleteSync(gl.fence);
+        gl.fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+// Coverage heatmap
+// ------------------------------------------
+// Translucent shell over the mission sphere, each cell coloured by the
+// time drones spent in it (blue -> red), unvisited cells grey
+void drawCoverage(const control::ControlConfig& cfg)
+{
+    if (!g_showCoverage || g_coverage.cells() == 0) return;
+
+    const std::vector<uint32_t>& dwell = g_coverage.dwellTicks();
+    const float scale = g_coverage.maxDwell() ? 1.0f / g_coverage.maxDwell() : 0.0f;
+    const double r = cfg.sphereRadius;
+
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+
+    glBegin(GL_QUADS);
+    for (size_t c = 0; c < g_coverage.cells(); ++c)
+    {
+        if (dwell[c] == 0)
+        {
+            glColor4f(0.5f, 0.5f, 0.5f, 0.15f);
+        }
+        else
+        {
+            float t = std::sqrt(dwell[c] * scale);
+            glColor4f(t, 0.2f, 1.0f - t, 0.45f);
+        }
+
+        double z0, z1, p0, p1;
+        g_coverage.cellBounds(static_cast<int>(c), z0, z1, p0, p1);
+        const double zs[4]   = { z0, z0, z1, z1 };
+        const double phis[4] = { p0, p1, p1, p0 };
+        for (int k = 0; k < 4; ++k)
+        {
+            double rho = std::sqrt(std::max(0.0, 1.0 - zs[k] * zs[k]));
+            glVertex3d(cfg.center.x + r * rho * std::cos(phis[k]),
+                       cfg.center.y + r * rho * std::sin(phis[k]),
+                       cfg.center.z + r * zs[k]);
+        }
+    }
+    glEnd();
+
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+// Running coverage metrics in the bottom-left corner of the window
+void drawCoverageStats()
+{
+    if (!g_showCoverage || g_coverage.cells() == 0) return;
+
+    sim::CoverageStats st = g_coverage.stats();
+    char line[128];
+    std::snprintf(line, sizeof(line), "coverage %.1f%%  revisit mean %.1f s max %.1f s  stalest %.1f s",
+                  100.0 * st.fraction(), st.meanRevisit, st.maxRevisit, st.maxGap);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, g_winW, 0, g_winH);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glDisable(GL_DEPTH_TEST);
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    glRasterPos2i(8, 8);
+    glutBitmapString(GLUT_BITMAP_8_BY_13, reinterpret_cast<const unsigned char*>(line));
+
+    glEnable(GL_DEPTH_TEST);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void display() 
+{
+    if (g_views.empty()) layoutViews();
+
+    // Cameras, then one culling pass over the snapshot for all of them
+    aimViews();
+    g_frusta.clear();
+    for (const View& v : g_views) g_frusta.push_back(viewFrustum(v));
+    sim::cullViews(g_snapPos, CULL_RADIUS, g_frusta, g_visible);
+    if (g_fieldTiles.isOpen()) planFieldTiles();
+
+    glEnable(GL_SCISSOR_TEST);
+    for (size_t k = 0; k < g_views.size(); ++k)
+    {
+        const View& v = g_views[k];
+        applyView(v);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        drawField(k);
+
+        // This view's UAVs; the map marks them as points, the models
+        // would be sub-pixel there
+        if (v.kind == ViewKind::Map)
+        {
+            glDisable(GL_TEXTURE_2D);
+            glDisable(GL_DEPTH_TEST);
+            glPointSize(4.0f);
+            glColor3f(1.0f, 0.3f, 0.3f);
+            glBegin(GL_POINTS);
+            for (uint32_t i : g_visible[k]) glVertex3d(g_snapPos[i].x, g_snapPos[i].y, g_snapPos[i].z);
+            glEnd();
+            glEnable(GL_DEPTH_TEST);
+        }
+        else
+        {
+            for (uint32_t i : g_visible[k]) drawUAV(g_snapPos[i]);
+        }
+
+        drawTrails();
+        if (v.kind == ViewKind::Orbit) drawCoverage(g_missionCfg);
+        drawSelection();
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    // Text over the whole window
+    glViewport(0, 0, g_winW, g_winH);
+    drawCoverageStats();
+    drawSelectionPanel();
+
+    glutSwapBuffers();
+}
+
+void reshape(int w, int h) 
+{
+    if (h == 0) h = 1;
+    g_winW = w;
+    g_winH = h;
+
+    // Viewports and projections are set per view in display()
+    layoutViews();
 }
 
 void timer(int value) 
@@ -396,6 +1089,56 @@ void timer(int value)
     // Simulation-side collision handling
     sim::checkAndResolveCollisions(g_uavs, 0.01);
 
+    // One snapshot of every drone for the models, trails and coverage grid
+    const size_t n = g_uavs.size();
+    g_rawPos.resize(n);
+    g_rawVel.resize(n);
+    g_rawPhase.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        sim::UAV::Status st = g_uavs[i]->getStatus();
+        g_rawPos[i] = st.state.pos;
+        g_rawVel[i] = st.state.vel;
+        g_rawPhase[i] = static_cast<uint8_t>(st.phase);
+    }
+    g_snapFrame.resize(n);
+    g_snapCodec.encode(n, g_rawPos.data(), g_rawVel.data(), g_rawPhase.data(), g_snapFrame.data());
+
+    // Anything clamped (out of the bounds or over maxSpeed): re-fit the
+    // codec around it and encode again. Non-finite state stays flagged.
+    control::Vec3 lo = g_snapCodec.boundsLo(), hi = g_snapCodec.boundsHi();
+    double vmax = g_snapCodec.maxSpeed();
+    bool refit = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!(g_snapFrame[i].flags & sim::PackedDrone::Clamped)) continue;
+        const control::Vec3& p = g_rawPos[i];
+        if (std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z))
+            refit |= widenSnapBounds(lo, hi, p, 0.0);
+        const double v = g_rawVel[i].mag();
+        if (std::isfinite(v) && v > vmax)
+        {
+            vmax = 1.5 * v;
+            refit = true;
+        }
+    }
+    if (refit)
+    {
+        g_snapCodec = sim::SnapshotCodec(lo, hi, vmax);
+        g_snapCodec.encode(n, g_rawPos.data(), g_rawVel.data(), g_rawPhase.data(), g_snapFrame.data());
+    }
+
+    g_snapPos.resize(n);
+    g_snapOnSphere.resize(n);
+    g_snapCodec.decodePositions(n, g_snapFrame.data(), g_snapPos.data());
+    for (size_t i = 0; i < n; ++i)
+    {
+        g_snapOnSphere[i] = g_snapFrame[i].phase == static_cast<uint8_t>(control::Phase::OnSphere);
+    }
+    g_pickGridStale = true;
+    pushTrails(g_snapPos);
+    g_coverage.update(glutGet(GLUT_ELAPSED_TIME) * 1e-3, g_snapPos, g_snapOnSphere);
+
     glutPostRedisplay();
     glutTimerFunc(30, timer, 0); // ~30 ms
 }
@@ -405,8 +1148,24 @@ void initGL()
     glEnable(GL_DEPTH_TEST);
     glClearColor(0.2f, 0.4f, 0.7f, 1.0f);
 
-    // Load field texture
-    if (!loadBMP("ff.bmp", g_fieldTex)) 
+    // Field texture: streamed tiles when baked, else the single BMP
+    if (g_fieldTiles.open("ff.tiles"))
+    {
+        sim::MemScope tag(sim::Subsystem::AssetIO);
+        const GLsizei ts = static_cast<GLsizei>(g_fieldTiles.header().tileSize);
+        g_tileTex.resize(g_fieldTiles.config().slots);
+        glGenTextures(static_cast<GLsizei>(g_tileTex.size()), g_tileTex.data());
+        for (GLuint t : g_tileTex)
+        {
+            glBindTexture(GL_TEXTURE_2D, t);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, ts, ts, 0, GL_BGR, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+    }
+    else if (!loadBMP("ff.bmp", g_fieldTex)) 
     {
         printf("Failed to load ff.bmp, using flat green field.\n");
         g_fieldTex = 0;
@@ -427,34 +1186,120 @@ void initGL()
         printf("Failed to load Pingu_obj.obj, falling back to sphere.\n");
         g_chicken.loaded = false;
     }
+
+    initTrails();
 }
 
 // Main
 // ------------------------------------------
 int main(int argc, char** argv) 
 {
+    // --profile: sample the UAV threads and the render loop, report at exit
+    // --scenario <file>: drones and missions from a scenario file (text
+    // or compiled, see scenario_file.h) instead of the lab layout
+    const char* scenarioPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--profile" &&
+            sim::Profiler::instance().start(sim::Subsystem::Render))
+        {
+            std::atexit([] {
+                sim::Profiler::instance().stop();
+                sim::printMemReport(stderr, "at exit");
+            });
+        }
+        if (std::string(argv[i]) == "--scenario" && i + 1 < argc)
+        {
+            scenarioPath = argv[++i];
+        }
+    }
+    sim::ScenarioFile scenarioFile;
+    sim::Scenario scenarioText;
+    sim::ScenarioView scenario;
+    std::string scenarioError;
+    if (scenarioPath && !sim::openScenario(scenarioPath, scenarioFile, scenarioText, scenario, scenarioError))
+    {
+        std::fprintf(stderr, "%s: %s\n", scenarioPath, scenarioError.c_str());
+        return 1;
+    }
+    if (scenarioPath && scenario.drones > MAX_VIEWER_DRONES)
+    {
+        std::fprintf(stderr, "%s: %zu drones, but the viewer runs one thread per drone and takes at most "
+                     "%zu; fly larger scenarios on sim::Swarm (ScenarioView::loadInto)\n",
+                     scenarioPath, scenario.drones, MAX_VIEWER_DRONES);
+        return 1;
+    }
+    if (scenarioPath)
+    {
+        // sim::UAV has one built-in airframe, flies zero yaw and has no
+        // planner, so say what of the scenario is left out
+        bool yawed = false;
+        for (size_t i = 0; i < scenario.drones && !yawed; ++i) yawed = scenario.yaw[i] != 0.0;
+        if (scenario.airframeCount > 0)
+            std::fprintf(stderr, "%s: warning: %zu airframe(s) ignored, the viewer's drones share one\n",
+                         scenarioPath, scenario.airframeCount);
+        if (yawed)
+            std::fprintf(stderr, "%s: warning: initial yaw ignored, the viewer's drones fly zero yaw\n",
+                         scenarioPath);
+        if (scenario.obstacleCount > 0)
+            std::fprintf(stderr, "%s: warning: %zu obstacle(s) ignored, the viewer does not plan climbs\n",
+                         scenarioPath, scenario.obstacleCount);
+    }
+
+    // Heap use on this thread is the render loop's unless a scope says otherwise
+    sim::setMemTag(sim::Subsystem::Render);
+
     // Create 15 UAVs on different start positions
-    control::ControlConfig cfg;
+    control::ControlConfig& cfg = g_missionCfg;
     cfg.center = control::Vec3(0, 0, 50);
     cfg.sphereRadius = 10.0;
+    if (scenario.missionCount > 0)
+    {
+        cfg = scenario.missions[0];   // coverage and the HUD follow mission 0
+    }
+    g_coverage.configure(cfg.center, cfg.sphereRadius);
+
+    // Snapshot bounds around everything the scenario can reach
+    {
+        control::Vec3 lo = g_snapCodec.boundsLo(), hi = g_snapCodec.boundsHi();
+        widenSnapBounds(lo, hi, cfg.center, cfg.sphereRadius);
+        for (size_t m = 0; m < scenario.missionCount; ++m)
+        {
+            widenSnapBounds(lo, hi, scenario.missions[m].center, scenario.missions[m].sphereRadius);
+        }
+        for (size_t i = 0; i < scenario.drones; ++i) widenSnapBounds(lo, hi, scenario.positions[i], 0.0);
+        g_snapCodec = sim::SnapshotCodec(lo, hi, g_snapCodec.maxSpeed());
+    }
 
     // 3 rows × 5 columns = 15
     std::vector<double> xCols = { -46, -24, -2, 20, 44.0 };
     std::vector<double> yRows = { -22.5, 0.0, 22.5 };
 
-    for (double y : yRows) 
+    // UAV objects and their threads count as physics
     {
-        for (double x : xCols) 
+        sim::MemScope uavTag(sim::Subsystem::Physics);
+        for (size_t i = 0; i < scenario.drones; ++i)
         {
-            control::Vec3 startPos(x, y, 0.0); // on ground grid points
-            g_uavs.emplace_back(std::make_unique<sim::UAV>(startPos, cfg));
+            const control::ControlConfig& mission = scenario.missions[scenario.missionIds[i]];
+            g_uavs.emplace_back(std::make_unique<sim::UAV>(scenario.positions[i], mission));
+        }
+        if (!scenarioPath)
+        {
+            for (double y : yRows)
+            {
+                for (double x : xCols)
+                {
+                    control::Vec3 startPos(x, y, 0.0); // on ground grid points
+                    g_uavs.emplace_back(std::make_unique<sim::UAV>(startPos, cfg));
+                }
+            }
         }
-    }
 
-    // Start all worker threads
-    for (auto& u : g_uavs) 
-    {
-        u->start();
+        // Start all worker threads
+        for (auto& u : g_uavs) 
+        {
+            u->start();
+        }
     }
 
     // OpenGL setup
@@ -468,6 +1313,9 @@ int main(int argc, char** argv)
 
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
+    glutMouseFunc(mouse);
+    glutMotionFunc(motion);
+    glutKeyboardFunc(keyboard);
     glutTimerFunc(30, timer, 0);
 
     glutMainLoop();
@@ -0,0 +1,249 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the heap accounting hooks.
+*/
+
+#include "memtrack.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+
+namespace
+{
+
+constexpr int kTags = static_cast<int>(Subsystem::Count);
+
+struct Counter
+{
+    std::atomic<int64_t>  live{ 0 };
+    std::atomic<int64_t>  peak{ 0 };
+    std::atomic<uint64_t> allocs{ 0 };
+    std::atomic<uint64_t> frees{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+};
+
+// One per subsystem plus the process total; constant-initialised, so
+// allocations made before main() (or by other static constructors) count
+Counter counters[kTags + 1];
+
+thread_local Subsystem currentTag = Subsystem::Other;
+
+#ifdef UAV_MEMTRACK
+void charge(Counter& c, int64_t size)
+{
+    const int64_t now = c.live.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = c.peak.load(std::memory_order_relaxed);
+    while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+    c.allocs.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+}
+
+void refund(Counter& c, int64_t size)
+{
+    c.live.fetch_sub(size, std::memory_order_relaxed);
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+MemStats read(const Counter& c)
+{
+    MemStats s;
+    s.live   = c.live.load(std::memory_order_relaxed);
+    s.peak   = c.peak.load(std::memory_order_relaxed);
+    s.allocs = c.allocs.load(std::memory_order_relaxed);
+    s.frees  = c.frees.load(std::memory_order_relaxed);
+    s.bytes  = c.bytes.load(std::memory_order_relaxed);
+    return s;
+}
+
+size_t statmField(int field)
+{
+#ifdef __linux__
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long v[2] = { 0, 0 };
+    const int got = std::fscanf(f, "%lu %lu", &v[0], &v[1]);
+    std::fclose(f);
+    return got == 2 ? v[field] * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    (void)field;
+    return 0;
+#endif
+}
+
+} // namespace
+
+#ifdef UAV_MEMTRACK
+
+// ------------------------------------------
+// Allocation hooks
+// ------------------------------------------
+// Each block carries a 16-byte header just below the user pointer with
+// the requested size, the distance back to the malloc'd base (for
+// over-aligned blocks) and the subsystem it was charged to.
+namespace
+{
+
+struct alignas(16) Header
+{
+    uint64_t size;
+    uint32_t offset;
+    uint32_t tag;
+};
+static_assert(sizeof(Header) == 16, "header must keep default new alignment");
+
+void* trackedAlloc(size_t size, size_t align) noexcept
+{
+    align = align < sizeof(Header) ? sizeof(Header) : align;
+    const size_t slack = align > sizeof(Header) ? align : 0;
+    if (size > SIZE_MAX - sizeof(Header) - slack) return nullptr;
+    char* base = static_cast<char*>(std::malloc(size + sizeof(Header) + slack));
+    if (!base) return nullptr;
+
+    // malloc already gives 16-byte alignment; larger ones are rounded up
+    uintptr_t user = reinterpret_cast<uintptr_t>(base) + sizeof(Header);
+    user = (user + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+
+    Header* h = reinterpret_cast<Header*>(user) - 1;
+    h->size   = size;
+    h->offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(base));
+    h->tag    = static_cast<uint32_t>(currentTag);
+    charge(counters[h->tag], static_cast<int64_t>(size));
+    charge(counters[kTags], static_cast<int64_t>(size));
+    return reinterpret_cast<void*>(user);
+}
+
+void trackedFree(void* p) noexcept
+{
+    if (!p) return;
+    Header* h = static_cast<Header*>(p) - 1;
+    refund(counters[h->tag], static_cast<int64_t>(h->size));
+    refund(counters[kTags], static_cast<int64_t>(h->size));
+    std::free(static_cast<char*>(p) - h->offset);
+}
+
+void* allocOrThrow(size_t size, size_t align)
+{
+    while (true)
+    {
+        if (void* p = trackedAlloc(size, align)) return p;
+        std::new_handler h = std::get_new_handler();
+        if (!h) throw std::bad_alloc();
+        h();
+    }
+}
+
+} // namespace
+
+#endif
+
+bool memTrackingEnabled()
+{
+#ifdef UAV_MEMTRACK
+    return true;
+#else
+    return false;
+#endif
+}
+
+Subsystem memTag()
+{
+    return currentTag;
+}
+
+void setMemTag(Subsystem s)
+{
+    currentTag = s;
+}
+
+MemStats memStats(Subsystem s)
+{
+    return read(counters[static_cast<int>(s)]);
+}
+
+MemStats memTotal()
+{
+    return read(counters[kTags]);
+}
+
+void resetMemPeaks()
+{
+    for (Counter& c : counters)
+    {
+        c.peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+size_t residentBytes()
+{
+    return statmField(1);
+}
+
+size_t virtualBytes()
+{
+    return statmField(0);
+}
+
+void printMemReport(std::FILE* out, const char* title)
+{
+    const double MB = 1.0 / (1024.0 * 1024.0);
+    std::fprintf(out, "== memory: %s (RSS %.1f MB) ==\n", title, residentBytes() * MB);
+    if (!memTrackingEnabled())
+    {
+        std::fprintf(out, "  heap tracking not built in (UAV_MEMTRACK=OFF)\n");
+        return;
+    }
+    std::fprintf(out, "  %-10s %10s %10s %12s %12s\n", "subsystem", "live MB", "peak MB", "allocs", "frees");
+    for (int k = 0; k <= kTags; ++k)
+    {
+        const MemStats s = read(counters[k]);
+        std::fprintf(out, "  %-10s %10.2f %10.2f %12llu %12llu\n",
+                     k < kTags ? subsystemName(static_cast<Subsystem>(k)) : "total",
+                     s.live * MB, s.peak * MB, (unsigned long long)s.allocs, (unsigned long long)s.frees);
+    }
+}
+
+} // namespace sim
+
+#ifdef UAV_MEMTRACK
+
+// Global replacements. The array, nothrow and sized forms are all
+// replaced too so every path goes through the same header.
+void* operator new(size_t size) { return sim::allocOrThrow(size, 0); }
+void* operator new[](size_t size) { return sim::allocOrThrow(size, 0); }
+void* operator new(size_t size, std::align_val_t a) { return sim::allocOrThrow(size, static_cast<size_t>(a)); }
+void* operator new[](size_t size, std::align_val_t a) { return sim::allocOrThrow(size, static_cast<size_t>(a)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return sim::trackedAlloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return sim::trackedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t a, const std::nothrow_t&) noexcept
+{
+    return sim::trackedAlloc(size, static_cast<size_t>(a));
+}
+void* operator new[](size_t size, std::align_val_t a, const std::nothrow_t&) noexcept
+{
+    return sim::trackedAlloc(size, static_cast<size_t>(a));
+}
+
+void operator delete(void* p) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p) noexcept { sim::trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { sim::trackedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { sim::trackedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { sim::trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { sim::trackedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { sim::trackedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { sim::trackedFree(p); }
+
+#endif
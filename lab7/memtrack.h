@@ -0,0 +1,61 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Heap accounting by subsystem: replacement operator new/delete keep
+    live, peak and total byte counters per Subsystem, tagged by a
+    thread-local scope. Built in unless UAV_MEMTRACK is switched off,
+    in which case the counters stay at zero.
+*/
+
+#pragma once
+#include "profiler.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace sim {
+
+struct MemStats
+{
+    int64_t  live   = 0;   // bytes currently allocated
+    int64_t  peak   = 0;   // high-water mark of live since the last resetMemPeaks()
+    uint64_t allocs = 0;
+    uint64_t frees  = 0;
+    uint64_t bytes  = 0;   // total ever allocated
+};
+
+// True when the allocation hooks are compiled in
+bool memTrackingEnabled();
+
+// Allocations on this thread are charged to the innermost scope's
+// subsystem (Other outside any scope). Frees are charged to whoever
+// allocated the block, whichever thread frees it.
+Subsystem memTag();
+void setMemTag(Subsystem s);
+
+class MemScope
+{
+public:
+    explicit MemScope(Subsystem s) : prev(memTag()) { setMemTag(s); }
+    ~MemScope() { setMemTag(prev); }
+    MemScope(const MemScope&) = delete;
+    MemScope& operator=(const MemScope&) = delete;
+
+private:
+    Subsystem prev;
+};
+
+MemStats memStats(Subsystem s);
+MemStats memTotal();
+void resetMemPeaks();   // peak = live, everywhere
+
+// Process resident / virtual size from the OS (0 where unsupported)
+size_t residentBytes();
+size_t virtualBytes();
+
+// Per-subsystem table: live, peak, allocation counts, and the RSS
+void printMemReport(std::FILE* out, const char* title);
+
+} // namespace sim
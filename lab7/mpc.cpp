@@ -0,0 +1,232 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the batched model-predictive controller.
+*/
+
+#include "mpc.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+namespace
+{
+
+// Drones solved together; each is one SIMD lane in the loops below.
+// The omp simd hints (-fopenmp-simd, no OpenMP runtime) keep GCC from
+// vectorising across the horizon instead of across drones.
+constexpr int Lanes = 8;
+
+} // namespace
+
+void MpcBatch::configure(const MpcParams& params, double m, double g)
+{
+    prm = params;
+    prm.horizon    = std::clamp(prm.horizon, 1, maxHorizon);
+    prm.iterations = std::max(1, prm.iterations);
+    mass = m;
+    gravity = g;
+
+    const int N = prm.horizon;
+    const double Ts = prm.stepTime;
+
+    // Step k (1..N) response to input j (0..N-1), per unit force
+    auto gp = [&](int k, int j) { return j < k ? Ts * Ts * (k - j - 0.5) / mass : 0.0; };
+    auto gv = [&](int k, int j) { return j < k ? Ts / mass : 0.0; };
+    auto wp = [&](int k) { return prm.posWeight * (k == N ? prm.terminalWeight : 1.0); };
+    auto wv = [&](int k) { return prm.velWeight * (k == N ? prm.terminalWeight : 1.0); };
+
+    H.assign(N * N, 0.0);
+    Bp.assign(N * N, 0.0);
+    Bv.assign(N * N, 0.0);
+    for (int i = 0; i < N; ++i)
+    {
+        for (int j = 0; j < N; ++j)
+        {
+            double h = i == j ? prm.forceWeight : 0.0;
+            for (int k = 1; k <= N; ++k)
+            {
+                h += wp(k) * gp(k, i) * gp(k, j) + wv(k) * gv(k, i) * gv(k, j);
+            }
+            H[i * N + j] = h;
+            Bp[i * N + j] = wp(j + 1) * gp(j + 1, i);
+            Bv[i * N + j] = wv(j + 1) * gv(j + 1, i);
+        }
+    }
+
+    freeP.resize(N);
+    gravP.resize(N);
+    gravV.resize(N);
+    for (int k = 1; k <= N; ++k)
+    {
+        freeP[k - 1] = k * Ts;
+        gravP[k - 1] = 0.5 * Ts * Ts * k * k;
+        gravV[k - 1] = k * Ts;
+    }
+
+    // Largest eigenvalue of H by power iteration -> gradient step size
+    std::vector<double> x(N, 1.0), hx(N);
+    double lambda = 1.0;
+    for (int it = 0; it < 200; ++it)
+    {
+        double norm = 0.0;
+        for (int i = 0; i < N; ++i)
+        {
+            hx[i] = 0.0;
+            for (int j = 0; j < N; ++j) hx[i] += H[i * N + j] * x[j];
+            norm += hx[i] * hx[i];
+        }
+        lambda = std::sqrt(norm);
+        for (int i = 0; i < N; ++i) x[i] = hx[i] / lambda;
+    }
+    stepL = 1.0 / lambda;
+
+    resize(size());
+}
+
+void MpcBatch::resize(size_t n)
+{
+    for (auto* v : { &px, &py, &pz, &vx, &vy, &vz, &fmax })
+    {
+        v->resize(n, 0.0);
+    }
+    refP.assign(3 * prm.horizon * n, 0.0);
+    refV.assign(3 * prm.horizon * n, 0.0);
+    plan.assign(3 * prm.horizon * n, 0.0);
+}
+
+void MpcBatch::resetPlan(size_t i)
+{
+    for (int k = 0; k < 3 * prm.horizon; ++k)
+    {
+        plan[k * size() + i] = 0.0;
+    }
+}
+
+// Accelerated projected gradient (FISTA) on
+//   min 1/2 u'Hu + f'u   s.t. |u_k| <= fmax for every step k,
+// one axis block of H per coordinate, the ball constraint coupling them.
+void MpcBatch::solve(size_t begin, size_t end)
+{
+    const int    N = prm.horizon;
+    const size_t n = size();
+    const double* Hm = H.data();
+
+    for (size_t i0 = begin; i0 < end; i0 += Lanes)
+    {
+        const int cnt = static_cast<int>(std::min<size_t>(Lanes, end - i0));
+
+        double f[3][maxHorizon][Lanes];
+        double u[3][maxHorizon][Lanes];
+        double y[3][maxHorizon][Lanes];
+        double z[3][maxHorizon][Lanes];
+        double fm[Lanes];
+
+        // Gather into lanes (unused lanes solve an all-zero problem)
+        for (int l = 0; l < Lanes; ++l)
+        {
+            fm[l] = l < cnt ? fmax[i0 + l] : 0.0;
+        }
+        for (int a = 0; a < 3; ++a)
+        {
+            const double* P0 = a == 0 ? px.data() : a == 1 ? py.data() : pz.data();
+            const double* V0 = a == 0 ? vx.data() : a == 1 ? vy.data() : vz.data();
+            const double  ga = a == 2 ? -gravity : 0.0;
+
+            double ep[maxHorizon][Lanes], ev[maxHorizon][Lanes];
+            for (int k = 0; k < N; ++k)
+            {
+                const size_t row = (a * N + k) * n + i0;
+                for (int l = 0; l < Lanes; ++l)
+                {
+                    bool in = l < cnt;
+                    double p0 = in ? P0[i0 + l] : 0.0;
+                    double v0 = in ? V0[i0 + l] : 0.0;
+                    ep[k][l] = in ? p0 + freeP[k] * v0 + gravP[k] * ga - refP[row + l] : 0.0;
+                    ev[k][l] = in ? v0 + gravV[k] * ga - refV[row + l] : 0.0;
+                    u[a][k][l] = in ? plan[row + l] : 0.0;
+                    y[a][k][l] = u[a][k][l];
+                }
+            }
+
+            // Linear term of the QP: tracking error of the free response
+            for (int j = 0; j < N; ++j)
+            {
+                double acc[Lanes] = {};
+                for (int k = 0; k < N; ++k)
+                {
+                    const double bp = Bp[j * N + k], bv = Bv[j * N + k];
+                    for (int l = 0; l < Lanes; ++l) acc[l] += bp * ep[k][l] + bv * ev[k][l];
+                }
+                for (int l = 0; l < Lanes; ++l) f[a][j][l] = acc[l];
+            }
+        }
+
+        double t = 1.0;
+        for (int it = 0; it < prm.iterations; ++it)
+        {
+            // Gradient step
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int k = 0; k < N; ++k)
+                {
+                    double g[Lanes];
+                    for (int l = 0; l < Lanes; ++l) g[l] = f[a][k][l];
+                    for (int j = 0; j < N; ++j)
+                    {
+                        const double h = Hm[k * N + j];
+                        #pragma omp simd
+                        for (int l = 0; l < Lanes; ++l) g[l] += h * y[a][j][l];
+                    }
+                    for (int l = 0; l < Lanes; ++l) z[a][k][l] = y[a][k][l] - stepL * g[l];
+                }
+            }
+
+            // Project every step's force onto the ball |u| <= fmax
+            for (int k = 0; k < N; ++k)
+            {
+                for (int l = 0; l < Lanes; ++l)
+                {
+                    double m = std::sqrt(z[0][k][l] * z[0][k][l] + z[1][k][l] * z[1][k][l]
+                                         + z[2][k][l] * z[2][k][l]);
+                    double s = std::min(1.0, fm[l] / std::max(m, 1e-12));
+                    z[0][k][l] *= s;
+                    z[1][k][l] *= s;
+                    z[2][k][l] *= s;
+                }
+            }
+
+            // Momentum
+            double tn = 0.5 * (1.0 + std::sqrt(1.0 + 4.0 * t * t));
+            double beta = (t - 1.0) / tn;
+            t = tn;
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int k = 0; k < N; ++k)
+                {
+                    for (int l = 0; l < Lanes; ++l)
+                    {
+                        y[a][k][l] = z[a][k][l] + beta * (z[a][k][l] - u[a][k][l]);
+                        u[a][k][l] = z[a][k][l];
+                    }
+                }
+            }
+        }
+
+        // Keep the plan as next tick's warm start
+        for (int a = 0; a < 3; ++a)
+        {
+            for (int k = 0; k < N; ++k)
+            {
+                const size_t row = (a * N + k) * n + i0;
+                for (int l = 0; l < cnt; ++l) plan[row + l] = u[a][k][l];
+            }
+        }
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,80 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Batched linear model-predictive controller: an alternative to the
+    PID control law. Each drone solves a small dense QP over a short
+    horizon with its force limited to maxForce.
+*/
+
+#pragma once
+#include "control.h"
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+struct MpcParams
+{
+    int    horizon        = 10;     // steps (at most MpcBatch::maxHorizon)
+    double stepTime       = 0.1;    // s per horizon step
+    double posWeight      = 1.0;
+    double velWeight      = 0.5;
+    double terminalWeight = 5.0;    // multiplies the last step's weights
+    double forceWeight    = 0.002;
+    int    iterations     = 10;     // projected-gradient iterations per solve (warm-started)
+};
+
+// Model: point mass per axis, a = u / m + gravity, u held over each step.
+// The cost tracks a reference trajectory; the constraint is |u_k| <= maxForce.
+// The condensed QP Hessian is the same for every drone and axis, so it
+// is built once and the solver runs across drones in SIMD lanes.
+class MpcBatch
+{
+public:
+    static constexpr int maxHorizon = 20;
+
+    void configure(const MpcParams& params, double mass, double gravity);
+    void resize(size_t n);
+    size_t size() const { return fmax.size(); }
+    const MpcParams& params() const { return prm; }
+
+    // Per-drone problem data, filled by the caller before solve():
+    // start state, reference at horizon steps 1..N, force limit.
+    // Reference arrays are laid out [axis][step][drone].
+    std::vector<double> px, py, pz, vx, vy, vz;
+    std::vector<double> refP, refV;
+    std::vector<double> fmax;
+    double& refPos(int axis, int k, size_t i) { return refP[(axis * prm.horizon + k) * size() + i]; }
+    double& refVel(int axis, int k, size_t i) { return refV[(axis * prm.horizon + k) * size() + i]; }
+
+    // Solve drones [begin, end), warm-started from the previous solution.
+    // Disjoint ranges may run in parallel.
+    void solve(size_t begin, size_t end);
+
+    // First input of each drone's plan (the force to apply now)
+    control::Vec3 force(size_t i) const
+    {
+        return control::Vec3(plan[i], plan[prm.horizon * size() + i],
+                             plan[(2 * prm.horizon) * size() + i]);
+    }
+
+    // Forget the warm start for drone i (e.g. when its reference jumps)
+    void resetPlan(size_t i);
+
+private:
+    MpcParams prm;
+    double mass = 1.0, gravity = 10.0;
+    double stepL = 1.0;   // 1 / Lipschitz constant of the gradient
+
+    // Shared matrices, N x N row-major: Hessian and the maps from
+    // position / velocity tracking error to the gradient
+    std::vector<double> H, Bp, Bv;
+    std::vector<double> freeP, freeV;   // response to v0 per step (k Ts, 1)
+    std::vector<double> gravP, gravV;   // response to gravity per step
+
+    std::vector<double> plan;   // [axis][step][drone], warm start
+};
+
+} // namespace sim
@@ -0,0 +1,452 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the climb path planner.
+*/
+
+#include "planner.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace sim
+{
+
+using control::Vec3;
+
+// ------------------------------------------
+// VoxelMap
+// ------------------------------------------
+VoxelMap::VoxelMap(const Vec3& lo, const Vec3& hi, double voxelSize)
+    : origin(lo), voxel(voxelSize)
+{
+    dims[0] = std::max(1, static_cast<int>(std::ceil((hi.x - lo.x) / voxel)));
+    dims[1] = std::max(1, static_cast<int>(std::ceil((hi.y - lo.y) / voxel)));
+    dims[2] = std::max(1, static_cast<int>(std::ceil((hi.z - lo.z) / voxel)));
+    cells.assign(static_cast<size_t>(dims[0]) * dims[1] * dims[2], 0);
+}
+
+void VoxelMap::toVoxel(const Vec3& p, int& x, int& y, int& z) const
+{
+    x = static_cast<int>(std::floor((p.x - origin.x) / voxel));
+    y = static_cast<int>(std::floor((p.y - origin.y) / voxel));
+    z = static_cast<int>(std::floor((p.z - origin.z) / voxel));
+}
+
+Vec3 VoxelMap::voxelCenter(int x, int y, int z) const
+{
+    return Vec3(origin.x + (x + 0.5) * voxel,
+                origin.y + (y + 0.5) * voxel,
+                origin.z + (z + 0.5) * voxel);
+}
+
+bool VoxelMap::blockedAt(const Vec3& p) const
+{
+    int x, y, z;
+    toVoxel(p, x, y, z);
+    return blocked(x, y, z);
+}
+
+void VoxelMap::addBox(const Vec3& lo, const Vec3& hi)
+{
+    int x0, y0, z0, x1, y1, z1;
+    toVoxel(lo, x0, y0, z0);
+    toVoxel(hi, x1, y1, z1);
+    for (int z = std::max(z0, 0); z <= std::min(z1, dims[2] - 1); ++z)
+        for (int y = std::max(y0, 0); y <= std::min(y1, dims[1] - 1); ++y)
+            for (int x = std::max(x0, 0); x <= std::min(x1, dims[0] - 1); ++x)
+                cells[index(x, y, z)] = 1;
+}
+
+void VoxelMap::addSphere(const Vec3& center, double radius)
+{
+    int x0, y0, z0, x1, y1, z1;
+    toVoxel(center - Vec3(radius, radius, radius), x0, y0, z0);
+    toVoxel(center + Vec3(radius, radius, radius), x1, y1, z1);
+    for (int z = std::max(z0, 0); z <= std::min(z1, dims[2] - 1); ++z)
+        for (int y = std::max(y0, 0); y <= std::min(y1, dims[1] - 1); ++y)
+            for (int x = std::max(x0, 0); x <= std::min(x1, dims[0] - 1); ++x)
+                if (control::distance(voxelCenter(x, y, z), center) <= radius)
+                    cells[index(x, y, z)] = 1;
+}
+
+VoxelMap VoxelMap::inflated(double radius) const
+{
+    VoxelMap out = *this;
+    const int r = static_cast<int>(std::ceil(radius / voxel));
+    const double r2 = (radius / voxel) * (radius / voxel);
+
+    // Offsets inside the ball, applied around every blocked voxel that
+    // has a free neighbour (interior voxels add nothing new)
+    std::vector<int> off;
+    for (int dz = -r; dz <= r; ++dz)
+        for (int dy = -r; dy <= r; ++dy)
+            for (int dx = -r; dx <= r; ++dx)
+                if (dx * dx + dy * dy + dz * dz <= r2)
+                {
+                    off.push_back(dx); off.push_back(dy); off.push_back(dz);
+                }
+
+    for (int z = 0; z < dims[2]; ++z)
+        for (int y = 0; y < dims[1]; ++y)
+            for (int x = 0; x < dims[0]; ++x)
+            {
+                if (!cells[index(x, y, z)]) continue;
+                bool surface = false;
+                for (int d = 0; d < 3 && !surface; ++d)
+                {
+                    int p[3] = { x, y, z };
+                    for (int s : { -1, 1 })
+                    {
+                        p[d] += s;
+                        if (inside(p[0], p[1], p[2]) && !cells[index(p[0], p[1], p[2])])
+                            surface = true;
+                        p[d] -= s;
+                    }
+                }
+                if (!surface) continue;
+
+                for (size_t k = 0; k < off.size(); k += 3)
+                {
+                    int qx = x + off[k], qy = y + off[k + 1], qz = z + off[k + 2];
+                    if (inside(qx, qy, qz)) out.cells[index(qx, qy, qz)] = 1;
+                }
+            }
+    return out;
+}
+
+bool VoxelMap::segmentFree(const Vec3& a, const Vec3& b) const
+{
+    const double len = control::distance(a, b);
+    const int steps = std::max(1, static_cast<int>(std::ceil(len / (0.5 * voxel))));
+    for (int s = 0; s <= steps; ++s)
+    {
+        if (blockedAt(a + (b - a) * (static_cast<double>(s) / steps))) return false;
+    }
+    return true;
+}
+
+// ------------------------------------------
+// Entry points
+// ------------------------------------------
+std::vector<Vec3> sphereEntryPoints(const control::ControlConfig& cfg, size_t count)
+{
+    const double golden = 3.14159265358979323846 * (3.0 - std::sqrt(5.0));
+    std::vector<Vec3> pts;
+    pts.reserve(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+        double z   = -1.0 + (2.0 * k + 1.0) / count;
+        double rho = std::sqrt(std::max(0.0, 1.0 - z * z));
+        double phi = golden * k;
+        pts.push_back(cfg.center + Vec3(rho * std::cos(phi), rho * std::sin(phi), z)
+                                   * cfg.sphereRadius);
+    }
+    return pts;
+}
+
+namespace
+{
+
+// Entry points in a k-d tree that forgets taken points: nodes count their
+// untaken points, so a nearest query skips whole taken regions instead of
+// rescanning them for every drone that arrives late
+class EntryTree
+{
+public:
+    explicit EntryTree(const std::vector<Vec3>& pts) : pts(pts), leafOf(pts.size())
+    {
+        order.resize(pts.size());
+        for (uint32_t p = 0; p < order.size(); ++p) order[p] = p;
+        if (!order.empty()) build(0, static_cast<uint32_t>(order.size()), UINT32_MAX);
+    }
+
+    void take(uint32_t p)
+    {
+        for (uint32_t n = leafOf[p]; n != UINT32_MAX; n = nodes[n].parent) --nodes[n].live;
+        order[slotOf(p)] = UINT32_MAX;
+    }
+
+    // Nearest untaken point to s, ties to the lower index; UINT32_MAX if
+    // every point is taken
+    uint32_t nearest(const Vec3& s, double& dist) const
+    {
+        uint32_t best = UINT32_MAX;
+        dist = INFINITY;
+        if (!nodes.empty()) search(0, s, best, dist);
+        return best;
+    }
+
+private:
+    struct Node
+    {
+        Vec3 lo, hi;
+        uint32_t begin, end;          // range of `order`
+        uint32_t left = UINT32_MAX, right = UINT32_MAX, parent = UINT32_MAX;
+        uint32_t live = 0;
+    };
+
+    uint32_t build(uint32_t begin, uint32_t end, uint32_t parent)
+    {
+        const uint32_t n = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({ pts[order[begin]], pts[order[begin]], begin, end });
+        nodes[n].parent = parent;
+        nodes[n].live = end - begin;
+        Vec3 lo = nodes[n].lo, hi = nodes[n].hi;
+        for (uint32_t k = begin; k < end; ++k)
+        {
+            const Vec3& q = pts[order[k]];
+            lo = Vec3(std::min(lo.x, q.x), std::min(lo.y, q.y), std::min(lo.z, q.z));
+            hi = Vec3(std::max(hi.x, q.x), std::max(hi.y, q.y), std::max(hi.z, q.z));
+        }
+        nodes[n].lo = lo;
+        nodes[n].hi = hi;
+
+        if (end - begin <= 8)
+        {
+            for (uint32_t k = begin; k < end; ++k) leafOf[order[k]] = n;
+            return n;
+        }
+        const Vec3 ext = hi - lo;
+        const int axis = ext.x >= ext.y && ext.x >= ext.z ? 0 : (ext.y >= ext.z ? 1 : 2);
+        const uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                         [&](uint32_t a, uint32_t b) { return coord(pts[a], axis) < coord(pts[b], axis); });
+        const uint32_t l = build(begin, mid, n);
+        const uint32_t r = build(mid, end, n);
+        nodes[n].left = l;
+        nodes[n].right = r;
+        return n;
+    }
+
+    static double coord(const Vec3& v, int axis) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); }
+
+    uint32_t slotOf(uint32_t p) const
+    {
+        const Node& leaf = nodes[leafOf[p]];
+        return static_cast<uint32_t>(std::find(order.begin() + leaf.begin, order.begin() + leaf.end, p)
+                                     - order.begin());
+    }
+
+    static double boxDistance(const Node& n, const Vec3& s)
+    {
+        const double dx = std::max({ n.lo.x - s.x, 0.0, s.x - n.hi.x });
+        const double dy = std::max({ n.lo.y - s.y, 0.0, s.y - n.hi.y });
+        const double dz = std::max({ n.lo.z - s.z, 0.0, s.z - n.hi.z });
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    void search(uint32_t n, const Vec3& s, uint32_t& best, double& dist) const
+    {
+        const Node& node = nodes[n];
+        if (node.live == 0 || boxDistance(node, s) > dist) return;
+        if (node.left == UINT32_MAX)
+        {
+            for (uint32_t k = node.begin; k < node.end; ++k)
+            {
+                const uint32_t p = order[k];
+                if (p == UINT32_MAX) continue;
+                const double d = control::distance(s, pts[p]);
+                if (d < dist || (d == dist && p < best))
+                {
+                    dist = d;
+                    best = p;
+                }
+            }
+            return;
+        }
+        const bool leftFirst = boxDistance(nodes[node.left], s) <= boxDistance(nodes[node.right], s);
+        search(leftFirst ? node.left : node.right, s, best, dist);
+        search(leftFirst ? node.right : node.left, s, best, dist);
+    }
+
+    const std::vector<Vec3>& pts;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> order;    // point indices, UINT32_MAX once taken
+    std::vector<uint32_t> leafOf;   // point -> leaf node
+};
+
+} // namespace
+
+// Greedy, closest pair first, without forming every pair: each start
+// keeps its nearest untaken point in a heap, and a start whose point was
+// taken by a closer pair looks up its next one. The order of acceptance,
+// and so the result, is that of sorting all pairs by (distance, start,
+// point).
+std::vector<uint32_t> assignEntryPoints(const std::vector<Vec3>& starts,
+                                        const std::vector<Vec3>& points)
+{
+    struct Entry
+    {
+        double d;
+        uint32_t s, p;
+        bool operator>(const Entry& o) const
+        {
+            return d != o.d ? d > o.d : (s != o.s ? s > o.s : p > o.p);
+        }
+    };
+
+    EntryTree tree(points);
+    std::vector<uint32_t> out(starts.size(), UINT32_MAX);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    double d;
+    for (uint32_t s = 0; s < starts.size(); ++s)
+    {
+        const uint32_t p = tree.nearest(starts[s], d);
+        if (p != UINT32_MAX) heap.push({ d, s, p });
+    }
+
+    std::vector<bool> taken(points.size(), false);
+    size_t left = std::min(starts.size(), points.size());
+    while (left > 0 && !heap.empty())
+    {
+        const Entry e = heap.top();
+        heap.pop();
+        if (taken[e.p])
+        {
+            const uint32_t p = tree.nearest(starts[e.s], d);
+            if (p != UINT32_MAX) heap.push({ d, e.s, p });
+            continue;
+        }
+        out[e.s] = e.p;
+        taken[e.p] = true;
+        tree.take(e.p);
+        --left;
+    }
+    return out;
+}
+
+// ------------------------------------------
+// ClimbPlanner
+// ------------------------------------------
+ClimbPlanner::ClimbPlanner(const VoxelMap& map, const PlannerConfig& c)
+    : cfg(c), grown(map.inflated(c.clearance))
+{
+}
+
+std::vector<Vec3> ClimbPlanner::plan(const Vec3& start, const Vec3& goal) const
+{
+    Scratch s;
+    return search(start, goal, s);
+}
+
+std::vector<std::vector<Vec3>> ClimbPlanner::planAll(ThreadPool& pool,
+                                                     const std::vector<Vec3>& starts,
+                                                     const std::vector<Vec3>& goals) const
+{
+    std::vector<std::vector<Vec3>> paths(starts.size());
+    std::vector<Scratch> scratch(pool.size());
+    pool.parallelFor(starts.size(), [&](size_t b, size_t e, unsigned slot) {
+        for (size_t i = b; i < e; ++i)
+        {
+            paths[i] = search(starts[i], goals[i], scratch[slot]);
+        }
+    }, 1);
+    return paths;
+}
+
+// A* over the 26-connected lattice with the straight-line heuristic
+std::vector<Vec3> ClimbPlanner::search(const Vec3& start, const Vec3& goal, Scratch& s) const
+{
+    const VoxelMap& m = grown;
+    int sx, sy, sz, gx, gy, gz;
+    m.toVoxel(start, sx, sy, sz);
+    m.toVoxel(goal, gx, gy, gz);
+    // A pad sitting on the ground is allowed even inside the clearance
+    sz = std::max(sz, 0);
+    if (!m.inside(sx, sy, sz) || m.blocked(gx, gy, gz)) return {};
+
+    if (s.stamp.size() != m.voxels())
+    {
+        s.stamp.assign(m.voxels(), 0);
+        s.cost.resize(m.voxels());
+        s.parent.resize(m.voxels());
+        s.generation = 0;
+    }
+    if (++s.generation == 0)
+    {
+        std::fill(s.stamp.begin(), s.stamp.end(), 0u);
+        s.generation = 1;
+    }
+    const uint32_t gen = s.generation;
+
+    auto h = [&](int x, int y, int z) {
+        double dx = x - gx, dy = y - gy, dz = z - gz;
+        return static_cast<float>(std::sqrt(dx * dx + dy * dy + dz * dz));
+    };
+
+    using Entry = std::pair<float, uint32_t>;   // (f, voxel)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    const uint32_t startIdx = static_cast<uint32_t>(m.index(sx, sy, sz));
+    const uint32_t goalIdx  = static_cast<uint32_t>(m.index(gx, gy, gz));
+    if (goalIdx == startIdx) return { goal };   // same voxel: fly straight there
+    s.stamp[startIdx]  = gen;
+    s.cost[startIdx]   = 0.0f;
+    s.parent[startIdx] = startIdx;
+    open.push({ h(sx, sy, sz), startIdx });
+
+    const int nx = m.nx(), nxy = m.nx() * m.ny();
+    size_t expansions = 0;
+    bool found = false;
+    while (!open.empty() && expansions < cfg.maxExpansions)
+    {
+        auto [f, idx] = open.top();
+        open.pop();
+        const int x = idx % nx, y = (idx / nx) % m.ny(), z = idx / nxy;
+        const float g = s.cost[idx];
+        if (f > g + h(x, y, z) + 1e-4f) continue;   // stale entry
+        if (idx == goalIdx) { found = true; break; }
+        ++expansions;
+
+        for (int dz = -1; dz <= 1; ++dz)
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    if ((dx | dy | dz) == 0) continue;
+                    int qx = x + dx, qy = y + dy, qz = z + dz;
+                    if (m.blocked(qx, qy, qz)) continue;
+
+                    float step = static_cast<float>(std::sqrt(double(dx * dx + dy * dy + dz * dz)));
+                    uint32_t q = static_cast<uint32_t>(m.index(qx, qy, qz));
+                    float ng = g + step;
+                    if (s.stamp[q] == gen && s.cost[q] <= ng) continue;
+                    s.stamp[q]  = gen;
+                    s.cost[q]   = ng;
+                    s.parent[q] = idx;
+                    open.push({ ng + h(qx, qy, qz), q });
+                }
+    }
+    if (!found) return {};
+
+    std::vector<Vec3> cells;
+    for (uint32_t idx = goalIdx; idx != startIdx; idx = s.parent[idx])
+    {
+        cells.push_back(m.voxelCenter(idx % nx, (idx / nx) % m.ny(), idx / nxy));
+    }
+    std::reverse(cells.begin(), cells.end());
+    cells.back() = goal;
+    return shortcut(start, cells);
+}
+
+// Greedy line-of-sight smoothing: from each kept point, jump to the
+// furthest later cell still visible in a straight line
+std::vector<Vec3> ClimbPlanner::shortcut(const Vec3& start, const std::vector<Vec3>& path) const
+{
+    std::vector<Vec3> out;
+    Vec3 cur = start;
+    size_t i = 0;
+    while (i < path.size())
+    {
+        size_t j = i;
+        while (j + 1 < path.size() && grown.segmentFree(cur, path[j + 1])) ++j;
+        out.push_back(path[j]);
+        cur = path[j];
+        i = j + 1;
+    }
+    return out;
+}
+
+} // namespace sim
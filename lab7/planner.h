@@ -0,0 +1,122 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Climb path planning: lattice A* over a voxel map of obstacles and
+    reserved airspace, run in parallel for many drones, plus distinct
+    entry points on the mission sphere.
+*/
+
+#pragma once
+#include "control.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Axis-aligned voxel grid; a voxel is either free or blocked
+class VoxelMap
+{
+public:
+    VoxelMap(const control::Vec3& lo, const control::Vec3& hi, double voxelSize);
+
+    // Obstacles and reserved airspace are both just blocked voxels
+    void addBox(const control::Vec3& lo, const control::Vec3& hi);
+    void addSphere(const control::Vec3& center, double radius);
+
+    // Copy with every blocked voxel grown by `radius` (drone clearance)
+    VoxelMap inflated(double radius) const;
+
+    int nx() const { return dims[0]; }
+    int ny() const { return dims[1]; }
+    int nz() const { return dims[2]; }
+    size_t voxels() const { return cells.size(); }
+    double voxelSize() const { return voxel; }
+
+    bool inside(int x, int y, int z) const
+    {
+        return x >= 0 && y >= 0 && z >= 0 && x < dims[0] && y < dims[1] && z < dims[2];
+    }
+    size_t index(int x, int y, int z) const
+    {
+        return (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+    }
+    bool blocked(int x, int y, int z) const
+    {
+        return !inside(x, y, z) || cells[index(x, y, z)] != 0;
+    }
+
+    // World <-> voxel (floor of the world coordinate)
+    void toVoxel(const control::Vec3& p, int& x, int& y, int& z) const;
+    control::Vec3 voxelCenter(int x, int y, int z) const;
+    bool blockedAt(const control::Vec3& p) const;
+
+    // Straight segment clear of blocked voxels (sampled at half a voxel)
+    bool segmentFree(const control::Vec3& a, const control::Vec3& b) const;
+
+private:
+    control::Vec3 origin;
+    double voxel;
+    int dims[3];
+    std::vector<uint8_t> cells;
+};
+
+// `count` roughly evenly spread points on the mission sphere (Fibonacci
+// lattice), starting from the bottom where climbing drones arrive
+std::vector<control::Vec3> sphereEntryPoints(const control::ControlConfig& cfg, size_t count);
+
+// Give each start its own entry point: greedy, closest pair first, with
+// nearest-point lookups rather than a sort over every pair. Returns an
+// index into `points` per start (UINT32_MAX for starts left over when
+// there are fewer points).
+std::vector<uint32_t> assignEntryPoints(const std::vector<control::Vec3>& starts,
+                                        const std::vector<control::Vec3>& points);
+
+struct PlannerConfig
+{
+    double clearance     = 1.5;      // m kept from anything blocked
+    size_t maxExpansions = 2000000;  // per drone, then give up
+};
+
+class ClimbPlanner
+{
+public:
+    // The map is inflated once and then only read, by every thread
+    ClimbPlanner(const VoxelMap& map, const PlannerConfig& cfg = PlannerConfig());
+
+    // Waypoints from start to goal (start excluded, goal included),
+    // shortcut where the straight line is free. Empty if no path; just
+    // the goal when both are in one voxel.
+    std::vector<control::Vec3> plan(const control::Vec3& start,
+                                    const control::Vec3& goal) const;
+
+    // All drones at once on the pool; one scratch buffer per pool slot
+    std::vector<std::vector<control::Vec3>> planAll(
+        ThreadPool& pool,
+        const std::vector<control::Vec3>& starts,
+        const std::vector<control::Vec3>& goals) const;
+
+    const VoxelMap& map() const { return grown; }
+
+private:
+    // Per-thread A* state; `stamp` marks which voxels this search touched
+    struct Scratch
+    {
+        std::vector<uint32_t> stamp;
+        std::vector<float>    cost;
+        std::vector<uint32_t> parent;
+        uint32_t generation = 0;
+    };
+
+    std::vector<control::Vec3> search(const control::Vec3& start,
+                                      const control::Vec3& goal, Scratch& s) const;
+    std::vector<control::Vec3> shortcut(const control::Vec3& start,
+                                        const std::vector<control::Vec3>& path) const;
+
+    PlannerConfig cfg;
+    VoxelMap grown;
+};
+
+} // namespace sim
@@ -0,0 +1,606 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the built-in sampling profiler.
+*/
+
+#include "profiler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <atomic>
+#include <chrono>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include <linux/perf_event.h>
+#include <mutex>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#endif
+
+namespace sim
+{
+
+const char* subsystemName(Subsystem s)
+{
+    switch (s)
+    {
+        case Subsystem::Control:   return "control";
+        case Subsystem::Physics:   return "physics";
+        case Subsystem::Collision: return "collision";
+        case Subsystem::Render:    return "render";
+        case Subsystem::AssetIO:   return "asset I/O";
+        default:                   return "other";
+    }
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler p;
+    return p;
+}
+
+#ifndef __linux__
+
+struct Profiler::State {};
+Profiler::~Profiler() = default;
+bool Profiler::start(Subsystem, const ProfilerConfig&) { return false; }
+void Profiler::registerThread(Subsystem) {}
+void Profiler::stop(std::FILE* out)
+{
+    if (out) std::fprintf(out, "--profile needs Linux perf events; nothing sampled.\n");
+}
+
+#else
+
+namespace
+{
+
+enum Event { Clock = 0, Misses = 1, NumEvents = 2 };
+
+const char* const eventName[NumEvents] = { "cpu-clock", "cache-misses" };
+
+struct Ring
+{
+    int       fd = -1;
+    void*     map = nullptr;
+    size_t    bytes = 0;
+    int       event = Clock;
+    Subsystem role = Subsystem::Other;
+};
+
+// Function symbols of the executable itself, from its ELF symbol table
+// (static and anonymous-namespace functions included, unlike dladdr)
+struct ExeSymbols
+{
+    struct Sym { uint64_t addr, size; std::string name; };
+    std::vector<Sym> syms;
+    uint64_t base = 0;
+
+    void load()
+    {
+        dl_iterate_phdr([](dl_phdr_info* info, size_t, void* self) {
+            static_cast<ExeSymbols*>(self)->base = info->dlpi_addr;
+            return 1;   // the first object is the executable
+        }, this);
+
+        std::FILE* f = std::fopen("/proc/self/exe", "rb");
+        if (!f) return;
+        std::vector<char> file;
+        char chunk[65536];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) file.insert(file.end(), chunk, chunk + n);
+        std::fclose(f);
+        if (file.size() < sizeof(Elf64_Ehdr)) return;
+
+        const auto* eh = reinterpret_cast<const Elf64_Ehdr*>(file.data());
+        if (std::memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_ident[EI_CLASS] != ELFCLASS64) return;
+        if (eh->e_shoff + uint64_t(eh->e_shnum) * sizeof(Elf64_Shdr) > file.size()) return;
+        const auto* sh = reinterpret_cast<const Elf64_Shdr*>(file.data() + eh->e_shoff);
+
+        for (int want : { SHT_SYMTAB, SHT_DYNSYM })
+        {
+            for (int i = 0; i < eh->e_shnum && syms.empty(); ++i)
+            {
+                if (sh[i].sh_type != static_cast<Elf64_Word>(want) || sh[i].sh_link >= eh->e_shnum) continue;
+                const Elf64_Shdr& strs = sh[sh[i].sh_link];
+                if (sh[i].sh_offset + sh[i].sh_size > file.size() ||
+                    strs.sh_offset + strs.sh_size > file.size()) continue;
+                const auto* st = reinterpret_cast<const Elf64_Sym*>(file.data() + sh[i].sh_offset);
+                const size_t count = sh[i].sh_size / sizeof(Elf64_Sym);
+                for (size_t k = 0; k < count; ++k)
+                {
+                    if (ELF64_ST_TYPE(st[k].st_info) != STT_FUNC || st[k].st_value == 0) continue;
+                    if (st[k].st_name >= strs.sh_size) continue;
+                    syms.push_back({ st[k].st_value, std::max<uint64_t>(st[k].st_size, 1),
+                                     file.data() + strs.sh_offset + st[k].st_name });
+                }
+            }
+            if (!syms.empty()) break;
+        }
+        std::sort(syms.begin(), syms.end(), [](const Sym& a, const Sym& b) { return a.addr < b.addr; });
+    }
+
+    const std::string* find(uint64_t ip) const
+    {
+        const uint64_t a = ip - base;
+        auto it = std::upper_bound(syms.begin(), syms.end(), a,
+                                   [](uint64_t v, const Sym& s) { return v < s.addr; });
+        if (it == syms.begin()) return nullptr;
+        --it;
+        return a < it->addr + it->size ? &it->name : nullptr;
+    }
+};
+
+std::string demangle(const char* name)
+{
+    int status = 0;
+    char* d = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    std::string out = status == 0 && d ? d : name;
+    std::free(d);
+    return out;
+}
+
+// std::function thunks name the lambda they call; report that instead
+std::string compact(const std::string& name)
+{
+    const char* thunk = "std::_Function_handler<";
+    if (name.compare(0, std::strlen(thunk), thunk) != 0) return name;
+    int depth = 0;
+    size_t comma = std::string::npos;
+    for (size_t i = std::strlen(thunk); i < name.size(); ++i)
+    {
+        const char c = name[i];
+        if (c == '<' || c == '(' || c == '{') ++depth;
+        else if (c == ')' || c == '}') --depth;
+        else if (c == '>' && depth-- == 0)
+        {
+            if (comma == std::string::npos) break;
+            return name.substr(comma + 2, i - comma - 2) + " [std::function]";
+        }
+        else if (c == ',' && depth == 0 && comma == std::string::npos) comma = i;
+    }
+    return name;
+}
+
+bool startsWith(const std::string& s, const char* p)
+{
+    return s.compare(0, std::strlen(p), p) == 0;
+}
+
+bool isIdent(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Qualified name starting at fn[i], template arguments dropped, up to
+// whatever follows it (a parameter list, a space, ...), which is left
+// at fn[end]
+std::string qualifiedAt(const std::string& fn, size_t i, size_t& end)
+{
+    static const char anon[] = "(anonymous namespace)";
+    std::string out;
+    for (; i < fn.size(); ++i)
+    {
+        if (fn.compare(i, sizeof(anon) - 1, anon) == 0)
+        {
+            out += anon;
+            i += sizeof(anon) - 2;
+        }
+        else if (fn[i] == '<')
+        {
+            for (int depth = 0; i < fn.size(); ++i)
+            {
+                if (fn[i] == '<') ++depth;
+                else if (fn[i] == '>' && --depth == 0) break;
+            }
+        }
+        else if (isIdent(fn[i]) || fn[i] == ':')
+        {
+            out += fn[i];
+        }
+        else
+        {
+            break;
+        }
+    }
+    end = i;
+    return out;
+}
+
+// The function a symbol belongs to: its qualified name without return
+// type, template or parameter lists, so lambdas and std::function thunks
+// count as their enclosing function:
+//   void sim::SpatialGrid::forEachWithin<...>(...)       -> sim::SpatialGrid::forEachWithin
+//   sim::Swarm::syncPoint()::{lambda(...)#1}::operator() -> sim::Swarm::syncPoint
+// Library templates instantiated for project code (std::sort over a
+// sim:: lambda) belong to that code's function.
+std::string ownerOf(const std::string& fn)
+{
+    size_t end = 0;
+    std::string head = qualifiedAt(fn, 0, end);
+    for (;;)
+    {
+        size_t k = end;
+        while (k < fn.size() && (fn[k] == '*' || fn[k] == '&')) ++k;
+        if (k + 1 >= fn.size() || fn[k] != ' ' || fn[k + 1] == '[') break;
+        head = qualifiedAt(fn, k + 1, end);   // that was (part of) the return type
+    }
+    if (startsWith(head, "sim::") || startsWith(head, "control::")) return head;
+
+    for (const char* ns : { "sim::", "control::" })
+    {
+        for (size_t k = fn.find(ns); k != std::string::npos; k = fn.find(ns, k + 1))
+        {
+            if (k > 0 && (isIdent(fn[k - 1]) || fn[k - 1] == ':')) continue;
+            const std::string name = qualifiedAt(fn, k, end);
+            if (end < fn.size() && fn[end] == '(') return name;
+        }
+    }
+    return head;
+}
+
+// Owners by qualified-name prefix, first match wins
+struct Rule
+{
+    const char* owner;
+    Subsystem   sub;
+};
+
+const Rule rules[] = {
+    // Broadphase and contact response, and the strides they bound
+    { "sim::SpatialGrid::",             Subsystem::Collision },
+    { "sim::Swarm::syncPoint",          Subsystem::Collision },
+    { "sim::Swarm::chooseStrides",      Subsystem::Collision },
+    { "sim::Swarm::checkActiveSet",     Subsystem::Collision },
+    { "sim::Swarm::resolveContacts",    Subsystem::Collision },
+    { "sim::checkAndResolveCollisions", Subsystem::Collision },
+
+    { "control::",                      Subsystem::Control },
+    { "sim::MpcBatch::",                Subsystem::Control },
+    { "sim::StateEstimator::",          Subsystem::Control },
+    { "sim::Swarm::computeForces",      Subsystem::Control },
+    { "sim::Swarm::mpcProblem",         Subsystem::Control },
+    { "sim::Swarm::controlInput",       Subsystem::Control },
+    { "sim::Swarm::followRoute",        Subsystem::Control },
+    { "sim::Swarm::planClimbs",         Subsystem::Control },
+    { "sim::ClimbPlanner::",            Subsystem::Control },
+    { "sim::VoxelMap::",                Subsystem::Control },
+    { "sim::assignEntryPoints",         Subsystem::Control },
+    { "sim::sphereEntryPoints",         Subsystem::Control },
+    { "sim::(anonymous namespace)::EntryTree::", Subsystem::Control },
+
+    // Everything else the swarm steps: kernels, battery, faults, sensors
+    { "sim::Swarm::",                   Subsystem::Physics },
+    { "sim::QuadrotorBatch::",          Subsystem::Physics },
+    { "sim::BatteryBatch::",            Subsystem::Physics },
+    { "sim::FaultModel::",              Subsystem::Physics },
+    { "sim::SensorSuite::",             Subsystem::Physics },
+    { "sim::integrate",                 Subsystem::Physics },
+    { "sim::UAV::",                     Subsystem::Physics },
+
+    { "sim::TrailBuffer::",             Subsystem::Render },
+    { "sim::SphereCoverage::",          Subsystem::Render },
+    { "sim::cullViews",                 Subsystem::Render },
+
+    { "sim::TileStreamer::",            Subsystem::AssetIO },
+    { "sim::RecordingWriter::",         Subsystem::AssetIO },
+    { "sim::Recording::",               Subsystem::AssetIO },
+    { "sim::AsyncWriter::",             Subsystem::AssetIO },
+    { "sim::ScenarioFile::",            Subsystem::AssetIO },
+    { "sim::parseScenarioText",         Subsystem::AssetIO },
+    { "sim::loadScenarioText",          Subsystem::AssetIO },
+    { "sim::saveScenario",              Subsystem::AssetIO },
+    { "sim::openScenario",              Subsystem::AssetIO },
+    { "loadOBJ",                        Subsystem::AssetIO },   // the viewer's loaders
+    { "loadBMP",                        Subsystem::AssetIO },
+
+    { "sim::ThreadPool::",              Subsystem::Other },
+    { "sim::Profiler::",                Subsystem::Other },
+};
+
+// Project code by the function it belongs to, GL drivers as render;
+// anything else (libc, libm, pthread, unclaimed std:: code) goes to the
+// thread's role
+Subsystem classify(const std::string& fn, const std::string& module, Subsystem role)
+{
+    const std::string owner = ownerOf(fn);
+    for (const Rule& r : rules)
+    {
+        if (startsWith(owner, r.owner)) return r.sub;
+    }
+    for (const char* gl : { "libGL", "libglut", "dri", "gallium", "LLVM" })
+    {
+        if (module.find(gl) != std::string::npos) return Subsystem::Render;
+    }
+    return role;
+}
+
+} // namespace
+
+struct Profiler::State
+{
+    ProfilerConfig cfg;
+    size_t page = 4096;
+
+    std::mutex mtx;               // rings and counts
+    std::vector<Ring> rings;
+    bool eventOk[NumEvents] = { false, false };
+    bool eventTried[NumEvents] = { false, false };
+
+    // Samples per (role, ip): role in the top byte
+    std::unordered_map<uint64_t, uint64_t> counts[NumEvents];
+    uint64_t lost = 0;
+
+    std::atomic<bool> quit{ false };
+    std::thread collector;
+    std::chrono::steady_clock::time_point t0;
+
+    void copyOut(const Ring& r, uint64_t pos, void* dst, size_t n)
+    {
+        const auto* meta = static_cast<const perf_event_mmap_page*>(r.map);
+        const size_t off  = meta->data_offset ? meta->data_offset : page;
+        const size_t size = meta->data_size ? meta->data_size : r.bytes - page;
+        const char* data = static_cast<const char*>(r.map) + off;
+        for (size_t i = 0; i < n; ++i)
+        {
+            static_cast<char*>(dst)[i] = data[(pos + i) % size];
+        }
+    }
+
+    void drain(Ring& r)
+    {
+        auto* meta = static_cast<perf_event_mmap_page*>(r.map);
+        const uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+        uint64_t tail = meta->data_tail;
+        while (tail < head)
+        {
+            perf_event_header h;
+            copyOut(r, tail, &h, sizeof(h));
+            if (h.size == 0) break;
+            if (h.type == PERF_RECORD_SAMPLE)
+            {
+                uint64_t ip;
+                copyOut(r, tail + sizeof(h), &ip, sizeof(ip));
+                ++counts[r.event][ip | (static_cast<uint64_t>(r.role) << 56)];
+            }
+            else if (h.type == PERF_RECORD_LOST)
+            {
+                uint64_t idLost[2];
+                copyOut(r, tail + sizeof(h), idLost, sizeof(idLost));
+                lost += idLost[1];
+            }
+            tail += h.size;
+        }
+        __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    void drainAll()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (Ring& r : rings) drain(r);
+    }
+
+    bool open(int event, Subsystem role)
+    {
+        perf_event_attr a;
+        std::memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        if (event == Clock)
+        {
+            a.type = PERF_TYPE_SOFTWARE;
+            a.config = PERF_COUNT_SW_CPU_CLOCK;
+            a.sample_period = cfg.clockPeriodNs;
+        }
+        else
+        {
+            a.type = PERF_TYPE_HARDWARE;
+            a.config = PERF_COUNT_HW_CACHE_MISSES;
+            a.sample_period = cfg.missPeriod;
+        }
+        a.sample_type    = PERF_SAMPLE_IP | PERF_SAMPLE_TID;
+        a.exclude_kernel = 1;
+        a.exclude_hv     = 1;
+
+        const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &a, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (fd < 0) return false;
+
+        Ring r;
+        r.fd = fd;
+        r.bytes = (1 + static_cast<size_t>(cfg.ringPages)) * page;
+        r.map = ::mmap(nullptr, r.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (r.map == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        r.event = event;
+        r.role = role;
+        std::lock_guard<std::mutex> lock(mtx);
+        rings.push_back(r);
+        return true;
+    }
+};
+
+Profiler::~Profiler()
+{
+    if (running) stop(nullptr);
+}
+
+bool Profiler::start(Subsystem role, const ProfilerConfig& cfg)
+{
+    std::lock_guard<std::mutex> guard(lifecycle);
+    if (running) return true;
+    state = std::make_unique<State>();
+    state->cfg = cfg;
+    int pages = 1;
+    while (pages < std::max(1, cfg.ringPages)) pages *= 2;
+    state->cfg.ringPages = pages;
+    state->page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    state->t0 = std::chrono::steady_clock::now();
+
+    registerLocked(role);
+    if (!state->eventOk[Clock])
+    {
+        std::fprintf(stderr, "--profile: perf_event_open failed (perf_event_paranoid?), profiling off.\n");
+        state.reset();
+        return false;
+    }
+
+    // Drain the rings in the background so they do not overflow
+    state->collector = std::thread([s = state.get()] {
+        while (!s->quit.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            s->drainAll();
+        }
+    });
+    running.store(true, std::memory_order_release);
+    return true;
+}
+
+void Profiler::registerThread(Subsystem role)
+{
+    if (!running.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> guard(lifecycle);
+    if (running) registerLocked(role);
+}
+
+void Profiler::registerLocked(Subsystem role)
+{
+    for (int e = 0; e < NumEvents; ++e)
+    {
+        // An event the machine lacks (e.g. cache misses in a VM) is tried once
+        if (state->eventTried[e] && !state->eventOk[e]) continue;
+        bool ok = state->open(e, role);
+        std::lock_guard<std::mutex> lock(state->mtx);
+        if (!state->eventTried[e]) state->eventOk[e] = ok;
+        state->eventTried[e] = true;
+    }
+}
+
+void Profiler::stop(std::FILE* out)
+{
+    // Take the state out under the lock: no thread can register into it
+    // (or see it) from here on
+    std::unique_ptr<State> owned;
+    {
+        std::lock_guard<std::mutex> guard(lifecycle);
+        if (!running) return;
+        running = false;
+        owned = std::move(state);
+    }
+    State& s = *owned;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - s.t0).count();
+
+    for (Ring& r : s.rings) ioctl(r.fd, PERF_EVENT_IOC_DISABLE, 0);
+    s.quit = true;
+    if (s.collector.joinable()) s.collector.join();
+    s.drainAll();
+    for (Ring& r : s.rings)
+    {
+        ::munmap(r.map, r.bytes);
+        ::close(r.fd);
+    }
+    size_t threads = 0;
+    for (const Ring& r : s.rings) threads += r.event == Clock;
+    s.rings.clear();
+
+    if (out)
+    {
+        // Symbolise: executable symbols first, then the shared objects' own
+        ExeSymbols exe;
+        exe.load();
+        struct Row { std::string name; Subsystem sub; uint64_t n[NumEvents]; };
+        std::vector<Row> rows;
+        std::unordered_map<std::string, size_t> rowOf;
+        uint64_t total[NumEvents] = {}, perSub[static_cast<int>(Subsystem::Count)][NumEvents] = {};
+
+        for (int e = 0; e < NumEvents; ++e)
+        {
+            for (const auto& kv : s.counts[e])
+            {
+                const uint64_t ip = kv.first & ((uint64_t(1) << 56) - 1);
+                const Subsystem role = static_cast<Subsystem>(kv.first >> 56);
+                std::string name, module;
+                if (const std::string* sym = exe.find(ip))
+                {
+                    name = compact(demangle(sym->c_str()));
+                }
+                else
+                {
+                    Dl_info info;
+                    if (dladdr(reinterpret_cast<void*>(ip), &info) && info.dli_fname)
+                    {
+                        module = info.dli_fname;
+                        module = module.substr(module.find_last_of('/') + 1);
+                    }
+                    name = info.dli_sname ? demangle(info.dli_sname)
+                                          : "[" + (module.empty() ? std::string("unknown") : module) + "]";
+                }
+                const Subsystem sub = classify(name, module, role);
+                const std::string key = name + '\x1f' + subsystemName(sub);
+                auto it = rowOf.find(key);
+                if (it == rowOf.end())
+                {
+                    it = rowOf.emplace(key, rows.size()).first;
+                    rows.push_back({ name, sub, {} });
+                }
+                rows[it->second].n[e] += kv.second;
+                total[e] += kv.second;
+                perSub[static_cast<int>(sub)][e] += kv.second;
+            }
+        }
+
+        auto pct = [](uint64_t a, uint64_t b) { return b ? 100.0 * a / b : 0.0; };
+        std::fprintf(out, "\n== profile: %.1f s, %zu threads, %llu %s samples (every %.2f ms)",
+                     seconds, threads, (unsigned long long)total[Clock], eventName[Clock],
+                     s.cfg.clockPeriodNs * 1e-6);
+        if (s.eventOk[Misses])
+            std::fprintf(out, ", %llu %s samples (every %llu)", (unsigned long long)total[Misses],
+                         eventName[Misses], (unsigned long long)s.cfg.missPeriod);
+        else
+            std::fprintf(out, ", %s unavailable", eventName[Misses]);
+        std::fprintf(out, ", %llu lost ==\n", (unsigned long long)s.lost);
+
+        std::fprintf(out, "%-12s %7s %9s %8s\n", "subsystem", "cpu%", "cpu-ms", "misses%");
+        for (int k = 0; k < static_cast<int>(Subsystem::Count); ++k)
+        {
+            std::fprintf(out, "%-12s %6.1f%% %9.1f %7.1f%%\n", subsystemName(static_cast<Subsystem>(k)),
+                         pct(perSub[k][Clock], total[Clock]),
+                         perSub[k][Clock] * s.cfg.clockPeriodNs * 1e-6,
+                         pct(perSub[k][Misses], total[Misses]));
+        }
+
+        std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            return a.n[Clock] != b.n[Clock] ? a.n[Clock] > b.n[Clock] : a.n[Misses] > b.n[Misses];
+        });
+        std::fprintf(out, "\n%7s %8s %8s  %-10s %s\n", "cpu%", "samples", "misses", "subsystem", "function");
+        for (size_t i = 0; i < rows.size() && i < static_cast<size_t>(s.cfg.topFunctions); ++i)
+        {
+            std::string fn = rows[i].name;
+            if (fn.size() > 90) fn = fn.substr(0, 87) + "...";
+            std::fprintf(out, "%6.1f%% %8llu %8llu  %-10s %s\n", pct(rows[i].n[Clock], total[Clock]),
+                         (unsigned long long)rows[i].n[Clock], (unsigned long long)rows[i].n[Misses],
+                         subsystemName(rows[i].sub), fn.c_str());
+        }
+        std::fflush(out);
+    }
+}
+
+#endif
+
+} // namespace sim
@@ -0,0 +1,77 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Built-in sampling profiler (--profile): perf_event_open sampling of
+    the simulation's own threads, symbolised in-process, reported per
+    function and per subsystem at exit. Linux only; elsewhere every call
+    is a no-op.
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace sim {
+
+enum class Subsystem
+{
+    Control,
+    Physics,
+    Collision,
+    Render,
+    AssetIO,
+    Other,
+    Count
+};
+
+const char* subsystemName(Subsystem s);
+
+struct ProfilerConfig
+{
+    uint64_t clockPeriodNs  = 1000000;  // CPU-clock sample every 1 ms of thread CPU time
+    uint64_t missPeriod     = 10000;    // cache-miss sample every N misses
+    int      ringPages      = 64;       // per thread and event (power of two)
+    int      topFunctions   = 25;       // rows in the report
+};
+
+class Profiler
+{
+public:
+    // Process-wide instance; everything is a no-op until start()
+    static Profiler& instance();
+
+    // Begin sampling; the calling thread is registered as `role`.
+    // Threads created later register themselves with registerThread().
+    bool start(Subsystem role, const ProfilerConfig& cfg = ProfilerConfig());
+    bool active() const { return running.load(std::memory_order_acquire); }
+
+    // Sample the calling thread. `role` is where samples in code that no
+    // name rule claims (libc, libm, ...) are counted. Safe from any
+    // thread, also while another one starts or stops the profiler.
+    void registerThread(Subsystem role);
+
+    // Stop sampling and print the breakdown
+    void stop(std::FILE* out = stderr);
+
+    ~Profiler();
+
+    struct State;   // platform part, in the .cpp
+
+private:
+    Profiler() = default;
+
+    void registerLocked(Subsystem role);
+
+    // `lifecycle` is held while state is created, handed rings or torn
+    // down; `running` lets unprofiled threads skip it
+    std::atomic<bool> running{ false };
+    std::mutex lifecycle;
+    std::unique_ptr<State> state;
+};
+
+} // namespace sim
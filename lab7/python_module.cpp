@@ -0,0 +1,494 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Python module (import uavswarm) over the batched swarm engine,
+    written against the CPython API directly. State arrays are exported
+    through the buffer protocol, so numpy.asarray(s.positions) is a view
+    of the engine's own memory; step() runs without the GIL.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "swarm.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+
+using control::Vec3;
+
+// ------------------------------------------
+// Swarm
+// ------------------------------------------
+struct SwarmObject
+{
+    PyObject_HEAD
+    sim::Swarm* swarm;
+    Py_ssize_t  exports;   // live buffers; the arrays must not move meanwhile
+    bool        busy;      // step() running with the GIL released
+};
+
+// Fields exported as arrays
+enum class Field
+{
+    Positions,
+    Velocities,
+    Accelerations,
+    Phases
+};
+
+struct ArrayObject
+{
+    PyObject_HEAD
+    SwarmObject* owner;
+    Field        field;
+    Py_ssize_t   shape[2];
+    Py_ssize_t   strides[2];
+};
+
+// Heap types, created in PyInit_uavswarm
+PyTypeObject* ArrayType = nullptr;
+
+bool checkIdle(SwarmObject* self, bool resizing)
+{
+    if (self->busy)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "swarm is stepping in another thread");
+        return false;
+    }
+    if (resizing && self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "cannot add drones while state arrays are exported");
+        return false;
+    }
+    return true;
+}
+
+// Missions must exist; 0 is also fine before any is added (the swarm
+// then adds a default one)
+bool checkMission(sim::Swarm* s, unsigned mission)
+{
+    if (mission < std::max<size_t>(s->missionCount(), 1)) return true;
+    PyErr_Format(PyExc_ValueError, "mission %u does not exist (%zu missions)", mission, s->missionCount());
+    return false;
+}
+
+bool parseVec3(PyObject* o, Vec3& v)
+{
+    return PyArg_ParseTuple(o, "ddd", &v.x, &v.y, &v.z) != 0;
+}
+
+PyObject* Swarm_new(PyTypeObject* type, PyObject*, PyObject*)
+{
+    SwarmObject* self = reinterpret_cast<SwarmObject*>(type->tp_alloc(type, 0));
+    if (self)
+    {
+        self->swarm = nullptr;
+        self->exports = 0;
+        self->busy = false;
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+int Swarm_init(SwarmObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = { "dt", "threads", "dynamics", "controller", "multi_rate",
+                                    "battery", "collision_dist", nullptr };
+    sim::SwarmConfig cfg;
+    unsigned threads = cfg.threads;
+    const char* dynamics = "point_mass";
+    const char* controller = "pid";
+    int multiRate = cfg.multiRate, battery = cfg.simulateBattery;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|dIssppd", const_cast<char**>(kwlist), &cfg.dt,
+                                     &threads, &dynamics, &controller, &multiRate, &battery,
+                                     &cfg.collisionDist))
+        return -1;
+    if (self->swarm && !checkIdle(self, true)) return -1;
+
+    if (std::strcmp(dynamics, "point_mass") == 0)     cfg.dynamics = sim::Dynamics::PointMass;
+    else if (std::strcmp(dynamics, "quadrotor") == 0) cfg.dynamics = sim::Dynamics::Quadrotor;
+    else
+    {
+        PyErr_SetString(PyExc_ValueError, "dynamics must be 'point_mass' or 'quadrotor'");
+        return -1;
+    }
+    if (std::strcmp(controller, "pid") == 0)      cfg.controller = sim::Controller::PID;
+    else if (std::strcmp(controller, "mpc") == 0) cfg.controller = sim::Controller::MPC;
+    else
+    {
+        PyErr_SetString(PyExc_ValueError, "controller must be 'pid' or 'mpc'");
+        return -1;
+    }
+    if (cfg.dt <= 0.0)
+    {
+        PyErr_SetString(PyExc_ValueError, "dt must be positive");
+        return -1;
+    }
+    cfg.threads = threads;
+    cfg.multiRate = multiRate != 0;
+    cfg.simulateBattery = battery != 0;
+
+    sim::Swarm* s = new (std::nothrow) sim::Swarm(cfg);
+    if (!s)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+    delete self->swarm;
+    self->swarm = s;
+    return 0;
+}
+
+void Swarm_dealloc(SwarmObject* self)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    delete self->swarm;
+    type->tp_free(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(type);
+}
+
+sim::Swarm* swarmOf(SwarmObject* self)
+{
+    if (!self->swarm) PyErr_SetString(PyExc_RuntimeError, "Swarm.__init__ was not called");
+    return self->swarm;
+}
+
+PyObject* Swarm_addMission(SwarmObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = { "center", "radius", "ground_wait", nullptr };
+    control::ControlConfig cfg;
+    PyObject* center = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Odd", const_cast<char**>(kwlist), &center,
+                                     &cfg.sphereRadius, &cfg.groundWait))
+        return nullptr;
+    if (center && !parseVec3(center, cfg.center)) return nullptr;
+    sim::Swarm* s = swarmOf(self);
+    if (!s || !checkIdle(self, false)) return nullptr;
+    return PyLong_FromUnsignedLong(s->addMission(cfg));
+}
+
+PyObject* Swarm_addDrone(SwarmObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = { "position", "mission", nullptr };
+    PyObject* posObj = nullptr;
+    unsigned mission = 0;
+    Vec3 p;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|I", const_cast<char**>(kwlist), &posObj, &mission)
+        || !parseVec3(posObj, p))
+        return nullptr;
+    sim::Swarm* s = swarmOf(self);
+    if (!s || !checkIdle(self, true) || !checkMission(s, mission)) return nullptr;
+    return PyLong_FromUnsignedLong(s->addDrone(p, mission));
+}
+
+// Many drones from an (n, 3) float64 buffer, e.g. a NumPy array
+PyObject* Swarm_addDrones(SwarmObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = { "positions", "mission", nullptr };
+    PyObject* posObj = nullptr;
+    unsigned mission = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|I", const_cast<char**>(kwlist), &posObj, &mission))
+        return nullptr;
+    sim::Swarm* s = swarmOf(self);
+    if (!s || !checkMission(s, mission)) return nullptr;
+
+    // Take the buffer before checking for exports: if it is one of our
+    // own arrays, growing the swarm would move it out from under us
+    Py_buffer view;
+    if (PyObject_GetBuffer(posObj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) return nullptr;
+    if (!checkIdle(self, true))
+    {
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+    const bool ok = view.ndim == 2 && view.shape[1] == 3 && view.itemsize == sizeof(double)
+                 && view.format && (std::strcmp(view.format, "d") == 0 || std::strcmp(view.format, "<d") == 0
+                                    || std::strcmp(view.format, "=d") == 0);
+    if (!ok)
+    {
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "positions must be a C-contiguous (n, 3) float64 array");
+        return nullptr;
+    }
+    const Py_ssize_t n = view.shape[0];
+    const std::vector<uint32_t> missions(static_cast<size_t>(n), mission);
+    s->addDrones(static_cast<const Vec3*>(view.buf), missions.data(), static_cast<size_t>(n));
+    PyBuffer_Release(&view);
+    return PyLong_FromSsize_t(n);
+}
+
+PyObject* Swarm_step(SwarmObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = { "ticks", nullptr };
+    int ticks = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", const_cast<char**>(kwlist), &ticks)) return nullptr;
+    sim::Swarm* s = swarmOf(self);
+    if (!s || !checkIdle(self, false)) return nullptr;
+    if (ticks > 0)
+    {
+        self->busy = true;
+        Py_BEGIN_ALLOW_THREADS
+        s->step(ticks);
+        Py_END_ALLOW_THREADS
+        self->busy = false;
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject* makeArray(SwarmObject* self, Field f)
+{
+    if (!swarmOf(self)) return nullptr;
+    ArrayObject* a = PyObject_New(ArrayObject, ArrayType);
+    if (!a) return nullptr;
+    Py_INCREF(self);
+    a->owner = self;
+    a->field = f;
+    return reinterpret_cast<PyObject*>(a);
+}
+
+PyObject* Swarm_positions(SwarmObject* self, void*)     { return makeArray(self, Field::Positions); }
+PyObject* Swarm_velocities(SwarmObject* self, void*)    { return makeArray(self, Field::Velocities); }
+PyObject* Swarm_accelerations(SwarmObject* self, void*) { return makeArray(self, Field::Accelerations); }
+PyObject* Swarm_phases(SwarmObject* self, void*)        { return makeArray(self, Field::Phases); }
+
+PyObject* Swarm_size(SwarmObject* self, void*)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? PyLong_FromSize_t(s->size()) : nullptr;
+}
+
+PyObject* Swarm_tick(SwarmObject* self, void*)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? PyLong_FromUnsignedLongLong(s->tick()) : nullptr;
+}
+
+PyObject* Swarm_time(SwarmObject* self, void*)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? PyFloat_FromDouble(s->time()) : nullptr;
+}
+
+PyObject* Swarm_collisions(SwarmObject* self, void*)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? PyLong_FromUnsignedLongLong(s->collisions()) : nullptr;
+}
+
+PyObject* Swarm_threads(SwarmObject* self, void*)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? PyLong_FromUnsignedLong(s->threads()) : nullptr;
+}
+
+Py_ssize_t Swarm_len(SwarmObject* self)
+{
+    sim::Swarm* s = swarmOf(self);
+    return s ? static_cast<Py_ssize_t>(s->size()) : -1;
+}
+
+PyMethodDef swarmMethods[] = {
+    { "add_mission", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Swarm_addMission)),
+      METH_VARARGS | METH_KEYWORDS,
+      "add_mission(center=(0, 0, 50), radius=10.0, ground_wait=5.0) -> mission id" },
+    { "add_drone", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Swarm_addDrone)),
+      METH_VARARGS | METH_KEYWORDS, "add_drone((x, y, z), mission=0) -> drone index" },
+    { "add_drones", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Swarm_addDrones)),
+      METH_VARARGS | METH_KEYWORDS, "add_drones(positions (n, 3) float64, mission=0) -> n" },
+    { "step", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Swarm_step)),
+      METH_VARARGS | METH_KEYWORDS, "step(ticks=1): advance the swarm; the GIL is released" },
+    { nullptr, nullptr, 0, nullptr }
+};
+
+PyGetSetDef swarmGetSet[] = {
+    { "positions", reinterpret_cast<getter>(Swarm_positions), nullptr,
+      "(n, 3) float64 view of the positions, m", nullptr },
+    { "velocities", reinterpret_cast<getter>(Swarm_velocities), nullptr,
+      "(n, 3) float64 view of the velocities, m/s", nullptr },
+    { "accelerations", reinterpret_cast<getter>(Swarm_accelerations), nullptr,
+      "(n, 3) float64 view of the last step's accelerations, m/s^2", nullptr },
+    { "phases", reinterpret_cast<getter>(Swarm_phases), nullptr,
+      "(n,) int32 strided view of the flight phases (index into PHASES)", nullptr },
+    { "size", reinterpret_cast<getter>(Swarm_size), nullptr, "number of drones", nullptr },
+    { "tick", reinterpret_cast<getter>(Swarm_tick), nullptr, "base ticks stepped", nullptr },
+    { "time", reinterpret_cast<getter>(Swarm_time), nullptr, "simulated time, s", nullptr },
+    { "collisions", reinterpret_cast<getter>(Swarm_collisions), nullptr, "collisions resolved", nullptr },
+    { "threads", reinterpret_cast<getter>(Swarm_threads), nullptr, "worker threads", nullptr },
+    { nullptr, nullptr, nullptr, nullptr, nullptr }
+};
+
+PyType_Slot swarmSlots[] = {
+    { Py_tp_doc, const_cast<char*>("Swarm(dt=0.01, threads=0, dynamics='point_mass', controller='pid', "
+                                   "multi_rate=False, battery=False, collision_dist=0.01)") },
+    { Py_tp_new, reinterpret_cast<void*>(Swarm_new) },
+    { Py_tp_init, reinterpret_cast<void*>(Swarm_init) },
+    { Py_tp_dealloc, reinterpret_cast<void*>(Swarm_dealloc) },
+    { Py_tp_methods, swarmMethods },
+    { Py_tp_getset, swarmGetSet },
+    { Py_sq_length, reinterpret_cast<void*>(Swarm_len) },
+    { 0, nullptr }
+};
+
+PyType_Spec swarmSpec = {
+    "uavswarm.Swarm", sizeof(SwarmObject), 0, Py_TPFLAGS_DEFAULT, swarmSlots
+};
+
+// ------------------------------------------
+// State arrays
+// ------------------------------------------
+// Read-only views; the memory is the swarm's and is updated in place by
+// step(). Adding drones is refused while any view is exported.
+int Array_getbuffer(ArrayObject* self, Py_buffer* view, int flags)
+{
+    if (flags & PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "swarm state arrays are read-only");
+        return -1;
+    }
+    const sim::Swarm& s = *self->owner->swarm;
+    const size_t n = s.size();
+    static double empty[3] = { 0.0, 0.0, 0.0 };
+
+    const char* format;
+    bool contiguous = true;
+    void* buf;
+    int ndim;
+    if (self->field == Field::Phases)
+    {
+        static_assert(sizeof(control::Phase) == sizeof(int), "phases are exported as int32");
+        ndim = 1;
+        format = "i";
+        self->shape[0] = static_cast<Py_ssize_t>(n);
+        self->strides[0] = sizeof(control::ControlState);
+        buf = n ? const_cast<control::Phase*>(&s.controlState(0).phase) : static_cast<void*>(empty);
+        contiguous = n <= 1;
+        view->itemsize = sizeof(int);
+    }
+    else
+    {
+        static_assert(sizeof(Vec3) == 3 * sizeof(double), "Vec3 must be three packed doubles");
+        const std::vector<Vec3>& v = self->field == Field::Positions  ? s.positions()
+                                   : self->field == Field::Velocities ? s.velocities()
+                                                                      : s.accelerations();
+        ndim = 2;
+        format = "d";
+        self->shape[0] = static_cast<Py_ssize_t>(n);
+        self->shape[1] = 3;
+        self->strides[0] = sizeof(Vec3);
+        self->strides[1] = sizeof(double);
+        buf = n ? const_cast<Vec3*>(v.data()) : static_cast<void*>(empty);
+        view->itemsize = sizeof(double);
+    }
+    if (!contiguous && (flags & PyBUF_STRIDES) != PyBUF_STRIDES)
+    {
+        PyErr_SetString(PyExc_BufferError, "phases are strided; request a strided buffer");
+        return -1;
+    }
+
+    view->buf = buf;
+    view->obj = reinterpret_cast<PyObject*>(self);
+    Py_INCREF(self);
+    view->len = self->shape[0] * (ndim == 2 ? 3 : 1) * view->itemsize;
+    view->readonly = 1;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(format) : nullptr;
+    view->ndim = (flags & PyBUF_ND) ? ndim : 1;
+    view->shape = (flags & PyBUF_ND) ? self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    ++self->owner->exports;
+    return 0;
+}
+
+void Array_releasebuffer(ArrayObject* self, Py_buffer*)
+{
+    --self->owner->exports;
+}
+
+void Array_dealloc(ArrayObject* self)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    Py_DECREF(self->owner);
+    PyObject_Free(self);
+    Py_DECREF(type);
+}
+
+PyObject* Array_repr(ArrayObject* self)
+{
+    static const char* names[] = { "positions", "velocities", "accelerations", "phases" };
+    const sim::Swarm* s = self->owner->swarm;
+    return PyUnicode_FromFormat("<uavswarm.StateArray %s of %zd drones>",
+                                names[static_cast<int>(self->field)],
+                                static_cast<Py_ssize_t>(s ? s->size() : 0));
+}
+
+PyType_Slot arraySlots[] = {
+    { Py_tp_doc, const_cast<char*>("Read-only buffer over one of the swarm's state arrays") },
+    { Py_tp_dealloc, reinterpret_cast<void*>(Array_dealloc) },
+    { Py_tp_repr, reinterpret_cast<void*>(Array_repr) },
+    { Py_bf_getbuffer, reinterpret_cast<void*>(Array_getbuffer) },
+    { Py_bf_releasebuffer, reinterpret_cast<void*>(Array_releasebuffer) },
+    { 0, nullptr }
+};
+
+PyType_Spec arraySpec = {
+    "uavswarm.StateArray", sizeof(ArrayObject), 0, Py_TPFLAGS_DEFAULT, arraySlots
+};
+
+// ------------------------------------------
+// Module
+// ------------------------------------------
+PyModuleDef moduleDef = {
+    PyModuleDef_HEAD_INIT,
+    "uavswarm",
+    "Batched UAV swarm engine. State arrays support the buffer protocol:\n"
+    "numpy.asarray(swarm.positions) is a zero-copy, read-only view that\n"
+    "step() updates in place.",
+    -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_uavswarm(void)
+{
+    PyObject* m = PyModule_Create(&moduleDef);
+    if (!m) return nullptr;
+
+    const int nPhases = static_cast<int>(control::Phase::Landed) + 1;
+    PyObject* phases = PyTuple_New(nPhases);
+    for (int k = 0; phases && k < nPhases; ++k)
+        PyTuple_SET_ITEM(phases, k, PyUnicode_FromString(control::phaseToString(static_cast<control::Phase>(k))));
+    PyObject* swarmType = PyType_FromSpec(&swarmSpec);
+    PyObject* arrayType = PyType_FromSpec(&arraySpec);
+    ArrayType = reinterpret_cast<PyTypeObject*>(arrayType);
+    Py_XINCREF(arrayType);   // one reference stays with ArrayType
+
+    // PyModule_AddObject steals only on success
+    if (!phases || PyModule_AddObject(m, "PHASES", phases) < 0)
+    {
+        Py_XDECREF(phases);
+        Py_XDECREF(swarmType);
+        Py_XDECREF(arrayType);
+        Py_DECREF(m);
+        return nullptr;
+    }
+    if (!swarmType || PyModule_AddObject(m, "Swarm", swarmType) < 0)
+    {
+        Py_XDECREF(swarmType);
+        Py_XDECREF(arrayType);
+        Py_DECREF(m);
+        return nullptr;
+    }
+    if (!arrayType || PyModule_AddObject(m, "StateArray", arrayType) < 0)
+    {
+        Py_XDECREF(arrayType);
+        Py_DECREF(m);
+        return nullptr;
+    }
+    return m;
+}
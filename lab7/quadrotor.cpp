@@ -0,0 +1,182 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the batched quadrotor dynamics.
+*/
+
+#include "quadrotor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+void QuadrotorBatch::resize(size_t n)
+{
+    for (auto* v : { &fx, &fy, &fz, &qx, &qy, &qz, &wx, &wy, &wz,
+                     &m0, &m1, &m2, &m3, &ax, &ay, &az })
+    {
+        v->resize(n, 0.0);
+    }
+    qw.resize(n, 1.0);
+}
+
+namespace
+{
+
+struct KernelConsts
+{
+    double L, k, Jxy, Jz, fMax, cMin, sMax, Kq, Kw, invM, dt, gravity;
+};
+
+// Motors sit on the body axes: 0 at +x, 1 at +y, 2 at -x, 3 at -y.
+// 0 and 2 spin clockwise, 1 and 3 counter-clockwise. Then
+//   T  = f0 + f1 + f2 + f3
+//   tx = L (f1 - f3),  ty = L (f2 - f0),  tz = k (-f0 + f1 - f2 + f3)
+//
+// The loop body is branch-free (selects only) and every array is a
+// restrict parameter, so the compiler vectorises it across drones.
+// Masked: motor thrusts are scaled by H0..H3 (fault injection).
+template <bool Masked>
+void quadKernel(size_t begin, size_t end, const KernelConsts c,
+                const double* __restrict Fx, const double* __restrict Fy,
+                const double* __restrict Fz,
+                double* __restrict Qw, double* __restrict Qx,
+                double* __restrict Qy, double* __restrict Qz,
+                double* __restrict Wx, double* __restrict Wy,
+                double* __restrict Wz,
+                double* __restrict M0, double* __restrict M1,
+                double* __restrict M2, double* __restrict M3,
+                double* __restrict Ax, double* __restrict Ay,
+                double* __restrict Az,
+                const double* __restrict H0, const double* __restrict H1,
+                const double* __restrict H2, const double* __restrict H3)
+{
+    const double invL2 = 0.5 / c.L;
+    const double invK4 = 0.25 / c.k;
+    const double dt    = c.dt;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        // 1) Force command -> thrust direction b (tilt-limited) and thrust
+        double fm  = std::sqrt(Fx[i] * Fx[i] + Fy[i] * Fy[i] + Fz[i] * Fz[i]);
+        double inv = 1.0 / std::max(fm, 1e-9);
+        double bx  = Fx[i] * inv;
+        double by  = Fy[i] * inv;
+        double bz  = fm < 1e-9 ? 1.0 : Fz[i] * inv;
+
+        bool   tilted = bz < c.cMin;
+        double h      = std::sqrt(std::max(bx * bx + by * by, 1e-18));
+        double hs     = tilted ? c.sMax / h : 1.0;
+        bx *= hs;
+        by *= hs;
+        bz  = tilted ? c.cMin : bz;
+
+        double thrust = std::max(0.0, Fx[i] * bx + Fy[i] * by + Fz[i] * bz);
+
+        // 2) Desired attitude: shortest arc taking body z onto b
+        double dw = 1.0 + bz, dx = -by, dy = bx;
+        double dn = 1.0 / std::sqrt(dw * dw + dx * dx + dy * dy);
+        dw *= dn; dx *= dn; dy *= dn;
+
+        // 3) Attitude error e = conj(q) * qd, body-rate setpoint from it
+        double w = Qw[i], x = Qx[i], y = Qy[i], z = Qz[i];
+        double ew =  w * dw + x * dx + y * dy;
+        double ex =  w * dx - x * dw + z * dy;
+        double ey =  w * dy - y * dw - z * dx;
+        double ez = -x * dy + y * dx - z * dw;
+        double sgn = ew < 0.0 ? -c.Kq : c.Kq;
+
+        double rx = Wx[i], ry = Wy[i], rz = Wz[i];
+        double gx = (c.Jz - c.Jxy) * ry * rz;   // w x Jw
+        double gy = (c.Jxy - c.Jz) * rz * rx;
+
+        // 4) Rate loop -> body torques
+        double tx = c.Jxy * c.Kw * (sgn * ex - rx) + gx;
+        double ty = c.Jxy * c.Kw * (sgn * ey - ry) + gy;
+        double tz = c.Jz  * c.Kw * (sgn * ez - rz);
+
+        // 5) Motor mixing and saturation
+        double base = 0.25 * thrust;
+        double f0 = std::min(std::max(base - ty * invL2 - tz * invK4, 0.0), c.fMax);
+        double f1 = std::min(std::max(base + tx * invL2 + tz * invK4, 0.0), c.fMax);
+        double f2 = std::min(std::max(base + ty * invL2 - tz * invK4, 0.0), c.fMax);
+        double f3 = std::min(std::max(base - tx * invL2 + tz * invK4, 0.0), c.fMax);
+        if constexpr (Masked)
+        {
+            f0 *= H0[i]; f1 *= H1[i]; f2 *= H2[i]; f3 *= H3[i];
+        }
+        M0[i] = f0; M1[i] = f1; M2[i] = f2; M3[i] = f3;
+
+        double T   = f0 + f1 + f2 + f3;
+        double tax = c.L * (f1 - f3);
+        double tay = c.L * (f2 - f0);
+        double taz = c.k * (-f0 + f1 - f2 + f3);
+
+        // 6) Rotational dynamics: J dw/dt = tau - w x Jw
+        rx += (tax - gx) / c.Jxy * dt;
+        ry += (tay - gy) / c.Jxy * dt;
+        rz += taz / c.Jz * dt;
+        Wx[i] = rx; Wy[i] = ry; Wz[i] = rz;
+
+        // 7) Quaternion kinematics dq/dt = q * (0, w) / 2, renormalised
+        double nw = w + 0.5 * dt * (-x * rx - y * ry - z * rz);
+        double nx = x + 0.5 * dt * ( w * rx + y * rz - z * ry);
+        double ny = y + 0.5 * dt * ( w * ry - x * rz + z * rx);
+        double nz = z + 0.5 * dt * ( w * rz + x * ry - y * rx);
+        double qn = 1.0 / std::sqrt(nw * nw + nx * nx + ny * ny + nz * nz);
+        nw *= qn; nx *= qn; ny *= qn; nz *= qn;
+        Qw[i] = nw; Qx[i] = nx; Qy[i] = ny; Qz[i] = nz;
+
+        // 8) Thrust along body z, plus gravity
+        double zx = 2.0 * (nx * nz + nw * ny);
+        double zy = 2.0 * (ny * nz - nw * nx);
+        double zz = 1.0 - 2.0 * (nx * nx + ny * ny);
+        Ax[i] = T * c.invM * zx;
+        Ay[i] = T * c.invM * zy;
+        Az[i] = T * c.invM * zz - c.gravity;
+    }
+}
+
+} // namespace
+
+void QuadrotorBatch::step(size_t begin, size_t end, double dt,
+                          double mass, double gravity, const double* const* health)
+{
+    KernelConsts c;
+    c.L       = params.armLength;
+    c.k       = params.yawCoeff;
+    c.Jxy     = params.inertiaXY;
+    c.Jz      = params.inertiaZ;
+    c.fMax    = params.maxMotorForce;
+    c.cMin    = std::cos(params.maxTilt);
+    c.sMax    = std::sin(params.maxTilt);
+    c.Kq      = 2.0 * params.attitudeGain;
+    c.Kw      = params.rateGain;
+    c.invM    = 1.0 / mass;
+    c.dt      = dt;
+    c.gravity = gravity;
+
+    if (health)
+    {
+        quadKernel<true>(begin, end, c,
+                         fx.data(), fy.data(), fz.data(),
+                         qw.data(), qx.data(), qy.data(), qz.data(),
+                         wx.data(), wy.data(), wz.data(),
+                         m0.data(), m1.data(), m2.data(), m3.data(),
+                         ax.data(), ay.data(), az.data(),
+                         health[0], health[1], health[2], health[3]);
+        return;
+    }
+    quadKernel<false>(begin, end, c,
+                      fx.data(), fy.data(), fz.data(),
+                      qw.data(), qx.data(), qy.data(), qz.data(),
+                      wx.data(), wy.data(), wz.data(),
+                      m0.data(), m1.data(), m2.data(), m3.data(),
+                      ax.data(), ay.data(), az.data(),
+                      nullptr, nullptr, nullptr, nullptr);
+}
+
+} // namespace sim
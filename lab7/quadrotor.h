@@ -0,0 +1,58 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Batched 6-DOF quadrotor dynamics: quaternion attitude, body rates,
+    four-motor "+" mixing and an attitude inner loop. State is kept one
+    array per component so the kernel vectorises across drones.
+*/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace sim {
+
+struct QuadrotorParams
+{
+    double armLength     = 0.10;    // m, motor to centre
+    double inertiaXY     = 0.005;   // kg m^2 (roll / pitch)
+    double inertiaZ      = 0.009;   // kg m^2 (yaw)
+    double yawCoeff      = 0.016;   // m, reaction torque per N of thrust
+    double maxMotorForce = 8.0;     // N per motor
+    double maxTilt       = 1.0;     // rad, limit on commanded tilt
+
+    // Attitude inner loop: quaternion error -> body rate -> torque
+    double attitudeGain  = 8.0;     // 1/s
+    double rateGain      = 25.0;    // 1/s
+};
+
+class QuadrotorBatch
+{
+public:
+    void resize(size_t n);
+    size_t size() const { return qw.size(); }
+
+    // Advance drones [begin, end). Inputs are the position controller's
+    // force (fx, fy, fz), turned into a thrust + attitude setpoint; outputs
+    // are the world-frame accelerations (ax, ay, az), gravity included.
+    // `health`, if given, scales each motor's thrust after saturation
+    // (one array per motor, indexed like the state; 1 = nominal).
+    void step(size_t begin, size_t end, double dt, double mass, double gravity,
+              const double* const* health = nullptr);
+
+    QuadrotorParams params;
+
+    // Inputs
+    std::vector<double> fx, fy, fz;
+    // Attitude (unit quaternion, body -> world) and body rates
+    std::vector<double> qw, qx, qy, qz;
+    std::vector<double> wx, wy, wz;
+    // Motor thrusts after saturation (for display / energy use)
+    std::vector<double> m0, m1, m2, m3;
+    // Outputs
+    std::vector<double> ax, ay, az;
+};
+
+} // namespace sim
@@ -0,0 +1,150 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Command-line queries over flight recordings.
+    Usage: uav_query <command> <file> [args...]
+*/
+
+#include "recording.h"
+#include "swarm.h"
+#include "trajectory_query.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using control::Vec3;
+
+namespace
+{
+
+double secondsSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Fly `drones` drones from a 3 m ground grid onto one shared sphere and
+// record them at `hz`
+int record(const std::string& path, int drones, double seconds, double hz)
+{
+    sim::Swarm swarm;
+    control::ControlConfig mission;
+    mission.center = Vec3(0, 0, 50);
+    mission.sphereRadius = 10.0;
+    uint32_t m = swarm.addMission(mission);
+    const int cols = static_cast<int>(std::ceil(std::sqrt(drones)));
+    for (int k = 0; k < drones; ++k)
+        swarm.addDrone(Vec3(3.0 * (k % cols - cols / 2), 3.0 * (k / cols - cols / 2), 0), m);
+
+    const int every = std::max(1, static_cast<int>(std::lround(1.0 / (hz * swarm.config().dt))));
+    sim::RecordingWriter out;
+    if (!out.open(path, drones, 0.0, every * swarm.config().dt))
+    {
+        std::cerr << "Cannot write " << path << "\n";
+        return 1;
+    }
+    out.append(swarm.positions());
+    const int ticks = static_cast<int>(seconds / swarm.config().dt);
+    for (int t = 1; t <= ticks; ++t)
+    {
+        swarm.step();
+        if (t % every == 0) out.append(swarm.positions());
+    }
+    uint64_t frames = out.frames();
+    if (!out.close())
+    {
+        std::cerr << "Write to " << path << " failed\n";
+        return 1;
+    }
+    std::cout << "Recorded " << drones << " drones, " << frames << " frames to " << path << "\n";
+    return 0;
+}
+
+void printCounters(const sim::TrajectoryQuery& q, double sec)
+{
+    const sim::QueryCounters& c = q.counters();
+    std::cout << "(" << 1e3 * sec << " ms; " << c.slices << " slices, " << c.candidates
+              << " candidates, " << c.samples << " positions read)\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: uav_query <command> <file> [args]\n"
+              << "  record <file> [drones=1000] [seconds=300] [hz=10]\n"
+              << "  info   <file>\n"
+              << "  range  <file> <t0> <t1> <x> <y> <z> <radius>\n"
+              << "  knn    <file> <t> <x> <y> <z> [k=5]\n"
+              << "  near   <file> <t0> <t1> [dist=0.5]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) return usage();
+    std::string cmd = argv[1], path = argv[2];
+    auto arg = [&](int i, double def) { return argc > i ? std::atof(argv[i]) : def; };
+
+    if (cmd == "record")
+    {
+        return record(path, static_cast<int>(arg(3, 1000)), arg(4, 300.0), arg(5, 10.0));
+    }
+
+    sim::ThreadPool pool;
+    sim::Recording rec;
+    if (!rec.open(path, &pool))
+    {
+        std::cerr << "Cannot read recording " << path << "\n";
+        return 1;
+    }
+    sim::TrajectoryQuery q(rec, pool);
+    std::cout << std::fixed << std::setprecision(3);
+
+    if (cmd == "info")
+    {
+        std::cout << path << ": " << rec.drones() << " drones, " << rec.frames() << " frames, "
+                  << rec.startTime() << " - " << rec.endTime() << " s every " << rec.period()
+                  << " s, " << rec.slices() << " slices of " << rec.sliceFrames() << " frames"
+                  << (rec.builtIndex() ? " (index rebuilt)" : "") << "\n";
+        return 0;
+    }
+    if (cmd == "range" && argc >= 9)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        auto hits = q.range(Vec3(arg(5, 0), arg(6, 0), arg(7, 0)), arg(8, 1), arg(3, 0), arg(4, 0));
+        double sec = secondsSince(t0);
+        for (const sim::RangeHit& h : hits)
+            std::cout << "drone " << h.drone << "  closest " << h.dist << " m at t=" << h.time << "\n";
+        std::cout << hits.size() << " drones ";
+        printCounters(q, sec);
+        return 0;
+    }
+    if (cmd == "knn" && argc >= 7)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        auto nn = q.nearest(Vec3(arg(4, 0), arg(5, 0), arg(6, 0)), arg(3, 0),
+                            static_cast<int>(arg(7, 5)));
+        double sec = secondsSince(t0);
+        for (const sim::Neighbor& n : nn)
+            std::cout << "drone " << n.drone << "  " << n.dist << " m\n";
+        printCounters(q, sec);
+        return 0;
+    }
+    if (cmd == "near" && argc >= 5)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        auto pairs = q.nearMisses(arg(5, 0.5), arg(3, 0), arg(4, 0));
+        double sec = secondsSince(t0);
+        for (const sim::NearMiss& p : pairs)
+            std::cout << "drones " << p.a << " & " << p.b << "  " << p.dist << " m at t=" << p.time << "\n";
+        std::cout << pairs.size() << " pairs ";
+        printCounters(q, sec);
+        return 0;
+    }
+    return usage();
+}
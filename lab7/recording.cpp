@@ -0,0 +1,230 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for flight recordings.
+*/
+
+#include "recording.h"
+#include "memtrack.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+
+namespace
+{
+
+void resetBoxes(float* boxes, size_t count)
+{
+    for (size_t i = 0; i < 6 * count; i += 6)
+    {
+        boxes[i] = boxes[i + 1] = boxes[i + 2] = INFINITY;
+        boxes[i + 3] = boxes[i + 4] = boxes[i + 5] = -INFINITY;
+    }
+}
+
+// Whether the header's frame count and index fit in a file of `bytes`.
+// Every product is bounded by a division first so none can wrap.
+bool indexFits(const RecordingHeader& h, size_t bytes)
+{
+    const uint64_t frameBytes = uint64_t(h.drones) * 3 * sizeof(float);
+    const uint64_t payload = bytes - sizeof(h);
+    if (frameBytes ? h.frames > payload / frameBytes : h.frames > UINT64_MAX - h.sliceFrames)
+        return false;
+    const uint64_t framesEnd = sizeof(h) + h.frames * frameBytes;
+    if (h.indexOffset < framesEnd || h.indexOffset > bytes || h.indexOffset % sizeof(float) != 0)
+        return false;
+    const uint64_t slices = (h.frames + h.sliceFrames - 1) / h.sliceFrames;
+    const uint64_t boxBytes = uint64_t(h.drones) * 6 * sizeof(float);
+    return boxBytes == 0 || slices <= (bytes - h.indexOffset) / boxBytes;
+}
+
+void growBox(float* b, const float* p)
+{
+    for (int a = 0; a < 3; ++a)
+    {
+        b[a]     = std::min(b[a], p[a]);
+        b[a + 3] = std::max(b[a + 3], p[a]);
+    }
+}
+
+} // namespace
+
+// ------------------------------------------
+// RecordingWriter
+// ------------------------------------------
+bool RecordingWriter::open(const std::string& path, uint32_t drones, double startTime,
+                           double period, uint32_t sliceFrames)
+{
+    close();
+    MemScope tag(Subsystem::AssetIO);
+    if (!out.open(path)) return false;
+
+    hdr = RecordingHeader();
+    hdr.drones      = drones;
+    hdr.sliceFrames = std::max(1u, sliceFrames);
+    hdr.startTime   = startTime;
+    hdr.period      = period;
+    frame.resize(static_cast<size_t>(drones) * 3);
+    sliceBox.resize(static_cast<size_t>(drones) * 6);
+    resetBoxes(sliceBox.data(), hdr.drones);
+    index.clear();
+    inSlice = 0;
+    ok = out.write(&hdr, sizeof(hdr));
+    return ok;
+}
+
+bool RecordingWriter::append(const std::vector<control::Vec3>& positions)
+{
+    if (!out.isOpen()) return false;
+    const size_t n = std::min<size_t>(hdr.drones, positions.size());
+    for (size_t d = 0; d < n; ++d)
+    {
+        float* p = &frame[3 * d];
+        p[0] = static_cast<float>(positions[d].x);
+        p[1] = static_cast<float>(positions[d].y);
+        p[2] = static_cast<float>(positions[d].z);
+        growBox(&sliceBox[6 * d], p);
+    }
+    ok = ok && out.write(frame.data(), frame.size() * sizeof(float));
+    ++hdr.frames;
+    if (++inSlice == hdr.sliceFrames) closeSlice();
+    return ok;
+}
+
+void RecordingWriter::closeSlice()
+{
+    MemScope tag(Subsystem::AssetIO);
+    index.insert(index.end(), sliceBox.begin(), sliceBox.end());
+    resetBoxes(sliceBox.data(), hdr.drones);
+    inSlice = 0;
+}
+
+bool RecordingWriter::close()
+{
+    if (!out.isOpen()) return ok;
+    if (inSlice > 0) closeSlice();
+
+    hdr.indexOffset = sizeof(hdr) + hdr.frames * frame.size() * sizeof(float);
+    ok = ok && out.write(index.data(), index.size() * sizeof(float));
+    ok = ok && out.writeAt(0, &hdr, sizeof(hdr));
+    ok = out.close() && ok;
+    index.clear();
+    index.shrink_to_fit();
+    return ok;
+}
+
+// ------------------------------------------
+// Recording
+// ------------------------------------------
+Recording::~Recording()
+{
+#ifndef _WIN32
+    if (base && contents.empty()) ::munmap(const_cast<unsigned char*>(base), bytes);
+#endif
+}
+
+bool Recording::open(const std::string& path, ThreadPool* pool)
+{
+#ifdef _WIN32
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    contents.resize(static_cast<size_t>(std::ftell(f)));
+    std::fseek(f, 0, SEEK_SET);
+    size_t got = std::fread(contents.data(), 1, contents.size(), f);
+    std::fclose(f);
+    if (got != contents.size() || got < sizeof(hdr)) return false;
+    base = contents.data();
+    bytes = contents.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(hdr))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const unsigned char*>(p);
+    bytes = static_cast<size_t>(st.st_size);
+#endif
+
+    std::memcpy(&hdr, base, sizeof(hdr));
+    const size_t frameBytes = static_cast<size_t>(hdr.drones) * 3 * sizeof(float);
+    if (std::memcmp(hdr.magic, "UREC", 4) != 0 || hdr.version != 1 || hdr.sliceFrames == 0)
+    {
+#ifndef _WIN32
+        ::munmap(const_cast<unsigned char*>(base), bytes);
+#endif
+        base = nullptr;
+        return false;
+    }
+    frameData = reinterpret_cast<const float*>(base + sizeof(hdr));
+
+    if (hdr.indexOffset != 0 && indexFits(hdr, bytes))
+    {
+        indexData = reinterpret_cast<const float*>(base + hdr.indexOffset);
+    }
+    else
+    {
+        // Writer never closed, or the header does not fit the file: trust
+        // only the whole frames on disk (before a plausible index)
+        const size_t end = hdr.indexOffset > sizeof(hdr) && hdr.indexOffset <= bytes
+            ? static_cast<size_t>(hdr.indexOffset) : bytes;
+        const uint64_t onDisk = frameBytes ? (end - sizeof(hdr)) / frameBytes : 0;
+        hdr.frames = hdr.indexOffset ? std::min(hdr.frames, onDisk) : onDisk;
+        buildIndex(pool);
+    }
+    return true;
+}
+
+void Recording::buildIndex(ThreadPool* pool)
+{
+    MemScope tag(Subsystem::AssetIO);
+    const size_t n = hdr.drones;
+    ownIndex.resize(slices() * n * 6);
+    auto run = [&](size_t b, size_t e, unsigned) {
+        for (size_t s = b; s < e; ++s)
+        {
+            float* boxes = &ownIndex[s * n * 6];
+            resetBoxes(boxes, n);
+            const uint64_t f1 = std::min<uint64_t>(hdr.frames, (s + 1) * hdr.sliceFrames);
+            for (uint64_t f = s * hdr.sliceFrames; f < f1; ++f)
+                for (size_t d = 0; d < n; ++d)
+                    growBox(boxes + 6 * d, position(f, static_cast<uint32_t>(d)));
+        }
+    };
+    if (pool) pool->parallelFor(slices(), run, 1);
+    else      run(0, slices(), 0);
+    indexData = ownIndex.data();
+}
+
+void Recording::frameRange(double t0, double t1, uint64_t& first, uint64_t& last) const
+{
+    first = last = 0;
+    if (frames() == 0 || t1 < t0 || hdr.period <= 0.0) return;
+    double a = std::ceil((t0 - hdr.startTime) / hdr.period - 1e-9);
+    double b = std::floor((t1 - hdr.startTime) / hdr.period + 1e-9) + 1.0;
+    a = std::max(a, 0.0);
+    b = std::min(b, static_cast<double>(frames()));
+    if (b <= a) return;
+    first = static_cast<uint64_t>(a);
+    last  = static_cast<uint64_t>(b);
+}
+
+} // namespace sim
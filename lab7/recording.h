@@ -0,0 +1,127 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Flight recordings: every drone's position at a fixed frame rate,
+    with a time-sliced index of per-drone bounding boxes so queries can
+    skip most of the file.
+*/
+
+#pragma once
+#include "async_writer.h"
+#include "control.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// File layout (little endian):
+//   header  64 bytes, see RecordingHeader
+//   frames  frames x drones x 3 float32 (x, y, z), frame f at start + f * period
+//   index   slices x drones x 6 float32 (lo xyz, hi xyz), slice s covering
+//           frames [s * sliceFrames, (s + 1) * sliceFrames)
+// indexOffset is 0 until the writer is closed; such a file is still
+// readable, the index is then rebuilt from the frames.
+struct RecordingHeader
+{
+    char     magic[4] = { 'U', 'R', 'E', 'C' };
+    uint32_t version     = 1;
+    uint32_t drones      = 0;
+    uint32_t sliceFrames = 0;
+    uint64_t frames      = 0;
+    double   startTime   = 0.0;
+    double   period      = 0.0;   // s between frames
+    uint64_t indexOffset = 0;     // bytes from the start of the file
+    uint8_t  reserved[16] = {};
+};
+static_assert(sizeof(RecordingHeader) == 64, "recording header must stay 64 bytes");
+
+// Frames go through the shared AsyncWriter, so appending does not wait
+// for the disk
+class RecordingWriter
+{
+public:
+    explicit RecordingWriter(const WriterConfig& io = WriterConfig()) : out(io) {}
+    ~RecordingWriter() { close(); }
+
+    // One frame every `period` seconds from `startTime`; the index keeps
+    // one box per drone per `sliceFrames` frames
+    bool open(const std::string& path, uint32_t drones, double startTime, double period,
+              uint32_t sliceFrames = 10);
+    bool isOpen() const { return out.isOpen(); }
+
+    // Positions of all drones for the next frame
+    bool append(const std::vector<control::Vec3>& positions);
+
+    // Flush the last slice, write the index and patch the header
+    bool close();
+
+    uint64_t frames() const { return hdr.frames; }
+    const AsyncWriter& writer() const { return out; }
+
+private:
+    void closeSlice();
+
+    AsyncWriter out;
+    RecordingHeader hdr;
+    std::vector<float> frame;
+    std::vector<float> sliceBox;   // drones x 6, current slice
+    std::vector<float> index;      // closed slices
+    uint32_t inSlice = 0;
+    bool ok = true;
+};
+
+class Recording
+{
+public:
+    Recording() = default;
+    ~Recording();
+    Recording(const Recording&) = delete;
+    Recording& operator=(const Recording&) = delete;
+
+    // Map the file (read the whole file on Windows). A file without an
+    // index gets one built from the frames, on `pool` if given.
+    bool open(const std::string& path, ThreadPool* pool = nullptr);
+    bool isOpen() const { return base != nullptr; }
+
+    uint32_t drones()      const { return hdr.drones; }
+    uint64_t frames()      const { return hdr.frames; }
+    uint32_t sliceFrames() const { return hdr.sliceFrames; }
+    uint64_t slices()      const { return (hdr.frames + hdr.sliceFrames - 1) / hdr.sliceFrames; }
+    double   startTime()   const { return hdr.startTime; }
+    double   period()      const { return hdr.period; }
+    double   timeOf(uint64_t f) const { return hdr.startTime + f * hdr.period; }
+    double   endTime()     const { return frames() ? timeOf(frames() - 1) : hdr.startTime; }
+
+    // Frames with timeOf(f) in [t0, t1] as [first, last); may be empty
+    void frameRange(double t0, double t1, uint64_t& first, uint64_t& last) const;
+
+    // Drone d in frame f: 3 floats
+    const float* position(uint64_t f, uint32_t d) const
+    {
+        return frameData + (f * hdr.drones + d) * 3;
+    }
+    // Drone d's box over slice s: lo xyz, hi xyz
+    const float* box(uint64_t s, uint32_t d) const
+    {
+        return indexData + (s * hdr.drones + d) * 6;
+    }
+
+    bool builtIndex() const { return !ownIndex.empty(); }
+
+private:
+    void buildIndex(ThreadPool* pool);
+
+    RecordingHeader hdr;
+    const unsigned char* base = nullptr;
+    size_t bytes = 0;
+    const float* frameData = nullptr;
+    const float* indexData = nullptr;
+    std::vector<float> ownIndex;          // rebuilt when the file has none
+    std::vector<unsigned char> contents;  // _WIN32: the whole file
+};
+
+} // namespace sim
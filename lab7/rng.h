@@ -0,0 +1,98 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Counter-based random numbers (Philox4x32-10) for the swarm engine.
+    Every draw is a pure function of (key, counter), so results do not
+    depend on thread count or on the order drones are processed in.
+*/
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace sim {
+
+struct Philox4x32
+{
+    uint32_t v[4];
+
+    // key = (k0, k1), counter = (c0, c1, c2, c3)
+    Philox4x32(uint32_t k0, uint32_t k1,
+               uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3)
+    {
+        uint32_t x0 = c0, x1 = c1, x2 = c2, x3 = c3;
+        for (int r = 0; r < 10; ++r)
+        {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * x0;
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * x2;
+            uint32_t y0 = static_cast<uint32_t>(p1 >> 32) ^ x1 ^ k0;
+            uint32_t y2 = static_cast<uint32_t>(p0 >> 32) ^ x3 ^ k1;
+            x1 = static_cast<uint32_t>(p1);
+            x3 = static_cast<uint32_t>(p0);
+            x0 = y0;
+            x2 = y2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        v[0] = x0; v[1] = x1; v[2] = x2; v[3] = x3;
+    }
+};
+
+// Uniform in (0, 1), never exactly 0 or 1
+inline double toUniform(uint32_t a)
+{
+    return (static_cast<double>(a) + 0.5) * (1.0 / 4294967296.0);
+}
+
+// Branch-free natural log for u in (0, 1]: exponent from the bits plus
+// an atanh series on the mantissa (|error| < 1e-9). Unlike std::log it
+// vectorises without -ffast-math.
+inline double logUnit(double u)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &u, sizeof bits);
+    int32_t e = static_cast<int32_t>((bits >> 52) & 0x7ff) - 1023;
+    bits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+    double m;
+    std::memcpy(&m, &bits, sizeof m);
+
+    // Keep the mantissa in [sqrt(1/2), sqrt(2))
+    bool big = m > 1.4142135623730951;
+    m = big ? 0.5 * m : m;
+    e = big ? e + 1 : e;
+
+    double s  = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double p  = 1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7
+              + s2 * (1.0 / 9 + s2 * (1.0 / 11)))));
+    return e * 0.6931471805599453 + 2.0 * s * p;
+}
+
+// Two independent standard normals from two random words (Box-Muller).
+// The angle's quadrant comes from the top two bits of b, the remaining
+// bits give an offset in [-pi/4, pi/4) where short Taylor series suffice.
+inline void normalPair(uint32_t a, uint32_t b, double& n0, double& n1)
+{
+    double r = std::sqrt(-2.0 * logUnit(toUniform(a)));
+
+    uint32_t q   = b >> 30;
+    double   phi = ((static_cast<double>(b & 0x3fffffffu) + 0.5) * (1.0 / 1073741824.0) - 0.5)
+                 * 1.5707963267948966;
+    double p2 = phi * phi;
+    double s  = phi * (1.0 - p2 / 6 * (1.0 - p2 / 20 * (1.0 - p2 / 42 * (1.0 - p2 / 72))));
+    double c  = 1.0 - p2 / 2 * (1.0 - p2 / 12 * (1.0 - p2 / 30 * (1.0 - p2 / 56 * (1.0 - p2 / 90))));
+
+    // Rotate (c, s) by q quarter turns
+    double x = (q & 1) ? -s : c;
+    double y = (q & 1) ?  c : s;
+    x = (q & 2) ? -x : x;
+    y = (q & 2) ? -y : y;
+
+    n0 = r * x;
+    n1 = r * y;
+}
+
+} // namespace sim
@@ -0,0 +1,85 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Compiles text scenarios into the memory-mapped binary form and back.
+    Usage: uav_scenario <command> <file> [args...]
+*/
+
+#include "scenario_file.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+double secondsSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int usage()
+{
+    std::cerr << "Usage: uav_scenario <command> <file> [args]\n"
+              << "  compile <scenario.txt> <out.scn>\n"
+              << "  decompile <scenario.scn> <out.txt>\n"
+              << "  info <scenario.txt|scenario.scn>\n";
+    return 1;
+}
+
+// A scenario of either form copied into vectors
+sim::Scenario toScenario(const sim::ScenarioView& v)
+{
+    sim::Scenario s;
+    s.missions.assign(v.missions, v.missions + v.missionCount);
+    s.airframes.assign(v.airframes, v.airframes + v.airframeCount);
+    s.obstacles.assign(v.obstacles, v.obstacles + v.obstacleCount);
+    s.positions.assign(v.positions, v.positions + v.drones);
+    s.yaw.assign(v.yaw, v.yaw + v.drones);
+    s.missionIds.assign(v.missionIds, v.missionIds + v.drones);
+    s.airframeIds.assign(v.airframeIds, v.airframeIds + v.drones);
+    return s;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) return usage();
+    const std::string cmd = argv[1], path = argv[2];
+    if ((cmd == "compile" || cmd == "decompile") && argc < 4) return usage();
+    if (cmd != "compile" && cmd != "decompile" && cmd != "info") return usage();
+
+    sim::ScenarioFile file;
+    sim::Scenario text;
+    sim::ScenarioView view;
+    std::string error;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!sim::openScenario(path, file, text, view, error))
+    {
+        std::cerr << path << ": " << error << "\n";
+        return 1;
+    }
+    const double loadTime = secondsSince(t0);
+
+    if (cmd == "compile" || cmd == "decompile")
+    {
+        t0 = std::chrono::steady_clock::now();
+        const sim::Scenario s = file.isOpen() ? toScenario(view) : std::move(text);
+        const bool ok = cmd == "compile" ? sim::saveScenarioBinary(s, argv[3])
+                                         : sim::saveScenarioText(s, argv[3]);
+        if (!ok)
+        {
+            std::cerr << "Cannot write " << argv[3] << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << argv[3] << " in " << secondsSince(t0) << " s\n";
+    }
+
+    std::cout << path << ": " << (file.isOpen() ? "compiled" : "text") << ", " << view.drones << " drones, "
+              << view.missionCount << " missions, " << view.airframeCount << " airframes, "
+              << view.obstacleCount << " obstacles (read in " << loadTime * 1e3 << " ms)\n";
+    return 0;
+}
@@ -0,0 +1,548 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for scenario files: the text parser and writer,
+    the compiler and the memory-mapped loader.
+*/
+
+#include "scenario_file.h"
+#include "memtrack.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+
+namespace
+{
+
+using control::Vec3;
+
+uint64_t alignUp(uint64_t off)
+{
+    return (off + 63) & ~uint64_t(63);
+}
+
+// Section offsets for a header's counts; the last entry is the file size
+struct Layout
+{
+    uint64_t missions, airframes, obstacles, positions, yaw, missionIds, airframeIds, end;
+
+    explicit Layout(const ScenarioHeader& h)
+    {
+        missions    = sizeof(ScenarioHeader);
+        airframes   = alignUp(missions + uint64_t(h.missions) * sizeof(control::ControlConfig));
+        obstacles   = alignUp(airframes + uint64_t(h.airframes) * sizeof(Airframe));
+        positions   = alignUp(obstacles + uint64_t(h.obstacles) * sizeof(Obstacle));
+        yaw         = alignUp(positions + h.drones * sizeof(Vec3));
+        missionIds  = alignUp(yaw + h.drones * sizeof(double));
+        airframeIds = alignUp(missionIds + h.drones * sizeof(uint32_t));
+        end         = airframeIds + h.drones * sizeof(uint16_t);
+    }
+};
+
+bool writeAt(std::FILE* f, uint64_t& at, uint64_t off, const void* p, size_t n)
+{
+    static const char zeros[64] = {};
+    while (at < off)
+    {
+        const size_t pad = static_cast<size_t>(std::min<uint64_t>(off - at, sizeof(zeros)));
+        if (std::fwrite(zeros, 1, pad, f) != pad) return false;
+        at += pad;
+    }
+    if (n && std::fwrite(p, 1, n, f) != n) return false;
+    at += n;
+    return true;
+}
+
+// ------------------------------------------
+// Text form
+// ------------------------------------------
+// One "key=value" token; value is a number or comma-separated numbers
+struct Token
+{
+    const char* key;
+    size_t keyLen;
+    const char* value;
+    size_t valueLen;
+
+    bool is(const char* k) const { return std::strlen(k) == keyLen && std::strncmp(k, key, keyLen) == 0; }
+};
+
+bool parseNumbers(const Token& t, double* out, int count)
+{
+    const char* p = t.value;
+    const char* end = t.value + t.valueLen;
+    for (int k = 0; k < count; ++k)
+    {
+        char* stop = nullptr;
+        out[k] = std::strtod(p, &stop);
+        if (stop == p || stop > end) return false;
+        p = stop;
+        if (k + 1 < count)
+        {
+            if (p >= end || *p != ',') return false;
+            ++p;
+        }
+    }
+    return p == end;
+}
+
+bool parseVec(const Token& t, Vec3& v)
+{
+    double d[3];
+    if (!parseNumbers(t, d, 3)) return false;
+    v = Vec3(d[0], d[1], d[2]);
+    return true;
+}
+
+bool parseIndex(const Token& t, uint32_t& v)
+{
+    double d;
+    if (!parseNumbers(t, &d, 1) || d < 0.0 || d != std::floor(d) || d > 4294967295.0) return false;
+    v = static_cast<uint32_t>(d);
+    return true;
+}
+
+// Splits a line into its keyword and tokens; false on a malformed token
+bool tokenize(const char* p, const char* end, std::string& word, std::vector<Token>& tokens)
+{
+    tokens.clear();
+    word.clear();
+    auto space = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    while (p < end && space(*p)) ++p;
+    const char* w = p;
+    while (p < end && !space(*p)) ++p;
+    word.assign(w, p);
+    while (p < end)
+    {
+        while (p < end && space(*p)) ++p;
+        if (p == end) break;
+        const char* k = p;
+        while (p < end && !space(*p) && *p != '=') ++p;
+        if (p == end || *p != '=' || p == k) return false;
+        const char* v = ++p;
+        while (p < end && !space(*p)) ++p;
+        if (p == v) return false;
+        tokens.push_back({ k, size_t(v - 1 - k), v, size_t(p - v) });
+    }
+    return true;
+}
+
+std::string lineError(size_t line, const std::string& what)
+{
+    return "line " + std::to_string(line) + ": " + what;
+}
+
+std::string format(const Vec3& v)
+{
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%.17g,%.17g,%.17g", v.x, v.y, v.z);
+    return buf;
+}
+
+} // namespace
+
+// ------------------------------------------
+// Scenario
+// ------------------------------------------
+void Scenario::addDrone(const Vec3& p, double heading, uint32_t missionId, uint16_t airframe)
+{
+    positions.push_back(p);
+    yaw.push_back(heading);
+    missionIds.push_back(missionId);
+    airframeIds.push_back(airframe);
+}
+
+ScenarioView Scenario::view() const
+{
+    ScenarioView v;
+    v.drones = positions.size();
+    v.missionCount = missions.size();
+    v.airframeCount = airframes.size();
+    v.obstacleCount = obstacles.size();
+    v.missions = missions.data();
+    v.airframes = airframes.data();
+    v.obstacles = obstacles.data();
+    v.positions = positions.data();
+    v.yaw = yaw.data();
+    v.missionIds = missionIds.data();
+    v.airframeIds = airframeIds.data();
+    return v;
+}
+
+// ------------------------------------------
+// Text form
+// ------------------------------------------
+bool parseScenarioText(const std::string& text, Scenario& out, std::string& error)
+{
+    out = Scenario();
+    std::string word;
+    std::vector<Token> tokens;
+    size_t lineNo = 0;
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    // A drone may name mission / airframe 0 before any is defined: the
+    // defaults are added at the end
+    auto checkRefs = [&](uint32_t m, uint32_t a) -> bool
+    {
+        if (m >= std::max<size_t>(out.missions.size(), 1))
+        {
+            error = lineError(lineNo, "mission " + std::to_string(m) + " is not defined");
+            return false;
+        }
+        if (a >= std::max<size_t>(out.airframes.size(), 1) || a > UINT16_MAX)
+        {
+            error = lineError(lineNo, "airframe " + std::to_string(a) + " is not defined");
+            return false;
+        }
+        return true;
+    };
+
+    while (p < end)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+        if (!eol) eol = end;
+        const char* hash = static_cast<const char*>(std::memchr(p, '#', size_t(eol - p)));
+        const char* stop = hash ? hash : eol;
+        ++lineNo;
+        if (!tokenize(p, stop, word, tokens))
+        {
+            error = lineError(lineNo, "expected key=value");
+            return false;
+        }
+        p = eol + (eol < end);
+        if (word.empty()) continue;
+
+        auto bad = [&](const Token& t)
+        {
+            error = lineError(lineNo, "bad value for " + std::string(t.key, t.keyLen) + " in " + word);
+            return false;
+        };
+        auto unknown = [&](const Token& t)
+        {
+            error = lineError(lineNo, "unknown key " + std::string(t.key, t.keyLen) + " in " + word);
+            return false;
+        };
+
+        if (word == "airframe")
+        {
+            Airframe a;
+            for (const Token& t : tokens)
+            {
+                if (t.is("name"))
+                {
+                    if (t.valueLen >= sizeof(a.name)) return bad(t);
+                    std::memcpy(a.name, t.value, t.valueLen);
+                }
+                else if (t.is("motor_force")) { if (!parseNumbers(t, &a.maxMotorForce, 1) || a.maxMotorForce <= 0.0) return bad(t); }
+                else if (t.is("arm"))         { if (!parseNumbers(t, &a.armLength, 1) || a.armLength <= 0.0) return bad(t); }
+                else if (t.is("battery_wh"))  { if (!parseNumbers(t, &a.batteryWh, 1) || a.batteryWh <= 0.0) return bad(t); }
+                else return unknown(t);
+            }
+            if (out.airframes.size() > UINT16_MAX)
+            {
+                error = lineError(lineNo, "too many airframes");
+                return false;
+            }
+            out.airframes.push_back(a);
+        }
+        else if (word == "mission")
+        {
+            control::ControlConfig m;
+            for (const Token& t : tokens)
+            {
+                if (t.is("center"))         { if (!parseVec(t, m.center)) return bad(t); }
+                else if (t.is("radius"))    { if (!parseNumbers(t, &m.sphereRadius, 1) || m.sphereRadius <= 0.0) return bad(t); }
+                else if (t.is("wait"))      { if (!parseNumbers(t, &m.groundWait, 1) || m.groundWait < 0.0) return bad(t); }
+                else if (t.is("max_force")) { if (!parseNumbers(t, &m.maxForce, 1) || m.maxForce <= 0.0) return bad(t); }
+                else if (t.is("min_speed")) { if (!parseNumbers(t, &m.minSpeed, 1)) return bad(t); }
+                else if (t.is("max_speed")) { if (!parseNumbers(t, &m.maxSpeed, 1)) return bad(t); }
+                else return unknown(t);
+            }
+            out.missions.push_back(m);
+        }
+        else if (word == "box" || word == "sphere")
+        {
+            Obstacle o;
+            o.kind = word == "box" ? ObstacleKind::Box : ObstacleKind::Sphere;
+            bool gotA = false, gotB = false;
+            for (const Token& t : tokens)
+            {
+                if (o.kind == ObstacleKind::Box && t.is("lo"))             { if (!parseVec(t, o.a)) return bad(t); gotA = true; }
+                else if (o.kind == ObstacleKind::Box && t.is("hi"))        { if (!parseVec(t, o.b)) return bad(t); gotB = true; }
+                else if (o.kind == ObstacleKind::Sphere && t.is("center")) { if (!parseVec(t, o.a)) return bad(t); gotA = true; }
+                else if (o.kind == ObstacleKind::Sphere && t.is("radius"))
+                {
+                    if (!parseNumbers(t, &o.b.x, 1) || o.b.x <= 0.0) return bad(t);
+                    gotB = true;
+                }
+                else return unknown(t);
+            }
+            if (!gotA || !gotB)
+            {
+                error = lineError(lineNo, word == "box" ? "box needs lo and hi" : "sphere needs center and radius");
+                return false;
+            }
+            out.obstacles.push_back(o);
+        }
+        else if (word == "drone" || word == "grid")
+        {
+            Vec3 origin, step(1.0, 1.0, 0.0);
+            double heading = 0.0, count[2] = { 1.0, 1.0 };
+            uint32_t m = 0, a = 0;
+            const bool grid = word == "grid";
+            for (const Token& t : tokens)
+            {
+                if (t.is(grid ? "origin" : "pos")) { if (!parseVec(t, origin)) return bad(t); }
+                else if (t.is("yaw"))              { if (!parseNumbers(t, &heading, 1)) return bad(t); }
+                else if (t.is("mission"))          { if (!parseIndex(t, m)) return bad(t); }
+                else if (t.is("airframe"))         { if (!parseIndex(t, a)) return bad(t); }
+                else if (grid && t.is("step"))
+                {
+                    double d[2];
+                    if (!parseNumbers(t, d, 2)) return bad(t);
+                    step = Vec3(d[0], d[1], 0.0);
+                }
+                else if (grid && t.is("count"))
+                {
+                    if (!parseNumbers(t, count, 2) || count[0] < 0.0 || count[1] < 0.0
+                        || count[0] != std::floor(count[0]) || count[1] != std::floor(count[1])
+                        || count[0] * count[1] > 1e9)
+                        return bad(t);
+                }
+                else return unknown(t);
+            }
+            if (!checkRefs(m, a)) return false;
+            const size_t nx = static_cast<size_t>(count[0]), ny = static_cast<size_t>(count[1]);
+            for (size_t y = 0; y < ny; ++y)
+            {
+                for (size_t x = 0; x < nx; ++x)
+                {
+                    out.addDrone(origin + Vec3(step.x * x, step.y * y, 0.0), heading, m, static_cast<uint16_t>(a));
+                }
+            }
+        }
+        else
+        {
+            error = lineError(lineNo, "unknown record " + word);
+            return false;
+        }
+    }
+
+    if (out.missions.empty() && out.drones()) out.missions.emplace_back();
+    if (out.airframes.empty() && out.drones()) out.airframes.emplace_back();
+    return true;
+}
+
+bool loadScenarioText(const std::string& path, Scenario& out, std::string& error)
+{
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string text;
+    char buf[1 << 16];
+    size_t got;
+    while ((got = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, got);
+    const bool ok = !std::ferror(f);
+    std::fclose(f);
+    if (!ok)
+    {
+        error = "cannot read " + path;
+        return false;
+    }
+    return parseScenarioText(text, out, error);
+}
+
+bool saveScenarioText(const Scenario& s, const std::string& path)
+{
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "# %zu missions, %zu airframes, %zu obstacles, %zu drones\n",
+                 s.missions.size(), s.airframes.size(), s.obstacles.size(), s.drones());
+    for (const Airframe& a : s.airframes)
+    {
+        const std::string name(a.name, strnlen(a.name, sizeof(a.name)));
+        std::fprintf(f, "airframe%s%s motor_force=%.17g arm=%.17g battery_wh=%.17g\n",
+                     name.empty() ? "" : " name=", name.c_str(), a.maxMotorForce, a.armLength, a.batteryWh);
+    }
+    for (const control::ControlConfig& m : s.missions)
+    {
+        std::fprintf(f, "mission center=%s radius=%.17g wait=%.17g max_force=%.17g min_speed=%.17g max_speed=%.17g\n",
+                     format(m.center).c_str(), m.sphereRadius, m.groundWait, m.maxForce, m.minSpeed, m.maxSpeed);
+    }
+    for (const Obstacle& o : s.obstacles)
+    {
+        if (o.kind == ObstacleKind::Box)
+            std::fprintf(f, "box lo=%s hi=%s\n", format(o.a).c_str(), format(o.b).c_str());
+        else
+            std::fprintf(f, "sphere center=%s radius=%.17g\n", format(o.a).c_str(), o.b.x);
+    }
+    for (size_t i = 0; i < s.drones(); ++i)
+    {
+        std::fprintf(f, "drone pos=%s yaw=%.17g mission=%u airframe=%u\n", format(s.positions[i]).c_str(),
+                     s.yaw[i], s.missionIds[i], unsigned(s.airframeIds[i]));
+    }
+    const bool ok = !std::ferror(f);
+    return std::fclose(f) == 0 && ok;
+}
+
+// ------------------------------------------
+// Compiled form
+// ------------------------------------------
+bool saveScenarioBinary(const Scenario& s, const std::string& path)
+{
+    ScenarioHeader h;
+    h.drones = s.drones();
+    h.missions = static_cast<uint32_t>(s.missions.size());
+    h.airframes = static_cast<uint32_t>(s.airframes.size());
+    h.obstacles = static_cast<uint32_t>(s.obstacles.size());
+    const Layout L(h);
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    uint64_t at = 0;
+    const uint64_t n = h.drones;
+    bool ok = writeAt(f, at, 0, &h, sizeof(h))
+           && writeAt(f, at, L.missions, s.missions.data(), s.missions.size() * sizeof(control::ControlConfig))
+           && writeAt(f, at, L.airframes, s.airframes.data(), s.airframes.size() * sizeof(Airframe))
+           && writeAt(f, at, L.obstacles, s.obstacles.data(), s.obstacles.size() * sizeof(Obstacle))
+           && writeAt(f, at, L.positions, s.positions.data(), n * sizeof(Vec3))
+           && writeAt(f, at, L.yaw, s.yaw.data(), n * sizeof(double))
+           && writeAt(f, at, L.missionIds, s.missionIds.data(), n * sizeof(uint32_t))
+           && writeAt(f, at, L.airframeIds, s.airframeIds.data(), n * sizeof(uint16_t));
+    ok = std::fclose(f) == 0 && ok;
+    return ok;
+}
+
+bool ScenarioFile::open(const std::string& path)
+{
+    close();
+#ifdef _WIN32
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    contents.resize(static_cast<size_t>(_ftelli64(f)));
+    std::fseek(f, 0, SEEK_SET);
+    size_t got = std::fread(contents.data(), 1, contents.size(), f);
+    std::fclose(f);
+    if (got != contents.size() || got < sizeof(hdr))
+    {
+        contents.clear();
+        return false;
+    }
+    base = contents.data();
+    bytes = contents.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(hdr))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base = static_cast<const unsigned char*>(p);
+    bytes = static_cast<size_t>(st.st_size);
+#ifdef MADV_SEQUENTIAL
+    ::madvise(p, bytes, MADV_SEQUENTIAL);   // read once, front to back
+#endif
+#endif
+
+    std::memcpy(&hdr, base, sizeof(hdr));
+    const Layout L(hdr);
+    bool ok = std::memcmp(hdr.magic, "USCN", 4) == 0 && hdr.version == 1
+           && hdr.drones < (uint64_t(1) << 40) && L.end <= bytes
+           && (hdr.drones == 0 || (hdr.missions > 0 && hdr.airframes > 0));
+    if (ok)
+    {
+        arrays.drones = static_cast<size_t>(hdr.drones);
+        arrays.missionCount = hdr.missions;
+        arrays.airframeCount = hdr.airframes;
+        arrays.obstacleCount = hdr.obstacles;
+        arrays.missions = reinterpret_cast<const control::ControlConfig*>(base + L.missions);
+        arrays.airframes = reinterpret_cast<const Airframe*>(base + L.airframes);
+        arrays.obstacles = reinterpret_cast<const Obstacle*>(base + L.obstacles);
+        arrays.positions = reinterpret_cast<const Vec3*>(base + L.positions);
+        arrays.yaw = reinterpret_cast<const double*>(base + L.yaw);
+        arrays.missionIds = reinterpret_cast<const uint32_t*>(base + L.missionIds);
+        arrays.airframeIds = reinterpret_cast<const uint16_t*>(base + L.airframeIds);
+
+        // Ids are the only thing the engine would index with blindly
+        uint32_t maxMission = 0;
+        uint16_t maxAirframe = 0;
+        for (size_t i = 0; i < arrays.drones; ++i)
+        {
+            maxMission = std::max(maxMission, arrays.missionIds[i]);
+            maxAirframe = std::max(maxAirframe, arrays.airframeIds[i]);
+        }
+        for (size_t k = 0; k < arrays.obstacleCount; ++k)
+        {
+            ok = ok && (arrays.obstacles[k].kind == ObstacleKind::Box || arrays.obstacles[k].kind == ObstacleKind::Sphere);
+        }
+        ok = ok && (arrays.drones == 0 || (maxMission < hdr.missions && maxAirframe < hdr.airframes));
+    }
+    if (!ok) close();
+    return ok;
+}
+
+void ScenarioFile::close()
+{
+#ifndef _WIN32
+    if (base && contents.empty()) ::munmap(const_cast<unsigned char*>(base), bytes);
+#endif
+    base = nullptr;
+    bytes = 0;
+    contents.clear();
+    contents.shrink_to_fit();
+    arrays = ScenarioView();
+}
+
+bool openScenario(const std::string& path, ScenarioFile& file, Scenario& storage,
+                  ScenarioView& view, std::string& error)
+{
+    char magic[4] = {};
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    const size_t got = std::fread(magic, 1, sizeof(magic), f);
+    std::fclose(f);
+
+    if (got == sizeof(magic) && std::memcmp(magic, "USCN", 4) == 0)
+    {
+        if (!file.open(path))
+        {
+            error = path + " is not a valid compiled scenario";
+            return false;
+        }
+        view = file.view();
+        return true;
+    }
+    MemScope tag(Subsystem::AssetIO);
+    if (!loadScenarioText(path, storage, error)) return false;
+    view = storage.view();
+    return true;
+}
+
+} // namespace sim
@@ -0,0 +1,194 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Scenario files: drones (spawn pose, airframe, mission), missions and
+    obstacles. The text form is for people; the compiled form is laid out
+    like the engine's arrays and is memory-mapped, so loading it is one
+    bulk copy per array instead of a parse.
+*/
+
+#pragma once
+#include "control.h"
+#include "planner.h"
+#include "swarm.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// Airframe profile. The engine flies one airframe per swarm, so these
+// are applied through SwarmConfig (see ScenarioView::configure).
+struct Airframe
+{
+    char   name[32]      = {};
+    double maxMotorForce = QuadrotorParams().maxMotorForce;   // N per motor
+    double armLength     = QuadrotorParams().armLength;       // m
+    double batteryWh     = BatteryParams().capacityWh;
+    double reserved      = 0.0;
+};
+static_assert(sizeof(Airframe) == 64, "airframe record must stay 64 bytes");
+
+enum class ObstacleKind : uint32_t
+{
+    Box,      // a = lo corner, b = hi corner
+    Sphere    // a = center, b.x = radius
+};
+
+struct Obstacle
+{
+    ObstacleKind  kind = ObstacleKind::Box;
+    uint32_t      pad  = 0;
+    control::Vec3 a, b;
+    double        reserved = 0.0;
+};
+static_assert(sizeof(Obstacle) == 64, "obstacle record must stay 64 bytes");
+static_assert(sizeof(control::ControlConfig) == 64, "mission record must stay 64 bytes");
+
+// File layout (little endian), every section starting on a 64-byte
+// boundary:
+//   header      64 bytes, see ScenarioHeader
+//   missions    missions x control::ControlConfig (64 bytes)
+//   airframes   airframes x Airframe
+//   obstacles   obstacles x Obstacle
+//   positions   drones x 3 float64, the engine's Vec3 layout
+//   yaw         drones x float64, rad
+//   mission ids drones x uint32
+//   airframe ids drones x uint16
+struct ScenarioHeader
+{
+    char     magic[4]  = { 'U', 'S', 'C', 'N' };
+    uint32_t version   = 1;
+    uint64_t drones    = 0;
+    uint32_t missions  = 0;
+    uint32_t airframes = 0;
+    uint32_t obstacles = 0;
+    uint8_t  reserved[36] = {};
+};
+static_assert(sizeof(ScenarioHeader) == 64, "scenario header must stay 64 bytes");
+
+// Non-owning view over one scenario's arrays: into a Scenario's vectors
+// or straight into a mapped file
+struct ScenarioView
+{
+    size_t drones = 0, missionCount = 0, airframeCount = 0, obstacleCount = 0;
+    const control::ControlConfig* missions  = nullptr;
+    const Airframe*               airframes = nullptr;
+    const Obstacle*               obstacles = nullptr;
+    const control::Vec3*          positions = nullptr;
+    const double*                 yaw       = nullptr;
+    const uint32_t*               missionIds  = nullptr;
+    const uint16_t*               airframeIds = nullptr;
+
+    // Inline so the threaded simulator can read scenarios without
+    // linking the swarm engine
+
+    // Airframe 0 (the default one if the scenario names none) into cfg
+    void configure(SwarmConfig& cfg) const
+    {
+        const Airframe a = airframeCount ? airframes[0] : Airframe();
+        cfg.quad.maxMotorForce = a.maxMotorForce;
+        cfg.quad.armLength = a.armLength;
+        cfg.battery.capacityWh = a.batteryWh;
+    }
+
+    // Missions and drones into the swarm, mission ids offset past the
+    // swarm's existing missions. Returns the index of the first drone.
+    size_t loadInto(Swarm& swarm) const
+    {
+        const size_t first = swarm.size();
+        uint32_t firstMission = 0;
+        for (size_t m = 0; m < missionCount; ++m)
+        {
+            const uint32_t id = swarm.addMission(missions[m]);
+            if (m == 0) firstMission = id;
+        }
+        swarm.addDrones(positions, missionIds, drones, firstMission, yaw);
+        return first;
+    }
+
+    // Obstacles as blocked voxels, for Swarm::planClimbs
+    void addObstacles(VoxelMap& map) const
+    {
+        for (size_t k = 0; k < obstacleCount; ++k)
+        {
+            const Obstacle& o = obstacles[k];
+            if (o.kind == ObstacleKind::Box) map.addBox(o.a, o.b);
+            else                             map.addSphere(o.a, o.b.x);
+        }
+    }
+};
+
+// Scenario held in vectors: what the text parser builds and the
+// compiler writes
+struct Scenario
+{
+    std::vector<control::ControlConfig> missions;
+    std::vector<Airframe>               airframes;
+    std::vector<Obstacle>               obstacles;
+    std::vector<control::Vec3>          positions;
+    std::vector<double>                 yaw;
+    std::vector<uint32_t>               missionIds;
+    std::vector<uint16_t>               airframeIds;
+
+    size_t drones() const { return positions.size(); }
+    void addDrone(const control::Vec3& p, double heading = 0.0, uint32_t mission = 0,
+                  uint16_t airframe = 0);
+    ScenarioView view() const;
+};
+
+// Text form, one record per line, '#' starts a comment. Missions and
+// airframes are numbered in the order they appear.
+//   airframe name=quad250 motor_force=8 arm=0.1 battery_wh=22
+//   mission center=0,0,50 radius=10 wait=5 max_force=20 min_speed=2 max_speed=10
+//   box lo=-5,-5,0 hi=5,5,30
+//   sphere center=0,20,20 radius=4
+//   drone pos=-46,-22.5,0 yaw=0 mission=0 airframe=0
+//   grid origin=-46,-22.5,0 step=22,22.5 count=5,3 yaw=0 mission=0 airframe=0
+// Every key is optional and defaults as in the structs above; grid adds
+// count.x * count.y drones row by row. Returns false with `error` set to
+// "line N: ..." on the first bad line or reference.
+bool parseScenarioText(const std::string& text, Scenario& out, std::string& error);
+bool loadScenarioText(const std::string& path, Scenario& out, std::string& error);
+bool saveScenarioText(const Scenario& s, const std::string& path);
+
+// Compiled form
+bool saveScenarioBinary(const Scenario& s, const std::string& path);
+
+// Read-only mapping of a compiled scenario; view() points into it and is
+// valid until close()
+class ScenarioFile
+{
+public:
+    ScenarioFile() = default;
+    ~ScenarioFile() { close(); }
+    ScenarioFile(const ScenarioFile&) = delete;
+    ScenarioFile& operator=(const ScenarioFile&) = delete;
+
+    // Checks the header, the section sizes and every mission / airframe
+    // reference before handing out the view
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    const ScenarioHeader& header() const { return hdr; }
+    const ScenarioView& view() const { return arrays; }
+    size_t fileBytes() const { return bytes; }
+
+private:
+    ScenarioHeader hdr;
+    ScenarioView arrays;
+    const unsigned char* base = nullptr;
+    size_t bytes = 0;
+    std::vector<unsigned char> contents;  // _WIN32: the whole file
+};
+
+// Compiled if `path` starts with the binary magic, text otherwise; the
+// text form is parsed into `storage`. The view is valid while `file`
+// and `storage` are.
+bool openScenario(const std::string& path, ScenarioFile& file, Scenario& storage,
+                  ScenarioView& view, std::string& error);
+
+} // namespace sim
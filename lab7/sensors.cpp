@@ -0,0 +1,205 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the simulated sensor suite.
+*/
+
+#include "sensors.h"
+#include "quadrotor.h"
+#include "rng.h"
+#include <algorithm>
+
+namespace sim
+{
+
+using control::Vec3;
+
+namespace
+{
+
+// RNG channels: the third counter word, so each sensor draws its own stream
+enum Channel : uint32_t
+{
+    ChAccel = 0, ChGyro, ChGpsPos, ChGpsVel, ChBaro, ChBias
+};
+
+// Four standard normals for (drone, tick, channel)
+struct Normals4
+{
+    double n[4];
+    Normals4(uint32_t drone, uint32_t seed, uint64_t tick, uint32_t channel)
+    {
+        Philox4x32 r(drone, seed, static_cast<uint32_t>(tick),
+                     static_cast<uint32_t>(tick >> 32), channel, 0);
+        normalPair(r.v[0], r.v[1], n[0], n[1]);
+        normalPair(r.v[2], r.v[3], n[2], n[3]);
+    }
+};
+
+// The kernels below take restrict pointers and contain no branches, so
+// the Philox rounds and the Box-Muller transform vectorise across drones.
+
+void imuKernel(size_t begin, size_t end, uint64_t tick, uint32_t seed,
+               double gravity, double sa, const Vec3* __restrict acc,
+               const double* __restrict bax, const double* __restrict bay,
+               const double* __restrict baz,
+               double* __restrict ox, double* __restrict oy, double* __restrict oz)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        Normals4 w(static_cast<uint32_t>(i), seed, tick, ChAccel);
+
+        // Specific force: what moved the drone, minus gravity
+        ox[i] = acc[i].x + bax[i] + sa * w.n[0];
+        oy[i] = acc[i].y + bay[i] + sa * w.n[1];
+        oz[i] = acc[i].z + gravity + baz[i] + sa * w.n[2];
+    }
+}
+
+void gyroKernel(size_t begin, size_t end, uint64_t tick, uint32_t seed, double sg,
+                const double* __restrict rx, const double* __restrict ry,
+                const double* __restrict rz,
+                const double* __restrict bgx, const double* __restrict bgy,
+                const double* __restrict bgz,
+                double* __restrict ox, double* __restrict oy, double* __restrict oz)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        Normals4 w(static_cast<uint32_t>(i), seed, tick, ChGyro);
+        ox[i] = rx[i] + bgx[i] + sg * w.n[0];
+        oy[i] = ry[i] + bgy[i] + sg * w.n[1];
+        oz[i] = rz[i] + bgz[i] + sg * w.n[2];
+    }
+}
+
+void vec3Kernel(size_t begin, size_t end, uint64_t tick, uint32_t seed,
+                uint32_t channel, double sigma, const Vec3* __restrict v,
+                double* __restrict ox, double* __restrict oy, double* __restrict oz)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        Normals4 w(static_cast<uint32_t>(i), seed, tick, channel);
+        ox[i] = v[i].x + sigma * w.n[0];
+        oy[i] = v[i].y + sigma * w.n[1];
+        oz[i] = v[i].z + sigma * w.n[2];
+    }
+}
+
+void baroKernel(size_t begin, size_t end, uint64_t tick, uint32_t seed, double sigma,
+                const Vec3* __restrict pos, const double* __restrict bias,
+                double* __restrict oz)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        Normals4 w(static_cast<uint32_t>(i), seed, tick, ChBaro);
+        oz[i] = pos[i].z + bias[i] + sigma * w.n[0];
+    }
+}
+
+} // namespace
+
+void SensorSuite::initRing(Ring& r, int comps, int period, int delay, size_t n)
+{
+    // Enough slots to hold every measurement still in flight
+    r.depth = std::max(1, delay / std::max(1, period) + 1);
+    r.comp.assign(comps, std::vector<double>(r.depth * n, 0.0));
+}
+
+void SensorSuite::configure(const SensorConfig& c, size_t drones)
+{
+    cfg = c;
+    cfg.gpsPeriod  = std::max(1, cfg.gpsPeriod);
+    cfg.baroPeriod = std::max(1, cfg.baroPeriod);
+    n = drones;
+
+    for (auto* v : { &imuAx, &imuAy, &imuAz, &gyroX, &gyroY, &gyroZ,
+                     &gpsX, &gpsY, &gpsZ, &gpsVx, &gpsVy, &gpsVz, &baroZ, &zeros })
+    {
+        v->assign(n, 0.0);
+    }
+
+    // Fixed biases: drawn once per drone from a reserved tick
+    for (auto* v : { &biasAx, &biasAy, &biasAz, &biasGx, &biasGy, &biasGz, &biasBaro })
+    {
+        v->resize(n);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        Normals4 a(static_cast<uint32_t>(i), cfg.seed, ~0ull, ChBias);
+        Normals4 b(static_cast<uint32_t>(i), cfg.seed, ~0ull - 1, ChBias);
+        biasAx[i]   = cfg.accelBias * a.n[0];
+        biasAy[i]   = cfg.accelBias * a.n[1];
+        biasAz[i]   = cfg.accelBias * a.n[2];
+        biasGx[i]   = cfg.gyroBias  * b.n[0];
+        biasGy[i]   = cfg.gyroBias  * b.n[1];
+        biasGz[i]   = cfg.gyroBias  * b.n[2];
+        biasBaro[i] = cfg.baroBias  * a.n[3];
+    }
+
+    initRing(imuRing, 6, 1, cfg.imuDelay, n);
+    initRing(gpsRing, 6, cfg.gpsPeriod, cfg.gpsDelay, n);
+    initRing(baroRing, 1, cfg.baroPeriod, cfg.baroDelay, n);
+}
+
+void SensorSuite::deliver(Ring& r, std::vector<double>* out[], int comps,
+                          uint64_t measurement, size_t begin, size_t end, size_t n)
+{
+    for (int c = 0; c < comps; ++c)
+    {
+        const double* src = r.slot(c, measurement, n);
+        std::copy(src + begin, src + end, out[c]->data() + begin);
+    }
+}
+
+void SensorSuite::sample(size_t begin, size_t end, uint64_t tick, double gravity,
+                         const Vec3* pos, const Vec3* vel, const Vec3* acc,
+                         const QuadrotorBatch* quad)
+{
+    // IMU: every tick
+    imuKernel(begin, end, tick, cfg.seed, gravity, cfg.accelNoise, acc,
+              biasAx.data(), biasAy.data(), biasAz.data(),
+              imuRing.slot(0, tick, n), imuRing.slot(1, tick, n), imuRing.slot(2, tick, n));
+    gyroKernel(begin, end, tick, cfg.seed, cfg.gyroNoise,
+               quad ? quad->wx.data() : zeros.data(),
+               quad ? quad->wy.data() : zeros.data(),
+               quad ? quad->wz.data() : zeros.data(),
+               biasGx.data(), biasGy.data(), biasGz.data(),
+               imuRing.slot(3, tick, n), imuRing.slot(4, tick, n), imuRing.slot(5, tick, n));
+
+    if (tick % cfg.gpsPeriod == 0)
+    {
+        uint64_t m = tick / cfg.gpsPeriod;
+        vec3Kernel(begin, end, tick, cfg.seed, ChGpsPos, cfg.gpsNoise, pos,
+                   gpsRing.slot(0, m, n), gpsRing.slot(1, m, n), gpsRing.slot(2, m, n));
+        vec3Kernel(begin, end, tick, cfg.seed, ChGpsVel, cfg.gpsVelNoise, vel,
+                   gpsRing.slot(3, m, n), gpsRing.slot(4, m, n), gpsRing.slot(5, m, n));
+    }
+
+    if (tick % cfg.baroPeriod == 0)
+    {
+        uint64_t m = tick / cfg.baroPeriod;
+        baroKernel(begin, end, tick, cfg.seed, cfg.baroNoise, pos, biasBaro.data(),
+                   baroRing.slot(0, m, n));
+    }
+
+    // Deliver measurements whose latency has elapsed
+    if (imuDue(tick))
+    {
+        std::vector<double>* out[] = { &imuAx, &imuAy, &imuAz, &gyroX, &gyroY, &gyroZ };
+        deliver(imuRing, out, 6, tick - cfg.imuDelay, begin, end, n);
+    }
+    if (gpsDue(tick))
+    {
+        std::vector<double>* out[] = { &gpsX, &gpsY, &gpsZ, &gpsVx, &gpsVy, &gpsVz };
+        deliver(gpsRing, out, 6, (tick - cfg.gpsDelay) / cfg.gpsPeriod, begin, end, n);
+    }
+    if (baroDue(tick))
+    {
+        std::vector<double>* out[] = { &baroZ };
+        deliver(baroRing, out, 1, (tick - cfg.baroDelay) / cfg.baroPeriod, begin, end, n);
+    }
+}
+
+} // namespace sim
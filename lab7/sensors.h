@@ -0,0 +1,102 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Simulated IMU, GPS and barometer for the whole swarm. Noise comes from
+    the counter-based RNG keyed by drone id and tick, so readings are
+    deterministic whatever the thread count.
+*/
+
+#pragma once
+#include "control.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+class QuadrotorBatch;
+
+struct SensorConfig
+{
+    uint32_t seed = 1;
+
+    // IMU: specific force in the world frame (attitude assumed known) and
+    // body rates. Sampled every tick.
+    double accelNoise = 0.05;   // m/s^2, white noise sigma
+    double accelBias  = 0.02;   // m/s^2, sigma of each drone's fixed bias
+    double gyroNoise  = 0.002;  // rad/s
+    double gyroBias   = 0.001;  // rad/s
+    int    imuDelay   = 0;      // ticks from measurement to delivery
+
+    // GPS position / velocity fixes
+    double gpsNoise    = 0.5;   // m
+    double gpsVelNoise = 0.1;   // m/s
+    int    gpsPeriod   = 10;    // ticks between fixes (10 Hz at dt = 0.01)
+    int    gpsDelay    = 10;
+
+    // Barometric altitude
+    double baroNoise  = 0.1;    // m
+    double baroBias   = 0.5;    // m, sigma of each drone's fixed offset
+    int    baroPeriod = 2;
+    int    baroDelay  = 2;
+};
+
+class SensorSuite
+{
+public:
+    void configure(const SensorConfig& cfg, size_t drones);
+
+    // Measure drones [begin, end) from the true state at `tick` and publish
+    // whatever becomes due at this tick. Disjoint ranges may run in
+    // parallel. `quad` supplies body rates (nullptr -> gyro reads bias
+    // and noise only).
+    void sample(size_t begin, size_t end, uint64_t tick, double gravity,
+                const control::Vec3* pos, const control::Vec3* vel,
+                const control::Vec3* acc, const QuadrotorBatch* quad);
+
+    // Which channels delivered a new reading at `tick`
+    bool imuDue(uint64_t tick)  const { return due(tick, 1, cfg.imuDelay); }
+    bool gpsDue(uint64_t tick)  const { return due(tick, cfg.gpsPeriod, cfg.gpsDelay); }
+    bool baroDue(uint64_t tick) const { return due(tick, cfg.baroPeriod, cfg.baroDelay); }
+
+    const SensorConfig& config() const { return cfg; }
+
+    // Latest delivered readings, one array per component
+    std::vector<double> imuAx, imuAy, imuAz;
+    std::vector<double> gyroX, gyroY, gyroZ;
+    std::vector<double> gpsX, gpsY, gpsZ, gpsVx, gpsVy, gpsVz;
+    std::vector<double> baroZ;
+
+private:
+    // Readings waiting out their latency: `depth` slots of n drones
+    struct Ring
+    {
+        int depth = 1;
+        std::vector<std::vector<double>> comp;   // per component, depth * n
+        double* slot(int c, uint64_t measurement, size_t n)
+        {
+            return comp[c].data() + (measurement % depth) * n;
+        }
+    };
+
+    static bool due(uint64_t tick, int period, int delay)
+    {
+        return tick >= static_cast<uint64_t>(delay) && (tick - delay) % period == 0;
+    }
+    static void initRing(Ring& r, int comps, int period, int delay, size_t n);
+    static void deliver(Ring& r, std::vector<double>* out[], int comps,
+                        uint64_t measurement, size_t begin, size_t end, size_t n);
+
+    SensorConfig cfg;
+    size_t n = 0;
+
+    // Fixed per-drone biases
+    std::vector<double> biasAx, biasAy, biasAz, biasGx, biasGy, biasGz, biasBaro;
+    std::vector<double> zeros;  // body rates for point-mass drones
+
+    Ring imuRing, gpsRing, baroRing;
+};
+
+} // namespace sim
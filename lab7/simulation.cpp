@@ -7,6 +7,7 @@ Description:
 */
 
 #include "simulation.h"
+#include "memtrack.h"
 #include <chrono>
 #include <cmath>
 
@@ -20,10 +21,8 @@ UAV::UAV(const Vec3& startPos, const control::ControlConfig& cfg_)
     : position(startPos),
       velocity(0,0,0),
       acceleration(0,0,0),
-      cfg(cfg_) {
-    // Default PID gains
-    pids.radialPID = control::PIDController(5, 1.0, 0.5, 100.0, 20.0);
-    pids.speedPID  = control::PIDController(0.8, 0.0, 10.0, 100.0, 10.0);
+      cfg(cfg_),
+      pids(control::defaultPIDs()) {
 }
 
 UAV::~UAV() 
@@ -34,6 +33,7 @@ UAV::~UAV()
 void UAV::start() {
     if (running.load()) return;
     running = true;
+    MemScope tag(Subsystem::Physics);
     worker = std::thread(&UAV::threadFunc, this);
 }
 
@@ -69,6 +69,20 @@ UAV::Snapshot UAV::getSnapshot() const
     return { position, velocity, acceleration };
 }
 
+UAV::Status UAV::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    Status s;
+    s.state = { position, velocity, acceleration };
+    s.phase = ctrlState.phase;
+    s.timeInPhase = ctrlState.timeInPhase;
+    s.radialIntegral = pids.radialPID.getIntegral();
+    s.radialError = pids.radialPID.getPrevError();
+    s.speedIntegral = pids.speedPID.getIntegral();
+    s.speedError = pids.speedPID.getPrevError();
+    return s;
+}
+
 void UAV::setVelocity(const Vec3& v) 
 {
     std::lock_guard<std::mutex> lock(mtx);
@@ -77,50 +91,39 @@ void UAV::setVelocity(const Vec3& v)
 
 void UAV::threadFunc() {
     const double dt = 0.01; // 10 ms
+    sim::Profiler::instance().registerThread(sim::Subsystem::Physics);
 
     while (running.load()) {
         // 1) Read current state (no long lock)
         control::Vec3 pos, vel;
+        control::ControlState state;
+        control::ControlPIDs  ctl;
         {
             std::lock_guard<std::mutex> lock(mtx);
             pos = position;
             vel = velocity;
+            state = ctrlState;
+            ctl = pids;
         }
 
         // 2) Control: compute motor force
         control::Vec3 motorForce = control::computeControlForce(
-            pos, vel, ctrlState, pids, cfg, dt
+            pos, vel, state, ctl, cfg, dt
         );
 
-        // 3) Physics: F = ma + gravity
-        control::Vec3 accel = motorForce / mass + control::Vec3(0, 0, -g);
-
-        // 4) Integrate using local copies
-        vel += accel * dt;
-        pos += vel * dt;
-
-        // Ground contact
-        if (pos.z < 0.0) {
-            pos.z = 0.0;
-            if (vel.z < 0.0) vel.z = 0.0;
-        }
+        // 3) Physics: F = ma + gravity, integrate local copies
+        control::Vec3 accel = integratePointMass(
+            pos, vel, motorForce, state.phase, dt
+        );
 
-        // 5) Write back & enforce climb-phase speed limit
+        // 4) Write back
         {
             std::lock_guard<std::mutex> lock(mtx);
-
-            // Limit speed to 2 m/s only during ClimbToCenter
-            if (ctrlState.phase == control::Phase::ClimbToCenter) {
-                double speed = vel.mag();
-                const double maxClimbSpeed = 2.0;
-                if (speed > maxClimbSpeed && speed > 1e-6) {
-                    vel = vel * (maxClimbSpeed / speed);
-                }
-            }
-
             position = pos;
             velocity = vel;
             acceleration = accel;
+            ctrlState = state;
+            pids = ctl;
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -133,6 +136,7 @@ void checkAndResolveCollisions(std::vector<std::unique_ptr<UAV>>& uavs,
 {
     const size_t n = uavs.size();
     if (n < 2) return;
+    MemScope tag(Subsystem::Collision);
 
     // take snapshot
     std::vector<UAV::Snapshot> snaps;
@@ -18,6 +18,51 @@ namespace sim {
 
 constexpr double g = 10.0;  // m/s^2
 constexpr double mass = 1.0;
+constexpr double maxClimbSpeed = 2.0;  // m/s, enforced during ClimbToCenter and ReturnHome
+
+// Integrate one step from a known acceleration: semi-implicit Euler,
+// climb-phase speed limit and ground contact. The speed limit is applied
+// before the position update so the climb path does not depend on dt.
+// Templated on the scalar like the control law (see control.h).
+template <typename T>
+inline void integrateAccel(control::Vec3T<T>& pos,
+                           control::Vec3T<T>& vel,
+                           const control::Vec3T<T>& accel,
+                           control::Phase phase,
+                           double dt)
+{
+    vel += accel * dt;
+
+    // Limit speed to 2 m/s only during ClimbToCenter (and the return leg)
+    if (phase == control::Phase::ClimbToCenter || phase == control::Phase::ReturnHome) {
+        T speed = vel.mag();
+        if (speed > maxClimbSpeed && speed > 1e-6) {
+            vel = vel * (maxClimbSpeed / speed);
+        }
+    }
+
+    pos += vel * dt;
+
+    // Ground contact
+    if (pos.z < 0.0) {
+        pos.z = 0.0;
+        if (vel.z < 0.0) vel.z = 0.0;
+    }
+}
+
+// Point-mass physics step shared by the threaded UAV and the batched swarm:
+// F = ma + gravity. Returns the commanded acceleration.
+template <typename T>
+inline control::Vec3T<T> integratePointMass(control::Vec3T<T>& pos,
+                                            control::Vec3T<T>& vel,
+                                            const control::Vec3T<T>& motorForce,
+                                            control::Phase phase,
+                                            double dt)
+{
+    control::Vec3T<T> accel = motorForce / mass + control::Vec3T<T>(0, 0, -g);
+    integrateAccel(pos, vel, accel, phase, dt);
+    return accel;
+}
 
 class UAV 
 {
@@ -44,6 +89,18 @@ public:
     Snapshot getSnapshot() const;
     void setVelocity(const control::Vec3& v);
 
+    // Controller state for display (phase and PID internals)
+    struct Status
+    {
+        Snapshot       state;
+        control::Phase phase;
+        double         timeInPhase;
+        double         radialIntegral, radialError;
+        double         speedIntegral, speedError;
+    };
+
+    Status getStatus() const;
+
 private:
     void threadFunc();
 
@@ -53,7 +110,7 @@ private:
     control::Vec3 acceleration;
 
     control::ControlConfig cfg;
-    control::ControlState  ctrlState;
+    control::ControlState  ctrlState;   // guarded by mtx together with the state
     control::ControlPIDs   pids;
     // For printing/debug: remember last printed phase and a small timer
     control::Phase lastPrintedPhase = control::Phase::GroundWait;
@@ -0,0 +1,175 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the compact snapshot encoding.
+*/
+
+#include "snapshot_codec.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+using control::Vec3;
+
+namespace
+{
+
+inline double clampd(double v, double a, double b)
+{
+    return v < a ? a : (v > b ? b : v);
+}
+
+// NaN and infinities become `fallback` (the encoder flags them), so
+// nothing non-finite reaches an integer conversion
+inline double finiteOr(double v, double fallback)
+{
+    return v - v == 0.0 ? v : fallback;
+}
+
+inline double signNotZero(double v)
+{
+    return v >= 0.0 ? 1.0 : -1.0;
+}
+
+// Round-to-nearest for values already clamped to the target range
+inline int32_t roundSigned(double v)
+{
+    return static_cast<int32_t>(v + (v >= 0.0 ? 0.5 : -0.5));
+}
+
+} // namespace
+
+SnapshotCodec::SnapshotCodec(const Vec3& lo_, const Vec3& hi_, double maxSpeed)
+    : lo(lo_), hi(hi_), vmax(maxSpeed > 0.0 ? maxSpeed : 1.0)
+{
+    const double span[3] = { hi.x - lo.x, hi.y - lo.y, hi.z - lo.z };
+    for (int a = 0; a < 3; ++a)
+    {
+        const double s = span[a] > 0.0 ? span[a] : 1.0;
+        scale[a] = kPosMax / s;
+        step[a]  = s / kPosMax;
+    }
+}
+
+Vec3 SnapshotCodec::positionStep() const
+{
+    return Vec3(0.5 * step[0], 0.5 * step[1], 0.5 * step[2]);
+}
+
+void SnapshotCodec::encode(size_t n, const Vec3* pos, const Vec3* vel,
+                           const uint8_t* phase, PackedDrone* out) const
+{
+    const double qmax = kPosMax;
+    const double lx = lo.x, ly = lo.y, lz = lo.z;
+    const double sx = scale[0], sy = scale[1], sz = scale[2];
+    const double speedScale = 65535.0 / vmax;
+
+    // Quantise a block into uniform 32-bit lanes first (the vectorised
+    // part), then pack the mixed-width fields
+    constexpr size_t kBlock = 256;
+    int32_t qx[kBlock], qy[kBlock], qz[kBlock], qu[kBlock], qv[kBlock], qs[kBlock], fl[kBlock];
+
+    for (size_t b = 0; b < n; b += kBlock)
+    {
+        const size_t m = std::min(kBlock, n - b);
+        const Vec3* P = pos + b;
+        const Vec3* V = vel + b;
+
+        #pragma omp simd
+        for (size_t i = 0; i < m; ++i)
+        {
+            // Position: offset from the lower bound in fixed-point counts;
+            // a non-finite axis encodes as the lower bound
+            const double fx = (P[i].x - lx) * sx;
+            const double fy = (P[i].y - ly) * sy;
+            const double fz = (P[i].z - lz) * sz;
+            const double cx = clampd(finiteOr(fx, 0.0), 0.0, qmax);
+            const double cy = clampd(finiteOr(fy, 0.0), 0.0, qmax);
+            const double cz = clampd(finiteOr(fz, 0.0), 0.0, qmax);
+            qx[i] = static_cast<int32_t>(cx + 0.5);
+            qy[i] = static_cast<int32_t>(cy + 0.5);
+            qz[i] = static_cast<int32_t>(cz + 0.5);
+
+            // Velocity: direction on the octahedron, then the magnitude;
+            // a non-finite component encodes as zero
+            const double vx = finiteOr(V[i].x, 0.0), vy = finiteOr(V[i].y, 0.0),
+                         vz = finiteOr(V[i].z, 0.0);
+            const double speed = std::sqrt(vx * vx + vy * vy + vz * vz);
+            const double l1 = std::fabs(vx) + std::fabs(vy) + std::fabs(vz);
+            const double inv = l1 > 0.0 ? 1.0 / l1 : 0.0;
+            const double u = vx * inv, v = vy * inv;
+            const double fu = vz >= 0.0 ? u : (1.0 - std::fabs(v)) * signNotZero(u);
+            const double fv = vz >= 0.0 ? v : (1.0 - std::fabs(u)) * signNotZero(v);
+            const double s = speed * speedScale;
+            qu[i] = roundSigned(clampd(fu, -1.0, 1.0) * 32767.0);
+            qv[i] = roundSigned(clampd(fv, -1.0, 1.0) * 32767.0);
+            qs[i] = static_cast<int32_t>(std::min(s, 65535.0) + 0.5);
+            fl[i] = (cx != fx) | (cy != fy) | (cz != fz) | (s > 65535.0) |
+                    (vx != V[i].x) | (vy != V[i].y) | (vz != V[i].z);
+        }
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            PackedDrone& p = out[b + i];
+            p.pos   = static_cast<uint64_t>(qx[i]) | (static_cast<uint64_t>(qy[i]) << 21) |
+                      (static_cast<uint64_t>(qz[i]) << 42);
+            p.octU  = static_cast<int16_t>(qu[i]);
+            p.octV  = static_cast<int16_t>(qv[i]);
+            p.speed = static_cast<uint16_t>(qs[i]);
+            p.phase = phase ? phase[b + i] : 0;
+            p.flags = static_cast<uint8_t>(fl[i] * PackedDrone::Clamped);
+        }
+    }
+}
+
+void SnapshotCodec::decodePositions(size_t n, const PackedDrone* in, Vec3* pos) const
+{
+    const uint64_t mask = kPosMax;
+    const double lx = lo.x, ly = lo.y, lz = lo.z;
+    const double dx = step[0], dy = step[1], dz = step[2];
+
+    #pragma omp simd
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t q = in[i].pos;
+        pos[i].x = lx + static_cast<int32_t>(q & mask) * dx;
+        pos[i].y = ly + static_cast<int32_t>((q >> 21) & mask) * dy;
+        pos[i].z = lz + static_cast<int32_t>((q >> 42) & mask) * dz;
+    }
+}
+
+void SnapshotCodec::decode(size_t n, const PackedDrone* in, Vec3* pos,
+                           Vec3* vel, uint8_t* phase) const
+{
+    if (pos) decodePositions(n, in, pos);
+    if (vel)
+    {
+        const double speedStep = vmax / 65535.0;
+
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+        {
+            double u = in[i].octU * (1.0 / 32767.0);
+            double v = in[i].octV * (1.0 / 32767.0);
+            const double z = 1.0 - std::fabs(u) - std::fabs(v);
+            const double t = z < 0.0 ? -z : 0.0;
+            u += u >= 0.0 ? -t : t;
+            v += v >= 0.0 ? -t : t;
+            const double len = std::sqrt(u * u + v * v + z * z);
+            const double k = len > 0.0 ? in[i].speed * speedStep / len : 0.0;
+            vel[i].x = u * k;
+            vel[i].y = v * k;
+            vel[i].z = z * k;
+        }
+    }
+    if (phase)
+    {
+        for (size_t i = 0; i < n; ++i) phase[i] = in[i].phase;
+    }
+}
+
+} // namespace sim
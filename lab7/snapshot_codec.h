@@ -0,0 +1,67 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Compact swarm snapshot encoding for the render handoff and telemetry:
+    16 bytes per drone instead of 72 for pos / vel / acc in doubles.
+*/
+
+#pragma once
+#include "control.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+// One drone's state as the render path and telemetry see it
+struct alignas(16) PackedDrone
+{
+    uint64_t pos;     // 21-bit fixed point per axis: x | y << 21 | z << 42
+    int16_t  octU;    // velocity direction, octahedral, snorm16
+    int16_t  octV;
+    uint16_t speed;   // |v| as a fraction of the codec's maxSpeed
+    uint8_t  phase;   // control::Phase
+    uint8_t  flags;   // PackedDrone::Clamped, ...
+
+    enum : uint8_t
+    {
+        Clamped = 1   // position or speed outside the codec's range, or not finite
+    };
+};
+static_assert(sizeof(PackedDrone) == 16, "PackedDrone must stay 16 bytes");
+
+// Fixed-point ranges for a snapshot stream. Both ends must agree on
+// them; the defaults cover the 120 x 53.3 m field up to 100 m altitude
+// (~0.06 mm position steps, ~0.5 mm/s speed steps).
+class SnapshotCodec
+{
+public:
+    static constexpr uint32_t kPosMax = (1u << 21) - 1;
+
+    SnapshotCodec(const control::Vec3& lo = control::Vec3(-60.0, -26.65, 0.0),
+                  const control::Vec3& hi = control::Vec3(60.0, 26.65, 100.0),
+                  double maxSpeed = 32.0);
+
+    const control::Vec3& boundsLo() const { return lo; }
+    const control::Vec3& boundsHi() const { return hi; }
+    double maxSpeed() const { return vmax; }
+
+    // Worst-case quantisation error per position axis
+    control::Vec3 positionStep() const;
+
+    // Batch encode / decode; phase may be null (encodes 0). The loops are
+    // branch-free so they vectorise with -fopenmp-simd.
+    void encode(size_t n, const control::Vec3* pos, const control::Vec3* vel,
+                const uint8_t* phase, PackedDrone* out) const;
+    void decode(size_t n, const PackedDrone* in, control::Vec3* pos,
+                control::Vec3* vel = nullptr, uint8_t* phase = nullptr) const;
+    void decodePositions(size_t n, const PackedDrone* in, control::Vec3* pos) const;
+
+private:
+    control::Vec3 lo, hi;
+    double scale[3], step[3];   // metres -> counts, counts -> metres
+    double vmax;
+};
+
+} // namespace sim
@@ -0,0 +1,171 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the hashed uniform grid.
+*/
+
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+void SpatialGrid::build(const std::vector<control::Vec3>& pts, double cellSize)
+{
+    buildImpl(pts, nullptr, pts.size(), cellSize);
+}
+
+void SpatialGrid::build(const std::vector<control::Vec3>& pts,
+                        const std::vector<uint32_t>& subset, double cellSize)
+{
+    buildImpl(pts, subset.data(), subset.size(), cellSize);
+}
+
+void SpatialGrid::buildImpl(const std::vector<control::Vec3>& pts,
+                            const uint32_t* subset, size_t n, double cellSize)
+{
+    cell    = cellSize;
+    invCell = 1.0 / cellSize;
+
+    // Table of at least 2n buckets keeps hash chains short
+    uint32_t tableSize = 1;
+    while (tableSize < 2 * n) tableSize <<= 1;
+    mask = tableSize - 1;
+
+    start.assign(tableSize + 1, 0);
+    keys.resize(n);
+    items.resize(n);
+
+    // Counting sort by cell hash: start[h] first holds the running end of
+    // bucket h, then the backward scatter walks it down to the bucket begin
+    lo = control::Vec3(INFINITY, INFINITY, INFINITY);
+    hi = control::Vec3(-INFINITY, -INFINITY, -INFINITY);
+    for (size_t k = 0; k < n; ++k)
+    {
+        const control::Vec3& p = pts[subset ? subset[k] : k];
+        keys[k] = hashCell(cellCoord(p.x), cellCoord(p.y), cellCoord(p.z));
+        ++start[keys[k]];
+        lo = control::Vec3(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+        hi = control::Vec3(std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z));
+    }
+    for (uint32_t h = 1; h < tableSize; ++h)
+    {
+        start[h] += start[h - 1];
+    }
+    start[tableSize] = static_cast<uint32_t>(n);
+    for (size_t k = n; k-- > 0;)
+    {
+        items[--start[keys[k]]] = subset ? subset[k] : static_cast<uint32_t>(k);
+    }
+}
+
+uint32_t SpatialGrid::raycast(const std::vector<control::Vec3>& pts,
+                              const control::Vec3& origin, const control::Vec3& dir,
+                              double radius, double maxDist, double* hitDist) const
+{
+    if (items.empty()) return noHit;
+
+    const double r2 = radius * radius;
+    const int reach = static_cast<int>(std::ceil(radius * invCell));
+    double best = maxDist;
+    uint32_t hit = noHit;
+
+    auto test = [&](uint32_t idx) {
+        control::Vec3 oc = pts[idx] - origin;
+        double tca = oc.dot(dir);
+        double d2 = oc.dot(oc) - tca * tca;
+        if (d2 > r2) return;
+        double t = tca - std::sqrt(r2 - d2);
+        if (t < 0.0) t = tca >= 0.0 ? 0.0 : -1.0;   // origin inside the sphere
+        if (t >= 0.0 && (t < best || (t == best && idx < hit)))
+        {
+            best = t;
+            hit = idx;
+        }
+    };
+
+    // Only the part of the ray inside the points' bounds (grown by the
+    // radius) can hit anything
+    const double o[3]  = { origin.x, origin.y, origin.z };
+    const double d[3]  = { dir.x, dir.y, dir.z };
+    const double bl[3] = { lo.x - radius, lo.y - radius, lo.z - radius };
+    const double bh[3] = { hi.x + radius, hi.y + radius, hi.z + radius };
+    double tMin = 0.0, tMax = maxDist;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (d[a] == 0.0)
+        {
+            if (o[a] < bl[a] || o[a] > bh[a]) return noHit;
+            continue;
+        }
+        double t0 = (bl[a] - o[a]) / d[a], t1 = (bh[a] - o[a]) / d[a];
+        tMin = std::max(tMin, std::min(t0, t1));
+        tMax = std::min(tMax, std::max(t0, t1));
+    }
+    if (tMin > tMax) return noHit;
+
+    // Amanatides-Woo traversal from the clipped start: per axis, the ray
+    // distance to the next cell boundary and between boundaries
+    int c[3], step[3];
+    double tNext[3], tDelta[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        c[a] = cellCoord(o[a] + d[a] * tMin);
+        if (d[a] > 0.0)
+        {
+            step[a] = 1;
+            tDelta[a] = cell / d[a];
+            tNext[a] = ((c[a] + 1) * cell - o[a]) / d[a];
+        }
+        else if (d[a] < 0.0)
+        {
+            step[a] = -1;
+            tDelta[a] = -cell / d[a];
+            tNext[a] = (c[a] * cell - o[a]) / d[a];
+        }
+        else
+        {
+            step[a] = 0;
+            tDelta[a] = tNext[a] = INFINITY;
+        }
+    }
+
+    // A sphere hit before `best` has its center within radius of the ray,
+    // so in a cell within `reach` of a cell the ray crosses. The first
+    // cell visits its whole neighbourhood; each step after that only the
+    // slab of neighbours it newly brings in.
+    for (int dz = -reach; dz <= reach; ++dz)
+        for (int dy = -reach; dy <= reach; ++dy)
+            for (int dx = -reach; dx <= reach; ++dx)
+            {
+                forEachInCell(c[0] + dx, c[1] + dy, c[2] + dz, test);
+            }
+
+    double tEnter = tMin;
+    for (;;)
+    {
+        int a = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2)
+                                    : (tNext[1] < tNext[2] ? 1 : 2);
+        tEnter = tNext[a];
+        if (tEnter > tMax || tEnter > best + radius) break;
+        tNext[a] += tDelta[a];
+        c[a] += step[a];
+
+        int off[3];
+        off[a] = step[a] * reach;
+        const int b = (a + 1) % 3, e = (a + 2) % 3;
+        for (off[e] = -reach; off[e] <= reach; ++off[e])
+            for (off[b] = -reach; off[b] <= reach; ++off[b])
+            {
+                forEachInCell(c[0] + off[0], c[1] + off[1], c[2] + off[2], test);
+            }
+    }
+
+    if (hitDist && hit != noHit) *hitDist = best;
+    return hit;
+}
+
+} // namespace sim
@@ -0,0 +1,131 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Hashed uniform grid used as the swarm's broadphase / spatial index.
+*/
+
+#pragma once
+#include "control.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+class SpatialGrid
+{
+public:
+    // Rebuild over all points (or over the given subset of point indices).
+    // Items stored in the grid are indices into `pts`.
+    void build(const std::vector<control::Vec3>& pts, double cellSize);
+    void build(const std::vector<control::Vec3>& pts,
+               const std::vector<uint32_t>& subset, double cellSize);
+
+    double cellSize() const { return cell; }
+    bool   empty() const { return items.empty(); }
+
+    int cellCoord(double v) const
+    {
+        return static_cast<int>(std::floor(v * invCell));
+    }
+
+    // Visit every item hashed into cell (ix, iy, iz). Hash collisions mean
+    // a few foreign items may show up too, so callers must distance-check.
+    template <typename Fn>
+    void forEachInCell(int ix, int iy, int iz, Fn&& fn) const
+    {
+        if (items.empty()) return;
+        uint32_t h = hashCell(ix, iy, iz);
+        for (uint32_t k = start[h]; k < start[h + 1]; ++k)
+        {
+            fn(items[k]);
+        }
+    }
+
+    // Visit the items in every cell overlapping the cube of half-size r
+    // around p. With r <= cellSize / 2 that is at most 8 cells. Cells that
+    // alias onto one hash bucket must not hand out its items twice (a
+    // contact seen twice swaps velocities back), so each bucket is
+    // visited once.
+    template <typename Fn>
+    void forEachWithin(const control::Vec3& p, double r, Fn&& fn) const
+    {
+        if (items.empty()) return;
+        int x0 = cellCoord(p.x - r), x1 = cellCoord(p.x + r);
+        int y0 = cellCoord(p.y - r), y1 = cellCoord(p.y + r);
+        int z0 = cellCoord(p.z - r), z1 = cellCoord(p.z + r);
+
+        const size_t cells = size_t(x1 - x0 + 1) * size_t(y1 - y0 + 1) * size_t(z1 - z0 + 1);
+        if (cells > 27)
+        {
+            // Wide ranges: every bucket if the range covers the table,
+            // else the distinct buckets, sorted
+            if (cells > mask)
+            {
+                for (uint32_t it : items) fn(it);
+                return;
+            }
+            std::vector<uint32_t> buckets;
+            buckets.reserve(cells);
+            for (int iz = z0; iz <= z1; ++iz)
+                for (int iy = y0; iy <= y1; ++iy)
+                    for (int ix = x0; ix <= x1; ++ix) buckets.push_back(hashCell(ix, iy, iz));
+            std::sort(buckets.begin(), buckets.end());
+            buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+            for (uint32_t h : buckets)
+                for (uint32_t k = start[h]; k < start[h + 1]; ++k) fn(items[k]);
+            return;
+        }
+        uint32_t seen[27];
+        size_t nSeen = 0;
+        for (int iz = z0; iz <= z1; ++iz)
+            for (int iy = y0; iy <= y1; ++iy)
+                for (int ix = x0; ix <= x1; ++ix)
+                {
+                    // A plain scan rather than std::find, so it inlines into
+                    // the caller and its time is counted there
+                    uint32_t h = hashCell(ix, iy, iz);
+                    bool dup = false;
+                    for (size_t k = 0; k < nSeen; ++k) dup |= seen[k] == h;
+                    if (dup) continue;
+                    seen[nSeen++] = h;
+                    for (uint32_t k = start[h]; k < start[h + 1]; ++k)
+                    {
+                        fn(items[k]);
+                    }
+                }
+    }
+
+    // Nearest point whose sphere of `radius` the ray from `origin` along
+    // unit `dir` hits within maxDist; noHit if none. Walks the cells the
+    // ray crosses (plus neighbours within radius) front to back and stops
+    // once no later cell can beat the best hit.
+    static constexpr uint32_t noHit = UINT32_MAX;
+    uint32_t raycast(const std::vector<control::Vec3>& pts,
+                     const control::Vec3& origin, const control::Vec3& dir,
+                     double radius, double maxDist, double* hitDist = nullptr) const;
+
+private:
+    uint32_t hashCell(int ix, int iy, int iz) const
+    {
+        uint32_t h = static_cast<uint32_t>(ix) * 73856093u
+                   ^ static_cast<uint32_t>(iy) * 19349663u
+                   ^ static_cast<uint32_t>(iz) * 83492791u;
+        return h & mask;
+    }
+
+    void buildImpl(const std::vector<control::Vec3>& pts,
+                   const uint32_t* subset, size_t n, double cellSize);
+
+    double   cell    = 1.0;
+    double   invCell = 1.0;
+    uint32_t mask    = 0;
+    std::vector<uint32_t> start;  // tableSize + 1 prefix offsets
+    std::vector<uint32_t> items;  // point indices sorted by cell hash
+    std::vector<uint32_t> keys;   // scratch
+    control::Vec3 lo, hi;         // bounds of the stored points
+};
+
+} // namespace sim
@@ -0,0 +1,659 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the batched swarm engine.
+*/
+
+#include "swarm.h"
+#include "memtrack.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+using control::Vec3;
+using control::Phase;
+
+Swarm::Swarm(const SwarmConfig& cfg)
+    : scfg(cfg),
+      pool(cfg.threads)
+{
+    // maxStride must be a power of two no larger than 128
+    int s = 1;
+    while (s * 2 <= std::clamp(scfg.maxStride, 1, 128)) s *= 2;
+    scfg.maxStride = s;
+    if (scfg.estimateState)
+    {
+        scfg.simulateSensors = true;
+    }
+    if (scfg.dynamics == Dynamics::Quadrotor || scfg.estimateState
+        || scfg.controller == Controller::MPC)
+    {
+        scfg.multiRate = false;
+    }
+    quad.params = scfg.quad;
+    batteryState.configure(scfg.battery);
+    if (scfg.controller == Controller::MPC)
+    {
+        mpc.configure(scfg.mpc, mass, g);
+    }
+
+    contacts.resize(pool.size());
+}
+
+uint32_t Swarm::addMission(const control::ControlConfig& cfg)
+{
+    missions.push_back(cfg);
+    return static_cast<uint32_t>(missions.size() - 1);
+}
+
+uint32_t Swarm::addDrone(const Vec3& startPos, uint32_t missionId)
+{
+    const Vec3 p = startPos;   // may be one of our own positions
+    addDrones(&p, &missionId, 1);
+    return static_cast<uint32_t>(pos.size() - 1);
+}
+
+void Swarm::addDrones(const Vec3* startPos, const uint32_t* missionIds, size_t n,
+                      uint32_t firstMission, const double* yaw)
+{
+    if (n == 0) return;
+    if (missions.empty())
+    {
+        addMission(control::ControlConfig());
+    }
+    const size_t first = pos.size(), total = first + n;
+    const uint32_t lastMission = static_cast<uint32_t>(missions.size() - 1);
+
+    MemScope tag(Subsystem::Physics);
+    pos.insert(pos.end(), startPos, startPos + n);
+    vel.resize(total);
+    acc.resize(total);
+    force.resize(total);
+    {
+        MemScope ctl(Subsystem::Control);
+        ctrl.resize(total);
+        pids.resize(total, control::defaultPIDs());
+        mission.resize(total);
+        for (size_t i = first; i < total; ++i)
+        {
+            ctrl[i].home = pos[i];
+            const uint32_t id = missionIds ? missionIds[i - first] : 0;
+            mission[i] = std::min(firstMission + id, lastMission);
+        }
+        routes.resize(total);
+        routeIndex.resize(total, 0);
+    }
+    stats.resize(total);
+    faults.resize(total);
+    batteryState.resize(total);
+
+    strides.resize(total, 1);
+    velAtSync.resize(total);
+    winAccel.resize(total);
+    if (scfg.dynamics == Dynamics::Quadrotor)
+    {
+        quad.resize(total);
+        for (size_t i = first; yaw && i < total; ++i)
+        {
+            quad.qw[i] = std::cos(0.5 * yaw[i - first]);
+            quad.qz[i] = std::sin(0.5 * yaw[i - first]);
+        }
+    }
+}
+
+// What the controller sees: the true state, or the filter's estimate
+void Swarm::controlInput(size_t i, Vec3& p, Vec3& v) const
+{
+    if (scfg.estimateState && i < stateEstimator.size())
+    {
+        p = stateEstimator.position(i);
+        v = stateEstimator.velocity(i);
+    }
+    else
+    {
+        p = pos[i];
+        v = vel[i];
+    }
+}
+
+void Swarm::setClimbRoute(size_t i, std::vector<Vec3> route)
+{
+    routes[i] = std::move(route);
+    routeIndex[i] = 0;
+    ctrl[i].plannedClimb = !routes[i].empty();
+}
+
+size_t Swarm::planClimbs(const VoxelMap& map, const PlannerConfig& cfg)
+{
+    const size_t n = size();
+    ClimbPlanner planner(map, cfg);
+
+    // Entry points per mission: twice as many candidates as drones, so
+    // the assignment can keep everyone on the side they arrive from.
+    // Candidates inside an obstacle's clearance are dropped.
+    std::vector<std::vector<uint32_t>> byMission(missions.size());
+    for (uint32_t i = 0; i < n; ++i) byMission[mission[i]].push_back(i);
+
+    // Drones without a goal (sphere mostly blocked) are not planned and
+    // fly straight
+    std::vector<uint32_t> planned;
+    std::vector<Vec3> starts, goals;
+    for (size_t m = 0; m < missions.size(); ++m)
+    {
+        const std::vector<uint32_t>& ids = byMission[m];
+        if (ids.empty()) continue;
+        std::vector<Vec3> missionStarts;
+        for (uint32_t i : ids) missionStarts.push_back(pos[i]);
+        std::vector<Vec3> pts;
+        for (size_t want = 2 * ids.size();
+             pts.size() < ids.size() && want <= 64 * ids.size(); want *= 2)
+        {
+            pts = sphereEntryPoints(missions[m], want);
+            pts.erase(std::remove_if(pts.begin(), pts.end(), [&](const Vec3& q) {
+                return planner.map().blockedAt(q);
+            }), pts.end());
+        }
+        if (pts.size() < ids.size()) continue;   // sphere mostly blocked: fly straight
+        std::vector<uint32_t> pick = assignEntryPoints(missionStarts, pts);
+        for (size_t k = 0; k < ids.size(); ++k)
+        {
+            planned.push_back(ids[k]);
+            starts.push_back(pos[ids[k]]);
+            goals.push_back(pts[pick[k]]);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) setClimbRoute(i, {});
+    std::vector<std::vector<Vec3>> paths = planner.planAll(pool, starts, goals);
+    size_t found = 0;
+    for (size_t k = 0; k < planned.size(); ++k)
+    {
+        found += !paths[k].empty();
+        setClimbRoute(planned[k], std::move(paths[k]));
+    }
+    return found;
+}
+
+// Point a planned climb at its next waypoint, moving on once within
+// 1 m of the current one. The last waypoint is the entry point.
+void Swarm::followRoute(size_t i, const Vec3& p)
+{
+    const std::vector<Vec3>& r = routes[i];
+    if (r.empty()) return;
+
+    uint32_t& k = routeIndex[i];
+    while (k + 1 < r.size() && control::distance(p, r[k]) < 1.0) ++k;
+    ctrl[i].climbTarget        = r[k];
+    ctrl[i].climbTargetIsEntry = k + 1 == r.size();
+}
+
+// Same control + physics as UAV::threadFunc, with an explicit dt
+void Swarm::stepDrone(size_t i, double dt)
+{
+    Vec3 p, v;
+    controlInput(i, p, v);
+    followRoute(i, p);
+    Vec3 motorForce = control::computeControlForce(
+        p, v, ctrl[i], pids[i], missions[mission[i]], dt
+    ) * faults.thrust[i];
+    motorForce = motorForce * drainBattery(i, motorForce.mag(), dt);
+    // Keep the velocity change actually applied, which the climb speed
+    // limit and ground contact can make differ from F / m
+    Vec3 p0 = pos[i], v0 = vel[i];
+    integratePointMass(pos[i], vel[i], motorForce, ctrl[i].phase, dt);
+    acc[i] = (vel[i] - v0) * (1.0 / dt);
+    holdIfFrozen(i, p0);
+    recordStats(i, dt);
+}
+
+// Battery drain for drone i's step at rotor thrust `thrust` N (the motor
+// force itself: gravity is applied separately). Starts the
+// return home when the charge gets low; returns the motor scale, 0 once
+// the pack is empty.
+double Swarm::drainBattery(size_t i, double thrust, double dt)
+{
+    if (!scfg.simulateBattery) return 1.0;
+    control::ControlState& cs = ctrl[i];
+    const bool armed = cs.phase != Phase::GroundWait && cs.phase != Phase::Landed
+                    && !batteryState.depleted(i);
+    const double left = batteryState.drain(i, thrust, armed, dt);
+    if (left < batteryState.returnThreshold()
+        && (cs.phase == Phase::ClimbToCenter || cs.phase == Phase::OnSphere))
+    {
+        control::beginReturnHome(pos[i], cs, pids[i]);
+    }
+    return left > 0.0 ? 1.0 : 0.0;
+}
+
+// Freeze fault: the step is undone and the drone is left at rest
+void Swarm::holdIfFrozen(size_t i, const Vec3& p0)
+{
+    if (faults.frozen[i])
+    {
+        pos[i] = p0;
+        vel[i] = Vec3(0, 0, 0);
+        acc[i] = Vec3(0, 0, 0);
+    }
+}
+
+// True state after the step, so the statistics judge the flight and not
+// the estimate the controller saw
+void Swarm::recordStats(size_t i, double dt)
+{
+    if (scfg.flightStats && ctrl[i].phase == Phase::OnSphere)
+    {
+        stats.record(i, pos[i], vel[i], missions[mission[i]], dt);
+    }
+}
+
+// Motor force for drones [begin, end) at the base rate, from either law
+void Swarm::computeForces(size_t begin, size_t end)
+{
+    const double dt = scfg.dt;
+    if (scfg.controller == Controller::PID)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Vec3 p, v;
+            controlInput(i, p, v);
+            followRoute(i, p);
+            force[i] = control::computeControlForce(
+                p, v, ctrl[i], pids[i], missions[mission[i]], dt
+            );
+        }
+        return;
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        Vec3 p, v;
+        controlInput(i, p, v);
+        followRoute(i, p);
+        control::advancePhase(p, ctrl[i], pids[i], missions[mission[i]], dt);
+        mpcProblem(i, p, v);
+    }
+    mpc.solve(begin, end);
+    for (size_t i = begin; i < end; ++i)
+    {
+        force[i] = mpc.force(i);
+    }
+}
+
+// MPC reference for the current phase, sampled at the horizon steps.
+// Climb: straight at the climb speed limit, stopping at the center (or
+// the current waypoint of a planned climb).
+// On sphere: along the great circle through the drone, tangent to the
+// same horizontal direction the PID law wanders in, at mid-band speed.
+void Swarm::mpcProblem(size_t i, const Vec3& p, const Vec3& v)
+{
+    const control::ControlConfig& cfg = missions[mission[i]];
+    const control::Phase phase = ctrl[i].phase;
+    const MpcParams& prm = mpc.params();
+
+    mpc.px[i] = p.x; mpc.py[i] = p.y; mpc.pz[i] = p.z;
+    mpc.vx[i] = v.x; mpc.vy[i] = v.y; mpc.vz[i] = v.z;
+    // Motors stay off on the ground
+    mpc.fmax[i] = phase == Phase::GroundWait || phase == Phase::Landed ? 0.0 : cfg.maxForce;
+
+    Vec3 toCenter = cfg.center - p;
+    double dist = toCenter.mag();
+    Vec3 d = dist > 1e-6 ? toCenter * (-1.0 / dist) : Vec3(1, 0, 0);   // outward
+    Vec3 t(-d.y, d.x, 0.0);                                             // up x d
+    t = t.mag() > 1e-3 ? t.normalized() : Vec3(0, 1, 0);
+    const double speed = 0.5 * (cfg.minSpeed + cfg.maxSpeed);
+    const double omega = speed / cfg.sphereRadius;
+
+    // Climb goal: the center, or the planned route's current waypoint;
+    // the return leg heads for the pad the same way
+    Vec3 toGoal = phase == Phase::ReturnHome ? control::homeTarget(p, ctrl[i]) - p
+                : ctrl[i].plannedClimb ? ctrl[i].climbTarget - p : toCenter;
+    const double goalDist = toGoal.mag();
+    toGoal = toGoal.normalized();
+
+    for (int k = 0; k < prm.horizon; ++k)
+    {
+        const double tk = (k + 1) * prm.stepTime;
+        Vec3 rp = p, rv(0, 0, 0);
+        if (phase == Phase::ClimbToCenter || phase == Phase::ReturnHome)
+        {
+            double s = std::min(maxClimbSpeed * tk, goalDist);
+            rp = p + toGoal * s;
+            rv = s < goalDist ? toGoal * maxClimbSpeed : Vec3(0, 0, 0);
+        }
+        else if (phase == Phase::OnSphere)
+        {
+            double c = std::cos(omega * tk), sn = std::sin(omega * tk);
+            rp = cfg.center + (d * c + t * sn) * cfg.sphereRadius;
+            rv = (d * (-sn) + t * c) * speed;
+        }
+        mpc.refPos(0, k, i) = rp.x; mpc.refPos(1, k, i) = rp.y; mpc.refPos(2, k, i) = rp.z;
+        mpc.refVel(0, k, i) = rv.x; mpc.refVel(1, k, i) = rv.y; mpc.refVel(2, k, i) = rv.z;
+    }
+}
+
+// 6-DOF step for a chunk of drones: control pass, then the vectorised
+// attitude/motor kernel, then translation. Done chunk by chunk so the
+// arrays are still in cache between the three passes.
+void Swarm::stepQuadrotors(size_t begin, size_t end)
+{
+    const double dt = scfg.dt;
+    computeForces(begin, end);
+    for (size_t i = begin; i < end; ++i)
+    {
+        // An empty pack commands nothing
+        const double on = scfg.simulateBattery && batteryState.depleted(i) ? 0.0 : 1.0;
+        quad.fx[i] = force[i].x * on;
+        quad.fy[i] = force[i].y * on;
+        quad.fz[i] = force[i].z * on;
+    }
+
+    // Motor masks only once something has failed
+    const double* health[4] = { faults.motor[0].data(), faults.motor[1].data(),
+                                faults.motor[2].data(), faults.motor[3].data() };
+    quad.step(begin, end, dt, mass, g, faults.active() ? health : nullptr);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        Vec3 p0 = pos[i], v0 = vel[i];
+        integrateAccel(pos[i], vel[i], Vec3(quad.ax[i], quad.ay[i], quad.az[i]),
+                       ctrl[i].phase, dt);
+        acc[i] = (vel[i] - v0) * (1.0 / dt);
+        holdIfFrozen(i, p0);
+        drainBattery(i, quad.m0[i] + quad.m1[i] + quad.m2[i] + quad.m3[i], dt);
+        recordStats(i, dt);
+    }
+}
+
+void Swarm::step(int ticks)
+{
+    const size_t n = size();
+    const int interval = syncInterval();
+
+    if (scfg.controller == Controller::MPC && mpc.size() != n)
+    {
+        mpc.resize(n);
+    }
+
+    for (int t = 0; t < ticks; ++t)
+    {
+        if (faults.pending())
+        {
+            faults.activate(tickCount);
+        }
+
+        if (tickCount % interval == 0)
+        {
+            syncPoint();
+        }
+
+        if (scfg.dynamics == Dynamics::Quadrotor)
+        {
+            pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+                stepQuadrotors(b, e);
+            }, 256);
+            stepsDone += n;
+        }
+        else if (scfg.controller == Controller::MPC)
+        {
+            pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+                computeForces(b, e);
+                for (size_t i = b; i < e; ++i)
+                {
+                    Vec3 f = force[i] * faults.thrust[i];
+                    f = f * drainBattery(i, f.mag(), scfg.dt);
+                    Vec3 p0 = pos[i], v0 = vel[i];
+                    integratePointMass(pos[i], vel[i], f, ctrl[i].phase, scfg.dt);
+                    acc[i] = (vel[i] - v0) * (1.0 / scfg.dt);
+                    holdIfFrozen(i, p0);
+                    recordStats(i, scfg.dt);
+                }
+            }, 256);
+            stepsDone += n;
+        }
+        else if (!scfg.multiRate)
+        {
+            pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+                for (size_t i = b; i < e; ++i) stepDrone(i, scfg.dt);
+            });
+            stepsDone += n;
+        }
+        else
+        {
+            const uint64_t tk = tickCount;
+            pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+                for (size_t i = b; i < e; ++i)
+                {
+                    if (tk % strides[i] == 0) stepDrone(i, scfg.dt * strides[i]);
+                }
+            });
+            for (int lvl = 0; (1 << lvl) <= interval; ++lvl)
+            {
+                if (tk % (1u << lvl) == 0) stepsDone += dueCount[lvl];
+            }
+
+            // Between sync points only full-rate drones can get close to
+            // anything, so only they need a contact check
+            if ((tk + 1) % interval != 0)
+            {
+                checkActiveSet();
+            }
+        }
+
+        if (scfg.simulateSensors)
+        {
+            sampleSensors();
+        }
+
+        ++tickCount;
+    }
+}
+
+// Readings are stamped with the tick that was just stepped
+void Swarm::sampleSensors()
+{
+    const size_t n = size();
+    if (sensorDrones != n)
+    {
+        sensorSuite.configure(scfg.sensors, n);
+        if (scfg.estimateState)
+        {
+            stateEstimator.configure(scfg.estimator, scfg.sensors, scfg.dt, g, pos);
+        }
+        sensorDrones = n;
+    }
+
+    // Filters run on the same chunk right after its readings are made
+    const QuadrotorBatch* q = scfg.dynamics == Dynamics::Quadrotor ? &quad : nullptr;
+    pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+        sensorSuite.sample(b, e, tickCount, g, pos.data(), vel.data(), acc.data(), q);
+        if (scfg.estimateState)
+        {
+            stateEstimator.update(b, e, tickCount, sensorSuite);
+        }
+    }, 1024);
+}
+
+// All drones are current here: full contact check, then (multi-rate only)
+// pick each drone's stride for the coming window.
+void Swarm::syncPoint()
+{
+    const size_t n = size();
+    if (n == 0) return;
+
+    // Worst-case distance any drone can cover before the next sync point
+    double reach = 0.0;
+    double nearDist = scfg.collisionDist;
+    if (scfg.multiRate)
+    {
+        double vmax = 0.0;
+        for (const auto& v : vel) vmax = std::max(vmax, v.mag());
+        double amax = 0.0;
+        for (const auto& m : missions) amax = std::max(amax, m.maxForce / mass);
+        amax += g;
+
+        const double T = syncInterval() * scfg.dt;
+        reach    = vmax * T + 0.5 * amax * T * T;
+        nearDist = scfg.collisionDist + 2.0 * reach;
+    }
+
+    // Cells twice the query radius: each lookup touches at most 8 cells
+    MemScope tag(Subsystem::Collision);
+    grid.build(pos, 2.0 * nearDist);
+
+    std::vector<double>& nearest = nearestScratch;
+    nearest.assign(n, nearDist);
+    pool.parallelFor(n, [&](size_t b, size_t e, unsigned slot) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const Vec3 p = pos[i];
+            double best = nearDist;
+            grid.forEachWithin(p, nearDist, [&](uint32_t j) {
+                if (j == i) return;
+                double d = control::distance(p, pos[j]);
+                if (d < best) best = d;
+                if (j > i && d < scfg.collisionDist)
+                {
+                    contacts[slot].push_back({ static_cast<uint32_t>(i), j, vel[i], vel[j] });
+                }
+            });
+            nearest[i] = best;
+        }
+    });
+    resolveContacts();
+
+    if (scfg.multiRate)
+    {
+        chooseStrides(reach, nearDist);
+    }
+}
+
+void Swarm::chooseStrides(double reach, double nearDist)
+{
+    const size_t n = size();
+    const double T = syncInterval() * scfg.dt;
+    const std::vector<double>& nearest = nearestScratch;
+
+    pool.parallelFor(n, [&](size_t b, size_t e, unsigned) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const control::ControlConfig& cfg = missions[mission[i]];
+            const control::ControlState& cs = ctrl[i];
+
+            // Mean acceleration over the window just finished; steady flight
+            // (including constant-rate circling) barely changes it
+            Vec3 a = (vel[i] - velAtSync[i]) / T;
+            double score = (a - winAccel[i]).mag() / scfg.accelScale;
+            winAccel[i]  = a;
+            velAtSync[i] = vel[i];
+
+            switch (cs.phase)
+            {
+                case Phase::GroundWait:
+                    // Take-off falls inside the next window
+                    if (cs.timeInPhase + T >= cfg.groundWait) score = 1.0;
+                    break;
+                case Phase::ClimbToCenter:
+                    // Hand-off to OnSphere falls inside the next window
+                    if (control::distance(pos[i], cfg.center) - 2.0 < reach) score = 1.0;
+                    break;
+                case Phase::OnSphere:
+                {
+                    double r = control::distance(pos[i], cfg.center);
+                    double targetSpeed = 0.5 * (cfg.minSpeed + cfg.maxSpeed);
+                    double err = std::max(std::abs(r - cfg.sphereRadius),
+                                          std::abs(vel[i].mag() - targetSpeed));
+                    score = std::max(score, err / scfg.errorScale);
+                    break;
+                }
+                case Phase::ReturnHome:
+                    // Heading for the pad; the landing is a phase change
+                    score = 1.0;
+                    break;
+                case Phase::Landed:
+                    break;
+            }
+
+            // Anything that could reach a neighbour before the next sync
+            if (nearest[i] < nearDist) score = 1.0;
+
+            // Largest power-of-two stride not above 1/score
+            int s = 1;
+            while (s < scfg.maxStride && score * (2 * s) <= 1.0) s *= 2;
+            strides[i] = static_cast<uint8_t>(s);
+        }
+    });
+
+    active.clear();
+    std::fill(std::begin(dueCount), std::end(dueCount), 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        int lvl = 0;
+        while ((1 << lvl) < strides[i]) ++lvl;
+        ++dueCount[lvl];
+        if (strides[i] == 1) active.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void Swarm::packSnapshot(const SnapshotCodec& codec, std::vector<PackedDrone>& out)
+{
+    out.resize(size());
+    pool.parallelFor(size(), [&](size_t b, size_t e, unsigned) {
+        uint8_t phase[256];
+        for (size_t c = b; c < e; c += 256)
+        {
+            const size_t m = std::min<size_t>(256, e - c);
+            for (size_t k = 0; k < m; ++k) phase[k] = static_cast<uint8_t>(ctrl[c + k].phase);
+            codec.encode(m, &pos[c], &vel[c], phase, &out[c]);
+        }
+    }, 4096);
+}
+
+void Swarm::checkActiveSet()
+{
+    if (active.size() < 2) return;
+    MemScope tag(Subsystem::Collision);
+
+    grid.build(pos, active, 2.0 * scfg.collisionDist);
+    pool.parallelFor(active.size(), [&](size_t b, size_t e, unsigned slot) {
+        for (size_t k = b; k < e; ++k)
+        {
+            const uint32_t i = active[k];
+            grid.forEachWithin(pos[i], scfg.collisionDist, [&](uint32_t j) {
+                if (j > i && control::distance(pos[i], pos[j]) < scfg.collisionDist)
+                {
+                    contacts[slot].push_back({ i, j, vel[i], vel[j] });
+                }
+            });
+        }
+    });
+    resolveContacts();
+}
+
+// Simple "swap velocities" response, applied in (i, j) order so the result
+// does not depend on thread scheduling
+void Swarm::resolveContacts()
+{
+    std::vector<Contact>& all = contacts[0];
+    for (size_t s = 1; s < contacts.size(); ++s)
+    {
+        all.insert(all.end(), contacts[s].begin(), contacts[s].end());
+        contacts[s].clear();
+    }
+    std::sort(all.begin(), all.end(), [](const Contact& a, const Contact& b) {
+        return a.i != b.i ? a.i < b.i : a.j < b.j;
+    });
+
+    for (const Contact& c : all)
+    {
+        vel[c.i] = c.vj;
+        vel[c.j] = c.vi;
+    }
+    collisionCount += all.size();
+    all.clear();
+}
+
+} // namespace sim
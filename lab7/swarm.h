@@ -0,0 +1,220 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Batched swarm engine: steps many UAVs in lockstep from one thread
+    pool instead of one std::thread per UAV.
+*/
+
+#pragma once
+#include "battery.h"
+#include "estimator.h"
+#include "faults.h"
+#include "flight_stats.h"
+#include "mpc.h"
+#include "planner.h"
+#include "quadrotor.h"
+#include "sensors.h"
+#include "simulation.h"
+#include "snapshot_codec.h"
+#include "spatial_grid.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+enum class Dynamics
+{
+    PointMass,   // motor force applied directly (UAV::threadFunc model)
+    Quadrotor    // 6-DOF: thrust + attitude setpoints, motor mixing
+};
+
+enum class Controller
+{
+    PID,   // control::computeControlForce
+    MPC    // batched linear MPC tracking the same mission
+};
+
+struct SwarmConfig
+{
+    double   dt            = 0.01;  // base tick, s (100 Hz like UAV::threadFunc)
+    unsigned threads       = 0;     // 0 = one per hardware thread
+    double   collisionDist = 0.01;  // m, same as the render-loop check
+    Dynamics dynamics      = Dynamics::PointMass;
+    QuadrotorParams quad;           // used with Dynamics::Quadrotor
+    Controller controller  = Controller::PID;
+    MpcParams  mpc;                 // used with Controller::MPC
+
+    // Simulated IMU / GPS / barometer readings, produced every tick
+    bool         simulateSensors = false;
+    SensorConfig sensors;
+
+    // Run a Kalman filter per drone on those readings and have the
+    // controllers fly on its estimate instead of the true state.
+    // Implies simulateSensors; uniform stepping only.
+    bool            estimateState = false;
+    EstimatorConfig estimator;
+
+    // Multi-rate stepping. Each drone runs at dt * stride, stride being a
+    // power of two up to maxStride. Strides are re-chosen only at sync
+    // ticks (every maxStride ticks) where every drone is current.
+    // Point-mass PID only: the quadrotor attitude loop and the MPC plan
+    // both need the base rate.
+    bool   multiRate   = false;
+    int    maxStride   = 4;
+    double accelScale  = 2.0;   // m/s^2 change of mean accel per window -> full rate
+    double errorScale  = 0.5;   // m radial / (m/s) speed error -> full rate
+
+    // Running radial / speed-band statistics per drone, updated in the
+    // step kernel while the drone is on its sphere
+    bool flightStats = true;
+
+    // Battery per drone, drained in the step kernel from the rotor
+    // thrust; below battery.returnAt a flying drone returns to its pad
+    // and lands, and an empty pack cuts the motors. Off by default, since
+    // it shortens every flight longer than one pack.
+    bool          simulateBattery = false;
+    BatteryParams battery;
+};
+
+class Swarm
+{
+public:
+    explicit Swarm(const SwarmConfig& cfg = SwarmConfig());
+
+    // Missions are shared control configs; each drone refers to one
+    uint32_t addMission(const control::ControlConfig& cfg);
+    uint32_t addDrone(const control::Vec3& startPos, uint32_t mission = 0);
+    // Many at once, e.g. straight from a mapped scenario: drone k starts
+    // at startPos[k] on mission firstMission + missionIds[k] (0 if null).
+    // yaw, if given, is the initial heading in rad (quadrotor only; the
+    // attitude loop itself flies zero yaw).
+    void addDrones(const control::Vec3* startPos, const uint32_t* missionIds, size_t n,
+                   uint32_t firstMission = 0, const double* yaw = nullptr);
+
+    // Planned climbs: give drone i waypoints to follow during
+    // ClimbToCenter, the last one being its entry point on the sphere.
+    // An empty route restores the straight climb to the center.
+    void setClimbRoute(size_t i, std::vector<control::Vec3> route);
+    const std::vector<control::Vec3>& climbRoute(size_t i) const { return routes[i]; }
+
+    // Plan every drone's climb around the map's obstacles in parallel,
+    // each drone of a mission getting its own entry point. Returns the
+    // number of drones a path was found for.
+    size_t planClimbs(const VoxelMap& map, const PlannerConfig& cfg = PlannerConfig());
+
+    // Advance the swarm by `ticks` base ticks
+    void step(int ticks = 1);
+
+    size_t   size() const { return pos.size(); }
+    size_t   missionCount() const { return missions.size(); }
+    uint64_t tick() const { return tickCount; }
+    double   time() const { return tickCount * scfg.dt; }
+    const SwarmConfig& config() const { return scfg; }
+    unsigned threads() const { return pool.size(); }
+    // Workers shared with code running alongside the swarm (e.g. comms)
+    ThreadPool& threadPool() { return pool; }
+
+    // Ticks between sync points (1 when stepping uniformly)
+    int  syncInterval() const { return scfg.multiRate ? scfg.maxStride : 1; }
+    // True when every drone's state refers to time()
+    bool atSyncPoint() const { return tickCount % syncInterval() == 0; }
+
+    // Per-drone state, one array per field. Between sync points a drone
+    // with stride > 1 may be up to one stride ahead of time().
+    // Accelerations are the velocity change over the drone's last step.
+    const std::vector<control::Vec3>& positions()     const { return pos; }
+    const std::vector<control::Vec3>& velocities()    const { return vel; }
+    const std::vector<control::Vec3>& accelerations() const { return acc; }
+    const control::ControlState& controlState(size_t i) const { return ctrl[i]; }
+    const control::ControlConfig& missionOf(size_t i) const { return missions[mission[i]]; }
+    int stride(size_t i) const { return strides[i]; }
+
+    // Attitude / motor state (Dynamics::Quadrotor only)
+    const QuadrotorBatch& quadrotors() const { return quad; }
+    // Latest sensor readings (simulateSensors only)
+    const SensorSuite& sensors() const { return sensorSuite; }
+    // State estimates (estimateState only)
+    const StateEstimator& estimator() const { return stateEstimator; }
+
+    // Work accounting: drone updates performed and collisions resolved
+    uint64_t droneSteps() const { return stepsDone; }
+    uint64_t collisions() const { return collisionCount; }
+    // How well each drone holds its sphere and speed band (flightStats only)
+    const FlightStats& flightStats() const { return stats; }
+    // Battery state (simulateBattery only) and fleet-wide energy figures
+    const BatteryBatch& batteries() const { return batteryState; }
+    BatterySummary batterySummary() const { return batteryState.summary(ctrl); }
+
+    // Fault injection: schedule motor loss / thrust loss / freezes here.
+    // Faults fire at the start of their tick; with multi-rate stepping a
+    // drone sees its mask at its next own step.
+    FaultModel&       faultModel()       { return faults; }
+    const FaultModel& faultModel() const { return faults; }
+
+    // Positions, velocities and phases packed 16 bytes per drone for the
+    // render handoff and telemetry (see snapshot_codec.h)
+    void packSnapshot(const SnapshotCodec& codec, std::vector<PackedDrone>& out);
+
+private:
+    struct Contact
+    {
+        uint32_t i, j;
+        control::Vec3 vi, vj;  // velocities when the contact was found
+    };
+
+    void syncPoint();
+    void chooseStrides(double reach, double nearDist);
+    void resolveContacts();
+    void checkActiveSet();
+    void controlInput(size_t i, control::Vec3& p, control::Vec3& v) const;
+    void followRoute(size_t i, const control::Vec3& p);
+    void stepDrone(size_t i, double dt);
+    void recordStats(size_t i, double dt);
+    void holdIfFrozen(size_t i, const control::Vec3& p0);
+    double drainBattery(size_t i, double thrust, double dt);
+    void computeForces(size_t begin, size_t end);
+    void mpcProblem(size_t i, const control::Vec3& p, const control::Vec3& v);
+    void stepQuadrotors(size_t begin, size_t end);
+    void sampleSensors();
+
+    SwarmConfig scfg;
+    ThreadPool  pool;
+    SpatialGrid grid;
+
+    std::vector<control::ControlConfig> missions;
+
+    std::vector<control::Vec3>         pos, vel, acc;
+    std::vector<control::ControlState> ctrl;
+    std::vector<control::ControlPIDs>  pids;
+    std::vector<uint32_t>              mission;
+    std::vector<std::vector<control::Vec3>> routes;   // planned climbs
+    std::vector<uint32_t>              routeIndex;
+    std::vector<control::Vec3>         force;    // this tick's motor force
+    QuadrotorBatch                     quad;
+    MpcBatch                           mpc;
+    SensorSuite                        sensorSuite;
+    StateEstimator                     stateEstimator;
+    FlightStats                        stats;
+    FaultModel                         faults;
+    BatteryBatch                       batteryState;
+    size_t                             sensorDrones = 0;  // size when configured
+
+    // Multi-rate bookkeeping
+    std::vector<uint8_t>       strides;
+    std::vector<control::Vec3> velAtSync;  // velocity at the previous sync
+    std::vector<control::Vec3> winAccel;   // mean accel over the last window
+    std::vector<uint32_t>      active;     // drones at stride 1
+    uint64_t dueCount[8] = {};             // drones per log2(stride)
+    std::vector<double>        nearestScratch;  // nearest neighbour at sync
+
+    std::vector<std::vector<Contact>> contacts;  // per pool slot
+
+    uint64_t tickCount      = 0;
+    uint64_t stepsDone      = 0;
+    uint64_t collisionCount = 0;
+};
+
+} // namespace sim
@@ -0,0 +1,434 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Regression checks for the swarm engine, run by ctest.
+    Usage: uav_tests [name]
+*/
+
+#include "planner.h"
+#include "scenario_file.h"
+#include "snapshot_codec.h"
+#include "spatial_grid.h"
+#include "swarm.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using control::Vec3;
+
+namespace
+{
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                          \
+    do                                                                       \
+    {                                                                        \
+        if (!(cond))                                                         \
+        {                                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,     \
+                         __LINE__, #cond);                                   \
+            ++g_failures;                                                    \
+        }                                                                    \
+    } while (0)
+
+// ------------------------------------------
+// SpatialGrid
+// ------------------------------------------
+// Two points on either side of a cell corner, in cells whose hashes
+// alias onto one bucket: forEachWithin must hand each out once
+void gridAliasedBuckets()
+{
+    sim::SpatialGrid grid;
+    std::vector<Vec3> pts;
+    bool found = false;
+    // Two points make a 4-bucket table, so some pair of the 8 cells
+    // around a corner aliases for most corners
+    for (int c = 1; c < 64 && !found; ++c)
+    {
+        const Vec3 corner(c, 2 * c, 3 * c);
+        for (int a = 0; a < 8 && !found; ++a)
+        {
+            for (int b = a + 1; b < 8 && !found; ++b)
+            {
+                auto side = [&](int k, int bit) { return (k >> bit & 1) ? 0.05 : -0.05; };
+                pts = { corner + Vec3(side(a, 0), side(a, 1), side(a, 2)),
+                        corner + Vec3(side(b, 0), side(b, 1), side(b, 2)) };
+                grid.build(pts, 1.0);
+                int seen = 0;
+                grid.forEachInCell(grid.cellCoord(pts[1].x), grid.cellCoord(pts[1].y),
+                                   grid.cellCoord(pts[1].z), [&](uint32_t i) { seen += i == 0; });
+                found = seen == 1;   // point 0 shows up under point 1's cell
+            }
+        }
+    }
+    CHECK(found);
+
+    int visits[2] = { 0, 0 };
+    grid.forEachWithin(pts[0], 0.2, [&](uint32_t i) { ++visits[i]; });
+    CHECK(visits[0] == 1);
+    CHECK(visits[1] == 1);
+
+    // Wider than the whole table: every item once
+    visits[0] = visits[1] = 0;
+    grid.forEachWithin(pts[0], 2.5, [&](uint32_t i) { ++visits[i]; });
+    CHECK(visits[0] == 1);
+    CHECK(visits[1] == 1);
+}
+
+// Ranges wider than 27 cells but smaller than the table: every point in
+// range once, nothing twice
+void gridWideQuery()
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> u(-20.0, 20.0);
+    std::vector<Vec3> pts;
+    for (int i = 0; i < 2000; ++i) pts.emplace_back(u(rng), u(rng), u(rng));
+    sim::SpatialGrid grid;
+    grid.build(pts, 1.0);
+    for (double r : { 1.7, 3.2, 6.0 })
+    {
+        const Vec3 p(1.3, -2.1, 0.4);
+        std::vector<int> visits(pts.size(), 0);
+        grid.forEachWithin(p, r, [&](uint32_t i) { ++visits[i]; });
+        bool ok = true;
+        for (size_t i = 0; i < pts.size(); ++i)
+        {
+            ok = ok && visits[i] <= 1;
+            if (control::distance(p, pts[i]) <= r) ok = ok && visits[i] == 1;
+        }
+        CHECK(ok);
+    }
+}
+
+// ------------------------------------------
+// ClimbPlanner
+// ------------------------------------------
+// Start and goal in one voxel: the route is just the goal
+void plannerSameVoxel()
+{
+    sim::VoxelMap map(Vec3(-10, -10, 0), Vec3(10, 10, 20), 1.0);
+    sim::ClimbPlanner planner(map);
+    const Vec3 start(0.2, 0.2, 5.2), goal(0.7, 0.6, 5.8);
+    const std::vector<Vec3> route = planner.plan(start, goal);
+    CHECK(route.size() == 1);
+    CHECK(!route.empty() && route.back().x == goal.x && route.back().y == goal.y &&
+          route.back().z == goal.z);
+}
+
+// Every entry point inside an obstacle: planClimbs plans nobody and
+// leaves the drones to fly straight
+void planClimbsBlockedSphere()
+{
+    control::ControlConfig mission;
+    sim::Swarm swarm;
+    swarm.addMission(mission);
+    for (int i = 0; i < 4; ++i) swarm.addDrone(Vec3(3.0 * i - 4.5, -20.0, 0.0));
+
+    sim::VoxelMap map(Vec3(-40, -40, 0), Vec3(40, 40, 80), 1.0);
+    map.addSphere(mission.center, mission.sphereRadius + 4.0);
+    CHECK(swarm.planClimbs(map) == 0);
+    for (size_t i = 0; i < swarm.size(); ++i) CHECK(swarm.climbRoute(i).empty());
+}
+
+// The nearest-point assignment picks what sorting every pair would
+std::vector<uint32_t> greedyAllPairs(const std::vector<Vec3>& starts, const std::vector<Vec3>& points)
+{
+    std::vector<std::tuple<double, uint32_t, uint32_t>> pairs;
+    for (uint32_t s = 0; s < starts.size(); ++s)
+        for (uint32_t p = 0; p < points.size(); ++p)
+            pairs.emplace_back(control::distance(starts[s], points[p]), s, p);
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<uint32_t> out(starts.size(), UINT32_MAX);
+    std::vector<bool> taken(points.size(), false);
+    for (const auto& [d, s, p] : pairs)
+    {
+        if (out[s] != UINT32_MAX || taken[p]) continue;
+        out[s] = p;
+        taken[p] = true;
+    }
+    return out;
+}
+
+void assignMatchesGreedy()
+{
+    control::ControlConfig mission;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> u(-60.0, 60.0);
+    for (size_t n : { 1u, 5u, 40u, 200u })
+    {
+        std::vector<Vec3> starts;
+        for (size_t i = 0; i < n; ++i) starts.emplace_back(u(rng), u(rng), 0.5 * (u(rng) + 60.0));
+        starts.push_back(mission.center);   // degenerate: at the center
+        for (size_t want : { 2 * starts.size(), starts.size(), starts.size() / 2 + 1 })
+        {
+            const std::vector<Vec3> pts = sim::sphereEntryPoints(mission, want);
+            CHECK(sim::assignEntryPoints(starts, pts) == greedyAllPairs(starts, pts));
+        }
+    }
+}
+
+// ------------------------------------------
+// Scenario files
+// ------------------------------------------
+template <typename T>
+bool sameArray(const std::vector<T>& a, const T* b, size_t n)
+{
+    return a.size() == n && (n == 0 || std::memcmp(a.data(), b, n * sizeof(T)) == 0);
+}
+
+bool sameScenario(const sim::Scenario& s, const sim::ScenarioView& v)
+{
+    return v.drones == s.drones()
+        && sameArray(s.missions, v.missions, v.missionCount)
+        && sameArray(s.airframes, v.airframes, v.airframeCount)
+        && sameArray(s.obstacles, v.obstacles, v.obstacleCount)
+        && sameArray(s.positions, v.positions, v.drones)
+        && sameArray(s.yaw, v.yaw, v.drones)
+        && sameArray(s.missionIds, v.missionIds, v.drones)
+        && sameArray(s.airframeIds, v.airframeIds, v.drones);
+}
+
+sim::Scenario copyScenario(const sim::ScenarioView& v)
+{
+    sim::Scenario s;
+    s.missions.assign(v.missions, v.missions + v.missionCount);
+    s.airframes.assign(v.airframes, v.airframes + v.airframeCount);
+    s.obstacles.assign(v.obstacles, v.obstacles + v.obstacleCount);
+    s.positions.assign(v.positions, v.positions + v.drones);
+    s.yaw.assign(v.yaw, v.yaw + v.drones);
+    s.missionIds.assign(v.missionIds, v.missionIds + v.drones);
+    s.airframeIds.assign(v.airframeIds, v.airframeIds + v.drones);
+    return s;
+}
+
+const char* kScenarioText =
+    "# two missions, two airframes, one of each obstacle\n"
+    "airframe name=quad250 motor_force=8 arm=0.1 battery_wh=22\n"
+    "airframe name=heavy motor_force=14.5 arm=0.25 battery_wh=60\n"
+    "mission center=0,0,50 radius=10 wait=5 max_force=20 min_speed=2 max_speed=10\n"
+    "mission center=12.3,-4.1,35 radius=6.5 wait=1 max_force=18 min_speed=1.5 max_speed=7\n"
+    "box lo=-5,-5,0 hi=5,5,30\n"
+    "sphere center=0,20,20 radius=4\n"
+    "drone pos=-46,-22.5,0 yaw=0.3 mission=1 airframe=1\n"
+    "grid origin=-46,-22.5,0 step=22,22.5 count=3,2 yaw=-1.25 mission=0 airframe=0\n";
+
+// Text -> compiled -> text keeps every record bit for bit
+void scenarioRoundTrip()
+{
+    sim::Scenario text;
+    std::string error;
+    CHECK(sim::parseScenarioText(kScenarioText, text, error));
+    CHECK(text.drones() == 7 && text.missions.size() == 2 && text.obstacles.size() == 2);
+
+    const std::string bin = "/tmp/uav_tests_scenario.bin", txt = "/tmp/uav_tests_scenario.txt";
+    CHECK(sim::saveScenarioBinary(text, bin));
+    sim::ScenarioFile file;
+    CHECK(file.open(bin));
+    CHECK(sameScenario(text, file.view()));
+
+    CHECK(sim::saveScenarioText(copyScenario(file.view()), txt));
+    sim::Scenario back;
+    CHECK(sim::loadScenarioText(txt, back, error));
+    CHECK(sameScenario(back, text.view()));
+    file.close();
+    std::remove(bin.c_str());
+    std::remove(txt.c_str());
+}
+
+// References to missions or airframes that were never defined
+void scenarioRejectsUndefinedIds()
+{
+    sim::Scenario s;
+    std::string error;
+    CHECK(!sim::parseScenarioText("mission radius=5\ndrone pos=0,0,0 mission=1\n", s, error));
+    CHECK(!error.empty());
+
+    error.clear();
+    CHECK(!sim::parseScenarioText("airframe name=a\ndrone pos=0,0,0 airframe=1\n", s, error));
+    CHECK(!error.empty());
+
+    error.clear();
+    CHECK(!sim::parseScenarioText("mission radius=5\ngrid count=2,2 mission=3\n", s, error));
+    CHECK(!error.empty());
+}
+
+bool writeBytes(const std::string& path, const std::vector<unsigned char>& bytes)
+{
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// A compiled file cut short, or with an id past the tables, never opens
+void scenarioFileRejectsBadFiles()
+{
+    sim::Scenario s;
+    std::string error;
+    CHECK(sim::parseScenarioText(kScenarioText, s, error));
+    const std::string path = "/tmp/uav_tests_bad.bin";
+    CHECK(sim::saveScenarioBinary(s, path));
+
+    std::vector<unsigned char> good;
+    {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        CHECK(f != nullptr);
+        if (!f) return;
+        unsigned char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) good.insert(good.end(), buf, buf + n);
+        std::fclose(f);
+    }
+
+    sim::ScenarioFile file;
+    CHECK(file.open(path));
+    file.close();
+
+    // Truncated: one byte short, and the header alone
+    std::vector<unsigned char> cut(good.begin(), good.end() - 1);
+    CHECK(writeBytes(path, cut));
+    CHECK(!file.open(path));
+    cut.assign(good.begin(), good.begin() + sizeof(sim::ScenarioHeader));
+    CHECK(writeBytes(path, cut));
+    CHECK(!file.open(path));
+
+    // Mission and airframe ids one past the last record. The id arrays
+    // are the last two sections, each starting on a 64-byte boundary.
+    const auto alignUp = [](size_t off) { return (off + 63) & ~size_t(63); };
+    const size_t n = s.drones();
+    const size_t airframeIds = good.size() - n * sizeof(uint16_t);
+    const size_t missionIds = alignUp(airframeIds - n * sizeof(uint32_t) - 63);
+    CHECK(std::memcmp(&good[missionIds], s.missionIds.data(), n * sizeof(uint32_t)) == 0);
+    CHECK(std::memcmp(&good[airframeIds], s.airframeIds.data(), n * sizeof(uint16_t)) == 0);
+
+    std::vector<unsigned char> bad = good;
+    const uint32_t mission = static_cast<uint32_t>(s.missions.size());
+    std::memcpy(&bad[missionIds + 3 * sizeof(uint32_t)], &mission, sizeof(mission));
+    CHECK(writeBytes(path, bad));
+    CHECK(!file.open(path));
+
+    bad = good;
+    const uint16_t airframe = static_cast<uint16_t>(s.airframes.size());
+    std::memcpy(&bad[airframeIds + 2 * sizeof(uint16_t)], &airframe, sizeof(airframe));
+    CHECK(writeBytes(path, bad));
+    CHECK(!file.open(path));
+
+    std::remove(path.c_str());
+}
+
+// ------------------------------------------
+// SnapshotCodec
+// ------------------------------------------
+// In-range state decodes within half a step per position axis; speed
+// within half a speed step, direction to the octahedral snorm16 grid
+void codecRoundTrip()
+{
+    const sim::SnapshotCodec codec;
+    const Vec3 lo = codec.boundsLo(), hi = codec.boundsHi(), step = codec.positionStep();
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> u(0.0, 1.0), w(-1.0, 1.0);
+    const size_t n = 1000;
+    std::vector<Vec3> pos, vel;
+    std::vector<uint8_t> phase;
+    for (size_t i = 0; i < n; ++i)
+    {
+        pos.emplace_back(lo.x + u(rng) * (hi.x - lo.x), lo.y + u(rng) * (hi.y - lo.y),
+                         lo.z + u(rng) * (hi.z - lo.z));
+        Vec3 d(w(rng), w(rng), w(rng));
+        vel.push_back(i % 50 == 0 ? Vec3(0, 0, 0) : d.normalized() * (u(rng) * codec.maxSpeed()));
+        phase.push_back(static_cast<uint8_t>(i % 6));
+    }
+    std::vector<sim::PackedDrone> packed(n);
+    codec.encode(n, pos.data(), vel.data(), phase.data(), packed.data());
+    std::vector<Vec3> p2(n), v2(n);
+    std::vector<uint8_t> ph2(n);
+    codec.decode(n, packed.data(), p2.data(), v2.data(), ph2.data());
+
+    const double speedStep = codec.maxSpeed() / 65535.0;
+    bool posOk = true, velOk = true, restOk = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        posOk = posOk && std::fabs(p2[i].x - pos[i].x) <= step.x * (1 + 1e-9)
+                      && std::fabs(p2[i].y - pos[i].y) <= step.y * (1 + 1e-9)
+                      && std::fabs(p2[i].z - pos[i].z) <= step.z * (1 + 1e-9);
+        const double s = vel[i].mag();
+        velOk = velOk && std::fabs(v2[i].mag() - s) <= 0.5 * speedStep + 1e-9
+                      && control::distance(v2[i], vel[i]) <= 0.5 * speedStep + 1e-4 * s;
+        restOk = restOk && ph2[i] == phase[i] && packed[i].flags == 0;
+    }
+    CHECK(posOk);
+    CHECK(velOk);
+    CHECK(restOk);
+}
+
+// Out of range, too fast or not finite: flagged, and decoded to
+// something finite inside the bounds
+void codecClamped()
+{
+    const sim::SnapshotCodec codec;
+    const double nan = std::nan("");
+    const Vec3 pos[] = { Vec3(1000, 0, 50), Vec3(0, 0, 50), Vec3(nan, 0, 50), Vec3(0, 0, 50) };
+    const Vec3 vel[] = { Vec3(0, 0, 0), Vec3(100, 0, 0), Vec3(0, 0, 0), Vec3(0, nan, 1) };
+    sim::PackedDrone packed[4];
+    codec.encode(4, pos, vel, nullptr, packed);
+    Vec3 p2[4], v2[4];
+    codec.decode(4, packed, p2, v2);
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(packed[i].flags & sim::PackedDrone::Clamped);
+        CHECK(std::isfinite(p2[i].x) && std::isfinite(p2[i].y) && std::isfinite(p2[i].z));
+        CHECK(std::isfinite(v2[i].x) && std::isfinite(v2[i].y) && std::isfinite(v2[i].z));
+    }
+    CHECK(p2[0].x == codec.boundsHi().x);
+    CHECK(p2[2].x == codec.boundsLo().x);
+    CHECK(std::fabs(v2[1].mag() - codec.maxSpeed()) < 1e-9);
+}
+
+struct Test
+{
+    const char* name;
+    void (*run)();
+};
+
+const Test kTests[] = {
+    { "grid_aliased_buckets", gridAliasedBuckets },
+    { "grid_wide_query", gridWideQuery },
+    { "planner_same_voxel", plannerSameVoxel },
+    { "plan_climbs_blocked_sphere", planClimbsBlockedSphere },
+    { "assign_matches_greedy", assignMatchesGreedy },
+    { "scenario_round_trip", scenarioRoundTrip },
+    { "scenario_undefined_ids", scenarioRejectsUndefinedIds },
+    { "scenario_file_bad_files", scenarioFileRejectsBadFiles },
+    { "codec_round_trip", codecRoundTrip },
+    { "codec_clamped", codecClamped },
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int ran = 0;
+    for (const Test& t : kTests)
+    {
+        if (argc > 1 && std::strcmp(argv[1], t.name) != 0) continue;
+        const int before = g_failures;
+        t.run();
+        std::printf("%-32s %s\n", t.name, g_failures == before ? "ok" : "FAILED");
+        ++ran;
+    }
+    if (ran == 0)
+    {
+        std::fprintf(stderr, "no test named %s\n", argv[1]);
+        return 1;
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the fork-join thread pool.
+*/
+
+#include "thread_pool.h"
+#include "memtrack.h"
+#include <algorithm>
+
+namespace sim
+{
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+}
+
+void ThreadPool::runChunks(unsigned slot)
+{
+    while (true)
+    {
+        size_t begin = next.fetch_add(jobGrain);
+        if (begin >= jobSize) break;
+        size_t end = std::min(jobSize, begin + jobGrain);
+        (*job)(begin, end, slot);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned slot)
+{
+    Profiler::instance().registerThread(Subsystem::Physics);
+    unsigned long long seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+        }
+
+        {
+            MemScope tag(jobTag);
+            runChunks(slot);
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pending == 0)
+        {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const RangeFn& fn, size_t grain)
+{
+    if (n == 0) return;
+    if (grain == 0)
+    {
+        grain = std::max<size_t>(1, n / (size() * 8));
+    }
+
+    // Small jobs (or no workers): not worth waking anyone
+    if (workers.empty() || n <= grain)
+    {
+        fn(0, n, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job      = &fn;
+        jobTag   = memTag();
+        jobSize  = n;
+        jobGrain = grain;
+        next     = 0;
+        pending  = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait(lock, [&] { return pending == 0; });
+    job = nullptr;
+}
+
+} // namespace sim
@@ -0,0 +1,61 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Small fork-join thread pool used by the batched swarm engine.
+*/
+
+#pragma once
+#include "profiler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+class ThreadPool
+{
+public:
+    // threads == 0 -> one per hardware thread (the caller counts as one)
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads taking part in parallelFor (workers + caller)
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Run fn(begin, end, slot) over [0, n) in chunks of `grain` items.
+    // slot is in [0, size()) and is stable for the duration of the call,
+    // so callers can keep per-thread partial results. Blocks until done.
+    using RangeFn = std::function<void(size_t, size_t, unsigned)>;
+    void parallelFor(size_t n, const RangeFn& fn, size_t grain = 0);
+
+private:
+    void workerLoop(unsigned slot);
+    void runChunks(unsigned slot);
+
+    std::vector<std::thread> workers;
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned long long generation = 0;
+    unsigned pending = 0;
+    bool quit = false;
+
+    // Current job (valid while pending > 0)
+    const RangeFn* job = nullptr;
+    Subsystem jobTag = Subsystem::Other;   // caller's heap accounting tag
+    size_t jobSize  = 0;
+    size_t jobGrain = 1;
+    std::atomic<size_t> next{0};
+};
+
+} // namespace sim
@@ -0,0 +1,72 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Offline baking of field imagery into tile pyramids.
+    Usage: uav_tiles <command> <file> [args...]
+*/
+
+#include "field_tiles.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+double secondsSince(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int usage()
+{
+    std::cerr << "Usage: uav_tiles <command> <file> [args]\n"
+              << "  bake <image.bmp> <out.tiles> [tileSize=256]\n"
+              << "  info <file.tiles>\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) return usage();
+    std::string cmd = argv[1], path = argv[2];
+
+    if (cmd == "bake" && argc >= 4)
+    {
+        const int tileSize = argc > 4 ? std::atoi(argv[4]) : 256;
+        if (tileSize < 16 || tileSize > static_cast<int>(sim::kMaxTileSize))
+        {
+            std::cerr << "Tile size must be between 16 and " << sim::kMaxTileSize << "\n";
+            return 1;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        if (!sim::bakeTilePyramid(path, argv[3], static_cast<uint32_t>(tileSize)))
+        {
+            std::cerr << "Cannot bake " << path << " (24-bit uncompressed BMP) into " << argv[3] << "\n";
+            return 1;
+        }
+        std::cout << "Baked " << path << " into " << argv[3] << " in " << secondsSince(t0) << " s\n";
+        path = argv[3];
+    }
+    else if (cmd != "info")
+    {
+        return usage();
+    }
+
+    sim::TileStreamer tiles;
+    if (!tiles.open(path))
+    {
+        std::cerr << "Cannot read tile pyramid " << path << "\n";
+        return 1;
+    }
+    const sim::TilePyramidHeader& h = tiles.header();
+    std::cout << path << ": " << h.width << " x " << h.height << " texels, " << h.levels << " levels, "
+              << h.tiles << " tiles of " << h.tileSize << " x " << h.tileSize << " ("
+              << h.tiles * tiles.tileBytes() / (1024.0 * 1024.0) << " MB)\n";
+    return 0;
+}
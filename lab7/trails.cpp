@@ -0,0 +1,67 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the trail ring buffer.
+*/
+
+#include "trails.h"
+#include <algorithm>
+
+namespace sim
+{
+
+void TrailBuffer::reset(size_t drones, int length, float* storage)
+{
+    n = drones;
+    k = std::max(1, length);
+    count = 0;
+    written = 0;
+    if (storage)
+    {
+        owned.clear();
+        buf = storage;
+    }
+    else
+    {
+        owned.assign(floatsNeeded(n, k), 0.0f);
+        buf = owned.data();
+    }
+}
+
+void TrailBuffer::pushRange(const std::vector<control::Vec3>& positions,
+                            size_t begin, size_t end)
+{
+    const size_t slot = count % k;
+    const size_t stride = 6 * static_cast<size_t>(k);   // floats per drone
+    for (size_t i = begin; i < end; ++i)
+    {
+        const control::Vec3& p = positions[i];
+        float* v = buf + i * stride + 3 * slot;
+        float* m = v + 3 * static_cast<size_t>(k);
+        v[0] = m[0] = static_cast<float>(p.x);
+        v[1] = m[1] = static_cast<float>(p.y);
+        v[2] = m[2] = static_cast<float>(p.z);
+    }
+}
+
+void TrailBuffer::push(const std::vector<control::Vec3>& positions)
+{
+    const size_t m = std::min(n, positions.size());
+    pushRange(positions, 0, m);
+    ++count;
+    written += 6 * m;
+}
+
+void TrailBuffer::push(const std::vector<control::Vec3>& positions, ThreadPool& pool)
+{
+    const size_t m = std::min(n, positions.size());
+    pool.parallelFor(m, [&](size_t b, size_t e, unsigned) {
+        pushRange(positions, b, e);
+    }, 4096);
+    ++count;
+    written += 6 * m;
+}
+
+} // namespace sim
@@ -0,0 +1,66 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Recent flight paths: the last K positions of every drone in a ring
+    laid out so each trail can be drawn straight out of a vertex buffer.
+*/
+
+#pragma once
+#include "control.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Every drone owns a run of 2K vertices (x, y, z floats). Sample s goes to
+// slot s % K and to its mirror K + s % K, so the newest K samples are
+// always one contiguous run of vertices: a single line strip per drone.
+// A push writes 2 vertices per drone however long the trails are.
+class TrailBuffer
+{
+public:
+    // Floats needed for `drones` trails of `length` samples
+    static size_t floatsNeeded(size_t drones, int length)
+    {
+        return drones * 2 * static_cast<size_t>(length) * 3;
+    }
+
+    // Start over with empty trails. `storage` (floatsNeeded() floats, e.g.
+    // a persistently mapped vertex buffer) is written in place; without
+    // it the buffer owns its memory.
+    void reset(size_t drones, int length, float* storage = nullptr);
+
+    // Append one sample per drone (positions of the published snapshot)
+    void push(const std::vector<control::Vec3>& positions);
+    void push(const std::vector<control::Vec3>& positions, ThreadPool& pool);
+
+    size_t drones()  const { return n; }
+    int    length()  const { return k; }
+    int    samples() const { return static_cast<int>(count < uint64_t(k) ? count : k); }
+
+    // Drone i's trail, oldest to newest: samples() vertices from this index
+    size_t first(size_t i) const
+    {
+        return i * 2 * k + (count == 0 ? 0 : (count - 1) % k + k + 1 - samples());
+    }
+    const float* data() const { return buf; }
+
+    // Floats written by push() so far (what a renderer has to upload)
+    uint64_t floatsWritten() const { return written; }
+
+private:
+    void pushRange(const std::vector<control::Vec3>& positions, size_t begin, size_t end);
+
+    size_t n = 0;
+    int    k = 0;
+    uint64_t count = 0;
+    uint64_t written = 0;
+    float* buf = nullptr;
+    std::vector<float> owned;
+};
+
+} // namespace sim
@@ -0,0 +1,332 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for the recording query engine.
+*/
+
+#include "trajectory_query.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace sim
+{
+
+namespace
+{
+
+// Squared distance from p to box b (lo xyz, hi xyz); infinite for the
+// empty box of a drone never seen in the slice
+double boxDist2(const float* b, const control::Vec3& p)
+{
+    if (b[0] > b[3]) return std::numeric_limits<double>::infinity();
+    double d2 = 0.0;
+    const double q[3] = { p.x, p.y, p.z };
+    for (int a = 0; a < 3; ++a)
+    {
+        double e = std::max({ b[a] - q[a], 0.0, q[a] - b[a + 3] });
+        d2 += e * e;
+    }
+    return d2;
+}
+
+double dist2(const float* a, const float* b)
+{
+    double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+double dist2(const float* a, const control::Vec3& p)
+{
+    double dx = a[0] - p.x, dy = a[1] - p.y, dz = a[2] - p.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void addCounters(QueryCounters& into, const QueryCounters& c)
+{
+    into.slices     += c.slices;
+    into.candidates += c.candidates;
+    into.samples    += c.samples;
+}
+
+} // namespace
+
+// ------------------------------------------
+// Range
+// ------------------------------------------
+std::vector<RangeHit> TrajectoryQuery::range(const control::Vec3& center, double radius,
+                                             double t0, double t1)
+{
+    count = QueryCounters();
+    uint64_t f0, f1;
+    rec.frameRange(t0, t1, f0, f1);
+    if (f0 >= f1) return {};
+
+    const uint32_t n  = rec.drones();
+    const uint64_t sf = rec.sliceFrames();
+    const uint64_t s0 = f0 / sf, s1 = (f1 - 1) / sf + 1;
+    const double   r2 = radius * radius;
+
+    // Per pool slot: best squared distance and frame per drone
+    struct Partial
+    {
+        std::vector<double>   d2;
+        std::vector<uint64_t> frame;
+        QueryCounters c;
+    };
+    std::vector<Partial> parts(pool.size());
+
+    pool.parallelFor(s1 - s0, [&](size_t b, size_t e, unsigned slot) {
+        Partial& pt = parts[slot];
+        if (pt.d2.empty())
+        {
+            pt.d2.assign(n, std::numeric_limits<double>::infinity());
+            pt.frame.assign(n, 0);
+        }
+        for (uint64_t s = s0 + b; s < s0 + e; ++s)
+        {
+            ++pt.c.slices;
+            const uint64_t fa = std::max(f0, s * sf), fb = std::min(f1, (s + 1) * sf);
+            for (uint32_t d = 0; d < n; ++d)
+            {
+                if (boxDist2(rec.box(s, d), center) > r2) continue;
+                ++pt.c.candidates;
+                for (uint64_t f = fa; f < fb; ++f)
+                {
+                    double q = dist2(rec.position(f, d), center);
+                    if (q <= r2 && q < pt.d2[d])
+                    {
+                        pt.d2[d] = q;
+                        pt.frame[d] = f;
+                    }
+                }
+                pt.c.samples += fb - fa;
+            }
+        }
+    }, 1);
+
+    std::vector<RangeHit> hits;
+    for (uint32_t d = 0; d < n; ++d)
+    {
+        double best = std::numeric_limits<double>::infinity();
+        uint64_t frame = 0;
+        for (const Partial& pt : parts)
+        {
+            if (!pt.d2.empty() && pt.d2[d] < best)
+            {
+                best = pt.d2[d];
+                frame = pt.frame[d];
+            }
+        }
+        if (best <= r2) hits.push_back({ d, rec.timeOf(frame), std::sqrt(best) });
+    }
+    for (const Partial& pt : parts) addCounters(count, pt.c);
+    return hits;
+}
+
+// ------------------------------------------
+// k nearest
+// ------------------------------------------
+// Drones in order of their slice box's distance to the point (popped
+// lazily off a heap); the scan stops once that lower bound passes the
+// k-th exact distance
+std::vector<Neighbor> TrajectoryQuery::knn(const control::Vec3& point, double time, int k,
+                                           std::vector<double>& bound,
+                                           std::vector<uint32_t>& order,
+                                           QueryCounters& c) const
+{
+    if (rec.frames() == 0 || k <= 0) return {};
+    const double rel = rec.period() > 0.0
+        ? std::round((time - rec.startTime()) / rec.period()) : 0.0;
+    const uint64_t f = static_cast<uint64_t>(
+        std::clamp(rel, 0.0, static_cast<double>(rec.frames() - 1)));
+    const uint64_t s = f / rec.sliceFrames();
+    const uint32_t n = rec.drones();
+
+    bound.resize(n);
+    order.resize(n);
+    for (uint32_t d = 0; d < n; ++d)
+    {
+        bound[d] = boxDist2(rec.box(s, d), point);
+        order[d] = d;
+    }
+    auto further = [&](uint32_t a, uint32_t b) {
+        return bound[a] != bound[b] ? bound[a] > bound[b] : a > b;
+    };
+    std::make_heap(order.begin(), order.end(), further);
+    ++c.slices;
+
+    // Max-heap of the k best so far
+    std::priority_queue<std::pair<double, uint32_t>> best;
+    for (auto end = order.end(); end != order.begin(); --end)
+    {
+        std::pop_heap(order.begin(), end, further);
+        const uint32_t d = *(end - 1);
+        if (static_cast<int>(best.size()) == k && bound[d] > best.top().first) break;
+        ++c.candidates;
+        ++c.samples;
+        double q = dist2(rec.position(f, d), point);
+        if (static_cast<int>(best.size()) < k)   best.push({ q, d });
+        else if (q < best.top().first)           { best.pop(); best.push({ q, d }); }
+    }
+
+    std::vector<Neighbor> out(best.size());
+    for (size_t i = out.size(); i-- > 0; best.pop())
+    {
+        out[i] = { best.top().second, std::sqrt(best.top().first) };
+    }
+    return out;
+}
+
+std::vector<Neighbor> TrajectoryQuery::nearest(const control::Vec3& point, double time, int k)
+{
+    count = QueryCounters();
+    std::vector<double> bound;
+    std::vector<uint32_t> order;
+    return knn(point, time, k, bound, order, count);
+}
+
+std::vector<std::vector<Neighbor>> TrajectoryQuery::nearest(const std::vector<KnnQuery>& queries)
+{
+    count = QueryCounters();
+    std::vector<std::vector<Neighbor>> out(queries.size());
+    struct Scratch
+    {
+        std::vector<double> bound;
+        std::vector<uint32_t> order;
+        QueryCounters c;
+    };
+    std::vector<Scratch> scratch(pool.size());
+    pool.parallelFor(queries.size(), [&](size_t b, size_t e, unsigned slot) {
+        Scratch& sc = scratch[slot];
+        for (size_t i = b; i < e; ++i)
+        {
+            const KnnQuery& q = queries[i];
+            out[i] = knn(q.point, q.time, q.k, sc.bound, sc.order, sc.c);
+        }
+    }, 1);
+    for (const Scratch& sc : scratch) addCounters(count, sc.c);
+    return out;
+}
+
+// ------------------------------------------
+// Near misses
+// ------------------------------------------
+// Per slice: sweep and prune over the drones' boxes along x, then the
+// frames of each overlapping pair. The slice's boxes and positions are
+// first copied out in sweep order, so the pair loop reads contiguous
+// runs instead of one cache line per frame.
+std::vector<NearMiss> TrajectoryQuery::nearMisses(double dist, double t0, double t1)
+{
+    count = QueryCounters();
+    uint64_t f0, f1;
+    rec.frameRange(t0, t1, f0, f1);
+    if (f0 >= f1) return {};
+
+    const uint32_t n  = rec.drones();
+    const uint64_t sf = rec.sliceFrames();
+    const uint64_t s0 = f0 / sf, s1 = (f1 - 1) / sf + 1;
+    const float    df = static_cast<float>(dist);
+    const double   d2max = dist * dist;
+
+    struct Partial
+    {
+        std::vector<NearMiss> hits;
+        std::vector<uint32_t> order;
+        std::vector<float>    boxes;   // sweep order, 6 per drone
+        std::vector<float>    track;   // sweep order, frames x 3 per drone
+        QueryCounters c;
+    };
+    std::vector<Partial> parts(pool.size());
+
+    pool.parallelFor(s1 - s0, [&](size_t b, size_t e, unsigned slot) {
+        Partial& pt = parts[slot];
+        for (uint64_t s = s0 + b; s < s0 + e; ++s)
+        {
+            ++pt.c.slices;
+            const uint64_t fa = std::max(f0, s * sf), fb = std::min(f1, (s + 1) * sf);
+            const size_t   nf = fb - fa;
+
+            pt.order.clear();
+            for (uint32_t d = 0; d < n; ++d)
+            {
+                if (rec.box(s, d)[0] <= rec.box(s, d)[3]) pt.order.push_back(d);
+            }
+            std::sort(pt.order.begin(), pt.order.end(), [&](uint32_t x, uint32_t y) {
+                return rec.box(s, x)[0] < rec.box(s, y)[0];
+            });
+
+            const size_t m = pt.order.size();
+            pt.boxes.resize(6 * m);
+            pt.track.resize(3 * nf * m);
+            for (size_t i = 0; i < m; ++i)
+            {
+                std::copy(rec.box(s, pt.order[i]), rec.box(s, pt.order[i]) + 6, &pt.boxes[6 * i]);
+            }
+            for (size_t f = 0; f < nf; ++f)
+            {
+                for (size_t i = 0; i < m; ++i)
+                {
+                    const float* p = rec.position(fa + f, pt.order[i]);
+                    float* q = &pt.track[(i * nf + f) * 3];
+                    q[0] = p[0]; q[1] = p[1]; q[2] = p[2];
+                }
+            }
+            pt.c.samples += nf * m;
+
+            for (size_t i = 0; i < m; ++i)
+            {
+                const float* ba = &pt.boxes[6 * i];
+                const float* ta = &pt.track[i * nf * 3];
+                for (size_t j = i + 1; j < m; ++j)
+                {
+                    const float* bb = &pt.boxes[6 * j];
+                    if (bb[0] > ba[3] + df) break;
+                    if (bb[1] > ba[4] + df || ba[1] > bb[4] + df ||
+                        bb[2] > ba[5] + df || ba[2] > bb[5] + df) continue;
+
+                    ++pt.c.candidates;
+                    const float* tb = &pt.track[j * nf * 3];
+                    double best = std::numeric_limits<double>::infinity();
+                    size_t when = 0;
+                    for (size_t f = 0; f < nf; ++f)
+                    {
+                        double q = dist2(ta + 3 * f, tb + 3 * f);
+                        if (q < best)
+                        {
+                            best = q;
+                            when = f;
+                        }
+                    }
+                    if (best > d2max) continue;
+
+                    const uint32_t da = pt.order[i], db = pt.order[j];
+                    pt.hits.push_back({ std::min(da, db), std::max(da, db),
+                                        rec.timeOf(fa + when), std::sqrt(best) });
+                }
+            }
+        }
+    }, 1);
+
+    // Merge: keep each pair's closest approach over all slices and slots
+    std::vector<NearMiss> out;
+    for (Partial& pt : parts)
+    {
+        addCounters(count, pt.c);
+        out.insert(out.end(), pt.hits.begin(), pt.hits.end());
+    }
+    std::sort(out.begin(), out.end(), [](const NearMiss& x, const NearMiss& y) {
+        if (x.a != y.a) return x.a < y.a;
+        if (x.b != y.b) return x.b < y.b;
+        return x.dist != y.dist ? x.dist < y.dist : x.time < y.time;
+    });
+    out.erase(std::unique(out.begin(), out.end(), [](const NearMiss& x, const NearMiss& y) {
+        return x.a == y.a && x.b == y.b;
+    }), out.end());
+    return out;
+}
+
+} // namespace sim
@@ -0,0 +1,88 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Spatio-temporal queries over a flight recording: range, k nearest
+    and near-miss, pruned by the recording's time-sliced box index and
+    run across a thread pool.
+*/
+
+#pragma once
+#include "recording.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Closest approach of one drone to a query point
+struct RangeHit
+{
+    uint32_t drone;
+    double   time;
+    double   dist;
+};
+
+// Closest approach of a pair of drones (a < b)
+struct NearMiss
+{
+    uint32_t a, b;
+    double   time;
+    double   dist;
+};
+
+struct Neighbor
+{
+    uint32_t drone;
+    double   dist;
+};
+
+struct KnnQuery
+{
+    control::Vec3 point;
+    double        time;
+    int           k;
+};
+
+// Work done by the last query: how much of the recording was looked at
+struct QueryCounters
+{
+    uint64_t slices    = 0;   // slices overlapping the time window
+    uint64_t candidates = 0;  // drones / pairs whose boxes passed
+    uint64_t samples   = 0;   // positions read from the frames
+};
+
+class TrajectoryQuery
+{
+public:
+    TrajectoryQuery(const Recording& rec, ThreadPool& pool) : rec(rec), pool(pool) {}
+
+    // Drones that came within `radius` of `center` during [t0, t1],
+    // with their closest approach, sorted by drone
+    std::vector<RangeHit> range(const control::Vec3& center, double radius,
+                                double t0, double t1);
+
+    // The k drones closest to `point` in the frame nearest `time`,
+    // closest first
+    std::vector<Neighbor> nearest(const control::Vec3& point, double time, int k);
+    // Many of those at once, one query per task
+    std::vector<std::vector<Neighbor>> nearest(const std::vector<KnnQuery>& queries);
+
+    // Pairs closer than `dist` in the same frame during [t0, t1], with
+    // their closest approach, sorted by (a, b)
+    std::vector<NearMiss> nearMisses(double dist, double t0, double t1);
+
+    const QueryCounters& counters() const { return count; }
+
+private:
+    std::vector<Neighbor> knn(const control::Vec3& point, double time, int k,
+                              std::vector<double>& bound, std::vector<uint32_t>& order,
+                              QueryCounters& c) const;
+
+    const Recording& rec;
+    ThreadPool& pool;
+    QueryCounters count;
+};
+
+} // namespace sim
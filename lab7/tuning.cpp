@@ -0,0 +1,100 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for PID gain gradients.
+*/
+
+#include "tuning.h"
+#include "dual.h"
+#include "simulation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+namespace
+{
+
+// The whole flight for scalar type T (double, or Dual for gradients)
+template <typename T>
+T flyLoss(const T gains[numGains], const TuningConfig& cfg)
+{
+    using V = control::Vec3T<T>;
+
+    // Limits and fresh state from the defaults, gains from the caller
+    const control::ControlPIDs defaults = control::defaultPIDs();
+    control::ControlPIDsT<T> pids{ control::PIDControllerT<T>(defaults.radialPID),
+                                   control::PIDControllerT<T>(defaults.speedPID) };
+    pids.radialPID.setGains(gains[0], gains[1], gains[2]);
+    pids.speedPID.setGains(gains[3], gains[4], gains[5]);
+
+    const control::ControlConfig& m = cfg.mission;
+    control::ControlStateT<T> state;
+    state.phase = control::Phase::OnSphere;
+
+    V center(m.center);
+    V pos(m.center + control::Vec3(m.sphereRadius + cfg.startOffset, 0, 0));
+    V vel;
+    const double midSpeed = 0.5 * (m.minSpeed + m.maxSpeed);
+
+    const int steps = static_cast<int>(cfg.seconds / cfg.dt);
+    T loss(0.0);
+    for (int s = 0; s < steps; ++s)
+    {
+        V force = control::computeControlForce(pos, vel, state, pids, m, cfg.dt);
+        integratePointMass(pos, vel, force, state.phase, cfg.dt);
+
+        T radial = control::distance(pos, center) - m.sphereRadius;
+        T speed  = vel.mag() - midSpeed;
+        loss += radial * radial + cfg.speedWeight * (speed * speed);
+    }
+    return loss / static_cast<double>(steps);
+}
+
+} // namespace
+
+void defaultGains(double gains[numGains])
+{
+    const control::ControlPIDs pids = control::defaultPIDs();
+    pids.radialPID.getGains(gains[0], gains[1], gains[2]);
+    pids.speedPID.getGains(gains[3], gains[4], gains[5]);
+}
+
+double trackingLoss(const double gains[numGains], const TuningConfig& cfg)
+{
+    return flyLoss(gains, cfg);
+}
+
+double trackingLossGradient(const double gains[numGains], const TuningConfig& cfg,
+                            double grad[numGains])
+{
+    using D = control::Dual<numGains>;
+    D g[numGains];
+    for (int k = 0; k < numGains; ++k) g[k] = D::variable(gains[k], k);
+
+    D loss = flyLoss(g, cfg);
+    for (int k = 0; k < numGains; ++k) grad[k] = loss.d[k];
+    return loss.v;
+}
+
+double finiteDifferenceGradient(const double gains[numGains], const TuningConfig& cfg,
+                                double grad[numGains], double step)
+{
+    double g[numGains];
+    for (int k = 0; k < numGains; ++k)
+    {
+        for (int j = 0; j < numGains; ++j) g[j] = gains[j];
+        const double h = step * std::max(1.0, std::abs(gains[k]));
+        g[k] = gains[k] + h;
+        double up = flyLoss(g, cfg);
+        g[k] = gains[k] - h;
+        double down = flyLoss(g, cfg);
+        grad[k] = (up - down) / (2.0 * h);
+    }
+    return flyLoss(gains, cfg);
+}
+
+} // namespace sim
@@ -0,0 +1,43 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Gradient of a single-drone tracking error with respect to the PID
+    gains, by forward-mode automatic differentiation through the
+    control law and the integrator.
+*/
+
+#pragma once
+#include "control.h"
+
+namespace sim {
+
+// Tuned gains, in this order: radial P, I, D, then speed P, I, D
+constexpr int numGains = 6;
+
+struct TuningConfig
+{
+    control::ControlConfig mission;
+    double seconds      = 20.0;
+    double dt           = 0.01;
+    double startOffset  = 2.0;   // m outside the sphere at t = 0
+    double speedWeight  = 0.1;   // weight of the speed error against the radial one
+};
+
+// The gains of defaultPIDs()
+void defaultGains(double gains[numGains]);
+
+// Fly one drone from just outside the sphere (already OnSphere) and
+// average (r - R)^2 + speedWeight * (speed - mid-band)^2 over the flight
+double trackingLoss(const double gains[numGains], const TuningConfig& cfg);
+
+// Same loss and its gradient from a single run with Dual numbers
+double trackingLossGradient(const double gains[numGains], const TuningConfig& cfg,
+                            double grad[numGains]);
+
+// Central differences for comparison: 2 * numGains runs
+double finiteDifferenceGradient(const double gains[numGains], const TuningConfig& cfg,
+                                double grad[numGains], double step = 1e-5);
+
+} // namespace sim
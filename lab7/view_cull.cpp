@@ -0,0 +1,124 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    Implementation file for view frusta and multi-view culling.
+*/
+
+#include "view_cull.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim
+{
+
+using control::Vec3;
+
+namespace
+{
+
+Vec3 cross(const Vec3& a, const Vec3& b)
+{
+    return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+// Plane with inward normal n through point p
+void setPlane(Frustum& f, int k, const Vec3& n, const Vec3& p)
+{
+    f.n[k] = n;
+    f.d[k] = -n.dot(p);
+}
+
+// View basis and the near / far pair shared by both projections
+void viewBasis(Frustum& f, const Vec3& eye, const Vec3& target, const Vec3& up,
+               double zNear, double zFar, Vec3& fwd, Vec3& right, Vec3& camUp)
+{
+    fwd = (target - eye).normalized();
+    right = cross(fwd, up).normalized();
+    camUp = cross(right, fwd);
+    setPlane(f, 4, fwd, eye + fwd * zNear);
+    setPlane(f, 5, fwd * -1.0, eye + fwd * zFar);
+}
+
+} // namespace
+
+Frustum Frustum::perspective(const Vec3& eye, const Vec3& target, const Vec3& up,
+                             double fovyDeg, double aspect, double zNear, double zFar)
+{
+    Frustum f;
+    Vec3 fwd, right, camUp;
+    viewBasis(f, eye, target, up, zNear, zFar, fwd, right, camUp);
+    const double v = std::tan(0.5 * fovyDeg * 3.14159265358979 / 180.0);
+    const double h = v * aspect;
+    // Side planes pass through the eye; x_right >= -h * z_fwd etc.
+    setPlane(f, 0, (right + fwd * h).normalized(), eye);
+    setPlane(f, 1, (right * -1.0 + fwd * h).normalized(), eye);
+    setPlane(f, 2, (camUp + fwd * v).normalized(), eye);
+    setPlane(f, 3, (camUp * -1.0 + fwd * v).normalized(), eye);
+    return f;
+}
+
+Frustum Frustum::orthographic(const Vec3& eye, const Vec3& target, const Vec3& up,
+                              double halfWidth, double halfHeight, double zNear, double zFar)
+{
+    Frustum f;
+    Vec3 fwd, right, camUp;
+    viewBasis(f, eye, target, up, zNear, zFar, fwd, right, camUp);
+    setPlane(f, 0, right, eye - right * halfWidth);
+    setPlane(f, 1, right * -1.0, eye + right * halfWidth);
+    setPlane(f, 2, camUp, eye - camUp * halfHeight);
+    setPlane(f, 3, camUp * -1.0, eye + camUp * halfHeight);
+    return f;
+}
+
+void cullViews(const std::vector<Vec3>& pos, double radius,
+               const std::vector<Frustum>& views, std::vector<std::vector<uint32_t>>& visible)
+{
+    visible.resize(views.size());
+    for (auto& list : visible) list.clear();
+
+    // kMaxViews views per pass over the positions
+    const size_t n = pos.size();
+    for (size_t first = 0; first < views.size(); first += kMaxViews)
+    {
+        const int nv = static_cast<int>(std::min<size_t>(views.size() - first, kMaxViews));
+
+        // Planes flattened so the inner test is straight-line code
+        double plane[kMaxViews * 6][4];
+        for (int v = 0; v < nv; ++v)
+        {
+            const Frustum& f = views[first + v];
+            for (int k = 0; k < 6; ++k)
+            {
+                double* p = plane[6 * v + k];
+                p[0] = f.n[k].x;
+                p[1] = f.n[k].y;
+                p[2] = f.n[k].z;
+                p[3] = f.d[k] + radius;
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double x = pos[i].x, y = pos[i].y, z = pos[i].z;
+            uint32_t mask = 0;
+            for (int v = 0; v < nv; ++v)
+            {
+                bool in = true;
+                for (int k = 0; k < 6; ++k)
+                {
+                    const double* p = plane[6 * v + k];
+                    in &= p[0] * x + p[1] * y + p[2] * z + p[3] >= 0.0;
+                }
+                mask |= uint32_t(in) << v;
+            }
+            for (size_t v = first; mask; ++v, mask >>= 1)
+            {
+                if (mask & 1u) visible[v].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+} // namespace sim
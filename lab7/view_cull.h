@@ -0,0 +1,53 @@
+/*
+Author: Shanyu Jiang
+Class: ECE6122
+Last Date Modified: 10/18/2026
+Description:
+    View frusta and multi-view culling: one pass over the drone
+    positions tests every view and builds each view's instance list.
+*/
+
+#pragma once
+#include "control.h"
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Six inward-facing planes; a point p is inside plane k when
+// n[k].dot(p) + d[k] >= 0
+struct Frustum
+{
+    control::Vec3 n[6];
+    double d[6];
+
+    // Camera at `eye` looking at `target` with world `up`;
+    // fovy in degrees, aspect = width / height
+    static Frustum perspective(const control::Vec3& eye, const control::Vec3& target,
+                               const control::Vec3& up, double fovyDeg, double aspect,
+                               double zNear, double zFar);
+    // Parallel projection of halfWidth x halfHeight around the view axis
+    static Frustum orthographic(const control::Vec3& eye, const control::Vec3& target,
+                                const control::Vec3& up, double halfWidth, double halfHeight,
+                                double zNear, double zFar);
+
+    bool containsSphere(const control::Vec3& p, double r) const
+    {
+        for (int k = 0; k < 6; ++k)
+        {
+            if (n[k].dot(p) + d[k] < -r) return false;
+        }
+        return true;
+    }
+};
+
+// Views tested per pass over the positions (one bit each)
+constexpr int kMaxViews = 32;
+
+// visible[v] = indices of the drones whose sphere of `radius` touches
+// view v, in index order. Each position is read once per kMaxViews
+// views; any number of views is accepted.
+void cullViews(const std::vector<control::Vec3>& pos, double radius,
+               const std::vector<Frustum>& views, std::vector<std::vector<uint32_t>>& visible);
+
+} // namespace sim